@@ -479,6 +479,10 @@ uint64_t OS::get_static_memory_peak_usage() const {
 	return ::OS::get_singleton()->get_static_memory_peak_usage();
 }
 
+Array OS::get_static_memory_usage_by_size_class() const {
+	return ::OS::get_singleton()->get_static_memory_usage_by_size_class();
+}
+
 Dictionary OS::get_memory_info() const {
 	return ::OS::get_singleton()->get_memory_info();
 }
@@ -652,6 +656,7 @@ void OS::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_static_memory_usage"), &OS::get_static_memory_usage);
 	ClassDB::bind_method(D_METHOD("get_static_memory_peak_usage"), &OS::get_static_memory_peak_usage);
+	ClassDB::bind_method(D_METHOD("get_static_memory_usage_by_size_class"), &OS::get_static_memory_usage_by_size_class);
 	ClassDB::bind_method(D_METHOD("get_memory_info"), &OS::get_memory_info);
 
 	ClassDB::bind_method(D_METHOD("move_to_trash", "path"), &OS::move_to_trash);
@@ -204,6 +204,7 @@ public:
 
 	uint64_t get_static_memory_usage() const;
 	uint64_t get_static_memory_peak_usage() const;
+	Array get_static_memory_usage_by_size_class() const;
 	Dictionary get_memory_info() const;
 
 	void delay_usec(int p_usec) const;
@@ -38,6 +38,7 @@
 #include "core/input/input.h"
 #include "core/io/resource_loader.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "servers/display_server.h"
 
@@ -93,6 +94,21 @@ public:
 	}
 };
 
+// Streams the WorkerThreadPool task timeline, captured while the profiler is enabled.
+class RemoteDebugger::TaskTimelineProfiler : public EngineProfiler {
+public:
+	void toggle(bool p_enable, const Array &p_opts) {
+		WorkerThreadPool::get_singleton()->set_task_timeline_capture_enabled(p_enable);
+	}
+	void add(const Array &p_data) {}
+	void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+		Array timeline = WorkerThreadPool::get_singleton()->take_task_timeline();
+		if (!timeline.is_empty()) {
+			EngineDebugger::get_singleton()->send_message("task_timeline:frame", timeline);
+		}
+	}
+};
+
 Error RemoteDebugger::_put_msg(const String &p_message, const Array &p_data) {
 	Array msg;
 	msg.push_back(p_message);
@@ -670,6 +686,10 @@ RemoteDebugger::RemoteDebugger(Ref<RemoteDebuggerPeer> p_peer) {
 		profiler_enable("performance", true);
 	}
 
+	// Task timeline profiler, enabled on request (e.g. by an EditorDebuggerPlugin).
+	task_timeline_profiler.instantiate();
+	task_timeline_profiler->bind("task_timeline");
+
 	// Core and profiler captures.
 	Capture core_cap(this,
 			[](void *p_user, const String &p_cmd, const Array &p_data, bool &r_captured) {
@@ -51,8 +51,10 @@ private:
 	typedef DebuggerMarshalls::OutputError ErrorMessage;
 
 	class PerformanceProfiler;
+	class TaskTimelineProfiler;
 
 	Ref<PerformanceProfiler> performance_profiler;
+	Ref<TaskTimelineProfiler> task_timeline_profiler;
 
 	Ref<RemoteDebuggerPeer> peer;
 
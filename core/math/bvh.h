@@ -71,6 +71,14 @@ public:
 		_thread_safe = p_enable;
 	}
 
+	// Refitting and pair detection in update() are spread over the WorkerThreadPool once there are at least
+	// this many dirty leaves / changed items to process. 0 (the default) keeps all the work on the calling thread.
+	// Pair and unpair callbacks are always sent from the calling thread, in the same order either way.
+	void params_set_parallel_threshold(uint32_t p_threshold) {
+		BVH_LOCKED_FUNCTION
+		tree._parallel_threshold = p_threshold;
+	}
+
 	// these 2 are crucial for fine tuning, and can be applied manually
 	// see the variable declarations for more info.
 	void params_set_node_expansion(real_t p_value) {
@@ -344,10 +352,25 @@ public:
 		}
 	}
 
+	// Culls can run on several threads at once by passing each a hits buffer of its own (r_hits).
+	// These culls don't lock the tree, the caller holds lock() for the duration of the whole batch instead.
+	void lock() {
+		if (BVH_THREAD_SAFE && _thread_safe) {
+			_mutex.lock();
+		}
+	}
+
+	void unlock() {
+		if (BVH_THREAD_SAFE && _thread_safe) {
+			_mutex.unlock();
+		}
+	}
+
 	// cull tests
-	int cull_aabb(const BOUNDS &p_aabb, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
-		BVH_LOCKED_FUNCTION
+	int cull_aabb(const BOUNDS &p_aabb, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr, LocalVector<uint32_t, uint32_t, true> *r_hits = nullptr) {
+		BVHLockedFunction _lock_guard(&_mutex, BVH_THREAD_SAFE && _thread_safe && !r_hits);
 		typename BVHTREE_CLASS::CullParams params;
+		params.hits = r_hits;
 
 		params.result_count_overall = 0;
 		params.result_max = p_result_max;
@@ -362,9 +385,10 @@ public:
 		return params.result_count_overall;
 	}
 
-	int cull_segment(const POINT &p_from, const POINT &p_to, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
-		BVH_LOCKED_FUNCTION
+	int cull_segment(const POINT &p_from, const POINT &p_to, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr, LocalVector<uint32_t, uint32_t, true> *r_hits = nullptr) {
+		BVHLockedFunction _lock_guard(&_mutex, BVH_THREAD_SAFE && _thread_safe && !r_hits);
 		typename BVHTREE_CLASS::CullParams params;
+		params.hits = r_hits;
 
 		params.result_count_overall = 0;
 		params.result_max = p_result_max;
@@ -381,9 +405,10 @@ public:
 		return params.result_count_overall;
 	}
 
-	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
-		BVH_LOCKED_FUNCTION
+	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr, LocalVector<uint32_t, uint32_t, true> *r_hits = nullptr) {
+		BVHLockedFunction _lock_guard(&_mutex, BVH_THREAD_SAFE && _thread_safe && !r_hits);
 		typename BVHTREE_CLASS::CullParams params;
+		params.hits = r_hits;
 
 		params.result_count_overall = 0;
 		params.result_max = p_result_max;
@@ -435,6 +460,11 @@ private:
 			return;
 		}
 
+		if (tree._parallel_threshold && changed_items.size() >= tree._parallel_threshold && WorkerThreadPool::get_singleton()) {
+			_check_for_collisions_parallel(p_full_check);
+			return;
+		}
+
 		BOUNDS bb;
 
 		typename BVHTREE_CLASS::CullParams params;
@@ -480,6 +510,73 @@ private:
 		_reset();
 	}
 
+	// Culling the changed items against the tree is the bulk of the pairing cost and only reads the tree,
+	// so it is done for blocks of changed items on several threads, each block gathering the candidates into
+	// buffers of its own. The leavers and new pairs (and their callbacks) are then processed serially in
+	// changed item order, giving exactly the same results as the single threaded path.
+	void _check_for_collisions_parallel(bool p_full_check) {
+		uint32_t num_blocks = (changed_items.size() + PAIR_BLOCK_SIZE - 1) / PAIR_BLOCK_SIZE;
+		if (_pair_blocks.size() < num_blocks) {
+			_pair_blocks.resize(num_blocks);
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_find_pair_candidates, (void *)nullptr, num_blocks, -1, true, SNAME("BVHFindPairs"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		for (uint32_t b = 0; b < num_blocks; b++) {
+			const PairBlock &block = _pair_blocks[b];
+			uint32_t first = b * PAIR_BLOCK_SIZE;
+			uint32_t hit = 0;
+
+			for (uint32_t n = 0; n < block.ends.size(); n++) {
+				const BVHHandle &h = changed_items[first + n];
+
+				BVHABB_CLASS abb;
+				abb.from(tree._pairs[h.id()].expanded_aabb);
+				_find_leavers(h, abb, p_full_check);
+
+				for (; hit < block.ends[n]; hit++) {
+					BVHHandle h_collidee;
+					h_collidee.set_id(block.hits[hit]);
+					_collide(h, h_collidee);
+				}
+			}
+		}
+		_reset();
+	}
+
+	void _find_pair_candidates(uint32_t p_block, void *p_userdata) {
+		PairBlock &block = _pair_blocks[p_block];
+		block.hits.clear();
+		block.ends.clear();
+
+		typename BVHTREE_CLASS::CullParams params;
+		params.hits = &block.cull_hits;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+
+		uint32_t first = p_block * PAIR_BLOCK_SIZE;
+		uint32_t last = MIN(first + PAIR_BLOCK_SIZE, changed_items.size());
+
+		for (uint32_t n = first; n < last; n++) {
+			const BVHHandle &h = changed_items[n];
+			params.abb.from(tree._pairs[h.id()].expanded_aabb);
+			tree.item_fill_cullparams(h, params);
+
+			params.result_count_overall = 0;
+			tree.cull_aabb(params, false);
+
+			for (const uint32_t ref_id : block.cull_hits) {
+				// don't collide against ourself
+				if (ref_id != h.id()) {
+					block.hits.push_back(ref_id);
+				}
+			}
+			block.ends.push_back(block.hits.size());
+		}
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -773,6 +870,17 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// pairing candidates gathered by _find_pair_candidates, for a block of changed items each
+	static constexpr uint32_t PAIR_BLOCK_SIZE = 32;
+
+	struct PairBlock {
+		LocalVector<uint32_t, uint32_t, true> hits;
+		// one past the last of each item's hits
+		LocalVector<uint32_t, uint32_t, true> ends;
+		LocalVector<uint32_t, uint32_t, true> cull_hits;
+	};
+	LocalVector<PairBlock> _pair_blocks;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
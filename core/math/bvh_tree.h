@@ -43,6 +43,7 @@
 #include "core/math/bvh_abb.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/vector3.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/pooled_list.h"
 #include <limits.h>
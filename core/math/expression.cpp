@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/ref_counted.h"
 #include "core/os/os.h"
+#include "core/variant/variant_internal.h"
 #include "core/variant/variant_parser.h"
 
 Error Expression::_get_token(Token &r_token) {
@@ -1239,231 +1240,416 @@ bool Expression::_compile_expression() {
 	return false;
 }
 
-bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+uint32_t Expression::_add_instruction(Instruction::Opcode p_opcode, const LocalVector<uint32_t> &p_operands) {
+	Instruction instruction;
+	instruction.opcode = p_opcode;
+	instruction.first_operand = operands.size();
+	instruction.operand_count = p_operands.size();
+	for (uint32_t operand : p_operands) {
+		operands.push_back(operand);
+	}
+	max_operand_count = MAX(max_operand_count, p_operands.size());
+	instructions.push_back(instruction);
+	return (OPERAND_REGISTER << OPERAND_TYPE_SHIFT) | (instructions.size() - 1);
+}
+
+uint32_t Expression::_compile_node(ENode *p_node) {
+	// Operands are compiled in the order the tree used to be evaluated, so errors are reported the same.
+	LocalVector<uint32_t> node_operands;
+
 	switch (p_node->type) {
-		case Expression::ENode::TYPE_INPUT: {
-			const Expression::InputNode *in = static_cast<const Expression::InputNode *>(p_node);
-			if (in->index < 0 || in->index >= p_inputs.size()) {
-				r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), in->index);
-				return true;
+		case ENode::TYPE_INPUT: {
+			return (OPERAND_INPUT << OPERAND_TYPE_SHIFT) | static_cast<const InputNode *>(p_node)->index;
+		}
+		case ENode::TYPE_CONSTANT: {
+			constants.push_back(static_cast<const ConstantNode *>(p_node)->value);
+			return (OPERAND_CONSTANT << OPERAND_TYPE_SHIFT) | (constants.size() - 1);
+		}
+		case ENode::TYPE_SELF: {
+			return OPERAND_SELF << OPERAND_TYPE_SHIFT;
+		}
+		case ENode::TYPE_OPERATOR: {
+			const OperatorNode *op = static_cast<const OperatorNode *>(p_node);
+			node_operands.push_back(_compile_node(op->nodes[0]));
+			if (op->nodes[1]) {
+				node_operands.push_back(_compile_node(op->nodes[1]));
 			}
-			r_ret = p_inputs[in->index];
-		} break;
-		case Expression::ENode::TYPE_CONSTANT: {
-			const Expression::ConstantNode *c = static_cast<const Expression::ConstantNode *>(p_node);
-			r_ret = c->value;
-
-		} break;
-		case Expression::ENode::TYPE_SELF: {
-			if (!p_instance) {
-				r_error_str = RTR("self can't be used because instance is null (not passed)");
-				return true;
+			uint32_t target = _add_instruction(Instruction::OPCODE_OPERATOR, node_operands);
+			instructions[instructions.size() - 1].op = op->op;
+			return target;
+		}
+		case ENode::TYPE_INDEX: {
+			const IndexNode *index = static_cast<const IndexNode *>(p_node);
+			node_operands.push_back(_compile_node(index->base));
+			node_operands.push_back(_compile_node(index->index));
+			return _add_instruction(Instruction::OPCODE_INDEX, node_operands);
+		}
+		case ENode::TYPE_NAMED_INDEX: {
+			const NamedIndexNode *index = static_cast<const NamedIndexNode *>(p_node);
+			node_operands.push_back(_compile_node(index->base));
+			uint32_t target = _add_instruction(Instruction::OPCODE_NAMED_INDEX, node_operands);
+			instructions[instructions.size() - 1].name = index->name;
+			return target;
+		}
+		case ENode::TYPE_ARRAY: {
+			const ArrayNode *array = static_cast<const ArrayNode *>(p_node);
+			for (ENode *element : array->array) {
+				node_operands.push_back(_compile_node(element));
 			}
-			r_ret = p_instance;
-		} break;
-		case Expression::ENode::TYPE_OPERATOR: {
-			const Expression::OperatorNode *op = static_cast<const Expression::OperatorNode *>(p_node);
-
-			Variant a;
-			bool ret = _execute(p_inputs, p_instance, op->nodes[0], a, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			return _add_instruction(Instruction::OPCODE_ARRAY, node_operands);
+		}
+		case ENode::TYPE_DICTIONARY: {
+			const DictionaryNode *dictionary = static_cast<const DictionaryNode *>(p_node);
+			for (ENode *element : dictionary->dict) {
+				node_operands.push_back(_compile_node(element));
 			}
-
-			Variant b;
-
-			if (op->nodes[1]) {
-				ret = _execute(p_inputs, p_instance, op->nodes[1], b, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
-				}
+			return _add_instruction(Instruction::OPCODE_DICTIONARY, node_operands);
+		}
+		case ENode::TYPE_CONSTRUCTOR: {
+			const ConstructorNode *constructor = static_cast<const ConstructorNode *>(p_node);
+			for (ENode *argument : constructor->arguments) {
+				node_operands.push_back(_compile_node(argument));
 			}
-
-			bool valid = true;
-			Variant::evaluate(op->op, a, b, r_ret, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op->op), Variant::get_type_name(a.get_type()), Variant::get_type_name(b.get_type()));
-				return true;
+			uint32_t target = _add_instruction(Instruction::OPCODE_CONSTRUCT, node_operands);
+			instructions[instructions.size() - 1].type = constructor->data_type;
+			return target;
+		}
+		case ENode::TYPE_BUILTIN_FUNC: {
+			const BuiltinFuncNode *bifunc = static_cast<const BuiltinFuncNode *>(p_node);
+			for (ENode *argument : bifunc->arguments) {
+				node_operands.push_back(_compile_node(argument));
 			}
-
-		} break;
-		case Expression::ENode::TYPE_INDEX: {
-			const Expression::IndexNode *index = static_cast<const Expression::IndexNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			uint32_t target = _add_instruction(Instruction::OPCODE_CALL_UTILITY, node_operands);
+			Instruction &instruction = instructions[instructions.size() - 1];
+			instruction.name = bifunc->func;
+			instruction.first_argument_type = argument_types.size();
+
+			// Utility functions are known at compile time, their validated version is used when the
+			// arguments have the exact types.
+			bool validated = !Variant::is_utility_function_vararg(bifunc->func) && bifunc->arguments.size() == Variant::get_utility_function_argument_count(bifunc->func);
+			for (int i = 0; i < bifunc->arguments.size(); i++) {
+				Variant::Type type = validated ? Variant::get_utility_function_argument_type(bifunc->func, i) : Variant::VARIANT_MAX;
+				validated = validated && type != Variant::NIL;
+				argument_types.push_back(type);
 			}
-
-			Variant idx;
-
-			ret = _execute(p_inputs, p_instance, index->index, idx, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			if (validated) {
+				instruction.utility_function = Variant::get_validated_utility_function(bifunc->func);
+				instruction.utility_return_type = Variant::has_utility_function_return_value(bifunc->func) ? Variant::get_utility_function_return_type(bifunc->func) : Variant::NIL;
 			}
-
-			bool valid;
-			r_ret = base.get(idx, &valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx.get_type()), Variant::get_type_name(base.get_type()));
-				return true;
+			return target;
+		}
+		case ENode::TYPE_CALL: {
+			const CallNode *call = static_cast<const CallNode *>(p_node);
+			node_operands.push_back(_compile_node(call->base));
+			for (ENode *argument : call->arguments) {
+				node_operands.push_back(_compile_node(argument));
 			}
+			uint32_t target = _add_instruction(Instruction::OPCODE_CALL, node_operands);
+			Instruction &instruction = instructions[instructions.size() - 1];
+			instruction.name = call->method;
+			return target;
+		}
+	}
 
-		} break;
-		case Expression::ENode::TYPE_NAMED_INDEX: {
-			const Expression::NamedIndexNode *index = static_cast<const Expression::NamedIndexNode *>(p_node);
+	ERR_FAIL_V(OPERAND_SELF << OPERAND_TYPE_SHIFT);
+}
 
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
+void Expression::_clear_program() {
+	instructions.clear();
+	operands.clear();
+	argument_types.clear();
+	constants.clear();
+	result_operand = 0;
+	max_operand_count = 0;
+
+	MutexLock lock(caches_mutex);
+	for (InstructionCache *cache : caches) {
+		memdelete(cache);
+	}
+	caches.clear();
+}
 
-			bool valid;
-			r_ret = base.get_named(index->name, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(index->name), Variant::get_type_name(base.get_type()));
-				return true;
-			}
+Expression::InstructionCache *Expression::_create_cache(const InstructionCache *p_previous) const {
+	if (p_previous && p_previous->generation >= MAX_CACHE_GENERATIONS) {
+		return nullptr;
+	}
+	InstructionCache *cache = memnew(InstructionCache);
+	cache->generation = p_previous ? p_previous->generation + 1 : 1;
+	return cache;
+}
 
-		} break;
-		case Expression::ENode::TYPE_ARRAY: {
-			const Expression::ArrayNode *array = static_cast<const Expression::ArrayNode *>(p_node);
+void Expression::_publish_cache(const Instruction &p_instruction, InstructionCache *p_cache) {
+	MutexLock lock(caches_mutex);
+	caches.push_back(p_cache);
+	p_instruction.cache.cache.store(p_cache, std::memory_order_release);
+}
 
-			Array arr;
-			arr.resize(array->array.size());
-			for (int i = 0; i < array->array.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, array->array[i], value, p_const_calls_only, r_error_str);
+bool Expression::_execute(Variant *p_registers, const Variant **p_arguments, const Variant *const *p_inputs, int p_input_count, Object *p_instance, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+	Variant *registers = p_registers;
+	const Variant **arguments = p_arguments;
+	const Variant nil;
+	Variant self;
+	if (p_instance) {
+		self = p_instance;
+	}
 
-				if (ret) {
-					return true;
+	// Returns nullptr and sets the error when the operand is not available.
+	auto get_operand = [&](uint32_t p_operand) -> const Variant * {
+		const uint32_t index = p_operand & OPERAND_INDEX_MASK;
+		switch (p_operand >> OPERAND_TYPE_SHIFT) {
+			case OPERAND_REGISTER:
+				return &registers[index];
+			case OPERAND_CONSTANT:
+				return &constants[index];
+			case OPERAND_INPUT:
+				if (unlikely((int)index >= p_input_count)) {
+					r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), index);
+					return nullptr;
 				}
-				arr[i] = value;
-			}
+				return p_inputs[index];
+			default:
+				if (unlikely(!p_instance)) {
+					r_error_str = RTR("self can't be used because instance is null (not passed)");
+					return nullptr;
+				}
+				return &self;
+		}
+	};
 
-			r_ret = arr;
+#define GET_OPERAND(m_var, m_operand)              \
+	const Variant *m_var = get_operand(m_operand); \
+	if (unlikely(!m_var)) {                        \
+		return true;                               \
+	}
 
-		} break;
-		case Expression::ENode::TYPE_DICTIONARY: {
-			const Expression::DictionaryNode *dictionary = static_cast<const Expression::DictionaryNode *>(p_node);
+	for (uint32_t ip = 0; ip < instructions.size(); ip++) {
+		const Instruction &instruction = instructions[ip];
+		const uint32_t *instruction_operands = &operands[instruction.first_operand];
+		Variant *dst = &registers[ip];
+
+		switch (instruction.opcode) {
+			case Instruction::OPCODE_OPERATOR: {
+				GET_OPERAND(a, instruction_operands[0]);
+				const Variant *b = &nil;
+				if (instruction.operand_count > 1) {
+					GET_OPERAND(operand_b, instruction_operands[1]);
+					b = operand_b;
+				}
 
-			Dictionary d;
-			for (int i = 0; i < dictionary->dict.size(); i += 2) {
-				Variant key;
-				bool ret = _execute(p_inputs, p_instance, dictionary->dict[i + 0], key, p_const_calls_only, r_error_str);
+				const Variant::Type a_type = a->get_type();
+				const Variant::Type b_type = b->get_type();
+				const InstructionCache *cache = instruction.cache.get();
+				if (likely(cache && cache->operator_evaluator && cache->types[0] == a_type && cache->types[1] == b_type)) {
+					VariantInternal::initialize(dst, cache->return_type);
+					cache->operator_evaluator(a, b, dst);
+					break;
+				}
 
-				if (ret) {
+				bool valid = true;
+				Variant::evaluate(instruction.op, *a, *b, *dst, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(instruction.op), Variant::get_type_name(a_type), Variant::get_type_name(b_type));
 					return true;
 				}
 
-				Variant value;
-				ret = _execute(p_inputs, p_instance, dictionary->dict[i + 1], value, p_const_calls_only, r_error_str);
-				if (ret) {
+				// Validated evaluators don't check for division by zero, negative shifts nor freed objects.
+				const bool checked_op = instruction.op == Variant::OP_DIVIDE || instruction.op == Variant::OP_MODULE || instruction.op == Variant::OP_SHIFT_LEFT || instruction.op == Variant::OP_SHIFT_RIGHT;
+				if (!checked_op && a_type != Variant::OBJECT && b_type != Variant::OBJECT) {
+					InstructionCache *new_cache = _create_cache(cache);
+					if (new_cache) {
+						new_cache->operator_evaluator = Variant::get_validated_operator_evaluator(instruction.op, a_type, b_type);
+						new_cache->return_type = Variant::get_operator_return_type(instruction.op, a_type, b_type);
+						new_cache->types[0] = a_type;
+						new_cache->types[1] = b_type;
+						_publish_cache(instruction, new_cache);
+					}
+				}
+			} break;
+			case Instruction::OPCODE_INDEX: {
+				GET_OPERAND(base, instruction_operands[0]);
+				GET_OPERAND(idx, instruction_operands[1]);
+
+				bool valid;
+				*dst = base->get(*idx, &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx->get_type()), Variant::get_type_name(base->get_type()));
 					return true;
 				}
+			} break;
+			case Instruction::OPCODE_NAMED_INDEX: {
+				GET_OPERAND(base, instruction_operands[0]);
+
+				const Variant::Type base_type = base->get_type();
+				const InstructionCache *cache = instruction.cache.get();
+				if (likely(cache && cache->getter && cache->types[0] == base_type)) {
+					VariantInternal::initialize(dst, cache->return_type);
+					cache->getter(base, dst);
+					break;
+				}
 
-				d[key] = value;
-			}
-
-			r_ret = d;
-		} break;
-		case Expression::ENode::TYPE_CONSTRUCTOR: {
-			const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(constructor->arguments.size());
-			argp.resize(constructor->arguments.size());
-
-			for (int i = 0; i < constructor->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, constructor->arguments[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
+				bool valid;
+				*dst = base->get_named(instruction.name, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(instruction.name), Variant::get_type_name(base_type));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
-
-			Callable::CallError ce;
-			Variant::construct(constructor->data_type, r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(constructor->data_type));
-				return true;
-			}
-
-		} break;
-		case Expression::ENode::TYPE_BUILTIN_FUNC: {
-			const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(bifunc->arguments.size());
-			argp.resize(bifunc->arguments.size());
+				if (base_type != Variant::OBJECT && base_type != Variant::DICTIONARY) {
+					InstructionCache *new_cache = _create_cache(cache);
+					if (new_cache) {
+						new_cache->getter = Variant::get_member_validated_getter(base_type, instruction.name);
+						new_cache->return_type = Variant::get_member_type(base_type, instruction.name);
+						new_cache->types[0] = base_type;
+						_publish_cache(instruction, new_cache);
+					}
+				}
+			} break;
+			case Instruction::OPCODE_ARRAY: {
+				Array arr;
+				arr.resize(instruction.operand_count);
+				for (uint32_t i = 0; i < instruction.operand_count; i++) {
+					GET_OPERAND(element, instruction_operands[i]);
+					arr[i] = *element;
+				}
+				*dst = arr;
+			} break;
+			case Instruction::OPCODE_DICTIONARY: {
+				Dictionary d;
+				for (uint32_t i = 0; i < instruction.operand_count; i += 2) {
+					GET_OPERAND(key, instruction_operands[i + 0]);
+					GET_OPERAND(value, instruction_operands[i + 1]);
+					d[*key] = *value;
+				}
+				*dst = d;
+			} break;
+			case Instruction::OPCODE_CONSTRUCT: {
+				for (uint32_t i = 0; i < instruction.operand_count; i++) {
+					GET_OPERAND(argument, instruction_operands[i]);
+					arguments[i] = argument;
+				}
 
-			for (int i = 0; i < bifunc->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, bifunc->arguments[i], value, p_const_calls_only, r_error_str);
-				if (ret) {
+				Callable::CallError ce;
+				Variant::construct(instruction.type, *dst, arguments, instruction.operand_count, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(instruction.type));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
+			} break;
+			case Instruction::OPCODE_CALL_UTILITY: {
+				const Variant::Type *types = &argument_types[instruction.first_argument_type];
+				bool types_match = instruction.utility_function != nullptr;
+				for (uint32_t i = 0; i < instruction.operand_count; i++) {
+					GET_OPERAND(argument, instruction_operands[i]);
+					arguments[i] = argument;
+					types_match = types_match && arguments[i]->get_type() == types[i];
+				}
 
-			r_ret = Variant(); //may not return anything
-			Callable::CallError ce;
-			Variant::call_utility_function(bifunc->func, &r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = "Builtin call failed: " + Variant::get_call_error_text(bifunc->func, (const Variant **)argp.ptr(), argp.size(), ce);
-				return true;
-			}
+				if (types_match) {
+					VariantInternal::initialize(dst, instruction.utility_return_type);
+					instruction.utility_function(dst, arguments, instruction.operand_count);
+					break;
+				}
 
-		} break;
-		case Expression::ENode::TYPE_CALL: {
-			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
+				*dst = Variant(); //may not return anything
+				Callable::CallError ce;
+				Variant::call_utility_function(instruction.name, dst, arguments, instruction.operand_count, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = "Builtin call failed: " + Variant::get_call_error_text(instruction.name, arguments, instruction.operand_count, ce);
+					return true;
+				}
+			} break;
+			case Instruction::OPCODE_CALL: {
+				GET_OPERAND(base, instruction_operands[0]);
+				const int argc = instruction.operand_count - 1;
+				for (int i = 0; i < argc; i++) {
+					GET_OPERAND(argument, instruction_operands[i + 1]);
+					arguments[i] = argument;
+				}
 
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
+				const Variant::Type base_type = base->get_type();
+				const InstructionCache *cache = instruction.cache.get();
+				Callable::CallError ce;
+
+				if (base_type != Variant::OBJECT) {
+					if (!cache || cache->types[0] != base_type) {
+						// Only const methods are resolved, as the base may be a constant or an input.
+						InstructionCache *new_cache = _create_cache(cache);
+						if (new_cache) {
+							new_cache->types[0] = base_type;
+							if (Variant::has_builtin_method(base_type, instruction.name) && Variant::is_builtin_method_const(base_type, instruction.name) && !Variant::is_builtin_method_vararg(base_type, instruction.name) && argc == Variant::get_builtin_method_argument_count(base_type, instruction.name)) {
+								new_cache->builtin_method = Variant::get_validated_builtin_method(base_type, instruction.name);
+								new_cache->return_type = Variant::has_builtin_method_return_value(base_type, instruction.name) ? Variant::get_builtin_method_return_type(base_type, instruction.name) : Variant::NIL;
+								new_cache->argument_types.resize(argc);
+								for (int i = 0; i < argc; i++) {
+									new_cache->argument_types[i] = Variant::get_builtin_method_argument_type(base_type, instruction.name, i);
+								}
+							}
+							_publish_cache(instruction, new_cache);
+						}
+						cache = new_cache;
+					}
 
-			if (ret) {
-				return true;
-			}
+					bool types_match = cache && cache->builtin_method != nullptr;
+					for (int i = 0; i < argc && types_match; i++) {
+						types_match = cache->argument_types[i] != Variant::NIL && arguments[i]->get_type() == cache->argument_types[i];
+					}
+					if (types_match) {
+						VariantInternal::initialize(dst, cache->return_type);
+						cache->builtin_method(const_cast<Variant *>(base), arguments, argc, dst);
+						break;
+					}
+				} else {
+					// Native methods are called directly, unless a script may override them.
+					Object *obj = base->get_validated_object();
+					if (obj && !obj->get_script_instance()) {
+						const StringName &class_name = obj->get_class_name();
+						if (!cache || cache->types[0] != Variant::OBJECT || cache->method_bind_class != class_name) {
+							InstructionCache *new_cache = _create_cache(cache);
+							if (new_cache) {
+								new_cache->types[0] = Variant::OBJECT;
+								new_cache->method_bind_class = class_name;
+								new_cache->method_bind = ClassDB::get_method(class_name, instruction.name);
+								_publish_cache(instruction, new_cache);
+							}
+							cache = new_cache;
+						}
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(call->arguments.size());
-			argp.resize(call->arguments.size());
+						MethodBind *method = cache ? cache->method_bind : nullptr;
+						if (method && (!p_const_calls_only || method->is_const())) {
+							*dst = method->call(obj, arguments, argc, ce);
+							if (ce.error != Callable::CallError::CALL_OK) {
+								r_error_str = vformat(RTR("On call to '%s':"), String(instruction.name));
+								return true;
+							}
+							break;
+						}
+					}
+				}
 
-			for (int i = 0; i < call->arguments.size(); i++) {
-				Variant value;
-				ret = _execute(p_inputs, p_instance, call->arguments[i], value, p_const_calls_only, r_error_str);
+				Variant base_copy = *base;
+				*dst = Variant();
+				if (p_const_calls_only) {
+					base_copy.call_const(instruction.name, arguments, argc, *dst, ce);
+				} else {
+					base_copy.callp(instruction.name, arguments, argc, *dst, ce);
+				}
 
-				if (ret) {
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("On call to '%s':"), String(instruction.name));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
-
-			Callable::CallError ce;
-			if (p_const_calls_only) {
-				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			} else {
-				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			}
+			} break;
+		}
+	}
 
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("On call to '%s':"), String(call->method));
-				return true;
-			}
+#undef GET_OPERAND
 
-		} break;
+	const Variant *result = get_operand(result_operand);
+	if (unlikely(!result)) {
+		return true;
 	}
+	r_ret = *result;
+
 	return false;
 }
 
@@ -1473,12 +1659,16 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 		nodes = nullptr;
 		root = nullptr;
 	}
+	_clear_program();
 
 	error_str = String();
 	error_set = false;
 	str_ofs = 0;
 	input_names = p_input_names;
 
+	bound_inputs.clear();
+	bound_inputs.resize(input_names.size());
+
 	expression = p_expression;
 	root = _parse_expression();
 
@@ -1491,16 +1681,36 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 		return ERR_INVALID_PARAMETER;
 	}
 
+	// The tree is only needed to compile the program.
+	result_operand = _compile_node(root);
+	memdelete(nodes);
+	nodes = nullptr;
+	root = nullptr;
+
 	return OK;
 }
 
-Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_error, bool p_const_calls_only) {
+Variant Expression::_execute_inputs(const Variant *const *p_inputs, int p_input_count, Object *p_base, bool p_show_error, bool p_const_calls_only) {
 	ERR_FAIL_COND_V_MSG(error_set, Variant(), "There was previously a parse error: " + error_str + ".");
 
+	// Registers live on the stack of each call, so other threads and nested calls (from a method called
+	// by the expression) never share them.
+	const uint32_t register_count = instructions.size();
+	Variant *registers = (Variant *)alloca(sizeof(Variant) * MAX(register_count, 1u));
+	for (uint32_t i = 0; i < register_count; i++) {
+		memnew_placement(&registers[i], Variant);
+	}
+	const Variant **arguments = (const Variant **)alloca(sizeof(Variant *) * MAX(max_operand_count, 1u));
+
 	execution_error = false;
 	Variant output;
 	String error_txt;
-	bool err = _execute(p_inputs, p_base, root, output, p_const_calls_only, error_txt);
+	bool err = _execute(registers, arguments, p_inputs, p_input_count, p_base, output, p_const_calls_only, error_txt);
+
+	for (uint32_t i = 0; i < register_count; i++) {
+		registers[i].~Variant();
+	}
+
 	if (err) {
 		execution_error = true;
 		error_str = error_txt;
@@ -1510,6 +1720,28 @@ Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_e
 	return output;
 }
 
+Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_error, bool p_const_calls_only) {
+	// The pointers are only used during this call, while the array is alive.
+	const Variant **inputs = (const Variant **)alloca(sizeof(Variant *) * MAX(p_inputs.size(), 1));
+	for (int i = 0; i < p_inputs.size(); i++) {
+		inputs[i] = &p_inputs[i];
+	}
+	return _execute_inputs(inputs, p_inputs.size(), p_base, p_show_error, p_const_calls_only);
+}
+
+void Expression::set_input_value(int p_index, const Variant &p_value) {
+	ERR_FAIL_INDEX(p_index, (int)bound_inputs.size());
+	bound_inputs[p_index] = p_value;
+}
+
+Variant Expression::execute_bound(Object *p_base, bool p_show_error, bool p_const_calls_only) {
+	const Variant **inputs = (const Variant **)alloca(sizeof(Variant *) * MAX(bound_inputs.size(), 1u));
+	for (uint32_t i = 0; i < bound_inputs.size(); i++) {
+		inputs[i] = &bound_inputs[i];
+	}
+	return _execute_inputs(inputs, bound_inputs.size(), p_base, p_show_error, p_const_calls_only);
+}
+
 bool Expression::has_execute_failed() const {
 	return execution_error;
 }
@@ -1521,6 +1753,8 @@ String Expression::get_error_text() const {
 void Expression::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("parse", "expression", "input_names"), &Expression::parse, DEFVAL(Vector<String>()));
 	ClassDB::bind_method(D_METHOD("execute", "inputs", "base_instance", "show_error", "const_calls_only"), &Expression::execute, DEFVAL(Array()), DEFVAL(Variant()), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("set_input_value", "index", "value"), &Expression::set_input_value);
+	ClassDB::bind_method(D_METHOD("execute_bound", "base_instance", "show_error", "const_calls_only"), &Expression::execute_bound, DEFVAL(Variant()), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("has_execute_failed"), &Expression::has_execute_failed);
 	ClassDB::bind_method(D_METHOD("get_error_text"), &Expression::get_error_text);
 }
@@ -1529,4 +1763,5 @@ Expression::~Expression() {
 	if (nodes) {
 		memdelete(nodes);
 	}
+	_clear_program();
 }
@@ -32,6 +32,10 @@
 #define EXPRESSION_H
 
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+
+class MethodBind;
 
 class Expression : public RefCounted {
 	GDCLASS(Expression, RefCounted);
@@ -254,10 +258,104 @@ private:
 	ENode *root = nullptr;
 	ENode *nodes = nullptr;
 
+	// The parsed tree is compiled into a flat program. Every instruction writes a register of its own,
+	// operands address registers, constants, inputs or self directly, so leaves cost nothing at run time.
+	// Registers belong to each call, so the same expression can run on several threads at once.
+	// Instructions cache the operator evaluator, getter or method resolved for the operand types last
+	// seen, and use it while the types stay the same.
+	enum OperandType {
+		OPERAND_REGISTER,
+		OPERAND_CONSTANT,
+		OPERAND_INPUT,
+		OPERAND_SELF,
+	};
+
+	enum {
+		OPERAND_TYPE_SHIFT = 30,
+		OPERAND_INDEX_MASK = (1 << OPERAND_TYPE_SHIFT) - 1,
+	};
+
+	// Caches are immutable once published, so calls on other threads can keep using the one they read.
+	// Replaced caches are only freed with the program, and an instruction stops caching after
+	// `MAX_CACHE_GENERATIONS` replacements, so types changing all the time don't grow the list forever.
+	struct InstructionCache {
+		Variant::Type types[2] = { Variant::VARIANT_MAX, Variant::VARIANT_MAX };
+		Variant::Type return_type = Variant::NIL;
+		Variant::ValidatedOperatorEvaluator operator_evaluator = nullptr;
+		Variant::ValidatedGetter getter = nullptr;
+		Variant::ValidatedBuiltInMethod builtin_method = nullptr;
+		LocalVector<Variant::Type> argument_types; // Of the builtin method.
+		MethodBind *method_bind = nullptr;
+		StringName method_bind_class;
+		uint32_t generation = 0;
+	};
+
+	enum {
+		MAX_CACHE_GENERATIONS = 8,
+	};
+
+	// Instructions are only copied while compiling, before any call can publish a cache.
+	struct CacheSlot {
+		mutable std::atomic<const InstructionCache *> cache = { nullptr };
+
+		_FORCE_INLINE_ const InstructionCache *get() const { return cache.load(std::memory_order_acquire); }
+
+		CacheSlot() {}
+		CacheSlot(const CacheSlot &p_other) :
+				cache(p_other.cache.load(std::memory_order_relaxed)) {}
+	};
+
+	struct Instruction {
+		enum Opcode {
+			OPCODE_OPERATOR,
+			OPCODE_INDEX,
+			OPCODE_NAMED_INDEX,
+			OPCODE_ARRAY,
+			OPCODE_DICTIONARY,
+			OPCODE_CONSTRUCT,
+			OPCODE_CALL_UTILITY,
+			OPCODE_CALL,
+		};
+
+		Opcode opcode = OPCODE_OPERATOR;
+		uint32_t first_operand = 0; // Into `operands`, for calls the base comes first.
+		uint32_t operand_count = 0;
+		uint32_t first_argument_type = 0; // Into `argument_types`, for utility functions.
+
+		Variant::Operator op = Variant::OP_ADD;
+		Variant::Type type = Variant::NIL; // Constructed type.
+		StringName name; // Named index, function or method.
+
+		// Utility functions are resolved at compile time.
+		Variant::ValidatedUtilityFunction utility_function = nullptr;
+		Variant::Type utility_return_type = Variant::NIL;
+
+		CacheSlot cache;
+	};
+
+	LocalVector<Instruction> instructions;
+	LocalVector<uint32_t> operands;
+	LocalVector<Variant::Type> argument_types; // Of utility functions, VARIANT_MAX when not validated.
+	LocalVector<Variant> constants;
+	uint32_t result_operand = 0;
+	uint32_t max_operand_count = 0;
+
+	BinaryMutex caches_mutex;
+	LocalVector<InstructionCache *> caches;
+
+	LocalVector<Variant> bound_inputs;
+
+	uint32_t _compile_node(ENode *p_node);
+	uint32_t _add_instruction(Instruction::Opcode p_opcode, const LocalVector<uint32_t> &p_operands);
+	void _clear_program();
+	InstructionCache *_create_cache(const InstructionCache *p_previous) const;
+	void _publish_cache(const Instruction &p_instruction, InstructionCache *p_cache);
+
 	Vector<String> input_names;
 
 	bool execution_error = false;
-	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
+	bool _execute(Variant *p_registers, const Variant **p_arguments, const Variant *const *p_inputs, int p_input_count, Object *p_instance, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
+	Variant _execute_inputs(const Variant *const *p_inputs, int p_input_count, Object *p_base, bool p_show_error, bool p_const_calls_only);
 
 protected:
 	static void _bind_methods();
@@ -265,6 +363,8 @@ protected:
 public:
 	Error parse(const String &p_expression, const Vector<String> &p_input_names = Vector<String>());
 	Variant execute(const Array &p_inputs = Array(), Object *p_base = nullptr, bool p_show_error = true, bool p_const_calls_only = false);
+	void set_input_value(int p_index, const Variant &p_value);
+	Variant execute_bound(Object *p_base = nullptr, bool p_show_error = true, bool p_const_calls_only = false);
 	bool has_execute_failed() const;
 	String get_error_text() const;
 
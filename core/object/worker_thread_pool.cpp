@@ -33,6 +33,7 @@
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/frame_arena.h"
 
 WorkerThreadPool::Task *const WorkerThreadPool::ThreadData::YIELDING = (Task *)1;
 
@@ -49,6 +50,232 @@ WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 thread_local uintptr_t WorkerThreadPool::unlockable_mutexes[MAX_UNLOCKABLE_MUTEXES] = {};
 #endif
 
+bool WorkerThreadPool::WorkQueue::push(Task *p_task) {
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	if (b - t >= (int64_t)SIZE) {
+		return false;
+	}
+	buffer[b & MASK].store(p_task, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+	return true;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::WorkQueue::pop() {
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	Task *task = nullptr;
+	if (t <= b) {
+		task = buffer[b & MASK].load(std::memory_order_relaxed);
+		if (t == b) {
+			// Last one; race against thieves for it.
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				task = nullptr;
+			}
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+	} else {
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::WorkQueue::steal(bool &r_retry) {
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+	if (t >= b) {
+		return nullptr;
+	}
+	Task *task = buffer[t & MASK].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		// Lost the race against the owner or another thief. There may be more.
+		r_retry = true;
+		return nullptr;
+	}
+	return task;
+}
+
+void WorkerThreadPool::_set_current_task(ThreadData &p_thread_data, Task *p_task) {
+	p_thread_data.current_task = p_task;
+	p_thread_data.has_task.set_to(p_task != nullptr);
+	p_thread_data.has_low_priority_task.set_to(p_task && p_task->low_priority);
+}
+
+WorkerThreadPool::ThreadData *WorkerThreadPool::_get_caller_pool_thread() {
+	// thread_ids is immutable while the threads are running, so no lock is needed.
+	const int *indexp = thread_ids.getptr(Thread::get_caller_id());
+	return indexp ? &threads[*indexp] : nullptr;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_steal_task(const ThreadData *p_thief) {
+	uint32_t thread_count = threads.size();
+	bool retry = true;
+	while (retry) {
+		retry = false;
+		// Start at the neighbor, so thieves don't all go for the same victim.
+		for (uint32_t i = 1; i < thread_count; i++) {
+			Task *task = threads[(p_thief->index + i) % thread_count].work_queue.steal(retry);
+			if (task) {
+				return task;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void WorkerThreadPool::_process_group_elements(Group *p_group) {
+	bool do_post = false;
+
+	while (true) {
+		uint32_t work_index = p_group->index.postincrement();
+
+		if (work_index >= p_group->max) {
+			break;
+		}
+		if (p_group->native_func) {
+			p_group->native_func(p_group->native_func_userdata, work_index);
+		} else if (p_group->template_userdata) {
+			p_group->template_userdata->callback_indexed(work_index);
+		} else {
+			p_group->callable.call(work_index);
+		}
+
+		// This is the only way to ensure posting is done when all tasks are really complete.
+		uint32_t completed_amount = p_group->completed_index.increment();
+
+		if (completed_amount == p_group->max) {
+			do_post = true;
+		}
+	}
+
+	if (do_post) {
+		if (p_group->template_userdata) {
+			memdelete(p_group->template_userdata); // This is no longer needed at this point, so get rid of it.
+			p_group->template_userdata = nullptr;
+		}
+		_complete_group(p_group);
+	}
+}
+
+void WorkerThreadPool::_complete_group(Group *p_group) {
+	LocalVector<Continuation *> ready;
+	{
+		// Flagged under the lock, so continuations are either registered before this or not at all.
+		MutexLock lock(task_mutex);
+		p_group->completed.set_to(true);
+
+		// Let pool threads waiting for the group collaboratively know.
+		for (uint32_t i = 0; i < threads.size(); i++) {
+			if (threads[i].awaited_group == p_group) {
+				threads[i].cond_var.notify_one();
+				threads[i].signaled = true;
+			}
+		}
+
+		for (Continuation *continuation : p_group->continuations) {
+			if (continuation->dependencies_left.decrement() == 0) {
+				ready.push_back(continuation);
+			}
+		}
+		p_group->continuations.clear();
+	}
+
+	// Last, since a user thread waiting may free the group from now on.
+	p_group->done_semaphore.post();
+
+	for (Continuation *continuation : ready) {
+		_post_continuation(continuation);
+	}
+}
+
+void WorkerThreadPool::_post_continuation(Continuation *p_continuation) {
+	if (p_continuation->group) {
+		p_continuation->group->pending_dependencies.clear();
+		if (p_continuation->group->max == 0) {
+			// Nothing to run, but it still must not complete before its dependencies.
+			// The continuation was counted as a user of the group, like a task would.
+			Group *group = p_continuation->group;
+			uint32_t max_users = group->tasks_used + 1;
+			_complete_group(group);
+			if (group->finished.increment() == max_users) {
+				group_allocator.free(group);
+			}
+		}
+	}
+	_post_tasks(p_continuation->tasks.ptr(), p_continuation->tasks.size(), p_continuation->high_priority);
+	memdelete(p_continuation);
+}
+
+void WorkerThreadPool::_post_tasks_after(TaskID p_id, Task **p_tasks, uint32_t p_count, Group *p_group, bool p_high_priority, const Vector<TaskID> &p_dependencies) {
+	if (p_dependencies.is_empty()) {
+		_post_tasks(p_tasks, p_count, p_high_priority);
+		return;
+	}
+
+	if (timeline_capture_enabled.is_set()) {
+		MutexLock lock(timeline_mutex);
+		timeline_dependencies[p_id] = p_dependencies;
+	}
+
+	Continuation *continuation = memnew(Continuation);
+	continuation->tasks.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		continuation->tasks[i] = p_tasks[i];
+	}
+	continuation->group = p_group;
+	continuation->high_priority = p_high_priority;
+	// The extra one keeps the continuation from being posted while dependencies are still being registered.
+	continuation->dependencies_left.set(p_dependencies.size() + 1);
+
+	for (const TaskID &dependency : p_dependencies) {
+		bool registered = false;
+		{
+			// Taking groups_mutex first keeps the group from being erased meanwhile.
+			MutexLock groups_lock(groups_mutex);
+			MutexLock lock(task_mutex);
+			Group **groupp = groups.getptr(dependency);
+			Task **taskp = groupp ? nullptr : tasks.getptr(dependency);
+			if (groupp) {
+				if (!(*groupp)->completed.is_set()) {
+					(*groupp)->continuations.push_back(continuation);
+					registered = true;
+				}
+			} else if (taskp) {
+				if (!(*taskp)->completed) {
+					(*taskp)->continuations.push_back(continuation);
+					registered = true;
+				}
+			} else {
+				ERR_PRINT(vformat("Invalid dependency Task or Group ID: %d.", dependency));
+			}
+		}
+		if (!registered) {
+			continuation->dependencies_left.decrement();
+		}
+	}
+
+	if (continuation->dependencies_left.decrement() == 0) {
+		_post_continuation(continuation);
+	}
+}
+
+void WorkerThreadPool::_add_timeline_entry(TaskID p_id, const String &p_description, uint64_t p_begin_usec) {
+	TimelineEntry entry;
+	entry.id = p_id;
+	entry.description = p_description;
+	entry.thread_index = get_thread_index();
+	entry.begin_usec = p_begin_usec;
+	entry.end_usec = OS::get_singleton()->get_ticks_usec();
+
+	MutexLock lock(timeline_mutex);
+	timeline.push_back(entry);
+}
+
 void WorkerThreadPool::_process_task(Task *p_task) {
 #ifdef THREADS_ENABLED
 	int pool_thread_index = thread_ids[Thread::get_caller_id()];
@@ -66,74 +293,54 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		// its pre-created threads can't have ScriptServer::thread_enter() called on them early.
 		// Therefore, we do it late at the first opportunity, so in case the task
 		// about to be run uses scripting, guarantees are held.
-		task_mutex.lock();
 		if (!curr_thread.ready_for_scripting && ScriptServer::are_languages_initialized()) {
-			task_mutex.unlock();
 			ScriptServer::thread_enter();
-			task_mutex.lock();
 			curr_thread.ready_for_scripting = true;
 		}
-		p_task->pool_thread_index = pool_thread_index;
 		prev_task = curr_thread.current_task;
-		curr_thread.current_task = p_task;
-		if (p_task->pending_notify_yield_over) {
-			curr_thread.yield_is_over = true;
+		if (p_task->group) {
+			// Group tasks have no ID, so nobody else can look them up; no need to lock.
+			_set_current_task(curr_thread, p_task);
+		} else {
+			task_mutex.lock();
+			p_task->pool_thread_index = pool_thread_index;
+			_set_current_task(curr_thread, p_task);
+			if (p_task->pending_notify_yield_over) {
+				curr_thread.yield_is_over = true;
+			}
+			task_mutex.unlock();
 		}
-		task_mutex.unlock();
 	}
 #endif
 
 #ifdef THREADS_ENABLED
 	bool low_priority = p_task->low_priority;
 #endif
+	bool locked = false;
+	bool capture_timeline = timeline_capture_enabled.is_set();
+	uint64_t timeline_begin_usec = capture_timeline ? OS::get_singleton()->get_ticks_usec() : 0;
+	LocalVector<Continuation *> ready_continuations;
+	// Tasks can span several frames, so their temporary memory is released when they finish instead.
+	FrameArena::Scope frame_arena_scope;
 
 	if (p_task->group) {
 		// Handling a group
-		bool do_post = false;
-
-		while (true) {
-			uint32_t work_index = p_task->group->index.postincrement();
-
-			if (work_index >= p_task->group->max) {
-				break;
-			}
-			if (p_task->native_group_func) {
-				p_task->native_group_func(p_task->native_func_userdata, work_index);
-			} else if (p_task->template_userdata) {
-				p_task->template_userdata->callback_indexed(work_index);
-			} else {
-				p_task->callable.call(work_index);
-			}
+		Group *group = p_task->group;
+		_process_group_elements(group);
 
-			// This is the only way to ensure posting is done when all tasks are really complete.
-			uint32_t completed_amount = p_task->group->completed_index.increment();
-
-			if (completed_amount == p_task->group->max) {
-				do_post = true;
-			}
+		if (capture_timeline) {
+			_add_timeline_entry(group->self, p_task->description, timeline_begin_usec);
 		}
 
-		if (do_post && p_task->template_userdata) {
-			memdelete(p_task->template_userdata); // This is no longer needed at this point, so get rid of it.
-		}
-
-		if (do_post) {
-			p_task->group->done_semaphore.post();
-			p_task->group->completed.set_to(true);
-		}
-		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
-		uint32_t finished_users = p_task->group->finished.increment();
+		uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
+		uint32_t finished_users = group->finished.increment();
 
 		if (finished_users == max_users) {
 			// Get rid of the group, because nobody else is using it.
-			task_mutex.lock();
-			group_allocator.free(p_task->group);
-			task_mutex.unlock();
+			group_allocator.free(group);
 		}
 
 		// For groups, tasks get rid of themselves.
-
-		task_mutex.lock();
 		task_allocator.free(p_task);
 	} else {
 		if (p_task->native_func) {
@@ -145,7 +352,12 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			p_task->callable.call();
 		}
 
+		if (capture_timeline) {
+			_add_timeline_entry(p_task->self, p_task->description, timeline_begin_usec);
+		}
+
 		task_mutex.lock();
+		locked = true;
 		p_task->completed = true;
 		p_task->pool_thread_index = -1;
 		if (p_task->waiting_user) {
@@ -158,12 +370,23 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 				threads[i].signaled = true;
 			}
 		}
+		// Dependents are posted once task_mutex is unlocked.
+		for (Continuation *continuation : p_task->continuations) {
+			if (continuation->dependencies_left.decrement() == 0) {
+				ready_continuations.push_back(continuation);
+			}
+		}
+		p_task->continuations.clear();
 	}
 
 #ifdef THREADS_ENABLED
 	{
-		curr_thread.current_task = prev_task;
+		_set_current_task(curr_thread, prev_task);
 		if (low_priority) {
+			if (!locked) {
+				task_mutex.lock();
+				locked = true;
+			}
 			low_priority_threads_used--;
 
 			if (_try_promote_low_priority_task()) {
@@ -172,10 +395,18 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 				}
 			}
 		}
+	}
+#endif
 
+	if (locked) {
 		task_mutex.unlock();
 	}
 
+	for (Continuation *continuation : ready_continuations) {
+		_post_continuation(continuation);
+	}
+
+#ifdef THREADS_ENABLED
 	set_current_thread_safe_for_nodes(safe_for_nodes_backup);
 	MessageQueue::set_thread_singleton_override(call_queue_backup);
 #endif
@@ -184,8 +415,13 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
+		// Own work first, then work from other pool threads; neither needs the lock.
+		Task *task_to_process = thread_data->work_queue.pop();
+		if (!task_to_process) {
+			task_to_process = singleton->_steal_task(thread_data);
+		}
+
+		if (!task_to_process) {
 			MutexLock lock(singleton->task_mutex);
 			if (singleton->exit_threads) {
 				return;
@@ -196,8 +432,16 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 				task_to_process = singleton->task_queue.first()->self();
 				singleton->task_queue.remove(singleton->task_queue.first());
 			} else {
-				thread_data->cond_var.wait(lock);
-				DEV_ASSERT(singleton->exit_threads || thread_data->signaled);
+				// Announce the intent to sleep before checking the work queues one last time.
+				// Pairs with the fence in _post_tasks(), so either we see the task or the poster sees us.
+				singleton->sleeping_threads.increment();
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				task_to_process = singleton->_steal_task(thread_data);
+				if (!task_to_process) {
+					thread_data->cond_var.wait(lock);
+					DEV_ASSERT(singleton->exit_threads || thread_data->signaled);
+				}
+				singleton->sleeping_threads.decrement();
 			}
 		}
 
@@ -207,24 +451,53 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 	}
 }
 
-void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority) {
+void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority) {
 	// Fall back to processing on the calling thread if there are no worker threads.
 	// Separated into its own variable to make it easier to extend this logic
 	// in custom builds.
 	bool process_on_calling_thread = threads.size() == 0;
 	if (process_on_calling_thread) {
-		task_mutex.unlock();
 		for (uint32_t i = 0; i < p_count; i++) {
 			_process_task(p_tasks[i]);
 		}
 		return;
 	}
 
+	ThreadData *caller_pool_thread = _get_caller_pool_thread();
+
+	if (caller_pool_thread && p_high_priority) {
+		// Pool threads keep high priority work in their own queue, where it's picked
+		// without locking, either by themselves or by idle threads stealing it.
+		uint32_t pushed = 0;
+		while (pushed < p_count) {
+			p_tasks[pushed]->low_priority = false;
+			if (!caller_pool_thread->work_queue.push(p_tasks[pushed])) {
+				break;
+			}
+			pushed++;
+		}
+
+		if (pushed) {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (sleeping_threads.get()) {
+				MutexLock lock(task_mutex);
+				_notify_threads(caller_pool_thread, pushed, 0);
+			}
+		}
+
+		if (pushed == p_count) {
+			return;
+		}
+		// The queue is full; the rest go to the shared one.
+		p_tasks += pushed;
+		p_count -= pushed;
+	}
+
+	MutexLock lock(task_mutex);
+
 	uint32_t to_process = 0;
 	uint32_t to_promote = 0;
 
-	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
-
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
 		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
@@ -241,8 +514,6 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 	}
 
 	_notify_threads(caller_pool_thread, to_process, to_promote);
-
-	task_mutex.unlock();
 }
 
 void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count) {
@@ -269,9 +540,9 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 		if (th.signaled) {
 			continue;
 		}
-		if (th.current_task) {
+		if (th.has_task.is_set()) {
 			// Good thread for promoting low-prio?
-			if (to_promote && th.awaited_task && th.current_task->low_priority) {
+			if (to_promote && th.awaited_task && th.has_low_priority_task.is_set()) {
 				if (likely(&th != p_current_thread_data)) {
 					th.cond_var.notify_one();
 				}
@@ -299,7 +570,7 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 		if (th.signaled) {
 			continue;
 		}
-		if (th.awaited_task) {
+		if (th.awaited_task || th.awaited_group) {
 			if (likely(&th != p_current_thread_data)) {
 				th.cond_var.notify_one();
 			}
@@ -325,20 +596,22 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
-	task_mutex.lock();
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
 	// Get a free task
 	Task *task = task_allocator.alloc();
-	TaskID id = last_task++;
+	TaskID id = last_task.postincrement();
 	task->self = id;
 	task->callable = p_callable;
 	task->native_func = p_func;
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
 	task->template_userdata = p_template_userdata;
+
+	task_mutex.lock();
 	tasks.insert(id, task);
+	task_mutex.unlock();
 
-	_post_tasks_and_unlock(&task, 1, p_high_priority);
+	_post_tasks_after(id, &task, 1, nullptr, p_high_priority, p_dependencies);
 
 	return id;
 }
@@ -347,6 +620,14 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bo
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
 
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_dependent_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_dependent_task(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	task_mutex.lock();
 	const Task *const *taskp = tasks.getptr(p_task_id);
@@ -379,7 +660,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 		return OK;
 	}
 
-	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
+	ThreadData *caller_pool_thread = _get_caller_pool_thread();
 	if (caller_pool_thread && p_task_id <= caller_pool_thread->current_task->self) {
 		// Deadlock prevention:
 		// When a pool thread wants to wait for an older task, the following situations can happen:
@@ -454,10 +735,10 @@ void WorkerThreadPool::_unlock_unlockable_mutexes() {
 #endif
 }
 
-void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task) {
+void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task, Group *p_group) {
 	// Keep processing tasks until the condition to stop waiting is met.
 
-#define IS_WAIT_OVER (unlikely(p_task == ThreadData::YIELDING) ? p_caller_pool_thread->yield_is_over : p_task->completed)
+#define IS_WAIT_OVER (p_group ? p_group->completed.is_set() : (unlikely(p_task == ThreadData::YIELDING) ? p_caller_pool_thread->yield_is_over : p_task->completed))
 
 	while (true) {
 		Task *task_to_process = nullptr;
@@ -491,20 +772,33 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 					}
 				}
 
-				if (singleton->task_queue.first()) {
+				// Nested work posted by this thread goes first, then shared work, then other threads' work.
+				task_to_process = p_caller_pool_thread->work_queue.pop();
+
+				if (!task_to_process && task_queue.first()) {
 					task_to_process = task_queue.first()->self();
 					task_queue.remove(task_queue.first());
 				}
 
 				if (!task_to_process) {
-					p_caller_pool_thread->awaited_task = p_task;
-
-					_unlock_unlockable_mutexes();
-					relock_unlockables = true;
-					p_caller_pool_thread->cond_var.wait(lock);
-
-					DEV_ASSERT(exit_threads || p_caller_pool_thread->signaled || IS_WAIT_OVER);
-					p_caller_pool_thread->awaited_task = nullptr;
+					// See _thread_function() about the ordering.
+					sleeping_threads.increment();
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					task_to_process = _steal_task(p_caller_pool_thread);
+
+					if (!task_to_process) {
+						p_caller_pool_thread->awaited_task = p_task;
+						p_caller_pool_thread->awaited_group = p_group;
+
+						_unlock_unlockable_mutexes();
+						relock_unlockables = true;
+						p_caller_pool_thread->cond_var.wait(lock);
+
+						DEV_ASSERT(exit_threads || p_caller_pool_thread->signaled || IS_WAIT_OVER);
+						p_caller_pool_thread->awaited_task = nullptr;
+						p_caller_pool_thread->awaited_group = nullptr;
+					}
+					sleeping_threads.decrement();
 				}
 			}
 		}
@@ -550,24 +844,29 @@ void WorkerThreadPool::notify_yield_over(TaskID p_task_id) {
 	task_mutex.unlock();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
 	}
 
-	task_mutex.lock();
 	Group *group = group_allocator.alloc();
-	GroupID id = last_task++;
+	GroupID id = last_task.postincrement();
 	group->max = p_elements;
 	group->self = id;
+	group->description = p_description;
+	group->pending_dependencies.set_to(!p_dependencies.is_empty());
 
 	Task **tasks_posted = nullptr;
 	if (p_elements == 0) {
 		// Should really not call it with zero Elements, but at least it should work.
-		group->completed.set_to(true);
-		group->done_semaphore.post();
-		group->tasks_used = 0;
+		if (p_dependencies.is_empty()) {
+			group->completed.set_to(true);
+			group->done_semaphore.post();
+			group->tasks_used = 0;
+		} else {
+			group->tasks_used = 1; // Completed by the continuation, see _post_continuation().
+		}
 		p_tasks = 0;
 		if (p_template_userdata) {
 			memdelete(p_template_userdata);
@@ -575,23 +874,25 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 
 	} else {
 		group->tasks_used = p_tasks;
+		group->callable = p_callable;
+		group->native_func = p_func;
+		group->native_func_userdata = p_userdata;
+		group->template_userdata = p_template_userdata;
 		tasks_posted = (Task **)alloca(sizeof(Task *) * p_tasks);
 		for (int i = 0; i < p_tasks; i++) {
 			Task *task = task_allocator.alloc();
-			task->native_group_func = p_func;
-			task->native_func_userdata = p_userdata;
 			task->description = p_description;
 			task->group = group;
-			task->callable = p_callable;
-			task->template_userdata = p_template_userdata;
 			tasks_posted[i] = task;
 			// No task ID is used.
 		}
 	}
 
+	groups_mutex.lock();
 	groups[id] = group;
+	groups_mutex.unlock();
 
-	_post_tasks_and_unlock(tasks_posted, p_tasks, p_high_priority);
+	_post_tasks_after(id, tasks_posted, p_tasks, group, p_high_priority, p_dependencies);
 
 	return id;
 }
@@ -604,62 +905,130 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_dependent_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_dependent_group_task(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
-	task_mutex.lock();
+	groups_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
 	if (!groupp) {
-		task_mutex.unlock();
+		groups_mutex.unlock();
 		ERR_FAIL_V_MSG(0, "Invalid Group ID");
 	}
 	uint32_t elements = (*groupp)->completed_index.get();
-	task_mutex.unlock();
+	groups_mutex.unlock();
 	return elements;
 }
 bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
-	task_mutex.lock();
+	groups_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
 	if (!groupp) {
-		task_mutex.unlock();
+		groups_mutex.unlock();
 		ERR_FAIL_V_MSG(false, "Invalid Group ID");
 	}
 	bool completed = (*groupp)->completed.is_set();
-	task_mutex.unlock();
+	groups_mutex.unlock();
 	return completed;
 }
 
 void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 #ifdef THREADS_ENABLED
-	task_mutex.lock();
+	groups_mutex.lock();
 	Group **groupp = groups.getptr(p_group);
-	task_mutex.unlock();
-	if (!groupp) {
+	Group *group = groupp ? *groupp : nullptr;
+	groups_mutex.unlock();
+	if (!group) {
 		ERR_FAIL_MSG("Invalid Group ID.");
 	}
 
 	{
-		Group *group = *groupp;
+		ThreadData *caller_pool_thread = _get_caller_pool_thread();
+		if (caller_pool_thread) {
+			// Rather than blocking a pool thread, help with the elements nobody has taken yet,
+			// then keep processing other work until the tasks still running the last ones finish.
+			if (!group->pending_dependencies.is_set()) {
+				if (timeline_capture_enabled.is_set()) {
+					uint64_t timeline_begin_usec = OS::get_singleton()->get_ticks_usec();
+					_process_group_elements(group);
+					_add_timeline_entry(group->self, group->description, timeline_begin_usec);
+				} else {
+					_process_group_elements(group);
+				}
+			}
+			_wait_collaboratively(caller_pool_thread, nullptr, group);
+		} else {
+			_unlock_unlockable_mutexes();
+			group->done_semaphore.wait();
+			_lock_unlockable_mutexes();
+		}
 
-		_unlock_unlockable_mutexes();
-		group->done_semaphore.wait();
-		_lock_unlockable_mutexes();
+		// Unregister the group before it may be freed, so no lookup can return a dangling pointer.
+		groups_mutex.lock(); // This mutex is needed when Physics 2D and/or 3D is selected to run on a separate thread.
+		groups.erase(p_group);
+		groups_mutex.unlock();
 
 		uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = group->finished.increment(); // fetch happens before inc, so increment later.
 
 		if (finished_users == max_users) {
 			// All tasks using this group are gone (finished before the group), so clear the group too.
-			task_mutex.lock();
 			group_allocator.free(group);
-			task_mutex.unlock();
 		}
 	}
-
-	task_mutex.lock(); // This mutex is needed when Physics 2D and/or 3D is selected to run on a separate thread.
-	groups.erase(p_group);
-	task_mutex.unlock();
 #endif
 }
 
+void WorkerThreadPool::set_task_timeline_capture_enabled(bool p_enabled) {
+	MutexLock lock(timeline_mutex);
+	if (p_enabled && !timeline_capture_enabled.is_set()) {
+		timeline.clear();
+		timeline_dependencies.clear();
+	}
+	timeline_capture_enabled.set_to(p_enabled);
+}
+
+bool WorkerThreadPool::is_task_timeline_capture_enabled() const {
+	return timeline_capture_enabled.is_set();
+}
+
+Array WorkerThreadPool::get_task_timeline() const {
+	MutexLock lock(timeline_mutex);
+	return _get_task_timeline();
+}
+
+Array WorkerThreadPool::take_task_timeline() {
+	MutexLock lock(timeline_mutex);
+	Array ret = _get_task_timeline();
+	for (const TimelineEntry &entry : timeline) {
+		timeline_dependencies.erase(entry.id);
+	}
+	timeline.clear();
+	return ret;
+}
+
+Array WorkerThreadPool::_get_task_timeline() const {
+	Array ret;
+	ret.resize(timeline.size());
+	for (uint32_t i = 0; i < timeline.size(); i++) {
+		const TimelineEntry &entry = timeline[i];
+		Dictionary d;
+		d["id"] = entry.id;
+		d["description"] = entry.description;
+		d["thread"] = entry.thread_index;
+		d["begin_usec"] = entry.begin_usec;
+		d["end_usec"] = entry.end_usec;
+		const Vector<TaskID> *dependencies = timeline_dependencies.getptr(entry.id);
+		d["dependencies"] = dependencies ? *dependencies : Vector<TaskID>();
+		ret[i] = d;
+	}
+	return ret;
+}
+
 int WorkerThreadPool::get_thread_index() {
 	Thread::ID tid = Thread::get_caller_id();
 	return singleton->thread_ids.has(tid) ? singleton->thread_ids[tid] : -1;
@@ -761,6 +1130,13 @@ void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
 	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
 	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
+
+	ClassDB::bind_method(D_METHOD("add_dependent_task", "action", "dependencies", "high_priority", "description"), &WorkerThreadPool::add_dependent_task, DEFVAL(false), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("add_dependent_group_task", "action", "elements", "dependencies", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_dependent_group_task, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
+
+	ClassDB::bind_method(D_METHOD("set_task_timeline_capture_enabled", "enabled"), &WorkerThreadPool::set_task_timeline_capture_enabled);
+	ClassDB::bind_method(D_METHOD("is_task_timeline_capture_enabled"), &WorkerThreadPool::is_task_timeline_capture_enabled);
+	ClassDB::bind_method(D_METHOD("get_task_timeline"), &WorkerThreadPool::get_task_timeline);
 }
 
 WorkerThreadPool::WorkerThreadPool() {
@@ -53,6 +53,7 @@ public:
 
 private:
 	struct Task;
+	struct Group;
 
 	struct BaseTemplateUserdata {
 		virtual void callback() {}
@@ -60,6 +61,14 @@ private:
 		virtual ~BaseTemplateUserdata() {}
 	};
 
+	// Tasks to post once all the tasks and groups they depend on are completed.
+	struct Continuation {
+		LocalVector<Task *> tasks;
+		Group *group = nullptr; // If the tasks belong to a group.
+		bool high_priority = false;
+		SafeNumeric<uint32_t> dependencies_left;
+	};
+
 	struct Group {
 		GroupID self = -1;
 		SafeNumeric<uint32_t> index;
@@ -69,13 +78,20 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		// Shared by every task of the group, and by pool threads helping while they wait for it.
+		Callable callable;
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		String description;
+		SafeFlag pending_dependencies; // Its tasks haven't been posted yet, so waiters must not help.
+		LocalVector<Continuation *> continuations; // Guarded by task_mutex.
 	};
 
 	struct Task {
 		TaskID self = -1;
 		Callable callable;
 		void (*native_func)(void *) = nullptr;
-		void (*native_group_func)(void *, uint32_t) = nullptr;
 		void *native_func_userdata = nullptr;
 		String description;
 		Semaphore done_semaphore; // For user threads awaiting.
@@ -88,6 +104,7 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
+		LocalVector<Continuation *> continuations; // Guarded by task_mutex.
 
 		void free_template_userdata();
 		Task() :
@@ -99,28 +116,51 @@ private:
 	static const uint32_t TASKS_PAGE_SIZE = 1024;
 	static const uint32_t GROUPS_PAGE_SIZE = 256;
 
-	PagedAllocator<Task, false, TASKS_PAGE_SIZE> task_allocator;
-	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
+	// Thread-safe, so group tasks can be created and disposed of without holding task_mutex.
+	PagedAllocator<Task, true, TASKS_PAGE_SIZE> task_allocator;
+	PagedAllocator<Group, true, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
 	SelfList<Task>::List task_queue;
 
 	BinaryMutex task_mutex;
+	BinaryMutex groups_mutex; // Only guards the groups map.
+
+	// Chase-Lev work-stealing deque of high priority tasks posted from a pool thread.
+	// Only the owner thread pushes and pops (LIFO, at the bottom), other pool threads
+	// steal from the top (FIFO). Capacity is fixed; when full, tasks go to the shared queue.
+	struct WorkQueue {
+		static const uint32_t SIZE = 512;
+		static const uint32_t MASK = SIZE - 1;
+
+		std::atomic<int64_t> top = { 0 };
+		std::atomic<int64_t> bottom = { 0 };
+		std::atomic<Task *> buffer[SIZE];
+
+		bool push(Task *p_task);
+		Task *pop();
+		Task *steal(bool &r_retry);
+	};
 
 	struct ThreadData {
 		static Task *const YIELDING; // Too bad constexpr doesn't work here.
 
 		uint32_t index = 0;
 		Thread thread;
-		bool ready_for_scripting : 1;
+		// Only accessed by the thread itself, so it's kept out of the bitfield the other threads write under the lock.
+		bool ready_for_scripting = false;
 		bool signaled : 1;
 		bool yield_is_over : 1;
-		Task *current_task = nullptr;
+		Task *current_task = nullptr; // Only accessed by the thread itself.
+		// Mirrors of current_task that other threads can read without locking, when picking who to notify.
+		SafeFlag has_task;
+		SafeFlag has_low_priority_task;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
+		Group *awaited_group = nullptr; // Null if not awaiting a group collaboratively.
 		ConditionVariable cond_var;
+		WorkQueue work_queue;
 
 		ThreadData() :
-				ready_for_scripting(false),
 				signaled(false),
 				yield_is_over(false) {}
 	};
@@ -147,14 +187,38 @@ private:
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
 	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
+	SafeNumeric<uint32_t> sleeping_threads; // Lets pool threads skip task_mutex after pushing to their work queue if nobody needs a wake-up.
 
-	uint64_t last_task = 1;
+	SafeNumeric<uint64_t> last_task{ 1 };
+
+	struct TimelineEntry {
+		TaskID id = INVALID_TASK_ID;
+		String description;
+		int thread_index = -1;
+		uint64_t begin_usec = 0;
+		uint64_t end_usec = 0;
+	};
+
+	SafeFlag timeline_capture_enabled;
+	BinaryMutex timeline_mutex;
+	LocalVector<TimelineEntry> timeline;
+	HashMap<TaskID, Vector<TaskID>> timeline_dependencies;
+
+	void _add_timeline_entry(TaskID p_id, const String &p_description, uint64_t p_begin_usec);
+	Array _get_task_timeline() const;
 
 	static void _thread_function(void *p_user);
 
 	void _process_task(Task *task);
-
-	void _post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority);
+	void _process_group_elements(Group *p_group);
+	void _set_current_task(ThreadData &p_thread_data, Task *p_task);
+	ThreadData *_get_caller_pool_thread();
+	Task *_steal_task(const ThreadData *p_thief);
+
+	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority);
+	void _post_tasks_after(TaskID p_id, Task **p_tasks, uint32_t p_count, Group *p_group, bool p_high_priority, const Vector<TaskID> &p_dependencies);
+	void _post_continuation(Continuation *p_continuation);
+	void _complete_group(Group *p_group);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
 	bool _try_promote_low_priority_task();
@@ -166,8 +230,8 @@ private:
 	static thread_local uintptr_t unlockable_mutexes[MAX_UNLOCKABLE_MUTEXES];
 #endif
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
 
 	template <typename C, typename M, typename U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -189,7 +253,7 @@ private:
 		}
 	};
 
-	void _wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task);
+	void _wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task, Group *p_group = nullptr);
 
 #ifdef THREADS_ENABLED
 	static uint32_t _thread_enter_unlock_allowance_zone(void *p_mutex, bool p_is_binary);
@@ -214,6 +278,20 @@ public:
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Dependent tasks and groups are only posted once all the tasks and groups in p_dependencies are completed,
+	// without any thread having to wait for them. Dependencies must not have been waited for yet.
+	template <typename C, typename M, typename U>
+	TaskID add_template_dependent_task(C *p_instance, M p_method, U p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description, p_dependencies);
+	}
+	TaskID add_native_dependent_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_dependent_task(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+
 	bool is_task_completed(TaskID p_task_id) const;
 	Error wait_for_task_completion(TaskID p_task_id);
 
@@ -231,12 +309,30 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	template <typename C, typename M, typename U>
+	GroupID add_template_dependent_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+	}
+	GroupID add_native_dependent_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_dependent_group_task(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
 
 	_FORCE_INLINE_ int get_thread_count() const { return threads.size(); }
 
+	// Records when and where every task and group runs, plus the dependencies between them.
+	void set_task_timeline_capture_enabled(bool p_enabled);
+	bool is_task_timeline_capture_enabled() const;
+	Array get_task_timeline() const;
+	// Like get_task_timeline(), but also discards the returned entries, for streaming them out while capturing.
+	Array take_task_timeline();
+
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	static int get_thread_index();
 
@@ -33,8 +33,13 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+#include "core/os/small_object_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,18 +70,63 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+// Allocation calls are counted in a slot of each thread, and only summed when read, so allocating doesn't
+// contend on a shared counter. Threads only share slots once there are more threads than slots.
+static constexpr uint32_t ALLOC_CALL_SLOT_COUNT = 64;
+
+struct alignas(64) AllocCallSlot {
+	std::atomic<uint64_t> count = { 0 };
+};
+
+static AllocCallSlot alloc_call_slots[ALLOC_CALL_SLOT_COUNT];
+static std::atomic<uint32_t> alloc_call_next_slot = { 0 };
+static thread_local uint32_t alloc_call_slot = UINT32_MAX;
+
+static _FORCE_INLINE_ void _count_alloc_call() {
+	if (unlikely(alloc_call_slot == UINT32_MAX)) {
+		alloc_call_slot = alloc_call_next_slot.fetch_add(1, std::memory_order_relaxed) % ALLOC_CALL_SLOT_COUNT;
+	}
+	alloc_call_slots[alloc_call_slot].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+// With the small object allocator, every allocation is padded, so the size
+// stored in the header tells which size class a block comes from, if any.
+static _FORCE_INLINE_ void *_alloc_block(size_t p_total_bytes) {
+	uint32_t size_class = SmallObjectAllocator::get_size_class(p_total_bytes);
+	if (size_class < SmallObjectAllocator::SIZE_CLASS_COUNT) {
+		return SmallObjectAllocator::alloc(size_class);
+	}
+	return malloc(p_total_bytes);
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem, size_t p_total_bytes) {
+	uint32_t size_class = SmallObjectAllocator::get_size_class(p_total_bytes);
+	if (size_class < SmallObjectAllocator::SIZE_CLASS_COUNT) {
+		SmallObjectAllocator::free(p_mem, size_class);
+	} else {
+		free(p_mem);
+	}
+}
+#endif
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_OBJECT_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	void *mem = _alloc_block(p_bytes + DATA_OFFSET);
+#else
 	void *mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+#endif
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 
 	alloc_count.increment();
+	_count_alloc_call();
 
 	if (prepad) {
 		uint8_t *s8 = (uint8_t *)mem;
@@ -99,9 +149,11 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		return alloc_static(p_bytes, p_pad_align);
 	}
 
+	_count_alloc_call();
+
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_OBJECT_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -110,6 +162,9 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= DATA_OFFSET;
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+		uint64_t old_bytes = *s;
+#endif
 
 #ifdef DEBUG_ENABLED
 		if (p_bytes > *s) {
@@ -121,11 +176,31 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+			_free_block(mem, old_bytes + DATA_OFFSET);
+#else
 			free(mem);
+#endif
 			return nullptr;
 		} else {
 			*s = p_bytes;
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+			uint32_t old_size_class = SmallObjectAllocator::get_size_class(old_bytes + DATA_OFFSET);
+			uint32_t new_size_class = SmallObjectAllocator::get_size_class(p_bytes + DATA_OFFSET);
+			if (old_size_class == new_size_class && new_size_class < SmallObjectAllocator::SIZE_CLASS_COUNT) {
+				return mem + DATA_OFFSET; // Still fits in the same block.
+			}
+			if (old_size_class < SmallObjectAllocator::SIZE_CLASS_COUNT || new_size_class < SmallObjectAllocator::SIZE_CLASS_COUNT) {
+				// Moving from or to a size class block; the system can't reallocate it.
+				uint8_t *new_mem = (uint8_t *)_alloc_block(p_bytes + DATA_OFFSET);
+				ERR_FAIL_NULL_V(new_mem, nullptr);
+				memcpy(new_mem, mem, DATA_OFFSET + MIN(old_bytes, (uint64_t)p_bytes)); // Header included.
+				_free_block(mem, old_bytes + DATA_OFFSET);
+				return new_mem + DATA_OFFSET;
+			}
+#endif
+
 			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 
@@ -149,7 +224,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_OBJECT_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -165,7 +240,11 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+		_free_block(mem, *(uint64_t *)(mem + SIZE_OFFSET) + DATA_OFFSET);
+#else
 		free(mem);
+#endif
 	} else {
 		free(mem);
 	}
@@ -191,6 +270,14 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_alloc_call_count() {
+	uint64_t count = 0;
+	for (const AllocCallSlot &slot : alloc_call_slots) {
+		count += slot.count.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
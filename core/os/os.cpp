@@ -36,6 +36,7 @@
 #include "core/io/file_access.h"
 #include "core/io/json.h"
 #include "core/os/midi_driver.h"
+#include "core/os/small_object_allocator.h"
 #include "core/version_generated.gen.h"
 
 #include <stdarg.h>
@@ -326,6 +327,25 @@ uint64_t OS::get_static_memory_peak_usage() const {
 	return Memory::get_mem_max_usage();
 }
 
+Array OS::get_static_memory_usage_by_size_class() const {
+	Array ret;
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	SmallObjectAllocator::SizeClassStats stats[SmallObjectAllocator::SIZE_CLASS_COUNT];
+	SmallObjectAllocator::get_stats(stats);
+	for (uint32_t i = 0; i < SmallObjectAllocator::SIZE_CLASS_COUNT; i++) {
+		Dictionary d;
+		d["block_size"] = stats[i].block_size;
+		d["reserved_blocks"] = stats[i].reserved_blocks;
+		d["depot_blocks"] = stats[i].depot_blocks;
+#ifdef DEBUG_ENABLED
+		d["used_blocks"] = stats[i].used_blocks;
+#endif
+		ret.push_back(d);
+	}
+#endif
+	return ret;
+}
+
 Error OS::set_cwd(const String &p_cwd) {
 	return ERR_CANT_OPEN;
 }
@@ -0,0 +1,255 @@
+/**************************************************************************/
+/*  small_object_allocator.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "small_object_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/safe_refcount.h"
+
+#include <stdlib.h>
+
+const size_t SmallObjectAllocator::block_sizes[SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128, // Steps of 16.
+	160, 192, 224, 256, // Steps of 32.
+	320, 384, 448, 512, // Steps of 64.
+	640, 768, 896, 1024, // Steps of 128.
+};
+
+namespace {
+
+// Free blocks are linked through their first bytes. Blocks are at least 16 bytes long,
+// which leaves room for linking whole batches in the depot too.
+struct FreeBlock {
+	FreeBlock *next;
+	FreeBlock *next_batch;
+};
+
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+_FORCE_INLINE_ uint32_t _get_batch_size(uint32_t p_size_class) {
+	// Around 4 KiB worth of blocks, but never too few.
+	return MAX(16u, MIN(256u, uint32_t(4096 / SmallObjectAllocator::get_block_size(p_size_class))));
+}
+
+// Shared state for one size class. Zero-initialized, so it's usable before static
+// constructors run, which matters because allocations can happen at any time.
+struct Depot {
+	SpinLock lock;
+	FreeBlock *batches; // Full batches, linked with next_batch.
+	uint64_t batch_count;
+	FreeBlock *loose; // Blocks returned by exiting threads.
+	uint64_t loose_count;
+	uint8_t *chunk_pos; // What's left of the last chunk.
+	uint8_t *chunk_end;
+	uint64_t reserved;
+};
+
+Depot depots[SmallObjectAllocator::SIZE_CLASS_COUNT];
+
+#ifdef DEBUG_ENABLED
+SafeNumeric<uint64_t> used_blocks[SmallObjectAllocator::SIZE_CLASS_COUNT];
+#endif
+
+// Takes up to a batch of blocks from the depot. Returns how many, chained from r_first.
+uint32_t _take_from_depot(uint32_t p_size_class, FreeBlock *&r_first) {
+	Depot &depot = depots[p_size_class];
+	uint32_t batch_size = _get_batch_size(p_size_class);
+	size_t block_size = SmallObjectAllocator::get_block_size(p_size_class);
+
+	depot.lock.lock();
+
+	if (depot.batches) {
+		r_first = depot.batches;
+		depot.batches = r_first->next_batch;
+		depot.batch_count--;
+		depot.lock.unlock();
+		return batch_size;
+	}
+
+	r_first = nullptr;
+	uint32_t taken = 0;
+	while (depot.loose && taken < batch_size) {
+		FreeBlock *block = depot.loose;
+		depot.loose = block->next;
+		depot.loose_count--;
+		block->next = r_first;
+		r_first = block;
+		taken++;
+	}
+
+	while (taken < batch_size) {
+		if (depot.chunk_pos + block_size > depot.chunk_end) {
+			uint8_t *chunk = (uint8_t *)malloc(CHUNK_SIZE);
+			if (unlikely(!chunk)) {
+				break;
+			}
+			depot.chunk_pos = chunk;
+			depot.chunk_end = chunk + CHUNK_SIZE;
+		}
+		FreeBlock *block = (FreeBlock *)depot.chunk_pos;
+		depot.chunk_pos += block_size;
+		depot.reserved++;
+		block->next = r_first;
+		r_first = block;
+		taken++;
+	}
+
+	depot.lock.unlock();
+	return taken;
+}
+
+void _give_batch_to_depot(uint32_t p_size_class, FreeBlock *p_first) {
+	Depot &depot = depots[p_size_class];
+	depot.lock.lock();
+	p_first->next_batch = depot.batches;
+	depot.batches = p_first;
+	depot.batch_count++;
+	depot.lock.unlock();
+}
+
+void _give_loose_to_depot(uint32_t p_size_class, FreeBlock *p_block) {
+	Depot &depot = depots[p_size_class];
+	depot.lock.lock();
+	p_block->next = depot.loose;
+	depot.loose = p_block;
+	depot.loose_count++;
+	depot.lock.unlock();
+}
+
+struct ThreadCache {
+	FreeBlock *blocks[SmallObjectAllocator::SIZE_CLASS_COUNT];
+	uint32_t counts[SmallObjectAllocator::SIZE_CLASS_COUNT];
+	bool destroyed;
+
+	~ThreadCache() {
+		for (uint32_t i = 0; i < SmallObjectAllocator::SIZE_CLASS_COUNT; i++) {
+			while (blocks[i]) {
+				FreeBlock *block = blocks[i];
+				blocks[i] = block->next;
+				_give_loose_to_depot(i, block);
+			}
+			counts[i] = 0;
+		}
+		// Other thread-local destructors may still free memory after this one.
+		destroyed = true;
+	}
+};
+
+thread_local ThreadCache thread_cache;
+
+} // namespace
+
+void *SmallObjectAllocator::alloc(uint32_t p_size_class) {
+	DEV_ASSERT(p_size_class < SIZE_CLASS_COUNT);
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.destroyed)) {
+		FreeBlock *first = nullptr;
+		uint32_t taken = _take_from_depot(p_size_class, first);
+		if (!first) {
+			return nullptr;
+		}
+		// Keep one, give the rest back.
+		FreeBlock *rest = first->next;
+		while (rest && --taken) {
+			FreeBlock *next = rest->next;
+			_give_loose_to_depot(p_size_class, rest);
+			rest = next;
+		}
+#ifdef DEBUG_ENABLED
+		used_blocks[p_size_class].increment();
+#endif
+		return first;
+	}
+
+	FreeBlock *block = cache.blocks[p_size_class];
+	if (unlikely(!block)) {
+		cache.counts[p_size_class] = _take_from_depot(p_size_class, block);
+		if (unlikely(!block)) {
+			return nullptr;
+		}
+	}
+	cache.blocks[p_size_class] = block->next;
+	cache.counts[p_size_class]--;
+
+#ifdef DEBUG_ENABLED
+	used_blocks[p_size_class].increment();
+#endif
+	return block;
+}
+
+void SmallObjectAllocator::free(void *p_block, uint32_t p_size_class) {
+	DEV_ASSERT(p_size_class < SIZE_CLASS_COUNT);
+	FreeBlock *block = (FreeBlock *)p_block;
+	ThreadCache &cache = thread_cache;
+
+#ifdef DEBUG_ENABLED
+	used_blocks[p_size_class].decrement();
+#endif
+
+	if (unlikely(cache.destroyed)) {
+		_give_loose_to_depot(p_size_class, block);
+		return;
+	}
+
+	block->next = cache.blocks[p_size_class];
+	cache.blocks[p_size_class] = block;
+	cache.counts[p_size_class]++;
+
+	uint32_t batch_size = _get_batch_size(p_size_class);
+	if (unlikely(cache.counts[p_size_class] > batch_size * 2)) {
+		// Too many cached, give the oldest batch to the depot; the most recently freed are more likely hot.
+		uint32_t kept = cache.counts[p_size_class] - batch_size;
+		FreeBlock *last_kept = block;
+		for (uint32_t i = 1; i < kept; i++) {
+			last_kept = last_kept->next;
+		}
+		FreeBlock *batch = last_kept->next;
+		last_kept->next = nullptr;
+		cache.counts[p_size_class] = kept;
+		_give_batch_to_depot(p_size_class, batch);
+	}
+}
+
+void SmallObjectAllocator::get_stats(SizeClassStats *r_stats) {
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		Depot &depot = depots[i];
+		SizeClassStats &stats = r_stats[i];
+		stats.block_size = block_sizes[i];
+		depot.lock.lock();
+		stats.reserved_blocks = depot.reserved;
+		stats.depot_blocks = depot.batch_count * _get_batch_size(i) + depot.loose_count;
+		depot.lock.unlock();
+#ifdef DEBUG_ENABLED
+		stats.used_blocks = used_blocks[i].get();
+#endif
+	}
+}
@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*  small_object_allocator.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SMALL_OBJECT_ALLOCATOR_H
+#define SMALL_OBJECT_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Size-class allocator used by Memory::alloc_static() for small blocks when
+// built with `small_object_allocator=yes`. Each thread keeps a cache of free
+// blocks per size class, so most allocations and frees don't synchronize at all.
+// Caches exchange batches of blocks with a shared depot, which carves new blocks
+// from large chunks. Memory is never given back to the system.
+class SmallObjectAllocator {
+public:
+	static constexpr uint32_t SIZE_CLASS_COUNT = 20;
+	static constexpr size_t MAX_BLOCK_SIZE = 1024;
+
+	struct SizeClassStats {
+		size_t block_size = 0;
+		uint64_t reserved_blocks = 0; // Carved from chunks so far.
+		uint64_t depot_blocks = 0; // Free and not cached by any thread.
+		uint64_t used_blocks = 0; // Only tracked with DEBUG_ENABLED.
+	};
+
+private:
+	static const size_t block_sizes[SIZE_CLASS_COUNT];
+
+public:
+	// Returns SIZE_CLASS_COUNT if the size is too large for the allocator.
+	static _FORCE_INLINE_ uint32_t get_size_class(size_t p_bytes) {
+		if (p_bytes <= 128) {
+			return p_bytes == 0 ? 0 : (p_bytes - 1) / 16;
+		} else if (p_bytes <= 256) {
+			return 8 + (p_bytes - 129) / 32;
+		} else if (p_bytes <= 512) {
+			return 12 + (p_bytes - 257) / 64;
+		} else if (p_bytes <= MAX_BLOCK_SIZE) {
+			return 16 + (p_bytes - 513) / 128;
+		}
+		return SIZE_CLASS_COUNT;
+	}
+	static _FORCE_INLINE_ size_t get_block_size(uint32_t p_size_class) { return block_sizes[p_size_class]; }
+
+	static void *alloc(uint32_t p_size_class);
+	static void free(void *p_block, uint32_t p_size_class);
+
+	static void get_stats(SizeClassStats *r_stats); // Fills SIZE_CLASS_COUNT entries.
+};
+
+#endif // SMALL_OBJECT_ALLOCATOR_H
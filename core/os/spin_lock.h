@@ -33,6 +33,19 @@
 
 #include "core/typedefs.h"
 
+// Tells the CPU the thread is busy-waiting, so it can save power and yield resources to its sibling hardware thread.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define CPU_PAUSE() _mm_pause()
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+#include <intrin.h>
+#define CPU_PAUSE() __yield()
+#elif defined(__aarch64__) || defined(__arm__)
+#define CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define CPU_PAUSE() ((void)0)
+#endif
+
 #if defined(__APPLE__)
 
 #include <os/lock.h>
@@ -118,6 +118,9 @@ public:
 
 	static Error set_name(const String &p_name);
 
+	// Lets the OS run another thread, for busy-waits that may last longer than a few instructions.
+	_FORCE_INLINE_ static void yield() { THREADING_NAMESPACE::this_thread::yield(); }
+
 	ID start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings());
 	bool is_started() const;
 	///< waits until thread is finished, and deallocates it.
@@ -178,6 +181,8 @@ public:
 
 	static Error set_name(const String &p_name) { return ERR_UNAVAILABLE; }
 
+	_FORCE_INLINE_ static void yield() {}
+
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings()) {}
 	bool is_started() const { return false; }
 	void wait_to_finish() {}
@@ -31,7 +31,9 @@
 #include "string_name.h"
 
 #include "core/os/os.h"
+#include "core/os/rw_lock.h"
 #include "core/string/print_string.h"
+#include "core/templates/hashfuncs.h"
 
 StaticCString StaticCString::create(const char *p_ptr) {
 	StaticCString scs;
@@ -39,7 +41,79 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+// Lookups of existing names only take the read lock of their shard, so they never wait on each other.
+// Adding or removing a name takes the write lock of its shard only.
+struct StringName::Table {
+	RWLock lock;
+	_Data **buckets = nullptr;
+	uint32_t mask = 0;
+	uint32_t count = 0;
+
+	void insert(_Data *p_data);
+	void remove(_Data *p_data);
+	void grow();
+};
+
+void StringName::Table::grow() {
+	const uint32_t new_size = (mask + 1) * 2;
+	_Data **new_buckets = memnew_arr(_Data *, new_size);
+	for (uint32_t i = 0; i < new_size; i++) {
+		new_buckets[i] = nullptr;
+	}
+
+	for (uint32_t i = 0; i <= mask; i++) {
+		_Data *d = buckets[i];
+		while (d) {
+			_Data *next = d->next;
+			const uint32_t idx = d->hash & (new_size - 1);
+			d->prev = nullptr;
+			d->next = new_buckets[idx];
+			if (new_buckets[idx]) {
+				new_buckets[idx]->prev = d;
+			}
+			new_buckets[idx] = d;
+			d = next;
+		}
+	}
+
+	memdelete_arr(buckets);
+	buckets = new_buckets;
+	mask = new_size - 1;
+}
+
+void StringName::Table::insert(_Data *p_data) {
+	if (count > mask) {
+		grow();
+	}
+
+	const uint32_t idx = p_data->hash & mask;
+	p_data->prev = nullptr;
+	p_data->next = buckets[idx];
+	if (buckets[idx]) {
+		buckets[idx]->prev = p_data;
+	}
+	buckets[idx] = p_data;
+	count++;
+}
+
+void StringName::Table::remove(_Data *p_data) {
+	if (p_data->prev) {
+		p_data->prev->next = p_data->next;
+	} else {
+		const uint32_t idx = p_data->hash & mask;
+		if (buckets[idx] != p_data) {
+			ERR_PRINT("BUG!");
+		}
+		buckets[idx] = p_data->next;
+	}
+
+	if (p_data->next) {
+		p_data->next->prev = p_data->prev;
+	}
+	count--;
+}
+
+StringName::Table *StringName::tables = nullptr;
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
@@ -52,10 +126,102 @@ Mutex StringName::mutex;
 bool StringName::debug_stringname = false;
 #endif
 
+StringName::Table &StringName::_get_table(uint32_t p_hash) {
+	// Buckets are picked from the low bits of the hash, mix it so the shards do not depend on them.
+	return tables[hash_fmix32(p_hash) >> (32 - STRING_TABLE_SHARD_BITS)];
+}
+
+template <typename T>
+StringName::_Data *StringName::_find(const Table &p_table, uint32_t p_hash, const T &p_name) {
+	_Data *data = p_table.buckets[p_hash & p_table.mask];
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->get_name() == p_name) {
+			return data;
+		}
+		data = data->next;
+	}
+	return nullptr;
+}
+
+void StringName::_ref_existing(_Data *p_data, bool p_static) {
+	if (p_static) {
+		p_data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		p_data->debug_references.increment();
+	}
+#endif
+}
+
+template <typename T>
+StringName::_Data *StringName::_search(uint32_t p_hash, const T &p_name) {
+	Table &table = _get_table(p_hash);
+	RWLockRead read_lock(table.lock);
+
+	_Data *data = _find(table, p_hash, p_name);
+	if (data && data->refcount.ref()) {
+		return data;
+	}
+	return nullptr;
+}
+
+template <typename T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static) {
+	Table &table = _get_table(p_hash);
+
+	{
+		RWLockRead read_lock(table.lock);
+		_Data *data = _find(table, p_hash, p_name);
+		if (data && data->refcount.ref()) {
+			// exists
+			_ref_existing(data, p_static);
+			return data;
+		}
+	}
+
+	RWLockWrite write_lock(table.lock);
+
+	// Another thread may have added it while the lock was released.
+	_Data *data = _find(table, p_hash, p_name);
+	if (data && data->refcount.ref()) {
+		_ref_existing(data, p_static);
+		return data;
+	}
+
+	data = memnew(_Data);
+	if (p_cname) {
+		data->cname = p_cname;
+	} else {
+		data->name = p_name;
+	}
+	data->refcount.init();
+	data->static_count.set(p_static ? 1 : 0);
+	data->hash = p_hash;
+
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		data->refcount.ref();
+		data->static_count.increment();
+	}
+#endif
+
+	table.insert(data);
+	return data;
+}
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	tables = memnew_arr(Table, STRING_TABLE_SHARD_COUNT);
+	for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		Table &table = tables[i];
+		table.mask = (1 << STRING_TABLE_SHARD_INITIAL_BITS) - 1;
+		table.buckets = memnew_arr(_Data *, table.mask + 1);
+		for (uint32_t j = 0; j <= table.mask; j++) {
+			table.buckets[j] = nullptr;
+		}
 	}
 	configured = true;
 }
@@ -66,11 +232,13 @@ void StringName::cleanup() {
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
-			while (d) {
-				data.push_back(d);
-				d = d->next;
+		for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+			for (uint32_t j = 0; j <= tables[i].mask; j++) {
+				_Data *d = tables[i].buckets[j];
+				while (d) {
+					data.push_back(d);
+					d = d->next;
+				}
 			}
 		}
 
@@ -80,10 +248,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -93,26 +261,35 @@ void StringName::cleanup() {
 	}
 #endif
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			if (d->static_count.get() != d->refcount.get()) {
-				lost_strings++;
-
-				if (OS::get_singleton()->is_stdout_verbose()) {
-					String dname = String(d->cname ? d->cname : d->name);
-
-					print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", dname, d->static_count.get(), d->refcount.get()));
+	for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		Table &table = tables[i];
+		RWLockWrite write_lock(table.lock);
+		for (uint32_t j = 0; j <= table.mask; j++) {
+			while (table.buckets[j]) {
+				_Data *d = table.buckets[j];
+				if (d->static_count.get() != d->refcount.get()) {
+					lost_strings++;
+
+					if (OS::get_singleton()->is_stdout_verbose()) {
+						String dname = String(d->cname ? d->cname : d->name);
+
+						print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", dname, d->static_count.get(), d->refcount.get()));
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				table.buckets[j] = table.buckets[j]->next;
+				memdelete(d);
+			}
 		}
+		memdelete_arr(table.buckets);
+		table.buckets = nullptr;
+		table.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose(vformat("StringName: %d unclaimed string names at exit.", lost_strings));
 	}
+	memdelete_arr(tables);
+	tables = nullptr;
 	configured = false;
 }
 
@@ -120,7 +297,8 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		Table &table = _get_table(_data->hash);
+		RWLockWrite write_lock(table.lock);
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -129,18 +307,7 @@ void StringName::unref() {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->name));
 			}
 		}
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			if (_table[_data->idx] != _data) {
-				ERR_PRINT("BUG!");
-			}
-			_table[_data->idx] = _data->next;
-		}
-
-		if (_data->next) {
-			_data->next->prev = _data->prev;
-		}
+		table.remove(_data);
 		memdelete(_data);
 	}
 
@@ -216,56 +383,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_name), p_name, nullptr, p_static);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -275,55 +393,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr, p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -335,54 +405,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name.hash(), p_name, nullptr, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -393,29 +416,14 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
+	_Data *data = _search(String::hash(p_name), p_name);
+	if (data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			data->debug_references.increment();
 		}
 #endif
-
-		return StringName(_data);
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -429,55 +437,27 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *data = _search(String::hash(p_name), p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
 }
 
 StringName StringName::search(const String &p_name) {
-	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
-
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
+	ERR_FAIL_COND_V(!configured, StringName());
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
+	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	if (_data && _data->refcount.ref()) {
+	_Data *data = _search(p_name.hash(), p_name);
+	if (data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			data->debug_references.increment();
 		}
 #endif
-		return StringName(_data);
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -46,9 +46,11 @@ struct StaticCString {
 
 class StringName {
 	enum {
-		STRING_TABLE_BITS = 16,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		// The table is split in shards with their own lock, picked from the name hash.
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARD_COUNT = 1 << STRING_TABLE_SHARD_BITS,
+		// Initial bucket count of each shard, they grow with the number of names.
+		STRING_TABLE_SHARD_INITIAL_BITS = 10,
 	};
 
 	struct _Data {
@@ -57,20 +59,30 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		// Counted while only holding the read lock of the shard, or no lock at all.
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
 		_Data *next = nullptr;
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct Table;
+	static Table *tables;
 
 	_Data *_data = nullptr;
 
+	static Table &_get_table(uint32_t p_hash);
+	template <typename T>
+	static _Data *_find(const Table &p_table, uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_search(uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static);
+	static void _ref_existing(_Data *p_data, bool p_static);
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
@@ -82,7 +94,7 @@ class StringName {
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
@@ -33,6 +33,109 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+struct CommandQueueMT::CommandBlock {
+	static constexpr uint32_t SIZE = 64 * 1024;
+	static constexpr uint32_t HEADER_SIZE = 64;
+	static constexpr uint32_t CAPACITY = SIZE - HEADER_SIZE;
+	// Keeps the block alive while its producer may still write to it.
+	static constexpr uint32_t PRODUCER_REF = 1u << 31;
+
+	// PRODUCER_REF, minus one per flushed command, minus the remainder once retired by the producer.
+	SafeNumeric<uint32_t> refs;
+	// Only accessed by the producer.
+	uint32_t used = 0;
+	uint32_t commands = 0;
+
+	_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)this + HEADER_SIZE; }
+};
+
+// The block the calling thread writes its commands to, retired when the thread exits.
+struct CommandQueueMT::ThreadBlock {
+	CommandBlock *block = nullptr;
+
+	~ThreadBlock() {
+		if (block) {
+			_retire_block(block);
+		}
+	}
+};
+
+thread_local CommandQueueMT::ThreadBlock CommandQueueMT::thread_block;
+
+// Released blocks are kept around, up to a limit, so steady streams of commands don't allocate.
+static constexpr uint32_t MAX_POOLED_COMMAND_BLOCKS = 16;
+static BinaryMutex command_block_pool_mutex;
+static void *command_block_pool[MAX_POOLED_COMMAND_BLOCKS];
+static uint32_t command_block_pool_size = 0;
+
+CommandQueueMT::CommandBlock *CommandQueueMT::_create_block() {
+	static_assert(sizeof(CommandBlock) <= CommandBlock::HEADER_SIZE);
+
+	void *mem = nullptr;
+	{
+		MutexLock lock(command_block_pool_mutex);
+		if (command_block_pool_size > 0) {
+			mem = command_block_pool[--command_block_pool_size];
+		}
+	}
+	if (!mem) {
+		mem = memalloc(CommandBlock::SIZE);
+		CRASH_COND_MSG(!mem, "Out of memory");
+	}
+	CommandBlock *block = memnew_placement(mem, CommandBlock);
+	block->refs.set(CommandBlock::PRODUCER_REF);
+	return block;
+}
+
+void CommandQueueMT::_free_block(CommandBlock *p_block) {
+	p_block->~CommandBlock();
+	{
+		MutexLock lock(command_block_pool_mutex);
+		if (command_block_pool_size < MAX_POOLED_COMMAND_BLOCKS) {
+			command_block_pool[command_block_pool_size++] = p_block;
+			return;
+		}
+	}
+	memfree(p_block);
+}
+
+void CommandQueueMT::_retire_block(CommandBlock *p_block) {
+	if (p_block->refs.sub(CommandBlock::PRODUCER_REF - p_block->commands) == 0) {
+		_free_block(p_block);
+	}
+}
+
+CommandQueueMT::CommandNode *CommandQueueMT::_alloc_node(uint32_t p_command_size) {
+	uint32_t size = NODE_SIZE + ((p_command_size + COMMAND_ALIGN - 1) & ~(COMMAND_ALIGN - 1));
+	DEV_ASSERT(size <= CommandBlock::CAPACITY);
+
+	CommandBlock *block = thread_block.block;
+	if (unlikely(!block || block->used + size > CommandBlock::CAPACITY)) {
+		if (block) {
+			_retire_block(block);
+		}
+		block = _create_block();
+		thread_block.block = block;
+	}
+
+	CommandNode *node = memnew_placement(block->get_data() + block->used, CommandNode);
+	node->block = block;
+	block->used += size;
+	block->commands++;
+	return node;
+}
+
+void CommandQueueMT::_release_node(CommandNode *p_node) {
+	CommandBlock *block = p_node->block;
+	if (!block) {
+		return; // Stub node.
+	}
+	p_node->~CommandNode();
+	if (block->refs.decrement() == 0) {
+		_free_block(block);
+	}
+}
+
 void CommandQueueMT::lock() {
 	mutex.lock();
 }
@@ -42,8 +145,18 @@ void CommandQueueMT::unlock() {
 }
 
 CommandQueueMT::CommandQueueMT() {
-	command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
+	head = &stub_node;
+	tail.store(&stub_node, std::memory_order_relaxed);
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	// Commands that were never flushed are destroyed without being called.
+	CommandNode *next = head->next.load(std::memory_order_acquire);
+	while (next) {
+		_get_command(next)->~CommandBase();
+		_release_node(head);
+		head = next;
+		next = head->next.load(std::memory_order_acquire);
+	}
+	_release_node(head);
 }
@@ -35,11 +35,15 @@
 #include "core/os/condition_variable.h"
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
 #include "core/string/print_string.h"
-#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -251,14 +255,11 @@
 #define DECL_PUSH(N)                                                            \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>    \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) {    \
-		MutexLock mlock(mutex);                                                 \
 		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                             \
 		cmd->instance = p_instance;                                             \
 		cmd->method = p_method;                                                 \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                    \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id); \
-		}                                                                       \
+		_commit(cmd);                                                           \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -266,17 +267,15 @@
 #define DECL_PUSH_AND_RET(N)                                                                   \
 	template <typename T, typename M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) typename R>       \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
-		MutexLock mlock(mutex);                                                                \
 		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                               \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);                \
-		}                                                                                      \
-		sync_tail++;                                                                           \
-		_wait_for_sync(mlock);                                                                 \
+		bool done = false;                                                                     \
+		cmd->done = &done;                                                                     \
+		_commit(cmd);                                                                          \
+		_wait_for_sync(done);                                                                  \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -284,16 +283,14 @@
 #define DECL_PUSH_AND_SYNC(N)                                                         \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>          \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		MutexLock mlock(mutex);                                                       \
 		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                      \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);       \
-		}                                                                             \
-		sync_tail++;                                                                  \
-		_wait_for_sync(mlock);                                                        \
+		bool done = false;                                                            \
+		cmd->done = &done;                                                            \
+		_commit(cmd);                                                                 \
+		_wait_for_sync(done);                                                         \
 	}
 
 #define MAX_CMD_PARAMS 15
@@ -306,6 +303,7 @@ class CommandQueueMT {
 	};
 
 	struct SyncCommand : public CommandBase {
+		bool *done = nullptr; // Owned by the waiting thread, guarded by sync_mutex.
 		virtual void call() override {}
 		SyncCommand() {
 			sync = true;
@@ -325,86 +323,153 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
-	static const uint32_t DEFAULT_COMMAND_MEM_SIZE_KB = 64;
+	// Commands are linked into an intrusive multi-producer single-consumer queue
+	// (D. Vyukov's design): pushing is one exchange on the tail, so producers never
+	// block each other, and commands run in the order their exchange happened. That
+	// keeps the submission order of each producer, as well as the order between
+	// producers that synchronize with each other.
+	// Every thread writes the commands it pushes, to any queue, to its own block of
+	// command memory. Blocks are released once all of their commands were flushed.
+	struct CommandBlock;
+
+	struct CommandNode {
+		std::atomic<CommandNode *> next = { nullptr };
+		CommandBlock *block = nullptr;
+	};
+
+	static constexpr uint32_t COMMAND_ALIGN = 16;
+	static constexpr uint32_t NODE_SIZE = (sizeof(CommandNode) + COMMAND_ALIGN - 1) & ~(COMMAND_ALIGN - 1);
 
-	BinaryMutex mutex;
-	LocalVector<uint8_t> command_mem;
+	Mutex mutex; // Held while flushing.
+	BinaryMutex sync_mutex;
 	ConditionVariable sync_cond_var;
-	uint32_t sync_head = 0;
-	uint32_t sync_tail = 0;
-	uint32_t sync_awaiters = 0;
-	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
-	uint64_t flush_read_ptr = 0;
+	SafeNumeric<WorkerThreadPool::TaskID> pump_task_id{ WorkerThreadPool::INVALID_TASK_ID };
+	bool flushing = false;
+
+	// Commands pushed and not yet accounted for by a flush.
+	SafeNumeric<uint32_t> pending;
+	std::atomic<CommandNode *> tail;
+	CommandNode *head = nullptr; // Last flushed node, only accessed by the flushing thread.
+	CommandNode stub_node;
+
+	struct ThreadBlock;
+	static thread_local ThreadBlock thread_block;
+
+	static CommandBlock *_create_block();
+	static void _free_block(CommandBlock *p_block);
+	static void _retire_block(CommandBlock *p_block);
+	static CommandNode *_alloc_node(uint32_t p_command_size);
+	static void _release_node(CommandNode *p_node);
+
+	_FORCE_INLINE_ static CommandBase *_get_command(CommandNode *p_node) {
+		return reinterpret_cast<CommandBase *>((uint8_t *)p_node + NODE_SIZE);
+	}
 
 	template <typename T>
 	T *allocate() {
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + 8);
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		T *cmd = memnew_placement(&command_mem[size + 8], T);
+		static_assert(alignof(T) <= COMMAND_ALIGN);
+		CommandNode *node = _alloc_node(sizeof(T));
+		T *cmd = memnew_placement((uint8_t *)node + NODE_SIZE, T);
 		return cmd;
 	}
 
-	_FORCE_INLINE_ void _prevent_sync_wraparound() {
-		bool safe_to_reset = !sync_awaiters;
-		bool already_sync_to_latest = sync_head == sync_tail;
-		if (safe_to_reset && already_sync_to_latest) {
-			sync_head = 0;
-			sync_tail = 0;
+	_FORCE_INLINE_ void _commit(CommandBase *p_cmd) {
+		CommandNode *node = reinterpret_cast<CommandNode *>((uint8_t *)p_cmd - NODE_SIZE);
+		// Counted before linking, so a flush never accounts for more than was pushed.
+		bool was_idle = pending.increment() == 1;
+		CommandNode *prev = tail.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+
+		// Wake up the pump only once per batch; it flushes everything pending.
+		if (was_idle) {
+			WorkerThreadPool::TaskID pump = pump_task_id.get();
+			if (pump != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->notify_yield_over(pump);
+			}
 		}
 	}
 
-	void _flush() {
-		if (unlikely(flush_read_ptr)) {
-			// Re-entrant call.
-			return;
+	// Waiting on a producer between two steps of a push. That's a matter of instructions, unless the
+	// producer got preempted, so spin for a while before letting it run.
+	_FORCE_INLINE_ static void _backoff(uint32_t &r_spins) {
+		if (r_spins < 64) {
+			r_spins++;
+			CPU_PAUSE();
+		} else {
+			Thread::yield();
 		}
+	}
 
-		lock();
+	uint32_t _flush_linked() {
+		uint32_t flushed = 0;
+		uint32_t spins = 0;
+		while (true) {
+			CommandNode *next = head->next.load(std::memory_order_acquire);
+			if (!next) {
+				if (tail.load(std::memory_order_acquire) == head) {
+					break;
+				}
+				// A producer swapped the tail but has yet to link its node.
+				_backoff(spins);
+				continue;
+			}
+			spins = 0;
 
-		uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(&mutex);
-		while (flush_read_ptr < command_mem.size()) {
-			uint64_t size = *(uint64_t *)&command_mem[flush_read_ptr];
-			flush_read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
+			CommandBase *cmd = _get_command(next);
 			cmd->call();
 
-			// Handle potential realloc due to the command and unlock allowance.
-			cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
-
 			if (unlikely(cmd->sync)) {
-				sync_head++;
-				unlock(); // Give an opportunity to awaiters right away.
+				SyncCommand *sync_cmd = static_cast<SyncCommand *>(cmd);
+				sync_mutex.lock();
+				*sync_cmd->done = true;
+				sync_mutex.unlock();
 				sync_cond_var.notify_all();
-				lock();
-				// Handle potential realloc happened during unlock.
-				cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
 			}
 
 			cmd->~CommandBase();
 
-			flush_read_ptr += size;
+			// The previous node could still be linked to until now.
+			_release_node(head);
+			head = next;
+			flushed++;
 		}
-		WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
+		return flushed;
+	}
 
-		command_mem.clear();
-		flush_read_ptr = 0;
+	void _flush() {
+		MutexLock lock(mutex);
+		if (unlikely(flushing)) {
+			// Re-entrant call.
+			return;
+		}
+		flushing = true;
 
-		_prevent_sync_wraparound();
+		uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(&mutex);
+		// Keep going until no push is in flight, otherwise a producer that didn't
+		// see an idle queue could be left without anybody flushing its command.
+		uint32_t spins = 0;
+		while (true) {
+			const uint32_t flushed = _flush_linked();
+			if (pending.sub(flushed) == 0) {
+				break;
+			}
+			if (flushed == 0) {
+				// A producer counted its command but has yet to swap the tail.
+				_backoff(spins);
+			} else {
+				spins = 0;
+			}
+		}
+		WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
 
-		unlock();
+		flushing = false;
 	}
 
-	_FORCE_INLINE_ void _wait_for_sync(MutexLock<BinaryMutex> &p_lock) {
-		sync_awaiters++;
-		uint32_t sync_head_goal = sync_tail;
-		do {
-			sync_cond_var.wait(p_lock);
-		} while (sync_head < sync_head_goal);
-		sync_awaiters--;
-		_prevent_sync_wraparound();
+	_FORCE_INLINE_ void _wait_for_sync(const bool &p_done) {
+		MutexLock lock(sync_mutex);
+		while (!p_done) {
+			sync_cond_var.wait(lock);
+		}
 	}
 
 	void _no_op() {}
@@ -426,7 +491,7 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
+		if (unlikely(pending.get() > 0)) {
 			_flush();
 		}
 	}
@@ -440,15 +505,14 @@ public:
 	}
 
 	void wait_and_flush() {
-		ERR_FAIL_COND(pump_task_id == WorkerThreadPool::INVALID_TASK_ID);
-		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id);
+		WorkerThreadPool::TaskID pump = pump_task_id.get();
+		ERR_FAIL_COND(pump == WorkerThreadPool::INVALID_TASK_ID);
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump);
 		_flush();
 	}
 
 	void set_pump_task_id(WorkerThreadPool::TaskID p_task_id) {
-		lock();
-		pump_task_id = p_task_id;
-		unlock();
+		pump_task_id.set(p_task_id);
 	}
 
 	CommandQueueMT();
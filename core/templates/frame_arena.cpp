@@ -0,0 +1,258 @@
+/**************************************************************************/
+/*  frame_arena.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/os/memory.h"
+
+namespace {
+
+struct ArenaChunk {
+	ArenaChunk *next = nullptr;
+	size_t size = 0;
+};
+
+constexpr size_t ARENA_CHUNK_SIZE = 64 * 1024;
+constexpr size_t ARENA_ALIGN = alignof(max_align_t);
+constexpr size_t CHUNK_HEADER_SIZE = (sizeof(ArenaChunk) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+// Allocations are preceded by the frame they were made in, or one of the tags below.
+constexpr size_t ALLOC_HEADER_SIZE = ARENA_ALIGN;
+constexpr uint64_t SCOPE_TAG = UINT64_MAX - 1;
+constexpr uint64_t HEAP_TAG = UINT64_MAX;
+
+_FORCE_INLINE_ uint8_t *_chunk_data(ArenaChunk *p_chunk) {
+	return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE;
+}
+
+_FORCE_INLINE_ uint64_t &_alloc_tag(void *p_ptr) {
+	return *(uint64_t *)((uint8_t *)p_ptr - ALLOC_HEADER_SIZE);
+}
+
+struct Arena {
+	ArenaChunk *first = nullptr;
+	ArenaChunk *current = nullptr;
+	uint8_t *pos = nullptr;
+	uint8_t *end = nullptr;
+	uint8_t *last_alloc = nullptr;
+	uint64_t frame = UINT64_MAX;
+
+	void rewind(uint64_t p_frame) {
+		frame = p_frame;
+		current = first;
+		pos = first ? _chunk_data(first) : nullptr;
+		end = first ? pos + first->size : nullptr;
+		last_alloc = nullptr;
+	}
+
+	// Moves to the next chunk able to hold p_size bytes, inserting a new one if needed.
+	void next_chunk(size_t p_size) {
+		ArenaChunk *next = current ? current->next : first;
+		if (!next || next->size < p_size) {
+			size_t size = MAX(ARENA_CHUNK_SIZE, p_size);
+			ArenaChunk *chunk = (ArenaChunk *)Memory::alloc_static(CHUNK_HEADER_SIZE + size);
+			CRASH_COND_MSG(!chunk, "Out of memory");
+			chunk->size = size;
+			chunk->next = next;
+			if (current) {
+				current->next = chunk;
+			} else {
+				first = chunk;
+			}
+			next = chunk;
+		}
+		current = next;
+		pos = _chunk_data(next);
+		end = pos + next->size;
+	}
+
+	void *alloc(size_t p_bytes, uint64_t p_tag) {
+		size_t size = ALLOC_HEADER_SIZE + ((MAX(p_bytes, (size_t)1) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1));
+		if (unlikely(size > (size_t)(end - pos))) {
+			next_chunk(size);
+		}
+		*(uint64_t *)pos = p_tag;
+		last_alloc = pos + ALLOC_HEADER_SIZE;
+		pos += size;
+		return last_alloc;
+	}
+
+	~Arena() {
+		while (first) {
+			ArenaChunk *next = first->next;
+			Memory::free_static(first);
+			first = next;
+		}
+	}
+};
+
+struct ThreadArenas {
+	Arena arenas[2];
+	Arena scope;
+	uint32_t scope_depth = 0;
+};
+
+thread_local ThreadArenas thread_arenas;
+
+} // namespace
+
+SafeNumeric<uint64_t> FrameArena::frame;
+SafeFlag FrameArena::frames_running;
+uint64_t FrameArena::frame_begin_alloc_calls = 0;
+uint64_t FrameArena::last_frame_alloc_calls = 0;
+
+static _FORCE_INLINE_ void _check_alive(uint64_t p_alloc_frame, uint64_t p_frame) {
+	// Memory lasts until the end of the next frame, after that its arena is rewound and handed out again.
+	DEV_ASSERT(p_alloc_frame <= p_frame && p_alloc_frame + 1 >= p_frame);
+}
+
+static _FORCE_INLINE_ Arena &_get_frame_arena(uint64_t p_frame) {
+	Arena &arena = thread_arenas.arenas[p_frame & 1];
+	if (unlikely(arena.frame != p_frame)) {
+		arena.rewind(p_frame);
+	}
+	return arena;
+}
+
+static void *_heap_alloc(size_t p_bytes) {
+	uint8_t *mem = (uint8_t *)Memory::alloc_static(ALLOC_HEADER_SIZE + p_bytes);
+	ERR_FAIL_NULL_V(mem, nullptr);
+	*(uint64_t *)mem = HEAP_TAG;
+	return mem + ALLOC_HEADER_SIZE;
+}
+
+FrameArena::Scope::Scope() {
+	ThreadArenas &arenas = thread_arenas;
+	chunk = arenas.scope.current;
+	pos = arenas.scope.pos;
+	end = arenas.scope.end;
+	last_alloc = arenas.scope.last_alloc;
+	arenas.scope_depth++;
+}
+
+FrameArena::Scope::~Scope() {
+	ThreadArenas &arenas = thread_arenas;
+	DEV_ASSERT(arenas.scope_depth > 0);
+	arenas.scope.current = (ArenaChunk *)chunk;
+	arenas.scope.pos = pos;
+	arenas.scope.end = end;
+	arenas.scope.last_alloc = last_alloc;
+	arenas.scope_depth--;
+}
+
+void *FrameArena::alloc(size_t p_bytes) {
+	ThreadArenas &arenas = thread_arenas;
+	if (arenas.scope_depth > 0) {
+		return arenas.scope.alloc(p_bytes, SCOPE_TAG);
+	}
+	if (unlikely(!frames_running.is_set())) {
+		return _heap_alloc(p_bytes);
+	}
+	const uint64_t current_frame = frame.get();
+	return _get_frame_arena(current_frame).alloc(p_bytes, current_frame);
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_old_bytes, size_t p_bytes) {
+	if (p_ptr == nullptr) {
+		return alloc(p_bytes);
+	}
+
+	// Keep the allocation where it came from, so containers created outside
+	// of a scope aren't moved into memory that the scope releases.
+	const uint64_t tag = _alloc_tag(p_ptr);
+	if (tag == HEAP_TAG) {
+		uint8_t *mem = (uint8_t *)Memory::realloc_static((uint8_t *)p_ptr - ALLOC_HEADER_SIZE, ALLOC_HEADER_SIZE + p_bytes);
+		ERR_FAIL_NULL_V(mem, nullptr);
+		return mem + ALLOC_HEADER_SIZE;
+	}
+
+	Arena *arena;
+	uint64_t new_tag;
+	if (tag == SCOPE_TAG) {
+		DEV_ASSERT(thread_arenas.scope_depth > 0);
+		arena = &thread_arenas.scope;
+		new_tag = SCOPE_TAG;
+	} else {
+		new_tag = frame.get();
+		_check_alive(tag, new_tag);
+		arena = &_get_frame_arena(new_tag);
+	}
+
+	if (p_bytes <= p_old_bytes) {
+		return p_ptr;
+	}
+
+	if (p_ptr == arena->last_alloc) {
+		// Most recent allocation, try to grow it in place.
+		size_t size = (p_bytes + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+		if (size <= (size_t)(arena->end - arena->last_alloc)) {
+			arena->pos = arena->last_alloc + size;
+			return p_ptr;
+		}
+	}
+
+	void *mem = arena->alloc(p_bytes, new_tag);
+	memcpy(mem, p_ptr, p_old_bytes);
+	return mem;
+}
+
+void FrameArena::free(void *p_ptr) {
+	if (p_ptr == nullptr) {
+		return;
+	}
+	const uint64_t tag = _alloc_tag(p_ptr);
+	if (tag == HEAP_TAG) {
+		Memory::free_static((uint8_t *)p_ptr - ALLOC_HEADER_SIZE);
+	} else if (tag != SCOPE_TAG) {
+		_check_alive(tag, frame.get());
+	}
+}
+
+void FrameArena::end_frame() {
+	uint64_t alloc_calls = Memory::get_alloc_call_count();
+	last_frame_alloc_calls = alloc_calls - frame_begin_alloc_calls;
+	frame_begin_alloc_calls = alloc_calls;
+	frame.increment();
+	frames_running.set();
+}
+
+void FrameArena::stop_frames() {
+	frames_running.clear();
+}
+
+uint64_t FrameArena::get_thread_reserved_bytes() {
+	uint64_t bytes = 0;
+	const Arena *arenas[3] = { &thread_arenas.arenas[0], &thread_arenas.arenas[1], &thread_arenas.scope };
+	for (const Arena *arena : arenas) {
+		for (ArenaChunk *chunk = arena->first; chunk; chunk = chunk->next) {
+			bytes += chunk->size;
+		}
+	}
+	return bytes;
+}
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  frame_arena.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Per-thread bump allocator for temporary data that does not outlive the frame.
+//
+// Each thread owns two arenas, used on alternating frames. An arena is rewound
+// the first time it is used in a new frame, so memory obtained during a frame
+// stays valid until the end of the next one. Chunks are kept when rewinding, so
+// once the arenas have grown to the working set no system allocations happen.
+//
+// Frames are advanced by `Main::iteration()`. Code whose lifetime isn't tied to
+// the frame (worker tasks, loader threads) opens a `FrameArena::Scope`: while one
+// is alive, the thread allocates from a separate arena that frames never rewind,
+// and which is reset to where the scope started when it's destroyed. Outside of
+// a scope and while no frame is running (before the main loop starts, after it
+// ends, `--test` runs), allocations fall back to the heap.
+//
+// `realloc()` keeps an allocation in the arena (or heap) it came from and grows
+// the most recent one in place when the chunk has room. `free()` only releases
+// heap fallbacks. Dev builds assert when frame memory is reallocated or freed
+// after its arena was rewound.
+class FrameArena {
+	static SafeNumeric<uint64_t> frame;
+	static SafeFlag frames_running;
+	static uint64_t frame_begin_alloc_calls;
+	static uint64_t last_frame_alloc_calls;
+
+public:
+	// Marks the position of the calling thread's scope arena, and resets it
+	// there on destruction. Scopes nest, and must be destroyed on the thread that
+	// created them; memory allocated inside one must not outlive it.
+	class Scope {
+		void *chunk = nullptr;
+		uint8_t *pos = nullptr;
+		uint8_t *end = nullptr;
+		uint8_t *last_alloc = nullptr;
+
+	public:
+		Scope();
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_old_bytes, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	// Must only be called from the main thread, once per frame.
+	static void end_frame();
+	// Called when the main loop exits; allocations outside of scopes go to the heap again.
+	static void stop_frames();
+	_FORCE_INLINE_ static uint64_t get_frame() { return frame.get(); }
+	_FORCE_INLINE_ static bool is_frame_running() { return frames_running.is_set(); }
+
+	// Calls to Memory::alloc_static/realloc_static during the previous frame,
+	// from any thread.
+	_FORCE_INLINE_ static uint64_t get_last_frame_alloc_calls() { return last_frame_alloc_calls; }
+	// Bytes reserved by the arenas of the calling thread.
+	static uint64_t get_thread_reserved_bytes();
+};
+
+// LocalVector allocating from the frame arena of the calling thread.
+// It must not be kept across frames; convert it to a Vector at API boundaries.
+//
+// There is no arena-backed Vector: its copy-on-write buffer is refcounted, can be
+// shared with other threads, Variants and resources, and is released by whoever
+// drops the last reference, so its lifetime can't be bound to a frame or scope.
+template <typename T, typename U = uint32_t, bool force_trivial = false, bool tight = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, tight, FrameArena>;
+
+#endif // FRAME_ARENA_H
@@ -627,8 +627,39 @@ struct _ArrayVariantSort {
 	}
 };
 
+// Typed arrays of builtin types compare with the validated operator, resolved once per call rather than
+// looked up for every comparison. Elements of another type (only possible when bypassing the validation
+// from C++) fall back to the regular comparison.
+struct _ArrayTypedSort {
+	Variant::Type type = Variant::NIL;
+	Variant::ValidatedOperatorEvaluator less = nullptr;
+
+	_FORCE_INLINE_ bool operator()(const Variant &p_l, const Variant &p_r) const {
+		if (likely(p_l.get_type() == type && p_r.get_type() == type)) {
+			Variant res(false);
+			less(&p_l, &p_r, &res);
+			return *VariantInternal::get_bool(&res);
+		}
+		return _ArrayVariantSort()(p_l, p_r);
+	}
+};
+
+static _ArrayTypedSort _get_typed_sort(const ContainerTypeValidate &p_typed) {
+	_ArrayTypedSort typed_sort;
+	if (p_typed.type != Variant::NIL && p_typed.type != Variant::OBJECT && Variant::get_operator_return_type(Variant::OP_LESS, p_typed.type, p_typed.type) == Variant::BOOL) {
+		typed_sort.type = p_typed.type;
+		typed_sort.less = Variant::get_validated_operator_evaluator(Variant::OP_LESS, p_typed.type, p_typed.type);
+	}
+	return typed_sort;
+}
+
 void Array::sort() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	const _ArrayTypedSort typed_sort = _get_typed_sort(_p->typed);
+	if (typed_sort.less) {
+		_p->array.sort_custom<_ArrayTypedSort>(typed_sort);
+		return;
+	}
 	_p->array.sort_custom<_ArrayVariantSort>();
 }
 
@@ -655,6 +686,12 @@ void Array::shuffle() {
 int Array::bsearch(const Variant &p_value, bool p_before) const {
 	Variant value = p_value;
 	ERR_FAIL_COND_V(!_p->typed.validate(value, "binary search"), -1);
+	const _ArrayTypedSort typed_sort = _get_typed_sort(_p->typed);
+	if (typed_sort.less) {
+		SearchArray<Variant, _ArrayTypedSort> avs;
+		avs.compare = typed_sort;
+		return avs.bisect(_p->array.ptr(), _p->array.size(), value, p_before);
+	}
 	SearchArray<Variant, _ArrayVariantSort> avs;
 	return avs.bisect(_p->array.ptrw(), _p->array.size(), value, p_before);
 }
@@ -726,6 +763,18 @@ Variant Array::pop_at(int p_pos) {
 }
 
 Variant Array::min() const {
+	const _ArrayTypedSort typed_sort = _get_typed_sort(_p->typed);
+	if (typed_sort.less && !_p->array.is_empty()) {
+		const Variant *data = _p->array.ptr();
+		const Variant *minval = &data[0];
+		for (int i = 1; i < _p->array.size(); i++) {
+			if (typed_sort(data[i], *minval)) {
+				minval = &data[i];
+			}
+		}
+		return *minval;
+	}
+
 	Variant minval;
 	for (int i = 0; i < size(); i++) {
 		if (i == 0) {
@@ -748,6 +797,18 @@ Variant Array::min() const {
 }
 
 Variant Array::max() const {
+	const _ArrayTypedSort typed_sort = _get_typed_sort(_p->typed);
+	if (typed_sort.less && !_p->array.is_empty()) {
+		const Variant *data = _p->array.ptr();
+		const Variant *maxval = &data[0];
+		for (int i = 1; i < _p->array.size(); i++) {
+			if (typed_sort(*maxval, data[i])) {
+				maxval = &data[i];
+			}
+		}
+		return *maxval;
+	}
+
 	Variant maxval;
 	for (int i = 0; i < size(); i++) {
 		if (i == 0) {
@@ -50,6 +50,7 @@
 #include "core/os/time.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
+#include "core/templates/frame_arena.h"
 #include "core/version.h"
 #include "drivers/register_driver_types.h"
 #include "main/app_icon.gen.h"
@@ -4145,6 +4146,7 @@ bool Main::iteration() {
 
 	frames++;
 	Engine::get_singleton()->_process_frames++;
+	FrameArena::end_frame();
 
 	if (frame > 1000000) {
 		// Wait a few seconds before printing FPS, as FPS reporting just after the engine has started is inaccurate.
@@ -4242,6 +4244,8 @@ void Main::cleanup(bool p_force) {
 		ERR_FAIL_COND(!_start_success);
 	}
 
+	FrameArena::stop_frames();
+
 #ifdef DEBUG_ENABLED
 	if (input) {
 		input->flush_frame_parsed_events();
@@ -100,6 +100,8 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		NAVIGATION_POLYGON_REBUILD_COUNT,
+		MEMORY_FRAME_ALLOCATIONS,
 		MONITOR_MAX
 	};
 
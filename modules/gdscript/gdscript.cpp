@@ -31,10 +31,14 @@
 #include "gdscript.h"
 
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_buffer.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_warning.h"
 
@@ -51,6 +55,7 @@
 #include "core/core_constants.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/resource_uid.h"
 #include "core/os/os.h"
 
 #include "scene/scene_string_names.h"
@@ -762,30 +767,27 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 #endif
 
-	{
-		String source_path = path;
-		if (source_path.is_empty()) {
-			source_path = get_path();
-		}
-		if (!source_path.is_empty()) {
-			if (GDScriptCache::get_cached_script(source_path).is_null()) {
-				MutexLock lock(GDScriptCache::singleton->mutex);
-				GDScriptCache::singleton->shallow_gdscript_cache[source_path] = Ref<GDScript>(this);
-			}
-			if (GDScriptCache::has_parser(source_path)) {
-				Error err = OK;
-				Ref<GDScriptParserRef> parser_ref = GDScriptCache::get_parser(source_path, GDScriptParserRef::EMPTY, err);
-				if (parser_ref.is_valid()) {
-					uint32_t source_hash;
-					if (!binary_tokens.is_empty()) {
-						source_hash = hash_djb2_buffer(binary_tokens.ptr(), binary_tokens.size());
-					} else {
-						source_hash = source.hash();
-					}
-					if (parser_ref->get_source_hash() != source_hash) {
-						GDScriptCache::remove_parser(source_path);
-					}
-				}
+	String source_path = path;
+	if (source_path.is_empty()) {
+		source_path = get_path();
+	}
+	uint32_t source_hash;
+	if (!binary_tokens.is_empty()) {
+		source_hash = hash_djb2_buffer(binary_tokens.ptr(), binary_tokens.size());
+	} else {
+		source_hash = source.hash();
+	}
+
+	if (!source_path.is_empty()) {
+		if (GDScriptCache::get_cached_script(source_path).is_null()) {
+			MutexLock lock(GDScriptCache::singleton->mutex);
+			GDScriptCache::singleton->shallow_gdscript_cache[source_path] = Ref<GDScript>(this);
+		}
+		if (GDScriptCache::has_parser(source_path)) {
+			Error err = OK;
+			Ref<GDScriptParserRef> parser_ref = GDScriptCache::get_parser(source_path, GDScriptParserRef::EMPTY, err);
+			if (parser_ref.is_valid() && parser_ref->get_source_hash() != source_hash) {
+				GDScriptCache::remove_parser(source_path);
 			}
 		}
 	}
@@ -799,9 +801,45 @@ Error GDScript::reload(bool p_keep_state) {
 #endif
 
 	valid = false;
-	GDScriptParser parser;
+
+	if (!precompiled_bytecode.is_empty() && !has_instances) {
+		Error err = GDScriptBytecodeBuffer::load_script(this, precompiled_bytecode);
+		if (err == OK) {
+			can_run = ScriptServer::is_scripting_enabled() || tool;
+			if (can_run) {
+				err = _static_init();
+				if (err) {
+					return err;
+				}
+			}
+
+#ifdef TOOLS_ENABLED
+			if (can_run && p_keep_state) {
+				_restore_old_static_data();
+			}
+#endif
+
+			reloading = false;
+			return OK;
+		}
+
+		// Made by another engine build or damaged, compile from the binary tokens instead.
+		print_verbose(vformat(R"(Precompiled bytecode of "%s" can't be used (%s), compiling it from source.)", path, error_names[err]));
+		precompiled_bytecode.clear();
+	}
+
+	// Use the tree GDScriptCache::parse_ahead() made for this source, if any, instead of parsing it again.
+	Ref<GDScriptParserRef> parsed_ahead;
+	if (!source_path.is_empty()) {
+		parsed_ahead = GDScriptCache::take_parsed_ahead(source_path, source_hash);
+	}
+	GDScriptParser local_parser;
+	GDScriptParser &parser = parsed_ahead.is_valid() ? *parsed_ahead->get_parser() : local_parser;
+
 	Error err;
-	if (!binary_tokens.is_empty()) {
+	if (parsed_ahead.is_valid()) {
+		err = OK; // Only parsers without errors are kept.
+	} else if (!binary_tokens.is_empty()) {
 		err = parser.parse_binary(binary_tokens, path);
 	} else {
 		err = parser.parse(source, path, false);
@@ -816,8 +854,16 @@ Error GDScript::reload(bool p_keep_state) {
 		return ERR_PARSE_ERROR;
 	}
 
-	GDScriptAnalyzer analyzer(&parser);
-	err = analyzer.analyze();
+	if (parsed_ahead.is_valid()) {
+		// Other scripts may have started analyzing it already, so go through its status.
+		err = parsed_ahead->raise_status(GDScriptParserRef::FULLY_SOLVED);
+		if (!err) {
+			err = parsed_ahead->get_analyzer()->resolve_dependencies();
+		}
+	} else {
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+	}
 
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -1130,6 +1176,14 @@ Vector<uint8_t> GDScript::get_as_binary_tokens() const {
 	return tokenizer.parse_code_string(source, GDScriptTokenizerBuffer::COMPRESS_NONE);
 }
 
+void GDScript::set_precompiled_bytecode(const Vector<uint8_t> &p_bytecode) {
+	precompiled_bytecode = p_bytecode;
+}
+
+const Vector<uint8_t> &GDScript::get_precompiled_bytecode() const {
+	return precompiled_bytecode;
+}
+
 const HashMap<StringName, GDScriptFunction *> &GDScript::debug_get_member_functions() const {
 	return member_functions;
 }
@@ -1518,6 +1572,7 @@ void GDScript::clear(ClearData *p_clear_data) {
 		return;
 	}
 	clearing = true;
+	GDScriptInlineCache::invalidate(this);
 
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
@@ -2236,11 +2291,66 @@ void GDScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+	if (!Engine::get_singleton()->is_editor_hint() && ScriptServer::is_scripting_enabled()) {
+		_parse_autoloads_ahead();
+	}
+
+#ifdef DEBUG_ENABLED
+	Ref<GDScriptSamplingProfiler> sampler;
+	sampler.instantiate();
+	sampler->bind("gdscript_sampler");
+	sampling_profiler = sampler;
+#endif
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
 }
 
+void GDScriptLanguage::_parse_autoloads_ahead() {
+	// Autoloads are loaded one after another, which then goes through their whole dependency
+	// chain. Parse their scripts in parallel beforehand, so only analysis and compilation remain.
+	Vector<String> paths;
+	HashSet<String> scenes;
+	List<String> pending;
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		pending.push_back(E.value.path);
+	}
+	while (!pending.is_empty()) {
+		String path = pending.front()->get();
+		pending.pop_front();
+
+		if (path.get_extension().to_lower() == "gd") {
+			paths.push_back(path);
+			continue;
+		}
+		if (scenes.has(path) || ResourceLoader::get_resource_type(path) != "PackedScene") {
+			continue;
+		}
+		scenes.insert(path);
+
+		// Scripts of autoloaded scenes, and the scenes they instance.
+		List<String> dependencies;
+		ResourceLoader::get_dependencies(path, &dependencies);
+		for (const String &dependency : dependencies) {
+			String dependency_path = dependency.get_slice("::", 0);
+			if (dependency_path.begins_with("uid://")) {
+				ResourceUID::ID id = ResourceUID::get_singleton()->text_to_id(dependency_path);
+				if (!ResourceUID::get_singleton()->has_id(id)) {
+					continue;
+				}
+				dependency_path = ResourceUID::get_singleton()->get_id_path(id);
+			}
+			pending.push_back(dependency_path);
+		}
+	}
+
+	if (!paths.is_empty()) {
+		GDScriptCache::parse_ahead(paths);
+		parsed_ahead_pending = true;
+	}
+}
+
 String GDScriptLanguage::get_type() const {
 	return "GDScript";
 }
@@ -2255,6 +2365,11 @@ void GDScriptLanguage::finish() {
 	}
 	finishing = true;
 
+#ifdef DEBUG_ENABLED
+	// Stops the sampling thread and unbinds it.
+	sampling_profiler.unref();
+#endif
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2568,6 +2683,15 @@ void GDScriptLanguage::reload_scripts(const Array &p_scripts, bool p_soft_reload
 		}
 	}
 
+	{
+		// Parse in parallel so the base classes are ready when their subclasses get analyzed.
+		Vector<String> paths;
+		for (const KeyValue<Ref<GDScript>, HashMap<ObjectID, List<Pair<StringName, Variant>>>> &E : to_reload) {
+			paths.push_back(E.key->get_path());
+		}
+		GDScriptCache::parse_ahead(paths);
+	}
+
 	for (KeyValue<Ref<GDScript>, HashMap<ObjectID, List<Pair<StringName, Variant>>>> &E : to_reload) {
 		Ref<GDScript> scr = E.key;
 		print_verbose("GDScript: Reloading: " + scr->get_path());
@@ -2616,6 +2740,7 @@ void GDScriptLanguage::reload_scripts(const Array &p_scripts, bool p_soft_reload
 		//if instance states were saved, set them!
 	}
 
+	GDScriptCache::release_parsed_ahead();
 #endif
 }
 
@@ -2628,6 +2753,12 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 void GDScriptLanguage::frame() {
 	calls = 0;
 
+	if (unlikely(parsed_ahead_pending)) {
+		// Autoloads and the main scene are loaded by now.
+		parsed_ahead_pending = false;
+		GDScriptCache::release_parsed_ahead();
+	}
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(mutex);
@@ -2839,6 +2970,18 @@ String GDScriptLanguage::get_global_class_name(const String &p_path, String *r_b
 }
 
 thread_local GDScriptLanguage::CallStack GDScriptLanguage::_call_stack;
+BinaryMutex GDScriptLanguage::call_stack_registry_mutex;
+LocalVector<GDScriptLanguage::CallStack *> GDScriptLanguage::call_stack_registry;
+
+void GDScriptLanguage::_register_call_stack(CallStack *p_call_stack) {
+	MutexLock lock(call_stack_registry_mutex);
+	call_stack_registry.push_back(p_call_stack);
+}
+
+void GDScriptLanguage::_unregister_call_stack(CallStack *p_call_stack) {
+	MutexLock lock(call_stack_registry_mutex);
+	call_stack_registry.erase(p_call_stack);
+}
 
 GDScriptLanguage::GDScriptLanguage() {
 	calls = 0;
@@ -2870,6 +3013,13 @@ GDScriptLanguage::GDScriptLanguage() {
 		_debug_max_call_stack = 0;
 	}
 
+	GLOBAL_DEF("gdscript/compiler/optimize_bytecode", false);
+	GLOBAL_DEF("gdscript/jit/enabled", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "gdscript/jit/hot_threshold", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"), 1000);
+#ifdef GDSCRIPT_JIT_ENABLED
+	GDScriptJIT::update_settings();
+#endif
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
@@ -2883,6 +3033,7 @@ GDScriptLanguage::GDScriptLanguage() {
 }
 
 GDScriptLanguage::~GDScriptLanguage() {
+	GDScriptFunctionState::clear_stack_pool();
 	singleton = nullptr;
 }
 
@@ -34,11 +34,13 @@
 #include "gdscript_function.h"
 
 #include "core/debugger/engine_debugger.h"
+#include "core/debugger/engine_profiler.h"
 #include "core/debugger/script_debugger.h"
 #include "core/doc_data.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_set.h"
 
 class GDScriptNativeClass : public RefCounted {
@@ -63,6 +65,7 @@ class GDScript : public Script {
 	bool tool = false;
 	bool valid = false;
 	bool reloading = false;
+	SafeFlag inline_cached; // Whether inline caches may reference the members and functions of this script.
 
 	struct MemberInfo {
 		int index = 0;
@@ -84,8 +87,10 @@ class GDScript : public Script {
 	friend class GDScriptInstance;
 	friend class GDScriptFunction;
 	friend class GDScriptAnalyzer;
+	friend class GDScriptBytecodeBuffer;
 	friend class GDScriptCompiler;
 	friend class GDScriptDocGen;
+	friend class GDScriptInlineCache;
 	friend class GDScriptLambdaCallable;
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptLanguage;
@@ -178,6 +183,7 @@ private:
 	//exported members
 	String source;
 	Vector<uint8_t> binary_tokens;
+	Vector<uint8_t> precompiled_bytecode;
 	String path;
 	bool path_valid = false; // False if using default path.
 	StringName local_name; // Inner class identifier or `class_name`.
@@ -308,6 +314,9 @@ public:
 	const Vector<uint8_t> &get_binary_tokens_source() const;
 	Vector<uint8_t> get_as_binary_tokens() const;
 
+	void set_precompiled_bytecode(const Vector<uint8_t> &p_bytecode);
+	const Vector<uint8_t> &get_precompiled_bytecode() const;
+
 	bool get_property_default_value(const StringName &p_property, Variant &r_value) const override;
 
 	virtual void get_script_method_list(List<MethodInfo> *p_list) const override;
@@ -353,6 +362,7 @@ class GDScriptInstance : public ScriptInstance {
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptCompiler;
 	friend class GDScriptCache;
+	friend class GDScriptInlineCache;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
 	ObjectID owner_id;
@@ -424,6 +434,7 @@ class GDScriptLanguage : public ScriptLanguage {
 		GDScriptInstance *instance = nullptr;
 		int *ip = nullptr;
 		int *line = nullptr;
+		MethodBind *native_call = nullptr;
 	};
 
 	static thread_local int _debug_parse_err_line;
@@ -435,6 +446,7 @@ class GDScriptLanguage : public ScriptLanguage {
 
 		void free() {
 			if (levels) {
+				_unregister_call_stack(this);
 				memdelete(levels);
 				levels = nullptr;
 			}
@@ -447,6 +459,12 @@ class GDScriptLanguage : public ScriptLanguage {
 	static thread_local CallStack _call_stack;
 	int _debug_max_call_stack = 0;
 
+	// Call stacks of all threads running scripts, so the sampling profiler can inspect them.
+	static BinaryMutex call_stack_registry_mutex;
+	static LocalVector<CallStack *> call_stack_registry;
+	static void _register_call_stack(CallStack *p_call_stack);
+	static void _unregister_call_stack(CallStack *p_call_stack);
+
 	void _add_global(const StringName &p_name, const Variant &p_value);
 
 	friend class GDScriptInstance;
@@ -457,23 +475,32 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	SelfList<GDScript>::List script_list;
 	friend class GDScriptFunction;
+	friend class GDScriptSamplingProfiler;
+	friend class TestGDScriptSamplingProfilerInternalsAccessor;
 
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
 	bool profile_native_calls;
 	uint64_t script_frame_time;
+#ifdef DEBUG_ENABLED
+	Ref<EngineProfiler> sampling_profiler;
+#endif
 
 	HashMap<String, ObjectID> orphan_subclasses;
 
+	bool parsed_ahead_pending = false;
+	void _parse_autoloads_ahead();
+
 public:
 	int calls;
 
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
-	_FORCE_INLINE_ void enter_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
+	_FORCE_INLINE_ CallLevel *enter_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
 		if (unlikely(_call_stack.levels == nullptr)) {
 			_call_stack.levels = memnew_arr(CallLevel, _debug_max_call_stack + 1);
+			_register_call_stack(&_call_stack);
 		}
 
 		if (EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
@@ -484,15 +511,18 @@ public:
 			//stack overflow
 			_debug_error = vformat("Stack overflow (stack size: %s). Check for infinite recursion in your script.", _debug_max_call_stack);
 			EngineDebugger::get_script_debugger()->debug(this);
-			return;
+			return nullptr;
 		}
 
-		_call_stack.levels[_call_stack.stack_pos].stack = p_stack;
-		_call_stack.levels[_call_stack.stack_pos].instance = p_instance;
-		_call_stack.levels[_call_stack.stack_pos].function = p_function;
-		_call_stack.levels[_call_stack.stack_pos].ip = p_ip;
-		_call_stack.levels[_call_stack.stack_pos].line = p_line;
+		CallLevel *level = &_call_stack.levels[_call_stack.stack_pos];
+		level->stack = p_stack;
+		level->instance = p_instance;
+		level->function = p_function;
+		level->ip = p_ip;
+		level->line = p_line;
+		level->native_call = nullptr;
 		_call_stack.stack_pos++;
+		return level;
 	}
 
 	_FORCE_INLINE_ void exit_function() {
@@ -31,6 +31,7 @@
 #include "gdscript_byte_codegen.h"
 
 #include "gdscript.h"
+#include "gdscript_bytecode_optimizer.h"
 
 #include "core/debugger/engine_debugger.h"
 
@@ -151,6 +152,7 @@ void GDScriptByteCodeGenerator::pop_temporary() {
 void GDScriptByteCodeGenerator::start_parameters() {
 	if (function->_default_arg_count > 0) {
 		append(GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
+		break_comparison_fusion();
 		function->default_arguments.push_back(opcodes.size());
 	}
 }
@@ -196,6 +198,11 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		}
 	}
 
+	if (optimize_bytecode) {
+		// May add constants, so it runs before they are copied into the function.
+		GDScriptByteCodeOptimizer::optimize(this);
+	}
+
 	if (constant_map.size()) {
 		function->_constant_count = constant_map.size();
 		function->constants.resize(constant_map.size());
@@ -400,6 +407,7 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 	}
 	function->_stack_size = GDScriptFunction::FIXED_ADDRESSES_MAX + max_locals + temporaries.size();
 	function->_instruction_args_size = instr_args_max;
+	function->_allocate_inline_caches(inline_cache_count);
 
 #ifdef DEBUG_ENABLED
 	function->operator_names = operator_names;
@@ -425,6 +433,10 @@ void GDScriptByteCodeGenerator::set_initial_line(int p_line) {
 	function->_initial_line = p_line;
 }
 
+void GDScriptByteCodeGenerator::set_optimize_bytecode(bool p_enabled) {
+	optimize_bytecode = p_enabled;
+}
+
 #define HAS_BUILTIN_TYPE(m_var) \
 	(m_var.type.has_type && m_var.type.kind == GDScriptDataType::BUILTIN)
 
@@ -584,6 +596,98 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	}
 }
 
+static GDScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_MULTIPLY_INT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_GREATER_EQUAL_INT;
+			default:
+				return GDScriptFunction::OPCODE_END;
+		}
+	}
+
+	if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_DIVIDE_FLOAT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT;
+			default:
+				return GDScriptFunction::OPCODE_END;
+		}
+	}
+
+	if (p_left_type == Variant::VECTOR2) {
+		if (p_right_type == Variant::VECTOR2) {
+			switch (p_operator) {
+				case Variant::OP_ADD:
+					return GDScriptFunction::OPCODE_ADD_VECTOR2;
+				case Variant::OP_SUBTRACT:
+					return GDScriptFunction::OPCODE_SUBTRACT_VECTOR2;
+				case Variant::OP_MULTIPLY:
+					return GDScriptFunction::OPCODE_MULTIPLY_VECTOR2;
+				default:
+					return GDScriptFunction::OPCODE_END;
+			}
+		}
+		if (p_right_type == Variant::FLOAT && p_operator == Variant::OP_MULTIPLY) {
+			return GDScriptFunction::OPCODE_MULTIPLY_VECTOR2_FLOAT;
+		}
+	}
+
+	if (p_left_type == Variant::VECTOR3) {
+		if (p_right_type == Variant::VECTOR3) {
+			switch (p_operator) {
+				case Variant::OP_ADD:
+					return GDScriptFunction::OPCODE_ADD_VECTOR3;
+				case Variant::OP_SUBTRACT:
+					return GDScriptFunction::OPCODE_SUBTRACT_VECTOR3;
+				case Variant::OP_MULTIPLY:
+					return GDScriptFunction::OPCODE_MULTIPLY_VECTOR3;
+				default:
+					return GDScriptFunction::OPCODE_END;
+			}
+		}
+		if (p_right_type == Variant::FLOAT && p_operator == Variant::OP_MULTIPLY) {
+			return GDScriptFunction::OPCODE_MULTIPLY_VECTOR3_FLOAT;
+		}
+	}
+
+	return GDScriptFunction::OPCODE_END;
+}
+
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
 	// Avoid validated evaluator for modulo and division when operands are int, since there's no check for division by zero.
 	if (HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand) && ((p_operator != Variant::OP_DIVIDE && p_operator != Variant::OP_MODULE) || p_left_operand.type.builtin_type != Variant::INT || p_right_operand.type.builtin_type != Variant::INT)) {
@@ -595,6 +699,20 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		// Common arithmetic and comparisons have opcodes working directly on the values.
+		GDScriptFunction::Opcode typed_opcode = _get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		if (typed_opcode != GDScriptFunction::OPCODE_END) {
+			append_opcode(typed_opcode);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			if (typed_opcode >= GDScriptFunction::OPCODE_EQUAL_INT && typed_opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT) {
+				fusable_comparison_pos = opcodes.size() - 4;
+				fusable_comparison_target = p_target;
+			}
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -664,15 +782,13 @@ void GDScriptByteCodeGenerator::write_type_test(const Address &p_target, const A
 }
 
 void GDScriptByteCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_left_operand);
+	append_jump_if_not(p_left_operand);
 	logic_op_jump_pos1.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_right_operand);
+	append_jump_if_not(p_right_operand);
 	logic_op_jump_pos2.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -728,8 +844,7 @@ void GDScriptByteCodeGenerator::write_start_ternary(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_ternary_condition(const Address &p_condition) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	ternary_jump_fail_pos.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -832,6 +947,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -850,6 +966,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -969,12 +1086,16 @@ void GDScriptByteCodeGenerator::write_assign_default_parameter(const Address &p_
 	} else {
 		write_assign(p_dst, p_src);
 	}
+	break_comparison_fusion();
 	function->default_arguments.push_back(opcodes.size());
 }
 
 void GDScriptByteCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
 	append_opcode(GDScriptFunction::OPCODE_STORE_GLOBAL);
 	append(p_dst);
+#ifdef TOOLS_ENABLED
+	function->global_index_offsets.push_back(opcodes.size());
+#endif
 	append(p_global_index);
 }
 
@@ -1040,6 +1161,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1065,6 +1187,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1299,6 +1422,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1312,6 +1436,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1325,6 +1450,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1442,8 +1568,7 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	if_jmp_addrs.push_back(opcodes.size());
 	append(0); // Jump destination, will be patched.
 }
@@ -1648,13 +1773,13 @@ void GDScriptByteCodeGenerator::write_endfor() {
 
 void GDScriptByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
+	break_comparison_fusion();
 	continue_addrs.push_back(opcodes.size());
 }
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	while_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 }
@@ -36,6 +36,8 @@
 #include "gdscript_utility_functions.h"
 
 class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
+	friend class GDScriptByteCodeOptimizer;
+
 	struct StackSlot {
 		Variant::Type type = Variant::NIL;
 		bool can_contain_object = true;
@@ -76,6 +78,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	bool ended = false;
 	GDScriptFunction *function = nullptr;
 	bool debug_stack = false;
+	bool optimize_bytecode = false;
 
 	Vector<int> opcodes;
 	List<RBMap<StringName, int>> stack_id_stack;
@@ -98,6 +101,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -156,6 +160,10 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	List<int> ternary_jump_fail_pos;
 	List<int> ternary_jump_skip_pos;
 
+	// Last typed comparison, which a conditional jump on its result can be fused into.
+	int fusable_comparison_pos = -1;
+	Address fusable_comparison_target;
+
 	List<List<int>> current_breaks_to_patch;
 
 	void add_stack_identifier(const StringName &p_id, int p_stackpos) {
@@ -395,6 +403,10 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		opcodes.push_back(get_name_map_pos(p_name));
 	}
 
+	void append_inline_cache() {
+		opcodes.push_back(inline_cache_count++);
+	}
+
 	void append(const Variant::ValidatedOperatorEvaluator p_operation) {
 		opcodes.push_back(get_operation_pos(p_operation));
 	}
@@ -449,6 +461,27 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		break_comparison_fusion();
+	}
+
+	// Must be called whenever the current position becomes a jump target,
+	// so the jump never lands between a comparison and the jump it was fused into.
+	void break_comparison_fusion() {
+		if (fusable_comparison_pos >= 0 && fusable_comparison_pos + 4 == opcodes.size()) {
+			fusable_comparison_pos = -1;
+		}
+	}
+
+	// Emits the opcode and condition of a `JUMP_IF_NOT`, the target has to be appended by the caller.
+	void append_jump_if_not(const Address &p_condition) {
+		if (fusable_comparison_pos >= 0 && fusable_comparison_pos + 4 == opcodes.size() && fusable_comparison_target.mode == p_condition.mode && fusable_comparison_target.address == p_condition.address) {
+			// The comparison is right before and still has its result stored, so only the jump target is missing.
+			opcodes.write[fusable_comparison_pos] += GDScriptFunction::OPCODE_EQUAL_INT_JUMP_IF_NOT - GDScriptFunction::OPCODE_EQUAL_INT;
+			fusable_comparison_pos = -1;
+			return;
+		}
+		append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
+		append(p_condition);
 	}
 
 public:
@@ -476,6 +509,7 @@ public:
 	virtual void set_signature(const String &p_signature) override;
 #endif
 	virtual void set_initial_line(int p_line) override;
+	virtual void set_optimize_bytecode(bool p_enabled) override;
 
 	virtual void write_type_adjust(const Address &p_target, Variant::Type p_new_type) override;
 	virtual void write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) override;
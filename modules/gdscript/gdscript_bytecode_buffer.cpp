@@ -0,0 +1,1591 @@
+/**************************************************************************/
+/*  gdscript_bytecode_buffer.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_bytecode_buffer.h"
+
+#include "gdscript_analyzer.h"
+#include "gdscript_cache.h"
+#include "gdscript_compiler.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_utility_functions.h"
+
+#include "core/io/marshalls.h"
+#include "core/version.h"
+
+#define BYTECODE_VERSION 2
+
+enum BytecodeFlags {
+	BYTECODE_FLAG_DEBUG = 1 << 0,
+	BYTECODE_FLAG_REAL_T_IS_DOUBLE = 1 << 1,
+};
+
+enum VariantTag {
+	VARIANT_TAG_VALUE,
+	VARIANT_TAG_READ_ONLY_VALUE,
+	VARIANT_TAG_NULL_OBJECT,
+	VARIANT_TAG_SCRIPT_CLASS, // GDScript class, by script path and fully qualified name.
+	VARIANT_TAG_GLOBAL, // Entry of the `GDScriptLanguage` global array, by name.
+	VARIANT_TAG_RESOURCE, // Resource, by path.
+};
+
+static uint32_t _get_build_flags() {
+	uint32_t flags = 0;
+#ifdef DEBUG_ENABLED
+	flags |= BYTECODE_FLAG_DEBUG;
+#endif
+#ifdef REAL_T_IS_DOUBLE
+	flags |= BYTECODE_FLAG_REAL_T_IS_DOUBLE;
+#endif
+	return flags;
+}
+
+static String _get_build_version() {
+	return String(VERSION_FULL_BUILD) + "." + String(VERSION_HASH);
+}
+
+static void _make_read_only(Variant &p_value) {
+	if (p_value.get_type() == Variant::ARRAY) {
+		Array array = p_value;
+		for (int i = 0; i < array.size(); i++) {
+			Variant element = array[i];
+			_make_read_only(element);
+		}
+		array.make_read_only();
+	} else if (p_value.get_type() == Variant::DICTIONARY) {
+		Dictionary dictionary = p_value;
+		for (const Variant &key : dictionary.keys()) {
+			Variant element = dictionary[key];
+			_make_read_only(element);
+		}
+		dictionary.make_read_only();
+	}
+}
+
+class GDScriptBytecodeBuffer::Reader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+
+	bool _can_read(uint32_t p_bytes) {
+		if (failed || p_bytes > size - position) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	GDScript *root = nullptr;
+	bool failed = false;
+
+	uint8_t get_u8() {
+		if (!_can_read(1)) {
+			return 0;
+		}
+		return data[position++];
+	}
+
+	uint32_t get_u32() {
+		if (!_can_read(4)) {
+			return 0;
+		}
+		uint32_t value = decode_uint32(&data[position]);
+		position += 4;
+		return value;
+	}
+
+	int32_t get_32() { return (int32_t)get_u32(); }
+
+	// Element counts are bounded by the remaining bytes, every element takes at least one.
+	uint32_t get_count() {
+		uint32_t count = get_u32();
+		if (count > size - position) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_string() {
+		uint32_t length = get_u32();
+		if (!_can_read(length)) {
+			return String();
+		}
+		String string = String::utf8(reinterpret_cast<const char *>(&data[position]), length);
+		position += length;
+		return string;
+	}
+
+	StringName get_string_name() { return StringName(get_string()); }
+
+	Variant::Type get_variant_type() {
+		uint32_t type = get_u32();
+		if (type >= Variant::VARIANT_MAX) {
+			failed = true;
+			return Variant::NIL;
+		}
+		return (Variant::Type)type;
+	}
+
+	GDScript *get_script_class() {
+		String path = get_string();
+		String fqcn = get_string();
+		if (failed) {
+			return nullptr;
+		}
+
+		GDScript *script = nullptr;
+		if (path == root->get_script_path()) {
+			script = root->find_class(fqcn);
+		} else {
+			Error err = OK;
+			Ref<GDScript> other = GDScriptCache::get_shallow_script(path, err, root->get_script_path());
+			if (other.is_valid()) {
+				script = other->find_class(fqcn);
+			}
+		}
+		if (script == nullptr) {
+			failed = true;
+		}
+		return script;
+	}
+
+	Variant get_variant() {
+		uint8_t tag = get_u8();
+		switch (tag) {
+			case VARIANT_TAG_VALUE:
+			case VARIANT_TAG_READ_ONLY_VALUE: {
+				uint32_t length = get_u32();
+				if (!_can_read(length)) {
+					return Variant();
+				}
+				Variant value;
+				int used = 0;
+				if (decode_variant(value, &data[position], length, &used, false) != OK || (uint32_t)used != length) {
+					failed = true;
+					return Variant();
+				}
+				position += length;
+				if (tag == VARIANT_TAG_READ_ONLY_VALUE) {
+					_make_read_only(value);
+				}
+				return value;
+			}
+			case VARIANT_TAG_NULL_OBJECT: {
+				return Variant((Object *)nullptr);
+			}
+			case VARIANT_TAG_SCRIPT_CLASS: {
+				return Variant(get_script_class());
+			}
+			case VARIANT_TAG_GLOBAL: {
+				StringName name = get_string_name();
+				const HashMap<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+				HashMap<StringName, int>::ConstIterator E = global_map.find(name);
+				if (!E) {
+					failed = true;
+					return Variant();
+				}
+				return GDScriptLanguage::get_singleton()->get_global_array()[E->value];
+			}
+			case VARIANT_TAG_RESOURCE: {
+				String path = get_string();
+				String type_hint = get_string();
+				if (failed) {
+					return Variant();
+				}
+				Ref<Resource> resource = ResourceLoader::load(path, type_hint);
+				if (resource.is_null()) {
+					failed = true;
+				}
+				return resource;
+			}
+			default: {
+				failed = true;
+				return Variant();
+			}
+		}
+	}
+
+	GDScriptDataType get_data_type() {
+		GDScriptDataType data_type;
+		uint32_t kind = get_u32();
+		if (kind > GDScriptDataType::GDSCRIPT) {
+			failed = true;
+			return data_type;
+		}
+		data_type.kind = (GDScriptDataType::Kind)kind;
+		data_type.has_type = get_u8();
+		data_type.builtin_type = get_variant_type();
+		data_type.native_type = get_string_name();
+
+		if (data_type.kind == GDScriptDataType::SCRIPT || data_type.kind == GDScriptDataType::GDSCRIPT) {
+			bool strong = get_u8();
+			Ref<Script> script = get_variant();
+			if (script.is_null()) {
+				failed = true;
+				return data_type;
+			}
+			data_type.script_type = script.ptr();
+			if (strong) {
+				data_type.script_type_ref = script;
+			}
+		}
+
+		uint32_t element_count = get_count();
+		for (uint32_t i = 0; i < element_count; i++) {
+			data_type.set_container_element_type(i, get_data_type());
+		}
+		return data_type;
+	}
+
+	PropertyInfo get_property_info() {
+		PropertyInfo info;
+		info.type = get_variant_type();
+		info.name = get_string();
+		info.class_name = get_string_name();
+		info.hint = (PropertyHint)get_u32();
+		info.hint_string = get_string();
+		info.usage = get_u32();
+		return info;
+	}
+
+	MethodInfo get_method_info() {
+		MethodInfo info;
+		info.name = get_string();
+		info.return_val = get_property_info();
+		info.flags = get_u32();
+		info.id = get_32();
+		uint32_t argument_count = get_count();
+		for (uint32_t i = 0; i < argument_count; i++) {
+			info.arguments.push_back(get_property_info());
+		}
+		uint32_t default_count = get_count();
+		for (uint32_t i = 0; i < default_count; i++) {
+			info.default_arguments.push_back(get_variant());
+		}
+		info.return_val_metadata = get_32();
+		uint32_t metadata_count = get_count();
+		for (uint32_t i = 0; i < metadata_count; i++) {
+			info.arguments_metadata.push_back(get_32());
+		}
+		return info;
+	}
+
+	Reader(const Vector<uint8_t> &p_buffer) {
+		data = p_buffer.ptr();
+		size = p_buffer.size();
+	}
+};
+
+#ifdef TOOLS_ENABLED
+
+class GDScriptBytecodeBuffer::Writer {
+	LocalVector<uint8_t> data;
+
+	bool tables_built = false;
+	HashMap<ObjectID, StringName> global_objects;
+	HashMap<int, StringName> global_names;
+
+	static bool _has_unsupported_values(const Variant &p_value) {
+		switch (p_value.get_type()) {
+			case Variant::OBJECT:
+			case Variant::CALLABLE:
+			case Variant::SIGNAL:
+			case Variant::RID:
+				return true;
+			case Variant::ARRAY: {
+				Array array = p_value;
+				if (array.get_typed_script() != Variant()) {
+					return true;
+				}
+				for (int i = 0; i < array.size(); i++) {
+					if (_has_unsupported_values(array[i])) {
+						return true;
+					}
+				}
+				return false;
+			}
+			case Variant::DICTIONARY: {
+				Dictionary dictionary = p_value;
+				for (const Variant &key : dictionary.keys()) {
+					if (_has_unsupported_values(key) || _has_unsupported_values(dictionary[key])) {
+						return true;
+					}
+				}
+				return false;
+			}
+			default:
+				return false;
+		}
+	}
+
+	struct OperatorKey {
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type type_a = Variant::NIL;
+		Variant::Type type_b = Variant::NIL;
+	};
+
+	// Reverse lookups from the validated function pointers held by compiled functions
+	// to the keys the runtime uses to look them up again.
+	RBMap<Variant::ValidatedOperatorEvaluator, OperatorKey> operators;
+	RBMap<Variant::ValidatedSetter, Pair<Variant::Type, StringName>> setters;
+	RBMap<Variant::ValidatedGetter, Pair<Variant::Type, StringName>> getters;
+	RBMap<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setters;
+	RBMap<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getters;
+	RBMap<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setters;
+	RBMap<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getters;
+	RBMap<Variant::ValidatedBuiltInMethod, Pair<Variant::Type, StringName>> builtin_methods;
+	RBMap<Variant::ValidatedConstructor, Pair<Variant::Type, int>> constructors;
+	RBMap<Variant::ValidatedUtilityFunction, StringName> utilities;
+	RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utilities;
+
+	void _build_tables() {
+		if (tables_built) {
+			return;
+		}
+		tables_built = true;
+
+		const HashMap<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+		const Variant *global_array = GDScriptLanguage::get_singleton()->get_global_array();
+		for (const KeyValue<StringName, int> &E : global_map) {
+			global_names.insert(E.value, E.key);
+			const Variant &global = global_array[E.value];
+			if (global.get_type() == Variant::OBJECT && global.get_validated_object() != nullptr) {
+				global_objects.insert(global.get_validated_object()->get_instance_id(), E.key);
+			}
+		}
+
+		for (int type_index = 0; type_index < Variant::VARIANT_MAX; type_index++) {
+			Variant::Type type = (Variant::Type)type_index;
+
+			for (int op = 0; op < Variant::OP_MAX; op++) {
+				for (int type_b = 0; type_b < Variant::VARIANT_MAX; type_b++) {
+					Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)op, type, (Variant::Type)type_b);
+					if (evaluator && !operators.has(evaluator)) {
+						operators.insert(evaluator, { (Variant::Operator)op, type, (Variant::Type)type_b });
+					}
+				}
+			}
+
+			List<StringName> members;
+			Variant::get_member_list(type, &members);
+			for (const StringName &member : members) {
+				Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, member);
+				if (setter && !setters.has(setter)) {
+					setters.insert(setter, Pair<Variant::Type, StringName>(type, member));
+				}
+				Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, member);
+				if (getter && !getters.has(getter)) {
+					getters.insert(getter, Pair<Variant::Type, StringName>(type, member));
+				}
+			}
+
+			if (Variant::is_keyed(type)) {
+				Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(type);
+				if (keyed_setter && !keyed_setters.has(keyed_setter)) {
+					keyed_setters.insert(keyed_setter, type);
+				}
+				Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(type);
+				if (keyed_getter && !keyed_getters.has(keyed_getter)) {
+					keyed_getters.insert(keyed_getter, type);
+				}
+			}
+
+			if (Variant::has_indexing(type)) {
+				Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(type);
+				if (indexed_setter && !indexed_setters.has(indexed_setter)) {
+					indexed_setters.insert(indexed_setter, type);
+				}
+				Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(type);
+				if (indexed_getter && !indexed_getters.has(indexed_getter)) {
+					indexed_getters.insert(indexed_getter, type);
+				}
+			}
+
+			List<StringName> methods;
+			Variant::get_builtin_method_list(type, &methods);
+			for (const StringName &method : methods) {
+				Variant::ValidatedBuiltInMethod builtin_method = Variant::get_validated_builtin_method(type, method);
+				if (builtin_method && !builtin_methods.has(builtin_method)) {
+					builtin_methods.insert(builtin_method, Pair<Variant::Type, StringName>(type, method));
+				}
+			}
+
+			for (int i = 0; i < Variant::get_constructor_count(type); i++) {
+				Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(type, i);
+				if (constructor && !constructors.has(constructor)) {
+					constructors.insert(constructor, Pair<Variant::Type, int>(type, i));
+				}
+			}
+		}
+
+		List<StringName> functions;
+		Variant::get_utility_function_list(&functions);
+		for (const StringName &function : functions) {
+			Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(function);
+			if (utility && !utilities.has(utility)) {
+				utilities.insert(utility, function);
+			}
+		}
+
+		functions.clear();
+		GDScriptUtilityFunctions::get_function_list(&functions);
+		for (const StringName &function : functions) {
+			GDScriptUtilityFunctions::FunctionPtr gds_utility = GDScriptUtilityFunctions::get_function(function);
+			if (gds_utility && !gds_utilities.has(gds_utility)) {
+				gds_utilities.insert(gds_utility, function);
+			}
+		}
+	}
+
+
+	template <typename K, typename V>
+	static const V *_lookup(const RBMap<K, V> &p_map, const K &p_key) {
+		const typename RBMap<K, V>::Element *E = p_map.find(p_key);
+		return E ? &E->get() : nullptr;
+	}
+
+	void _unknown_pointer(const char *p_what) {
+		error = ERR_BUG;
+		ERR_PRINT(vformat("Can't serialize GDScript bytecode: unknown %s.", p_what));
+	}
+
+public:
+	Error error = OK;
+	// Leave out what only debug builds read back.
+	bool release = false;
+
+	void put_u8(uint8_t p_value) { data.push_back(p_value); }
+
+	void put_u32(uint32_t p_value) {
+		uint32_t position = data.size();
+		data.resize(position + 4);
+		encode_uint32(p_value, &data[position]);
+	}
+
+	void put_32(int32_t p_value) { put_u32((uint32_t)p_value); }
+
+	void put_string(const String &p_string) {
+		CharString utf8 = p_string.utf8();
+		put_u32(utf8.length());
+		uint32_t position = data.size();
+		data.resize(position + utf8.length());
+		memcpy(&data[position], utf8.get_data(), utf8.length());
+	}
+
+	void put_variant(const Variant &p_value) {
+		if (p_value.get_type() == Variant::OBJECT) {
+			put_object(p_value.get_validated_object());
+			return;
+		}
+		if (_has_unsupported_values(p_value)) {
+			error = ERR_UNAVAILABLE;
+			put_u8(VARIANT_TAG_VALUE);
+			put_u32(0);
+			return;
+		}
+
+		bool read_only = (p_value.get_type() == Variant::ARRAY && Array(p_value).is_read_only()) ||
+				(p_value.get_type() == Variant::DICTIONARY && Dictionary(p_value).is_read_only());
+		put_u8(read_only ? VARIANT_TAG_READ_ONLY_VALUE : VARIANT_TAG_VALUE);
+
+		int length = 0;
+		Error err = encode_variant(p_value, nullptr, length, false);
+		if (err != OK) {
+			error = err;
+			put_u32(0);
+			return;
+		}
+		put_u32(length);
+		uint32_t position = data.size();
+		data.resize(position + length);
+		encode_variant(p_value, &data[position], length, false);
+	}
+
+	void put_object(Object *p_object) {
+		if (p_object == nullptr) {
+			put_u8(VARIANT_TAG_NULL_OBJECT);
+			return;
+		}
+
+		GDScript *script = Object::cast_to<GDScript>(p_object);
+		if (script != nullptr) {
+			if (!script->get_script_path().is_resource_file()) {
+				error = ERR_UNAVAILABLE; // Built-in scripts can't be loaded on their own.
+			}
+			put_u8(VARIANT_TAG_SCRIPT_CLASS);
+			put_string(script->get_script_path());
+			put_string(script->get_fully_qualified_name());
+			return;
+		}
+
+		_build_tables();
+		HashMap<ObjectID, StringName>::ConstIterator global = global_objects.find(p_object->get_instance_id());
+		if (global) {
+			put_u8(VARIANT_TAG_GLOBAL);
+			put_string(global->value);
+			return;
+		}
+
+		Resource *resource = Object::cast_to<Resource>(p_object);
+		if (resource == nullptr || !resource->get_path().is_resource_file()) {
+			error = ERR_UNAVAILABLE;
+		}
+		put_u8(VARIANT_TAG_RESOURCE);
+		put_string(resource ? resource->get_path() : String());
+		put_string(p_object->get_class());
+	}
+
+	void put_data_type(const GDScriptDataType &p_data_type) {
+		put_u32(p_data_type.kind);
+		put_u8(p_data_type.has_type);
+		put_u32(p_data_type.builtin_type);
+		put_string(p_data_type.native_type);
+
+		if (p_data_type.kind == GDScriptDataType::SCRIPT || p_data_type.kind == GDScriptDataType::GDSCRIPT) {
+			put_u8(p_data_type.script_type_ref.is_valid());
+			put_object(p_data_type.script_type);
+		}
+
+		put_u32(p_data_type.container_element_types.size());
+		for (const GDScriptDataType &element_type : p_data_type.container_element_types) {
+			put_data_type(element_type);
+		}
+	}
+
+	void put_property_info(const PropertyInfo &p_info) {
+		put_u32(p_info.type);
+		put_string(p_info.name);
+		put_string(p_info.class_name);
+		put_u32(p_info.hint);
+		put_string(p_info.hint_string);
+		put_u32(p_info.usage);
+	}
+
+	void put_method_info(const MethodInfo &p_info) {
+		put_string(p_info.name);
+		put_property_info(p_info.return_val);
+		put_u32(p_info.flags);
+		put_32(p_info.id);
+		put_u32(p_info.arguments.size());
+		for (const PropertyInfo &argument : p_info.arguments) {
+			put_property_info(argument);
+		}
+		put_u32(p_info.default_arguments.size());
+		for (const Variant &default_argument : p_info.default_arguments) {
+			put_variant(default_argument);
+		}
+		put_32(p_info.return_val_metadata);
+		put_u32(p_info.arguments_metadata.size());
+		for (int metadata : p_info.arguments_metadata) {
+			put_32(metadata);
+		}
+	}
+
+	void put_global(int p_index) {
+		_build_tables();
+		HashMap<int, StringName>::ConstIterator E = global_names.find(p_index);
+		if (!E) {
+			_unknown_pointer("global");
+			put_string(String());
+			return;
+		}
+		put_string(E->value);
+	}
+
+	void put_operator(Variant::ValidatedOperatorEvaluator p_evaluator) {
+		_build_tables();
+		const OperatorKey *key = _lookup(operators, p_evaluator);
+		if (key == nullptr) {
+			_unknown_pointer("operator evaluator");
+			return;
+		}
+		put_u32(key->op);
+		put_u32(key->type_a);
+		put_u32(key->type_b);
+	}
+
+	void put_setter(Variant::ValidatedSetter p_function) {
+		_build_tables();
+		const Pair<Variant::Type, StringName> *key = _lookup(setters, p_function);
+		if (key == nullptr) {
+			_unknown_pointer("member setter");
+			return;
+		}
+		put_u32(key->first);
+		put_string(key->second);
+	}
+
+	void put_getter(Variant::ValidatedGetter p_function) {
+		_build_tables();
+		const Pair<Variant::Type, StringName> *key = _lookup(getters, p_function);
+		if (key == nullptr) {
+			_unknown_pointer("member getter");
+			return;
+		}
+		put_u32(key->first);
+		put_string(key->second);
+	}
+
+	void put_keyed_setter(Variant::ValidatedKeyedSetter p_function) {
+		_build_tables();
+		const Variant::Type *type = _lookup(keyed_setters, p_function);
+		if (type == nullptr) {
+			_unknown_pointer("keyed setter");
+			return;
+		}
+		put_u32(*type);
+	}
+
+	void put_keyed_getter(Variant::ValidatedKeyedGetter p_function) {
+		_build_tables();
+		const Variant::Type *type = _lookup(keyed_getters, p_function);
+		if (type == nullptr) {
+			_unknown_pointer("keyed getter");
+			return;
+		}
+		put_u32(*type);
+	}
+
+	void put_indexed_setter(Variant::ValidatedIndexedSetter p_function) {
+		_build_tables();
+		const Variant::Type *type = _lookup(indexed_setters, p_function);
+		if (type == nullptr) {
+			_unknown_pointer("indexed setter");
+			return;
+		}
+		put_u32(*type);
+	}
+
+	void put_indexed_getter(Variant::ValidatedIndexedGetter p_function) {
+		_build_tables();
+		const Variant::Type *type = _lookup(indexed_getters, p_function);
+		if (type == nullptr) {
+			_unknown_pointer("indexed getter");
+			return;
+		}
+		put_u32(*type);
+	}
+
+	void put_builtin_method(Variant::ValidatedBuiltInMethod p_function) {
+		_build_tables();
+		const Pair<Variant::Type, StringName> *key = _lookup(builtin_methods, p_function);
+		if (key == nullptr) {
+			_unknown_pointer("built-in method");
+			return;
+		}
+		put_u32(key->first);
+		put_string(key->second);
+	}
+
+	void put_constructor(Variant::ValidatedConstructor p_function) {
+		_build_tables();
+		const Pair<Variant::Type, int> *key = _lookup(constructors, p_function);
+		if (key == nullptr) {
+			_unknown_pointer("constructor");
+			return;
+		}
+		put_u32(key->first);
+		put_32(key->second);
+	}
+
+	void put_utility(Variant::ValidatedUtilityFunction p_function) {
+		_build_tables();
+		const StringName *name = _lookup(utilities, p_function);
+		if (name == nullptr) {
+			_unknown_pointer("utility function");
+			return;
+		}
+		put_string(*name);
+	}
+
+	void put_gds_utility(GDScriptUtilityFunctions::FunctionPtr p_function) {
+		_build_tables();
+		const StringName *name = _lookup(gds_utilities, p_function);
+		if (name == nullptr) {
+			_unknown_pointer("GDScript utility function");
+			return;
+		}
+		put_string(*name);
+	}
+
+	Vector<uint8_t> get_data() const {
+		Vector<uint8_t> buffer;
+		buffer.resize(data.size());
+		if (data.size()) {
+			memcpy(buffer.ptrw(), data.ptr(), data.size());
+		}
+		return buffer;
+	}
+};
+
+#endif // TOOLS_ENABLED
+
+String GDScriptBytecodeBuffer::get_bytecode_path(const String &p_binary_tokens_path) {
+	return p_binary_tokens_path.get_basename() + ".gdbc";
+}
+
+Error GDScriptBytecodeBuffer::_read_header(Reader &p_reader, const GDScript *p_script) {
+	uint8_t magic[4];
+	for (int i = 0; i < 4; i++) {
+		magic[i] = p_reader.get_u8();
+	}
+	ERR_FAIL_COND_V_MSG(p_reader.failed || magic[0] != 'G' || magic[1] != 'D' || magic[2] != 'B' || magic[3] != 'C', ERR_FILE_UNRECOGNIZED, "Invalid precompiled GDScript bytecode.");
+
+	// Anything below is expected to differ between engine builds, so mismatches are not errors.
+	if (p_reader.get_u32() != BYTECODE_VERSION || p_reader.get_u32() != _get_build_flags()) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (p_reader.get_string() != _get_build_version()) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (p_reader.get_u32() != GDScriptFunction::OPCODE_END || p_reader.get_u32() != Variant::VARIANT_MAX || p_reader.get_u32() != Variant::OP_MAX) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	// The bytecode must come from the same source as the tokens it ships with.
+	uint32_t source_hash = p_reader.get_u32();
+	const Vector<uint8_t> &binary_tokens = p_script->binary_tokens;
+	if (binary_tokens.is_empty() || source_hash != hash_djb2_buffer(binary_tokens.ptr(), binary_tokens.size())) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	return p_reader.failed ? ERR_FILE_CORRUPT : OK;
+}
+
+Error GDScriptBytecodeBuffer::_read_class_layout(Reader &p_reader, GDScript *p_script) {
+	p_script->fully_qualified_name = p_reader.get_string();
+	p_script->local_name = p_reader.get_string_name();
+	p_script->global_name = p_reader.get_string_name();
+	p_script->simplified_icon_path = p_reader.get_string();
+
+	HashMap<StringName, Ref<GDScript>> old_subclasses = p_script->subclasses;
+	p_script->subclasses.clear();
+
+	uint32_t subclass_count = p_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		StringName name = p_reader.get_string_name();
+		ERR_FAIL_COND_V(p_reader.failed, ERR_FILE_CORRUPT);
+
+		Ref<GDScript> subclass;
+		if (old_subclasses.has(name)) {
+			subclass = old_subclasses[name];
+		} else {
+			subclass.instantiate();
+		}
+
+		subclass->_owner = p_script;
+		subclass->path = p_script->path;
+		p_script->subclasses.insert(name, subclass);
+
+		Error err = _read_class_layout(p_reader, subclass.ptr());
+		if (err) {
+			return err;
+		}
+	}
+
+	return p_reader.failed ? ERR_FILE_CORRUPT : OK;
+}
+
+void GDScriptBytecodeBuffer::_clear_class(GDScript *p_script) {
+	// Same as the reset done by `GDScriptCompiler::_prepare_compilation()`.
+	p_script->clearing = true;
+	GDScriptInlineCache::invalidate(p_script);
+
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = nullptr;
+	p_script->members.clear();
+
+	// This makes possible to clear script constants and member_functions without heap-use-after-free errors.
+	HashMap<StringName, Variant> constants;
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		constants.insert(E.key, E.value);
+	}
+	p_script->constants.clear();
+	constants.clear();
+	HashMap<StringName, GDScriptFunction *> member_functions;
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		member_functions.insert(E.key, E.value);
+	}
+	p_script->member_functions.clear();
+	for (const KeyValue<StringName, GDScriptFunction *> &E : member_functions) {
+		memdelete(E.value);
+	}
+
+	if (p_script->implicit_initializer) {
+		memdelete(p_script->implicit_initializer);
+	}
+	if (p_script->implicit_ready) {
+		memdelete(p_script->implicit_ready);
+	}
+	if (p_script->static_initializer) {
+		memdelete(p_script->static_initializer);
+	}
+
+	p_script->member_indices.clear();
+	p_script->static_variables_indices.clear();
+	p_script->static_variables.clear();
+	p_script->_signals.clear();
+	p_script->initializer = nullptr;
+	p_script->implicit_initializer = nullptr;
+	p_script->implicit_ready = nullptr;
+	p_script->static_initializer = nullptr;
+	p_script->rpc_config.clear();
+	p_script->lambda_info.clear();
+
+	p_script->clearing = false;
+}
+
+bool GDScriptBytecodeBuffer::_read_member_info(Reader &p_reader, GDScript::MemberInfo &r_member_info) {
+	r_member_info.index = p_reader.get_32();
+	r_member_info.setter = p_reader.get_string_name();
+	r_member_info.getter = p_reader.get_string_name();
+	r_member_info.data_type = p_reader.get_data_type();
+	r_member_info.property_info = p_reader.get_property_info();
+	return !p_reader.failed;
+}
+
+Error GDScriptBytecodeBuffer::_read_class(Reader &p_reader, GDScript *p_script) {
+	_clear_class(p_script);
+
+	p_script->tool = p_reader.get_u8();
+
+	StringName native_name = p_reader.get_string_name();
+	HashMap<StringName, int>::ConstIterator native_index = GDScriptLanguage::get_singleton()->get_global_map().find(native_name);
+	ERR_FAIL_COND_V(!native_index, ERR_CANT_RESOLVE);
+	p_script->native = GDScriptLanguage::get_singleton()->get_global_array()[native_index->value];
+	ERR_FAIL_COND_V(p_script->native.is_null(), ERR_CANT_RESOLVE);
+
+	if (p_reader.get_u8()) {
+		Ref<GDScript> base = p_reader.get_script_class();
+		ERR_FAIL_COND_V(base.is_null(), ERR_CANT_RESOLVE);
+		p_script->base = base;
+		p_script->_base = base.ptr();
+	}
+
+	uint32_t member_count = p_reader.get_count();
+	for (uint32_t i = 0; i < member_count; i++) {
+		StringName name = p_reader.get_string_name();
+		GDScript::MemberInfo member_info;
+		if (!_read_member_info(p_reader, member_info)) {
+			return ERR_FILE_CORRUPT;
+		}
+		p_script->member_indices.insert(name, member_info);
+	}
+
+	uint32_t own_member_count = p_reader.get_count();
+	for (uint32_t i = 0; i < own_member_count; i++) {
+		p_script->members.insert(p_reader.get_string_name());
+	}
+
+	uint32_t static_variable_count = p_reader.get_count();
+	for (uint32_t i = 0; i < static_variable_count; i++) {
+		StringName name = p_reader.get_string_name();
+		GDScript::MemberInfo member_info;
+		if (!_read_member_info(p_reader, member_info)) {
+			return ERR_FILE_CORRUPT;
+		}
+		p_script->static_variables_indices.insert(name, member_info);
+	}
+	p_script->static_variables.resize(p_script->static_variables_indices.size());
+
+	uint32_t constant_count = p_reader.get_count();
+	for (uint32_t i = 0; i < constant_count; i++) {
+		StringName name = p_reader.get_string_name();
+		p_script->constants.insert(name, p_reader.get_variant());
+	}
+
+	uint32_t signal_count = p_reader.get_count();
+	for (uint32_t i = 0; i < signal_count; i++) {
+		StringName name = p_reader.get_string_name();
+		p_script->_signals[name] = p_reader.get_method_info();
+	}
+
+	p_script->rpc_config = p_reader.get_variant();
+	ERR_FAIL_COND_V(p_reader.failed, ERR_FILE_CORRUPT);
+
+	uint32_t function_count = p_reader.get_count();
+	for (uint32_t i = 0; i < function_count; i++) {
+		GDScriptFunction *function = _read_function(p_reader, p_script, false);
+		if (function == nullptr) {
+			return ERR_FILE_CORRUPT;
+		}
+		p_script->member_functions[function->name] = function;
+	}
+
+	HashMap<StringName, GDScriptFunction *>::Iterator initializer = p_script->member_functions.find(GDScriptLanguage::get_singleton()->strings._init);
+	if (initializer) {
+		p_script->initializer = initializer->value;
+	}
+
+	GDScriptFunction **implicit_functions[] = { &p_script->implicit_initializer, &p_script->implicit_ready, &p_script->static_initializer };
+	for (GDScriptFunction **implicit_function : implicit_functions) {
+		if (p_reader.get_u8()) {
+			*implicit_function = _read_function(p_reader, p_script, false);
+			if (*implicit_function == nullptr) {
+				return ERR_FILE_CORRUPT;
+			}
+		}
+	}
+
+	uint32_t subclass_count = p_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		StringName name = p_reader.get_string_name();
+		HashMap<StringName, Ref<GDScript>>::Iterator subclass = p_script->subclasses.find(name);
+		ERR_FAIL_COND_V(!subclass, ERR_FILE_CORRUPT);
+
+		Error err = _read_class(p_reader, subclass->value.ptr());
+		if (err) {
+			return err;
+		}
+	}
+
+	p_script->_static_default_init();
+
+	p_script->valid = true;
+	return OK;
+}
+
+GDScriptFunction *GDScriptBytecodeBuffer::_read_function(Reader &p_reader, GDScript *p_script, bool p_is_lambda) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	function->_script = p_script;
+	function->source = p_script->get_script_path();
+	function->name = p_reader.get_string_name();
+
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+#endif
+
+	function->_static = p_reader.get_u8();
+	uint32_t argument_type_count = p_reader.get_count();
+	for (uint32_t i = 0; i < argument_type_count; i++) {
+		function->argument_types.push_back(p_reader.get_data_type());
+	}
+	function->return_type = p_reader.get_data_type();
+	function->method_info = p_reader.get_method_info();
+	function->rpc_config = p_reader.get_variant();
+
+	function->_initial_line = p_reader.get_32();
+	function->_argument_count = p_reader.get_32();
+	function->_stack_size = p_reader.get_32();
+	function->_instruction_args_size = p_reader.get_32();
+	int inline_cache_count = p_reader.get_32();
+
+	uint32_t temporary_slot_count = p_reader.get_count();
+	for (uint32_t i = 0; i < temporary_slot_count; i++) {
+		int slot = p_reader.get_32();
+		function->temporary_slots[slot] = p_reader.get_variant_type();
+	}
+
+	uint32_t stack_debug_count = p_reader.get_count();
+	for (uint32_t i = 0; i < stack_debug_count; i++) {
+		GDScriptFunction::StackDebug stack_debug;
+		stack_debug.line = p_reader.get_32();
+		stack_debug.pos = p_reader.get_32();
+		stack_debug.added = p_reader.get_u8();
+		stack_debug.identifier = p_reader.get_string_name();
+		function->stack_debug.push_back(stack_debug);
+	}
+
+	uint32_t code_size = p_reader.get_count();
+	function->code.resize(code_size);
+	for (uint32_t i = 0; i < code_size; i++) {
+		function->code.write[i] = p_reader.get_32();
+	}
+
+	// Global indices depend on registration order, which differs between the editor and export templates.
+	uint32_t relocation_count = p_reader.get_count();
+	for (uint32_t i = 0; i < relocation_count; i++) {
+		uint32_t offset = p_reader.get_u32();
+		StringName global = p_reader.get_string_name();
+		HashMap<StringName, int>::ConstIterator index = GDScriptLanguage::get_singleton()->get_global_map().find(global);
+		if (offset >= code_size || !index) {
+			p_reader.failed = true;
+			break;
+		}
+		function->code.write[offset] = index->value;
+	}
+
+	uint32_t default_argument_count = p_reader.get_count();
+	for (uint32_t i = 0; i < default_argument_count; i++) {
+		function->default_arguments.push_back(p_reader.get_32());
+	}
+
+	uint32_t constant_count = p_reader.get_count();
+	for (uint32_t i = 0; i < constant_count; i++) {
+		function->constants.push_back(p_reader.get_variant());
+	}
+
+	uint32_t global_name_count = p_reader.get_count();
+	for (uint32_t i = 0; i < global_name_count; i++) {
+		function->global_names.push_back(p_reader.get_string_name());
+	}
+
+	uint32_t operator_count = p_reader.get_count();
+	for (uint32_t i = 0; i < operator_count && !p_reader.failed; i++) {
+		uint32_t op = p_reader.get_u32();
+		Variant::Type type_a = p_reader.get_variant_type();
+		Variant::Type type_b = p_reader.get_variant_type();
+		Variant::ValidatedOperatorEvaluator evaluator = op < Variant::OP_MAX ? Variant::get_validated_operator_evaluator((Variant::Operator)op, type_a, type_b) : nullptr;
+		p_reader.failed = p_reader.failed || evaluator == nullptr;
+		function->operator_funcs.push_back(evaluator);
+	}
+
+	uint32_t setter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < setter_count && !p_reader.failed; i++) {
+		Variant::Type type = p_reader.get_variant_type();
+		Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || setter == nullptr;
+		function->setters.push_back(setter);
+	}
+
+	uint32_t getter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < getter_count && !p_reader.failed; i++) {
+		Variant::Type type = p_reader.get_variant_type();
+		Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || getter == nullptr;
+		function->getters.push_back(getter);
+	}
+
+	uint32_t keyed_setter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < keyed_setter_count && !p_reader.failed; i++) {
+		Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(p_reader.get_variant_type());
+		p_reader.failed = p_reader.failed || keyed_setter == nullptr;
+		function->keyed_setters.push_back(keyed_setter);
+	}
+
+	uint32_t keyed_getter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < keyed_getter_count && !p_reader.failed; i++) {
+		Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(p_reader.get_variant_type());
+		p_reader.failed = p_reader.failed || keyed_getter == nullptr;
+		function->keyed_getters.push_back(keyed_getter);
+	}
+
+	uint32_t indexed_setter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < indexed_setter_count && !p_reader.failed; i++) {
+		Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(p_reader.get_variant_type());
+		p_reader.failed = p_reader.failed || indexed_setter == nullptr;
+		function->indexed_setters.push_back(indexed_setter);
+	}
+
+	uint32_t indexed_getter_count = p_reader.get_count();
+	for (uint32_t i = 0; i < indexed_getter_count && !p_reader.failed; i++) {
+		Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(p_reader.get_variant_type());
+		p_reader.failed = p_reader.failed || indexed_getter == nullptr;
+		function->indexed_getters.push_back(indexed_getter);
+	}
+
+	uint32_t builtin_method_count = p_reader.get_count();
+	for (uint32_t i = 0; i < builtin_method_count && !p_reader.failed; i++) {
+		Variant::Type type = p_reader.get_variant_type();
+		Variant::ValidatedBuiltInMethod builtin_method = Variant::get_validated_builtin_method(type, p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || builtin_method == nullptr;
+		function->builtin_methods.push_back(builtin_method);
+	}
+
+	uint32_t constructor_count = p_reader.get_count();
+	for (uint32_t i = 0; i < constructor_count && !p_reader.failed; i++) {
+		Variant::Type type = p_reader.get_variant_type();
+		int index = p_reader.get_32();
+		Variant::ValidatedConstructor constructor = index >= 0 && index < Variant::get_constructor_count(type) ? Variant::get_validated_constructor(type, index) : nullptr;
+		p_reader.failed = p_reader.failed || constructor == nullptr;
+		function->constructors.push_back(constructor);
+	}
+
+	uint32_t utility_count = p_reader.get_count();
+	for (uint32_t i = 0; i < utility_count && !p_reader.failed; i++) {
+		Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || utility == nullptr;
+		function->utilities.push_back(utility);
+	}
+
+	uint32_t gds_utility_count = p_reader.get_count();
+	for (uint32_t i = 0; i < gds_utility_count && !p_reader.failed; i++) {
+		GDScriptUtilityFunctions::FunctionPtr gds_utility = GDScriptUtilityFunctions::get_function(p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || gds_utility == nullptr;
+		function->gds_utilities.push_back(gds_utility);
+	}
+
+	uint32_t method_count = p_reader.get_count();
+	for (uint32_t i = 0; i < method_count && !p_reader.failed; i++) {
+		StringName class_name = p_reader.get_string_name();
+		MethodBind *method = ClassDB::get_method(class_name, p_reader.get_string_name());
+		p_reader.failed = p_reader.failed || method == nullptr;
+		function->methods.push_back(method);
+	}
+
+	uint32_t lambda_count = p_reader.get_count();
+	for (uint32_t i = 0; i < lambda_count && !p_reader.failed; i++) {
+		GDScript::LambdaInfo lambda_info;
+		lambda_info.capture_count = p_reader.get_32();
+		lambda_info.use_self = p_reader.get_u8();
+		GDScriptFunction *lambda = _read_function(p_reader, p_script, true);
+		if (lambda == nullptr) {
+			p_reader.failed = true;
+			break;
+		}
+		function->lambdas.push_back(lambda);
+		p_script->lambda_info.insert(lambda, lambda_info);
+	}
+
+#ifdef DEBUG_ENABLED
+	Vector<String> *debug_names[] = {
+		&function->operator_names,
+		&function->setter_names,
+		&function->getter_names,
+		&function->builtin_methods_names,
+		&function->constructors_names,
+		&function->utilities_names,
+		&function->gds_utilities_names,
+	};
+	for (Vector<String> *names : debug_names) {
+		uint32_t name_count = p_reader.get_count();
+		for (uint32_t i = 0; i < name_count; i++) {
+			names->push_back(p_reader.get_string());
+		}
+	}
+
+	if (EngineDebugger::is_active()) {
+		// Same format as the signatures made by `GDScriptCompiler` for the profiler.
+		String signature = String(function->source) + "::" + itos(function->_initial_line);
+		if (p_script->local_name != StringName()) {
+			signature += "::" + String(p_script->local_name) + "." + String(function->name);
+		} else {
+			signature += "::" + String(function->name);
+		}
+		if (p_is_lambda) {
+			signature += "(lambda)";
+		}
+		function->profile.signature = signature;
+	}
+#endif
+
+	if (inline_cache_count < 0 || inline_cache_count > function->code.size()) {
+		// Each cache is referenced by one code operand.
+		p_reader.failed = true;
+	}
+
+	if (p_reader.failed) {
+		memdelete(function);
+		return nullptr;
+	}
+
+	// Publish the tables like `GDScriptByteCodeGenerator::write_end()` does.
+	function->_code_size = function->code.size();
+	function->_code_ptr = function->_code_size ? function->code.ptrw() : nullptr;
+	function->_allocate_inline_caches(inline_cache_count);
+	function->_default_arg_count = function->default_arguments.size() ? function->default_arguments.size() - 1 : 0;
+	function->_default_arg_ptr = function->default_arguments.size() ? function->default_arguments.ptr() : nullptr;
+	function->_constant_count = function->constants.size();
+	function->_constants_ptr = function->_constant_count ? function->constants.ptrw() : nullptr;
+	function->_global_names_count = function->global_names.size();
+	function->_global_names_ptr = function->_global_names_count ? function->global_names.ptr() : nullptr;
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_operator_funcs_ptr = function->_operator_funcs_count ? function->operator_funcs.ptr() : nullptr;
+	function->_setters_count = function->setters.size();
+	function->_setters_ptr = function->_setters_count ? function->setters.ptr() : nullptr;
+	function->_getters_count = function->getters.size();
+	function->_getters_ptr = function->_getters_count ? function->getters.ptr() : nullptr;
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_setters_ptr = function->_keyed_setters_count ? function->keyed_setters.ptr() : nullptr;
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_keyed_getters_ptr = function->_keyed_getters_count ? function->keyed_getters.ptr() : nullptr;
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_setters_ptr = function->_indexed_setters_count ? function->indexed_setters.ptr() : nullptr;
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_indexed_getters_ptr = function->_indexed_getters_count ? function->indexed_getters.ptr() : nullptr;
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_builtin_methods_ptr = function->_builtin_methods_count ? function->builtin_methods.ptr() : nullptr;
+	function->_constructors_count = function->constructors.size();
+	function->_constructors_ptr = function->_constructors_count ? function->constructors.ptr() : nullptr;
+	function->_utilities_count = function->utilities.size();
+	function->_utilities_ptr = function->_utilities_count ? function->utilities.ptr() : nullptr;
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_gds_utilities_ptr = function->_gds_utilities_count ? function->gds_utilities.ptr() : nullptr;
+	function->_methods_count = function->methods.size();
+	function->_methods_ptr = function->_methods_count ? function->methods.ptrw() : nullptr;
+	function->_lambdas_count = function->lambdas.size();
+	function->_lambdas_ptr = function->_lambdas_count ? function->lambdas.ptrw() : nullptr;
+
+	return function;
+}
+
+Error GDScriptBytecodeBuffer::make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	Reader reader(p_buffer);
+	reader.root = p_script;
+
+	Error err = _read_header(reader, p_script);
+	if (err) {
+		return err;
+	}
+	return _read_class_layout(reader, p_script);
+}
+
+Error GDScriptBytecodeBuffer::load_script(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_COND_V(!p_script->is_root_script(), ERR_INVALID_PARAMETER);
+
+	Reader reader(p_buffer);
+	reader.root = p_script;
+
+	Error err = _read_header(reader, p_script);
+	if (err) {
+		return err;
+	}
+	err = _read_class_layout(reader, p_script);
+	if (err) {
+		return err;
+	}
+
+	p_script->_owner = nullptr;
+	err = _read_class(reader, p_script);
+	if (err) {
+		return err;
+	}
+
+	bool register_static = reader.get_u8();
+	ERR_FAIL_COND_V(reader.failed, ERR_FILE_CORRUPT);
+	if (register_static) {
+		GDScriptCache::add_static_script(p_script);
+	}
+
+	return GDScriptCache::finish_compiling(p_script->path);
+}
+
+#ifdef TOOLS_ENABLED
+
+void GDScriptBytecodeBuffer::_write_class_layout(Writer &p_writer, const GDScript *p_script) {
+	p_writer.put_string(p_script->fully_qualified_name);
+	p_writer.put_string(p_script->local_name);
+	p_writer.put_string(p_script->global_name);
+	p_writer.put_string(p_script->simplified_icon_path);
+
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		_write_class_layout(p_writer, E.value.ptr());
+	}
+}
+
+void GDScriptBytecodeBuffer::_write_member_info(Writer &p_writer, const GDScript::MemberInfo &p_member_info) {
+	p_writer.put_32(p_member_info.index);
+	p_writer.put_string(p_member_info.setter);
+	p_writer.put_string(p_member_info.getter);
+	p_writer.put_data_type(p_member_info.data_type);
+	p_writer.put_property_info(p_member_info.property_info);
+}
+
+void GDScriptBytecodeBuffer::_write_class(Writer &p_writer, const GDScript *p_script) {
+	p_writer.put_u8(p_script->tool);
+	p_writer.put_string(p_script->native.is_valid() ? p_script->native->get_name() : StringName());
+
+	p_writer.put_u8(p_script->base.is_valid());
+	if (p_script->base.is_valid()) {
+		p_writer.put_object(p_script->base.ptr());
+	}
+
+	p_writer.put_u32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		p_writer.put_string(E.key);
+		_write_member_info(p_writer, E.value);
+	}
+
+	p_writer.put_u32(p_script->members.size());
+	for (const StringName &member : p_script->members) {
+		p_writer.put_string(member);
+	}
+
+	p_writer.put_u32(p_script->static_variables_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->static_variables_indices) {
+		p_writer.put_string(E.key);
+		_write_member_info(p_writer, E.value);
+	}
+
+	p_writer.put_u32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		p_writer.put_string(E.key);
+		p_writer.put_variant(E.value);
+	}
+
+	p_writer.put_u32(p_script->_signals.size());
+	for (const KeyValue<StringName, MethodInfo> &E : p_script->_signals) {
+		p_writer.put_string(E.key);
+		p_writer.put_method_info(E.value);
+	}
+
+	p_writer.put_variant(p_script->rpc_config);
+
+	p_writer.put_u32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		_write_function(p_writer, E.value);
+	}
+
+	const GDScriptFunction *implicit_functions[] = { p_script->implicit_initializer, p_script->implicit_ready, p_script->static_initializer };
+	for (const GDScriptFunction *implicit_function : implicit_functions) {
+		p_writer.put_u8(implicit_function != nullptr);
+		if (implicit_function != nullptr) {
+			_write_function(p_writer, implicit_function);
+		}
+	}
+
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		_write_class(p_writer, E.value.ptr());
+	}
+}
+
+void GDScriptBytecodeBuffer::_write_function(Writer &p_writer, const GDScriptFunction *p_function) {
+	p_writer.put_string(p_function->name);
+	p_writer.put_u8(p_function->_static);
+	p_writer.put_u32(p_function->argument_types.size());
+	for (const GDScriptDataType &argument_type : p_function->argument_types) {
+		p_writer.put_data_type(argument_type);
+	}
+	p_writer.put_data_type(p_function->return_type);
+	p_writer.put_method_info(p_function->method_info);
+	p_writer.put_variant(p_function->rpc_config);
+
+	p_writer.put_32(p_function->_initial_line);
+	p_writer.put_32(p_function->_argument_count);
+	p_writer.put_32(p_function->_stack_size);
+	p_writer.put_32(p_function->_instruction_args_size);
+	p_writer.put_32(p_function->_inline_cache_count);
+
+	p_writer.put_u32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		p_writer.put_32(E.key);
+		p_writer.put_u32(E.value);
+	}
+
+	p_writer.put_u32(p_function->stack_debug.size());
+	for (const GDScriptFunction::StackDebug &stack_debug : p_function->stack_debug) {
+		p_writer.put_32(stack_debug.line);
+		p_writer.put_32(stack_debug.pos);
+		p_writer.put_u8(stack_debug.added);
+		p_writer.put_string(stack_debug.identifier);
+	}
+
+	p_writer.put_u32(p_function->code.size());
+	for (int code : p_function->code) {
+		p_writer.put_32(code);
+	}
+
+	p_writer.put_u32(p_function->global_index_offsets.size());
+	for (int offset : p_function->global_index_offsets) {
+		p_writer.put_u32(offset);
+		p_writer.put_global(p_function->code[offset]);
+	}
+
+	p_writer.put_u32(p_function->default_arguments.size());
+	for (int default_argument : p_function->default_arguments) {
+		p_writer.put_32(default_argument);
+	}
+
+	p_writer.put_u32(p_function->constants.size());
+	for (const Variant &constant : p_function->constants) {
+		p_writer.put_variant(constant);
+	}
+
+	p_writer.put_u32(p_function->global_names.size());
+	for (const StringName &global_name : p_function->global_names) {
+		p_writer.put_string(global_name);
+	}
+
+	p_writer.put_u32(p_function->operator_funcs.size());
+	for (Variant::ValidatedOperatorEvaluator evaluator : p_function->operator_funcs) {
+		p_writer.put_operator(evaluator);
+	}
+
+	p_writer.put_u32(p_function->setters.size());
+	for (Variant::ValidatedSetter setter : p_function->setters) {
+		p_writer.put_setter(setter);
+	}
+
+	p_writer.put_u32(p_function->getters.size());
+	for (Variant::ValidatedGetter getter : p_function->getters) {
+		p_writer.put_getter(getter);
+	}
+
+	p_writer.put_u32(p_function->keyed_setters.size());
+	for (Variant::ValidatedKeyedSetter keyed_setter : p_function->keyed_setters) {
+		p_writer.put_keyed_setter(keyed_setter);
+	}
+
+	p_writer.put_u32(p_function->keyed_getters.size());
+	for (Variant::ValidatedKeyedGetter keyed_getter : p_function->keyed_getters) {
+		p_writer.put_keyed_getter(keyed_getter);
+	}
+
+	p_writer.put_u32(p_function->indexed_setters.size());
+	for (Variant::ValidatedIndexedSetter indexed_setter : p_function->indexed_setters) {
+		p_writer.put_indexed_setter(indexed_setter);
+	}
+
+	p_writer.put_u32(p_function->indexed_getters.size());
+	for (Variant::ValidatedIndexedGetter indexed_getter : p_function->indexed_getters) {
+		p_writer.put_indexed_getter(indexed_getter);
+	}
+
+	p_writer.put_u32(p_function->builtin_methods.size());
+	for (Variant::ValidatedBuiltInMethod builtin_method : p_function->builtin_methods) {
+		p_writer.put_builtin_method(builtin_method);
+	}
+
+	p_writer.put_u32(p_function->constructors.size());
+	for (Variant::ValidatedConstructor constructor : p_function->constructors) {
+		p_writer.put_constructor(constructor);
+	}
+
+	p_writer.put_u32(p_function->utilities.size());
+	for (Variant::ValidatedUtilityFunction utility : p_function->utilities) {
+		p_writer.put_utility(utility);
+	}
+
+	p_writer.put_u32(p_function->gds_utilities.size());
+	for (GDScriptUtilityFunctions::FunctionPtr gds_utility : p_function->gds_utilities) {
+		p_writer.put_gds_utility(gds_utility);
+	}
+
+	p_writer.put_u32(p_function->methods.size());
+	for (const MethodBind *method : p_function->methods) {
+		p_writer.put_string(method->get_instance_class());
+		p_writer.put_string(method->get_name());
+	}
+
+	p_writer.put_u32(p_function->lambdas.size());
+	for (const GDScriptFunction *lambda : p_function->lambdas) {
+		const GDScript::LambdaInfo *lambda_info = lambda->_script->lambda_info.getptr(const_cast<GDScriptFunction *>(lambda));
+		if (lambda_info == nullptr) {
+			p_writer.error = ERR_BUG;
+			ERR_FAIL_MSG("Can't serialize GDScript bytecode: lambda is missing its capture information.");
+		}
+		p_writer.put_32(lambda_info->capture_count);
+		p_writer.put_u8(lambda_info->use_self);
+		_write_function(p_writer, lambda);
+	}
+
+#ifdef DEBUG_ENABLED
+	if (p_writer.release) {
+		return;
+	}
+	const Vector<String> *debug_names[] = {
+		&p_function->operator_names,
+		&p_function->setter_names,
+		&p_function->getter_names,
+		&p_function->builtin_methods_names,
+		&p_function->constructors_names,
+		&p_function->utilities_names,
+		&p_function->gds_utilities_names,
+	};
+	for (const Vector<String> *names : debug_names) {
+		p_writer.put_u32(names->size());
+		for (const String &name : *names) {
+			p_writer.put_string(name);
+		}
+	}
+#endif
+}
+
+Error GDScriptBytecodeBuffer::_compile_release_script(const Ref<GDScript> &p_script, const Vector<uint8_t> &p_binary_tokens, Ref<GDScript> &r_release_script) {
+	const String path = p_script->get_script_path();
+
+	GDScriptParser parser;
+	Error err = parser.parse_binary(p_binary_tokens, path);
+	if (err == OK) {
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+	}
+	if (err != OK) {
+		return ERR_PARSE_ERROR;
+	}
+
+	// Only used to be serialized, so it isn't given to the cache nor statically initialized.
+	Ref<GDScript> release_script;
+	release_script.instantiate();
+	release_script->path = path;
+	release_script->path_valid = true;
+
+	GDScriptCompiler compiler;
+	compiler.set_release_code(true);
+	err = compiler.compile(&parser, release_script.ptr(), false);
+	if (err != OK) {
+		return ERR_COMPILATION_FAILED;
+	}
+
+	r_release_script = release_script;
+	return OK;
+}
+
+Error GDScriptBytecodeBuffer::serialize_script(const Ref<GDScript> &p_script, const Vector<uint8_t> &p_binary_tokens, Vector<uint8_t> &r_buffer, bool p_release) {
+	ERR_FAIL_COND_V(p_script.is_null() || !p_script->is_root_script(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(!p_script->is_valid(), ERR_INVALID_PARAMETER, "Can't serialize a GDScript that failed to compile.");
+	ERR_FAIL_COND_V(p_binary_tokens.is_empty(), ERR_INVALID_PARAMETER);
+
+	Ref<GDScript> script = p_script;
+	uint32_t flags = _get_build_flags();
+	if (p_release) {
+		Error err = _compile_release_script(p_script, p_binary_tokens, script);
+		if (err != OK) {
+			return err;
+		}
+		flags &= ~BYTECODE_FLAG_DEBUG;
+	}
+
+	Writer writer;
+	writer.release = p_release;
+	writer.put_u8('G');
+	writer.put_u8('D');
+	writer.put_u8('B');
+	writer.put_u8('C');
+	writer.put_u32(BYTECODE_VERSION);
+	writer.put_u32(flags);
+	writer.put_string(_get_build_version());
+	writer.put_u32(GDScriptFunction::OPCODE_END);
+	writer.put_u32(Variant::VARIANT_MAX);
+	writer.put_u32(Variant::OP_MAX);
+	writer.put_u32(hash_djb2_buffer(p_binary_tokens.ptr(), p_binary_tokens.size()));
+
+	_write_class_layout(writer, script.ptr());
+	_write_class(writer, script.ptr());
+
+	// The release copy isn't registered, but it has the same static data as `p_script`.
+	MutexLock lock(GDScriptCache::singleton->mutex);
+	writer.put_u8(GDScriptCache::singleton->static_gdscript_cache.has(p_script->get_fully_qualified_name()));
+
+	if (writer.error != OK) {
+		return writer.error;
+	}
+	r_buffer = writer.get_data();
+	return OK;
+}
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*  gdscript_bytecode_buffer.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_BUFFER_H
+#define GDSCRIPT_BYTECODE_BUFFER_H
+
+#include "gdscript.h"
+
+// Stores the compiled form of a GDScript file (bytecode, constants, function tables and
+// class members) so exported projects can skip parsing, analysis and code generation.
+// The buffer is only valid for the engine build that produced it: the loaders reject
+// anything else, and callers are expected to compile from the binary tokens instead.
+class GDScriptBytecodeBuffer {
+	class Writer;
+	class Reader;
+
+	static Error _read_header(Reader &p_reader, const GDScript *p_script);
+	static Error _read_class_layout(Reader &p_reader, GDScript *p_script);
+	static void _clear_class(GDScript *p_script);
+	static Error _read_class(Reader &p_reader, GDScript *p_script);
+	static bool _read_member_info(Reader &p_reader, GDScript::MemberInfo &r_member_info);
+	static GDScriptFunction *_read_function(Reader &p_reader, GDScript *p_script, bool p_is_lambda);
+
+#ifdef TOOLS_ENABLED
+	static void _write_class_layout(Writer &p_writer, const GDScript *p_script);
+	static void _write_class(Writer &p_writer, const GDScript *p_script);
+	static void _write_member_info(Writer &p_writer, const GDScript::MemberInfo &p_member_info);
+	static void _write_function(Writer &p_writer, const GDScriptFunction *p_function);
+	static Error _compile_release_script(const Ref<GDScript> &p_script, const Vector<uint8_t> &p_binary_tokens, Ref<GDScript> &r_release_script);
+#endif
+
+public:
+	static String get_bytecode_path(const String &p_binary_tokens_path);
+
+	// Creates the inner class objects of `p_script`, like `GDScriptCompiler::make_scripts()`.
+	static Error make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+	// Replaces the compiled state of `p_script` and its inner classes with the contents of the buffer.
+	static Error load_script(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+
+#ifdef TOOLS_ENABLED
+	// Fails with `ERR_UNAVAILABLE` when the script holds constants that can't be restored by path or name.
+	// With `p_release`, the tokens are compiled again without debug-only opcodes and metadata, for release export templates.
+	static Error serialize_script(const Ref<GDScript> &p_script, const Vector<uint8_t> &p_binary_tokens, Vector<uint8_t> &r_buffer, bool p_release = false);
+#endif
+};
+
+#endif // GDSCRIPT_BYTECODE_BUFFER_H
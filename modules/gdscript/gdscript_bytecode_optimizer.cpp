@@ -0,0 +1,926 @@
+/**************************************************************************/
+/*  gdscript_bytecode_optimizer.cpp                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_bytecode_optimizer.h"
+
+#include "gdscript_byte_codegen.h"
+
+#include "core/debugger/engine_debugger.h"
+#include "core/templates/hash_set.h"
+
+int GDScriptByteCodeOptimizer::_get_instruction_size(const int *p_code, int p_position, int p_code_size) {
+	int size = 0;
+	// Slots after the addresses of instructions using `LOAD_INSTRUCTION_ARGS`.
+	int variadic_tail = 0;
+
+	int opcode = p_code[p_position];
+	if (opcode >= GDScriptFunction::OPCODE_ADD_INT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT) {
+		size = 4;
+	} else if (opcode >= GDScriptFunction::OPCODE_EQUAL_INT_JUMP_IF_NOT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT) {
+		size = 5;
+	} else if (opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+		size = 5;
+	} else if (opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+		size = 2;
+	} else {
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR:
+				size = 7 + sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*p_code);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				size = 5;
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_ARRAY:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY:
+				size = 6;
+				break;
+			case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+			case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+				size = 5;
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_BUILTIN:
+			case GDScriptFunction::OPCODE_TYPE_TEST_NATIVE:
+			case GDScriptFunction::OPCODE_TYPE_TEST_SCRIPT:
+			case GDScriptFunction::OPCODE_SET_KEYED:
+			case GDScriptFunction::OPCODE_GET_KEYED:
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+			case GDScriptFunction::OPCODE_SET_STATIC_VARIABLE:
+			case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+			case GDScriptFunction::OPCODE_CAST_TO_SCRIPT:
+				size = 4;
+				break;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER:
+			case GDScriptFunction::OPCODE_ASSIGN:
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+			case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_STORE_GLOBAL:
+			case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+			case GDScriptFunction::OPCODE_ASSERT:
+				size = 3;
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_NULL:
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			case GDScriptFunction::OPCODE_AWAIT:
+			case GDScriptFunction::OPCODE_AWAIT_RESUME:
+			case GDScriptFunction::OPCODE_JUMP:
+			case GDScriptFunction::OPCODE_RETURN:
+			case GDScriptFunction::OPCODE_LINE:
+				size = 2;
+				break;
+			case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+			case GDScriptFunction::OPCODE_BREAKPOINT:
+			case GDScriptFunction::OPCODE_END:
+				size = 1;
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_ASYNC:
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+				variadic_tail = 4;
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT:
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+			case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+			case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+				variadic_tail = 3;
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+			case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+				variadic_tail = 2;
+				break;
+			default:
+				return -1;
+		}
+	}
+
+	if (variadic_tail > 0) {
+		if (p_position + 1 >= p_code_size || p_code[p_position + 1] < 0) {
+			return -1;
+		}
+		size = 1 + p_code[p_position + 1] + variadic_tail;
+	}
+
+	if (p_position + size > p_code_size) {
+		return -1;
+	}
+	return size;
+}
+
+int GDScriptByteCodeOptimizer::_get_jump_operand(GDScriptFunction::Opcode p_opcode) {
+	// Offset of the slot holding the jump destination, if any.
+	if (p_opcode >= GDScriptFunction::OPCODE_EQUAL_INT_JUMP_IF_NOT && p_opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT) {
+		return 4;
+	}
+	if (p_opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && p_opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+		return 4;
+	}
+	switch (p_opcode) {
+		case GDScriptFunction::OPCODE_JUMP:
+			return 1;
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+		case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+			return 2;
+		default:
+			return 0;
+	}
+}
+
+bool GDScriptByteCodeOptimizer::_has_fallthrough(GDScriptFunction::Opcode p_opcode) {
+	switch (p_opcode) {
+		case GDScriptFunction::OPCODE_JUMP:
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case GDScriptFunction::OPCODE_RETURN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+		case GDScriptFunction::OPCODE_END:
+			return false;
+		default:
+			return true;
+	}
+}
+
+void GDScriptByteCodeOptimizer::_get_address_operands(const int *p_code, int p_position, int p_size, int &r_first, int &r_count) {
+	GDScriptFunction::Opcode opcode = (GDScriptFunction::Opcode)p_code[p_position];
+	r_first = 0;
+
+	if ((opcode >= GDScriptFunction::OPCODE_ADD_INT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT) || (opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT)) {
+		r_count = 3;
+		return;
+	}
+	if (opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+		r_count = 1;
+		return;
+	}
+
+	switch (opcode) {
+		case GDScriptFunction::OPCODE_OPERATOR:
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+		case GDScriptFunction::OPCODE_SET_KEYED:
+		case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+		case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_KEYED:
+		case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+			r_count = 3;
+			break;
+		case GDScriptFunction::OPCODE_SET_NAMED:
+		case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_NAMED:
+		case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+		case GDScriptFunction::OPCODE_SET_STATIC_VARIABLE:
+		case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+		case GDScriptFunction::OPCODE_ASSIGN:
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_TYPE_TEST_BUILTIN:
+		case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+		case GDScriptFunction::OPCODE_ASSERT:
+			r_count = 2;
+			break;
+		case GDScriptFunction::OPCODE_SET_MEMBER:
+		case GDScriptFunction::OPCODE_GET_MEMBER:
+		case GDScriptFunction::OPCODE_ASSIGN_NULL:
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+		case GDScriptFunction::OPCODE_AWAIT:
+		case GDScriptFunction::OPCODE_AWAIT_RESUME:
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+		case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+		case GDScriptFunction::OPCODE_RETURN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_STORE_GLOBAL:
+		case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+			r_count = 1;
+			break;
+		case GDScriptFunction::OPCODE_JUMP:
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case GDScriptFunction::OPCODE_BREAKPOINT:
+		case GDScriptFunction::OPCODE_LINE:
+		case GDScriptFunction::OPCODE_END:
+			r_count = 0;
+			break;
+		case GDScriptFunction::OPCODE_CONSTRUCT:
+		case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+		case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+		case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+		case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+		case GDScriptFunction::OPCODE_CALL:
+		case GDScriptFunction::OPCODE_CALL_RETURN:
+		case GDScriptFunction::OPCODE_CALL_ASYNC:
+		case GDScriptFunction::OPCODE_CALL_UTILITY:
+		case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+		case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+		case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+			// The first slot is the count of addresses.
+			r_first = 1;
+			r_count = p_code[p_position + 1];
+			break;
+		default:
+			// Layouts with addresses mixed with other data, consider all of them as addresses.
+			r_count = p_size - 1;
+			break;
+	}
+}
+
+bool GDScriptByteCodeOptimizer::_get_typed_operator(GDScriptFunction::Opcode p_opcode, Variant::Operator &r_operator, Variant::Type &r_result_type, Variant::Type &r_left_type, Variant::Type &r_right_type) {
+	switch (p_opcode) {
+#define TYPED_OPERATOR(m_opcode, m_operator, m_result, m_left, m_right) \
+	case GDScriptFunction::m_opcode:                                      \
+		r_operator = Variant::m_operator;                                 \
+		r_result_type = Variant::m_result;                                \
+		r_left_type = Variant::m_left;                                    \
+		r_right_type = Variant::m_right;                                  \
+		return true;
+
+		TYPED_OPERATOR(OPCODE_ADD_INT, OP_ADD, INT, INT, INT)
+		TYPED_OPERATOR(OPCODE_SUBTRACT_INT, OP_SUBTRACT, INT, INT, INT)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_INT, OP_MULTIPLY, INT, INT, INT)
+		TYPED_OPERATOR(OPCODE_ADD_FLOAT, OP_ADD, FLOAT, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_SUBTRACT_FLOAT, OP_SUBTRACT, FLOAT, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_FLOAT, OP_MULTIPLY, FLOAT, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_DIVIDE_FLOAT, OP_DIVIDE, FLOAT, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_ADD_VECTOR2, OP_ADD, VECTOR2, VECTOR2, VECTOR2)
+		TYPED_OPERATOR(OPCODE_SUBTRACT_VECTOR2, OP_SUBTRACT, VECTOR2, VECTOR2, VECTOR2)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR2, OP_MULTIPLY, VECTOR2, VECTOR2, VECTOR2)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR2_FLOAT, OP_MULTIPLY, VECTOR2, VECTOR2, FLOAT)
+		TYPED_OPERATOR(OPCODE_ADD_VECTOR3, OP_ADD, VECTOR3, VECTOR3, VECTOR3)
+		TYPED_OPERATOR(OPCODE_SUBTRACT_VECTOR3, OP_SUBTRACT, VECTOR3, VECTOR3, VECTOR3)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR3, OP_MULTIPLY, VECTOR3, VECTOR3, VECTOR3)
+		TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR3_FLOAT, OP_MULTIPLY, VECTOR3, VECTOR3, FLOAT)
+		TYPED_OPERATOR(OPCODE_EQUAL_INT, OP_EQUAL, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_NOT_EQUAL_INT, OP_NOT_EQUAL, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_LESS_INT, OP_LESS, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_LESS_EQUAL_INT, OP_LESS_EQUAL, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_GREATER_INT, OP_GREATER, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_GREATER_EQUAL_INT, OP_GREATER_EQUAL, BOOL, INT, INT)
+		TYPED_OPERATOR(OPCODE_EQUAL_FLOAT, OP_EQUAL, BOOL, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_NOT_EQUAL_FLOAT, OP_NOT_EQUAL, BOOL, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_LESS_FLOAT, OP_LESS, BOOL, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_LESS_EQUAL_FLOAT, OP_LESS_EQUAL, BOOL, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_GREATER_FLOAT, OP_GREATER, BOOL, FLOAT, FLOAT)
+		TYPED_OPERATOR(OPCODE_GREATER_EQUAL_FLOAT, OP_GREATER_EQUAL, BOOL, FLOAT, FLOAT)
+
+#undef TYPED_OPERATOR
+
+		default:
+			return false;
+	}
+}
+
+bool GDScriptByteCodeOptimizer::_decode() {
+	const int *ptr = code.ptr();
+	int code_size = code.size();
+	if (code_size == 0) {
+		return false;
+	}
+
+	instruction_at.resize(code_size + 1);
+	for (int &E : instruction_at) {
+		E = -1;
+	}
+
+	int position = 0;
+	while (position < code_size) {
+		int size = _get_instruction_size(ptr, position, code_size);
+		if (size <= 0) {
+			return false;
+		}
+		instruction_at[position] = instructions.size();
+		Instruction instruction;
+		instruction.position = position;
+		instruction.size = size;
+		instructions.push_back(instruction);
+		position += size;
+	}
+
+	// Everything control flow can land on, so no rewrite spans over it.
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		GDScriptFunction::Opcode opcode = _get_opcode(i);
+		int jump = _get_jump_operand(opcode);
+		if (jump > 0) {
+			int target = _get_instruction_at(ptr[instructions[i].position + jump]);
+			if (target < 0) {
+				return false;
+			}
+			instructions[target].jump_target = true;
+		}
+		if (opcode == GDScriptFunction::OPCODE_AWAIT) {
+			// Resumed coroutines continue at `OPCODE_AWAIT_RESUME`, which is skipped when not awaiting a signal.
+			if (i + 2 >= instructions.size() || _get_opcode(i + 1) != GDScriptFunction::OPCODE_AWAIT_RESUME) {
+				return false;
+			}
+			instructions[i + 1].jump_target = true;
+			instructions[i + 2].jump_target = true;
+		}
+	}
+
+	for (const int &E : generator->function->default_arguments) {
+		int target = _get_instruction_at(E);
+		if (target < 0) {
+			return false;
+		}
+		instructions[target].jump_target = true;
+	}
+
+	return true;
+}
+
+int GDScriptByteCodeOptimizer::_get_next_instruction(int p_instruction) const {
+	int next = p_instruction + 1;
+	while (next < (int)instructions.size() && instructions[next].removed) {
+		next++;
+	}
+	return next;
+}
+
+int GDScriptByteCodeOptimizer::_get_instruction_at(int p_position) const {
+	if (p_position < 0 || p_position >= (int)instruction_at.size()) {
+		return -1;
+	}
+	return instruction_at[p_position];
+}
+
+bool GDScriptByteCodeOptimizer::_references(int p_instruction, int p_address, int p_skip_operand) const {
+	const Instruction &instruction = instructions[p_instruction];
+	int first = 0;
+	int count = 0;
+	_get_address_operands(code.ptr(), instruction.position, instruction.size, first, count);
+	for (int i = first; i < first + count; i++) {
+		if (i != p_skip_operand && _get_operand(p_instruction, i) == p_address) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool GDScriptByteCodeOptimizer::_is_overwrite(int p_instruction, int p_address) const {
+	GDScriptFunction::Opcode opcode = _get_opcode(p_instruction);
+	int destination = -1;
+
+	if (opcode >= GDScriptFunction::OPCODE_ADD_INT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT) {
+		destination = 2;
+	} else {
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				destination = 2;
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN:
+			case GDScriptFunction::OPCODE_ASSIGN_NULL:
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_GET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+				destination = 0;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return _get_operand(p_instruction, destination) == p_address && !_references(p_instruction, p_address, destination);
+}
+
+bool GDScriptByteCodeOptimizer::_is_read_after(int p_instruction, int p_address) const {
+	LocalVector<int> pending;
+	HashSet<int> visited;
+	int steps = 0;
+
+	pending.push_back(_get_next_instruction(p_instruction));
+	while (!pending.is_empty()) {
+		int current = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+
+		while (current < (int)instructions.size()) {
+			if (instructions[current].removed) {
+				current = _get_next_instruction(current);
+				continue;
+			}
+			if (visited.has(current)) {
+				break;
+			}
+			visited.insert(current);
+			if (++steps > MAX_LIVENESS_STEPS) {
+				return true;
+			}
+
+			if (_is_overwrite(current, p_address)) {
+				break;
+			}
+			if (_references(current, p_address)) {
+				return true;
+			}
+
+			GDScriptFunction::Opcode opcode = _get_opcode(current);
+			if (opcode == GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT || opcode == GDScriptFunction::OPCODE_AWAIT) {
+				return true;
+			}
+			int jump = _get_jump_operand(opcode);
+			if (jump > 0) {
+				int target = _get_instruction_at(_get_operand(current, jump - 1));
+				if (target < 0) {
+					return true;
+				}
+				pending.push_back(target);
+			}
+			if (!_has_fallthrough(opcode)) {
+				break;
+			}
+			current = _get_next_instruction(current);
+		}
+	}
+
+	return false;
+}
+
+bool GDScriptByteCodeOptimizer::_can_contain_object(int p_temporary) const {
+	int index = (p_temporary & GDScriptFunction::ADDR_MASK) - first_temporary;
+	ERR_FAIL_INDEX_V(index, generator->temporaries.size(), true);
+	return generator->temporaries[index].can_contain_object;
+}
+
+void GDScriptByteCodeOptimizer::_remove(int p_instruction) {
+	instructions[p_instruction].removed = true;
+}
+
+void GDScriptByteCodeOptimizer::_rewrite(int p_instruction, const int *p_code, int p_size) {
+	Instruction &instruction = instructions[p_instruction];
+	ERR_FAIL_COND(p_size > instruction.size);
+	int *w = code.ptrw();
+	for (int i = 0; i < p_size; i++) {
+		w[instruction.position + i] = p_code[i];
+	}
+	instruction.size = p_size;
+}
+
+bool GDScriptByteCodeOptimizer::_thread_jumps() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed) {
+			continue;
+		}
+		int jump = _get_jump_operand(_get_opcode(i));
+		if (jump == 0) {
+			continue;
+		}
+
+		int original = _get_operand(i, jump - 1);
+		int destination = original;
+		// Follow chains of unconditional jumps, the bound also stops on loops made only of jumps.
+		for (int hops = 0; hops < 16; hops++) {
+			int target = _get_instruction_at(destination);
+			if (target < 0) {
+				break;
+			}
+			if (instructions[target].removed) {
+				target = _get_next_instruction(target);
+			}
+			if (target >= (int)instructions.size() || target == (int)i || _get_opcode(target) != GDScriptFunction::OPCODE_JUMP) {
+				break;
+			}
+			int next_destination = _get_operand(target, 0);
+			if (next_destination == destination) {
+				break;
+			}
+			destination = next_destination;
+		}
+
+		if (destination != original) {
+			code.write[instructions[i].position + jump] = destination;
+			instructions[_get_instruction_at(destination)].jump_target = true;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_fold_constants() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed) {
+			continue;
+		}
+		GDScriptFunction::Opcode opcode = _get_opcode(i);
+
+		if (opcode == GDScriptFunction::OPCODE_JUMP_IF || opcode == GDScriptFunction::OPCODE_JUMP_IF_NOT) {
+			int condition = _get_operand(i, 0);
+			if (!_is_constant(condition)) {
+				continue;
+			}
+			bool value = constants[condition & GDScriptFunction::ADDR_MASK].booleanize();
+			if (value == (opcode == GDScriptFunction::OPCODE_JUMP_IF)) {
+				int jump[2] = { GDScriptFunction::OPCODE_JUMP, _get_operand(i, 1) };
+				_rewrite(i, jump, 2);
+			} else {
+				_remove(i);
+			}
+			changed = true;
+			continue;
+		}
+
+		Variant::Operator op;
+		Variant::Type result_type;
+		Variant::Type left_type;
+		Variant::Type right_type;
+		if (!_get_typed_operator(opcode, op, result_type, left_type, right_type)) {
+			continue;
+		}
+		int left = _get_operand(i, 0);
+		int right = _get_operand(i, 1);
+		if (!_is_constant(left) || !_is_constant(right)) {
+			continue;
+		}
+		const Variant &left_value = constants[left & GDScriptFunction::ADDR_MASK];
+		const Variant &right_value = constants[right & GDScriptFunction::ADDR_MASK];
+		if (left_value.get_type() != left_type || right_value.get_type() != right_type) {
+			continue;
+		}
+
+		Variant result;
+		bool valid = false;
+		Variant::evaluate(op, left_value, right_value, result, valid);
+		if (!valid || result.get_type() != result_type) {
+			continue;
+		}
+
+		uint32_t index = generator->add_or_get_constant(result);
+		if (index == constants.size()) {
+			constants.push_back(result);
+		}
+		ERR_CONTINUE(index >= constants.size() || index > (uint32_t)GDScriptFunction::ADDR_MASK);
+
+		int assign[3] = { GDScriptFunction::OPCODE_ASSIGN, _get_operand(i, 2), (int)index | (GDScriptFunction::ADDR_TYPE_CONSTANT << GDScriptFunction::ADDR_BITS) };
+		_rewrite(i, assign, 3);
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_propagate_copies() {
+	bool changed = false;
+
+	// Looks for a value computed into a temporary and then only copied somewhere else,
+	// e.g. `member += 1`, which becomes a single in-place operation.
+	for (uint32_t i = 1; i < instructions.size(); i++) {
+		if (instructions[i].removed || instructions[i].jump_target || _get_opcode(i) != GDScriptFunction::OPCODE_ASSIGN) {
+			continue;
+		}
+		int destination = _get_operand(i, 0);
+		int temporary = _get_operand(i, 1);
+		if (!_is_temporary(temporary) || destination == temporary) {
+			continue;
+		}
+
+		// The producer must be right before, with no jump landing in between.
+		int producer = i - 1;
+		bool crosses_target = false;
+		while (producer >= 0 && instructions[producer].removed) {
+			crosses_target = crosses_target || instructions[producer].jump_target;
+			producer--;
+		}
+		if (producer < 0 || crosses_target) {
+			continue;
+		}
+
+		GDScriptFunction::Opcode opcode = _get_opcode(producer);
+		int result_operand = -1;
+
+		Variant::Operator op;
+		Variant::Type result_type;
+		Variant::Type left_type;
+		Variant::Type right_type;
+		if (_get_typed_operator(opcode, op, result_type, left_type, right_type)) {
+			// These write the payload directly, so the destination must already hold the result type.
+			// That's only known when it's also an operand of the same type.
+			bool same_type_operand = (_get_operand(producer, 0) == destination && left_type == result_type) || (_get_operand(producer, 1) == destination && right_type == result_type);
+			if (!same_type_operand) {
+				continue;
+			}
+			result_operand = 2;
+		} else {
+			switch (opcode) {
+				case GDScriptFunction::OPCODE_OPERATOR:
+					result_operand = 2;
+					break;
+				case GDScriptFunction::OPCODE_ASSIGN:
+				case GDScriptFunction::OPCODE_ASSIGN_NULL:
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+				case GDScriptFunction::OPCODE_GET_MEMBER:
+				case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+					result_operand = 0;
+					break;
+				default:
+					// Includes `OPCODE_OPERATOR_VALIDATED`, which changes the type of its result: writing it
+					// straight to the destination isn't the same as the copy when the types differ.
+					continue;
+			}
+			// These may reset their result before reading the operands.
+			if (_references(producer, destination)) {
+				continue;
+			}
+		}
+
+		if (_get_operand(producer, result_operand) != temporary || _is_read_after(i, temporary)) {
+			continue;
+		}
+
+		code.write[instructions[producer].position + 1 + result_operand] = destination;
+		if (_can_contain_object(temporary)) {
+			// Still release whatever the temporary held at the same point.
+			int clear[2] = { GDScriptFunction::OPCODE_ASSIGN_NULL, temporary };
+			_rewrite(i, clear, 2);
+		} else {
+			_remove(i);
+		}
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_remove_dead_stores() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed) {
+			continue;
+		}
+		GDScriptFunction::Opcode opcode = _get_opcode(i);
+		int result_operand = -1;
+		if (opcode >= GDScriptFunction::OPCODE_ADD_INT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT) {
+			result_operand = 2;
+		} else {
+			switch (opcode) {
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+					result_operand = 2;
+					break;
+				case GDScriptFunction::OPCODE_ASSIGN:
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+					result_operand = 0;
+					break;
+				default:
+					continue;
+			}
+		}
+
+		// Temporaries which may hold objects are left alone, dropping a store would change when they are freed.
+		int temporary = _get_operand(i, result_operand);
+		if (!_is_temporary(temporary) || _can_contain_object(temporary) || _is_read_after(i, temporary)) {
+			continue;
+		}
+		_remove(i);
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_remove_redundant_type_adjusts() {
+	bool changed = false;
+	// Type each address is known to have, as the `OPCODE_TYPE_ADJUST_*` that set it.
+	HashMap<int, GDScriptFunction::Opcode> known_types;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed) {
+			continue;
+		}
+		if (instructions[i].jump_target) {
+			known_types.clear();
+		}
+
+		GDScriptFunction::Opcode opcode = _get_opcode(i);
+		if (opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+			int address = _get_operand(i, 0);
+			HashMap<int, GDScriptFunction::Opcode>::Iterator E = known_types.find(address);
+			if (E && E->value == opcode) {
+				_remove(i);
+				changed = true;
+			} else {
+				known_types[address] = opcode;
+			}
+			continue;
+		}
+
+		// Typed operations only write the payload. Everything else may change the type, including
+		// `OPCODE_OPERATOR_VALIDATED`, whose evaluators change the result to the type of the operation.
+		bool keeps_types = opcode >= GDScriptFunction::OPCODE_ADD_INT && opcode <= GDScriptFunction::OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT;
+		if (!keeps_types && !known_types.is_empty()) {
+			LocalVector<int> changed_types;
+			for (const KeyValue<int, GDScriptFunction::Opcode> &E : known_types) {
+				if (_references(i, E.key)) {
+					changed_types.push_back(E.key);
+				}
+			}
+			for (const int &E : changed_types) {
+				known_types.erase(E);
+			}
+		}
+
+		if (!_has_fallthrough(opcode) || opcode == GDScriptFunction::OPCODE_AWAIT || opcode == GDScriptFunction::OPCODE_AWAIT_RESUME) {
+			known_types.clear();
+		}
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_remove_redundant_lines() {
+	if (!strip_lines) {
+		return false;
+	}
+
+	bool changed = false;
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed || _get_opcode(i) != GDScriptFunction::OPCODE_LINE) {
+			continue;
+		}
+		// Nothing runs on this line, the next marker replaces it right away.
+		int next = _get_next_instruction(i);
+		if (next < (int)instructions.size() && _get_opcode(next) == GDScriptFunction::OPCODE_LINE) {
+			_remove(i);
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool GDScriptByteCodeOptimizer::_remove_useless_jumps() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (instructions[i].removed || _get_opcode(i) != GDScriptFunction::OPCODE_JUMP) {
+			continue;
+		}
+		// Everything between the jump and its destination was removed.
+		int target = _get_instruction_at(_get_operand(i, 0));
+		if (target > (int)i && target <= _get_next_instruction(i)) {
+			_remove(i);
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+void GDScriptByteCodeOptimizer::_emit() {
+	// Where each slot of the old code went. Removed instructions map to whatever follows them.
+	LocalVector<int> new_positions;
+	new_positions.resize(code.size() + 1);
+
+	int size = 0;
+	for (const Instruction &instruction : instructions) {
+		if (instruction.removed) {
+			new_positions[instruction.position] = size;
+			continue;
+		}
+		for (int i = 0; i < instruction.size; i++) {
+			new_positions[instruction.position + i] = size + i;
+		}
+		size += instruction.size;
+	}
+	new_positions[code.size()] = size;
+
+	Vector<int> new_code;
+	new_code.resize(size);
+	int *w = new_code.ptrw();
+	const int *r = code.ptr();
+	for (const Instruction &instruction : instructions) {
+		if (instruction.removed) {
+			continue;
+		}
+		int position = new_positions[instruction.position];
+		for (int i = 0; i < instruction.size; i++) {
+			w[position + i] = r[instruction.position + i];
+		}
+		int jump = _get_jump_operand((GDScriptFunction::Opcode)r[instruction.position]);
+		if (jump > 0) {
+			w[position + jump] = new_positions[r[instruction.position + jump]];
+		}
+	}
+
+	GDScriptFunction *function = generator->function;
+	for (int &E : function->default_arguments) {
+		E = new_positions[E];
+	}
+#ifdef TOOLS_ENABLED
+	for (int &E : function->global_index_offsets) {
+		E = new_positions[E];
+	}
+#endif
+
+	code = new_code;
+}
+
+GDScriptByteCodeOptimizer::GDScriptByteCodeOptimizer(GDScriptByteCodeGenerator *p_generator, Vector<int> &r_code) :
+		generator(p_generator),
+		code(r_code) {
+	constants.resize(generator->constant_map.size());
+	for (const KeyValue<Variant, int> &E : generator->constant_map) {
+		constants[E.value] = E.key;
+	}
+	first_temporary = GDScriptFunction::FIXED_ADDRESSES_MAX + generator->max_locals;
+	// Line markers are only needed to stop at every line while debugging.
+	strip_lines = !EngineDebugger::is_active();
+}
+
+void GDScriptByteCodeOptimizer::optimize(GDScriptByteCodeGenerator *p_generator) {
+	GDScriptByteCodeOptimizer optimizer(p_generator, p_generator->opcodes);
+	if (!optimizer._decode()) {
+		return;
+	}
+
+	// Each pass can expose more work to the others, but a couple of rounds get nearly everything.
+	for (int i = 0; i < 4; i++) {
+		bool changed = optimizer._fold_constants();
+		changed = optimizer._thread_jumps() || changed;
+		changed = optimizer._propagate_copies() || changed;
+		changed = optimizer._remove_dead_stores() || changed;
+		changed = optimizer._remove_redundant_type_adjusts() || changed;
+		changed = optimizer._remove_redundant_lines() || changed;
+		changed = optimizer._remove_useless_jumps() || changed;
+		if (!changed) {
+			break;
+		}
+	}
+
+	optimizer._emit();
+}
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  gdscript_bytecode_optimizer.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_OPTIMIZER_H
+#define GDSCRIPT_BYTECODE_OPTIMIZER_H
+
+#include "gdscript_function.h"
+
+#include "core/templates/local_vector.h"
+
+class GDScriptByteCodeGenerator;
+
+// Optional pass over the bytecode of a function, run by the generator once all its code is written
+// but before the function is finalized. Every rewrite keeps the instruction layouts the VM expects,
+// and the whole pass is skipped when the code contains something it doesn't understand.
+class GDScriptByteCodeOptimizer {
+	struct Instruction {
+		int position = 0;
+		int size = 0;
+		bool removed = false;
+		bool jump_target = false;
+	};
+
+	// Longest path the liveness queries follow before assuming a value is read.
+	static constexpr int MAX_LIVENESS_STEPS = 512;
+
+	GDScriptByteCodeGenerator *generator = nullptr;
+	Vector<int> &code;
+	LocalVector<Instruction> instructions;
+	LocalVector<int> instruction_at; // Instruction starting at each code position, or -1.
+	LocalVector<Variant> constants;
+	int first_temporary = 0;
+	bool strip_lines = false;
+
+	static int _get_instruction_size(const int *p_code, int p_position, int p_code_size);
+	static int _get_jump_operand(GDScriptFunction::Opcode p_opcode);
+	static bool _has_fallthrough(GDScriptFunction::Opcode p_opcode);
+	static void _get_address_operands(const int *p_code, int p_position, int p_size, int &r_first, int &r_count);
+	static bool _get_typed_operator(GDScriptFunction::Opcode p_opcode, Variant::Operator &r_operator, Variant::Type &r_result_type, Variant::Type &r_left_type, Variant::Type &r_right_type);
+
+	_FORCE_INLINE_ GDScriptFunction::Opcode _get_opcode(int p_instruction) const {
+		return (GDScriptFunction::Opcode)code[instructions[p_instruction].position];
+	}
+	_FORCE_INLINE_ int _get_operand(int p_instruction, int p_operand) const {
+		return code[instructions[p_instruction].position + 1 + p_operand];
+	}
+	_FORCE_INLINE_ bool _is_constant(int p_address) const {
+		return ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_CONSTANT && (uint32_t)(p_address & GDScriptFunction::ADDR_MASK) < constants.size();
+	}
+	_FORCE_INLINE_ bool _is_temporary(int p_address) const {
+		return ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_STACK && (p_address & GDScriptFunction::ADDR_MASK) >= first_temporary;
+	}
+
+	bool _decode();
+	int _get_next_instruction(int p_instruction) const;
+	int _get_instruction_at(int p_position) const;
+	bool _references(int p_instruction, int p_address, int p_skip_operand = -1) const;
+	bool _is_overwrite(int p_instruction, int p_address) const;
+	bool _is_read_after(int p_instruction, int p_address) const;
+	bool _can_contain_object(int p_temporary) const;
+	void _remove(int p_instruction);
+	void _rewrite(int p_instruction, const int *p_code, int p_size);
+
+	bool _thread_jumps();
+	bool _fold_constants();
+	bool _propagate_copies();
+	bool _remove_dead_stores();
+	bool _remove_redundant_type_adjusts();
+	bool _remove_redundant_lines();
+	bool _remove_useless_jumps();
+	void _emit();
+
+	GDScriptByteCodeOptimizer(GDScriptByteCodeGenerator *p_generator, Vector<int> &r_code);
+
+public:
+	static void optimize(GDScriptByteCodeGenerator *p_generator);
+};
+
+#endif // GDSCRIPT_BYTECODE_OPTIMIZER_H
@@ -32,10 +32,12 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_buffer.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/vector.h"
 
 GDScriptParserRef::Status GDScriptParserRef::get_status() const {
@@ -295,6 +297,14 @@ Vector<uint8_t> GDScriptCache::get_binary_tokens(const String &p_path) {
 	return buffer;
 }
 
+Vector<uint8_t> GDScriptCache::get_precompiled_bytecode(const String &p_binary_tokens_path) {
+	String bytecode_path = GDScriptBytecodeBuffer::get_bytecode_path(p_binary_tokens_path);
+	if (!FileAccess::exists(bytecode_path)) {
+		return Vector<uint8_t>();
+	}
+	return FileAccess::get_file_as_bytes(bytecode_path);
+}
+
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_error, const String &p_owner) {
 	MutexLock lock(singleton->mutex);
 	if (!p_owner.is_empty()) {
@@ -318,6 +328,7 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 			r_error = ERR_FILE_CANT_READ;
 		}
 		script->set_binary_tokens_source(buffer);
+		script->set_precompiled_bytecode(get_precompiled_bytecode(remapped_path));
 	} else {
 		r_error = script->load_source_code(remapped_path);
 	}
@@ -326,9 +337,14 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 		return Ref<GDScript>(); // Returns null and does not cache when the script fails to load.
 	}
 
-	Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
-	if (r_error == OK) {
-		GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+	// Precompiled bytecode describes the inner classes itself, so the parser is only needed as a fallback.
+	if (script->get_precompiled_bytecode().is_empty() || GDScriptBytecodeBuffer::make_scripts(script.ptr(), script->get_precompiled_bytecode()) != OK) {
+		script->set_precompiled_bytecode(Vector<uint8_t>());
+
+		Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
+		if (r_error == OK) {
+			GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+		}
 	}
 
 	singleton->shallow_gdscript_cache[p_path] = script;
@@ -440,6 +456,122 @@ void GDScriptCache::remove_static_script(const String &p_fqcn) {
 	singleton->static_gdscript_cache.erase(p_fqcn);
 }
 
+void GDScriptCache::_parse_ahead_step(uint32_t p_index, Ref<GDScriptParserRef> *p_parsers) {
+	// Parsing only touches the parser itself, analysis is left to whoever needs the script.
+	p_parsers[p_index]->raise_status(GDScriptParserRef::PARSED);
+}
+
+void GDScriptCache::parse_ahead(const Vector<String> &p_paths) {
+	if (singleton == nullptr) {
+		return;
+	}
+
+	// Scripts are parsed on WorkerThreadPool in waves: each wave parses the scripts they extend,
+	// which the analyzer is going to need first. Parsers are made outside of the cache lock and
+	// only published when done, so no one else can see a half-parsed tree.
+	HashSet<String> visited;
+	Vector<String> wave = p_paths;
+	while (!wave.is_empty()) {
+		Vector<Ref<GDScriptParserRef>> parsers;
+		{
+			MutexLock lock(singleton->mutex);
+			if (singleton->cleared) {
+				return;
+			}
+
+			for (const String &path : wave) {
+				if (visited.has(path)) {
+					continue;
+				}
+				visited.insert(path);
+
+				if (singleton->parser_map.has(path) || !FileAccess::exists(ResourceLoader::path_remap(path))) {
+					continue;
+				}
+
+				Ref<GDScriptParserRef> ref;
+				ref.instantiate();
+				ref->path = path;
+				ref->abandoned = true; // Not in the parser map yet.
+				ref->get_parser(); // Sets up the shared parser data on this thread.
+				parsers.push_back(ref);
+			}
+		}
+
+		if (parsers.is_empty()) {
+			break;
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(singleton, &GDScriptCache::_parse_ahead_step, parsers.ptrw(), parsers.size(), -1, true, SNAME("GDScriptParseAhead"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		wave.clear();
+
+		MutexLock lock(singleton->mutex);
+		if (singleton->cleared) {
+			return;
+		}
+
+		for (Ref<GDScriptParserRef> &ref : parsers) {
+			// Scripts that failed to parse are left for the regular path to report, as is any parsed meanwhile.
+			if (ref->result != OK || singleton->parser_map.has(ref->path)) {
+				continue;
+			}
+			ref->abandoned = false;
+			singleton->parser_map[ref->path] = ref.ptr();
+			singleton->parsed_ahead.push_back(ref);
+
+			const GDScriptParser::ClassNode *tree = ref->get_parser()->get_tree();
+			if (!tree->extends_path.is_empty()) {
+				String extends_path = tree->extends_path;
+				if (extends_path.is_relative_path()) {
+					extends_path = ref->path.get_base_dir().path_join(extends_path).simplify_path();
+				}
+				wave.push_back(extends_path);
+			} else if (!tree->extends.is_empty() && ScriptServer::is_global_class(tree->extends[0]->name)) {
+				wave.push_back(ScriptServer::get_global_class_path(tree->extends[0]->name));
+			}
+		}
+	}
+}
+
+Ref<GDScriptParserRef> GDScriptCache::take_parsed_ahead(const String &p_path, uint32_t p_source_hash) {
+	if (singleton == nullptr) {
+		return Ref<GDScriptParserRef>();
+	}
+
+	Ref<GDScriptParserRef> ref;
+	{
+		MutexLock lock(singleton->mutex);
+		for (int i = 0; i < singleton->parsed_ahead.size(); i++) {
+			if (singleton->parsed_ahead[i]->path == p_path) {
+				ref = singleton->parsed_ahead[i];
+				singleton->parsed_ahead.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	// Removed from the map or cleared since, or the file changed.
+	if (ref.is_null() || ref->abandoned || ref->get_status() == GDScriptParserRef::EMPTY || ref->get_source_hash() != p_source_hash) {
+		return Ref<GDScriptParserRef>();
+	}
+	return ref;
+}
+
+void GDScriptCache::release_parsed_ahead() {
+	if (singleton == nullptr) {
+		return;
+	}
+
+	Vector<Ref<GDScriptParserRef>> parsers;
+	{
+		MutexLock lock(singleton->mutex);
+		SWAP(parsers, singleton->parsed_ahead);
+	}
+	// Parsers no one else took a reference to are freed here, outside of the lock.
+}
+
 void GDScriptCache::clear() {
 	if (singleton == nullptr) {
 		return;
@@ -479,6 +611,7 @@ void GDScriptCache::clear() {
 	}
 
 	parser_map_refs.clear();
+	singleton->parsed_ahead.clear();
 	singleton->shallow_gdscript_cache.clear();
 	singleton->full_gdscript_cache.clear();
 }
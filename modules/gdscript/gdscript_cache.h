@@ -86,8 +86,11 @@ class GDScriptCache {
 	HashMap<String, Ref<GDScript>> static_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
 	HashMap<String, HashSet<String>> parser_inverse_dependencies;
+	// Parsers made ahead of time by parse_ahead(), kept alive until release_parsed_ahead().
+	Vector<Ref<GDScriptParserRef>> parsed_ahead;
 
 	friend class GDScript;
+	friend class GDScriptBytecodeBuffer;
 	friend class GDScriptParserRef;
 	friend class GDScriptInstance;
 
@@ -97,6 +100,8 @@ class GDScriptCache {
 
 	Mutex mutex;
 
+	void _parse_ahead_step(uint32_t p_index, Ref<GDScriptParserRef> *p_parsers);
+
 public:
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
@@ -105,12 +110,17 @@ public:
 	static void remove_parser(const String &p_path);
 	static String get_source_code(const String &p_path);
 	static Vector<uint8_t> get_binary_tokens(const String &p_path);
+	static Vector<uint8_t> get_precompiled_bytecode(const String &p_binary_tokens_path);
 	static Ref<GDScript> get_shallow_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
 	static Ref<GDScript> get_cached_script(const String &p_path);
 	static Error finish_compiling(const String &p_owner);
 	static void add_static_script(Ref<GDScript> p_script);
 	static void remove_static_script(const String &p_fqcn);
+	static void parse_ahead(const Vector<String> &p_paths);
+	// Hands over the parser parse_ahead() made for `p_path` if it was made from the same source, and stops keeping it alive.
+	static Ref<GDScriptParserRef> take_parsed_ahead(const String &p_path, uint32_t p_source_hash);
+	static void release_parsed_ahead();
 
 	static void clear();
 
@@ -90,6 +90,7 @@ public:
 	virtual void set_signature(const String &p_signature) = 0;
 #endif
 	virtual void set_initial_line(int p_line) = 0;
+	virtual void set_optimize_bytecode(bool p_enabled) = 0;
 
 	virtual void write_type_adjust(const Address &p_target, Variant::Type p_new_type) = 0;
 	virtual void write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) = 0;
@@ -33,6 +33,7 @@
 #include "gdscript.h"
 #include "gdscript_byte_codegen.h"
 #include "gdscript_cache.h"
+#include "gdscript_inline_cache.h"
 #include "gdscript_utility_functions.h"
 
 #include "core/config/engine.h"
@@ -1894,7 +1895,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 		// Add a newline before each statement, since the debugger needs those.
-		gen->write_newline(s->start_line);
+		if (!release_code) {
+			gen->write_newline(s->start_line);
+		}
 #endif
 
 		switch (s->type) {
@@ -1946,7 +1949,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 					// Add a newline before each branch, since the debugger needs those.
-					gen->write_newline(branch->start_line);
+					if (!release_code) {
+						gen->write_newline(branch->start_line);
+					}
 #endif
 					// For each pattern in branch.
 					GDScriptCodeGenerator::Address pattern_result = codegen.add_temporary();
@@ -2134,6 +2139,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (release_code) {
+					break;
+				}
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, as->condition);
@@ -2161,7 +2169,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::BREAKPOINT: {
 #ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
+				if (!release_code) {
+					gen->write_breakpoint();
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::VARIABLE: {
@@ -2241,6 +2251,7 @@ GDScriptFunction *GDScriptCompiler::_parse_function(Error &r_error, GDScript *p_
 	r_error = OK;
 	CodeGen codegen;
 	codegen.generator = memnew(GDScriptByteCodeGenerator);
+	codegen.generator->set_optimize_bytecode(optimize_bytecode);
 
 	codegen.class_node = p_class;
 	codegen.script = p_script;
@@ -2478,6 +2489,7 @@ GDScriptFunction *GDScriptCompiler::_make_static_initializer(Error &r_error, GDS
 	r_error = OK;
 	CodeGen codegen;
 	codegen.generator = memnew(GDScriptByteCodeGenerator);
+	codegen.generator->set_optimize_bytecode(optimize_bytecode);
 
 	codegen.class_node = p_class;
 	codegen.script = p_script;
@@ -2636,6 +2648,7 @@ Error GDScriptCompiler::_prepare_compilation(GDScript *p_script, const GDScriptP
 	parsing_classes.insert(p_script);
 
 	p_script->clearing = true;
+	GDScriptInlineCache::invalidate(p_script);
 
 	p_script->native = Ref<GDScriptNativeClass>();
 	p_script->base = Ref<GDScript>();
@@ -3231,6 +3244,7 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	const GDScriptParser::ClassNode *root = parser->get_tree();
 
 	source = p_script->get_path();
+	optimize_bytecode = GLOBAL_GET("gdscript/compiler/optimize_bytecode");
 
 	ScriptLambdaInfo old_lambda_info = _get_script_lambda_replacement_info(p_script);
 
@@ -3255,13 +3269,18 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
-	if (has_static_data && !root->annotated_static_unload) {
+	// Release code is only compiled to be exported, it must not replace the script the cache knows about.
+	if (has_static_data && !root->annotated_static_unload && !release_code) {
 		GDScriptCache::add_static_script(p_script);
 	}
 
 	return GDScriptCache::finish_compiling(main_script->path);
 }
 
+void GDScriptCompiler::set_release_code(bool p_enabled) {
+	release_code = p_enabled;
+}
+
 String GDScriptCompiler::get_error() const {
 	return error;
 }
@@ -174,11 +174,15 @@ class GDScriptCompiler {
 	String error;
 	GDScriptParser::ExpressionNode *awaited_node = nullptr;
 	bool has_static_data = false;
+	bool optimize_bytecode = false;
+	bool release_code = false;
 
 public:
 	static void convert_to_initializer_type(Variant &p_variant, const GDScriptParser::VariableNode *p_node);
 	static void make_scripts(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
+	// Leaves out line, assert and breakpoint opcodes, like a build without DEBUG_ENABLED would.
+	void set_release_code(bool p_enabled);
 
 	String get_error() const;
 	int get_error_line() const;
@@ -141,6 +141,72 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+
+#define DISASSEMBLE_TYPED_OPERATOR(m_opcode, m_operator) \
+	case OPCODE_##m_opcode: {                            \
+		text += "typed operator ";                       \
+		text += DADDR(3);                                \
+		text += " = ";                                   \
+		text += DADDR(1);                                \
+		text += " " m_operator " ";                      \
+		text += DADDR(2);                                \
+		incr += 4;                                       \
+	} break
+
+				DISASSEMBLE_TYPED_OPERATOR(ADD_INT, "+");
+				DISASSEMBLE_TYPED_OPERATOR(SUBTRACT_INT, "-");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_INT, "*");
+				DISASSEMBLE_TYPED_OPERATOR(ADD_FLOAT, "+");
+				DISASSEMBLE_TYPED_OPERATOR(SUBTRACT_FLOAT, "-");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_FLOAT, "*");
+				DISASSEMBLE_TYPED_OPERATOR(DIVIDE_FLOAT, "/");
+				DISASSEMBLE_TYPED_OPERATOR(ADD_VECTOR2, "+");
+				DISASSEMBLE_TYPED_OPERATOR(SUBTRACT_VECTOR2, "-");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_VECTOR2, "*");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_VECTOR2_FLOAT, "*");
+				DISASSEMBLE_TYPED_OPERATOR(ADD_VECTOR3, "+");
+				DISASSEMBLE_TYPED_OPERATOR(SUBTRACT_VECTOR3, "-");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_VECTOR3, "*");
+				DISASSEMBLE_TYPED_OPERATOR(MULTIPLY_VECTOR3_FLOAT, "*");
+				DISASSEMBLE_TYPED_OPERATOR(EQUAL_INT, "==");
+				DISASSEMBLE_TYPED_OPERATOR(EQUAL_FLOAT, "==");
+				DISASSEMBLE_TYPED_OPERATOR(NOT_EQUAL_INT, "!=");
+				DISASSEMBLE_TYPED_OPERATOR(NOT_EQUAL_FLOAT, "!=");
+				DISASSEMBLE_TYPED_OPERATOR(LESS_INT, "<");
+				DISASSEMBLE_TYPED_OPERATOR(LESS_FLOAT, "<");
+				DISASSEMBLE_TYPED_OPERATOR(LESS_EQUAL_INT, "<=");
+				DISASSEMBLE_TYPED_OPERATOR(LESS_EQUAL_FLOAT, "<=");
+				DISASSEMBLE_TYPED_OPERATOR(GREATER_INT, ">");
+				DISASSEMBLE_TYPED_OPERATOR(GREATER_FLOAT, ">");
+				DISASSEMBLE_TYPED_OPERATOR(GREATER_EQUAL_INT, ">=");
+				DISASSEMBLE_TYPED_OPERATOR(GREATER_EQUAL_FLOAT, ">=");
+
+#define DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(m_opcode, m_operator) \
+	case OPCODE_##m_opcode##_JUMP_IF_NOT: {                            \
+		text += "typed operator ";                                     \
+		text += DADDR(3);                                              \
+		text += " = ";                                                 \
+		text += DADDR(1);                                              \
+		text += " " m_operator " ";                                    \
+		text += DADDR(2);                                              \
+		text += ", jump-if-not to ";                                   \
+		text += itos(_code_ptr[ip + 4]);                               \
+		incr += 5;                                                     \
+	} break
+
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(EQUAL_INT, "==");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(EQUAL_FLOAT, "==");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(NOT_EQUAL_INT, "!=");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(NOT_EQUAL_FLOAT, "!=");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(LESS_INT, "<");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(LESS_FLOAT, "<");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(LESS_EQUAL_INT, "<=");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(LESS_EQUAL_FLOAT, "<=");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(GREATER_INT, ">");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(GREATER_FLOAT, ">");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(GREATER_EQUAL_INT, ">=");
+				DISASSEMBLE_TYPED_COMPARISON_JUMP_IF_NOT(GREATER_EQUAL_FLOAT, ">=");
+
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -267,7 +333,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -288,7 +354,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -597,7 +663,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
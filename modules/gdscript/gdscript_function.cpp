@@ -31,6 +31,8 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 
 Variant GDScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
@@ -104,6 +106,17 @@ void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<String
 	}
 }
 
+void GDScriptFunction::_allocate_inline_caches(int p_count) {
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+		_inline_caches_ptr = nullptr;
+	}
+	_inline_cache_count = p_count;
+	if (p_count > 0) {
+		_inline_caches_ptr = memnew_arr(GDScriptInlineCache, p_count);
+	}
+}
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -121,6 +134,14 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	GDScriptJIT::free_code(this);
+#endif
+
 	for (int i = 0; i < argument_types.size(); i++) {
 		argument_types.write[i].script_type_ref = Ref<Script>();
 	}
@@ -251,7 +272,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 void GDScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		// The first 3 are special addresses and not copied to the state, so we skip them here.
 		for (int i = 3; i < state.stack_size; i++) {
 			stack[i].~Variant();
@@ -260,6 +281,60 @@ void GDScriptFunctionState::_clear_stack() {
 	}
 }
 
+BinaryMutex GDScriptFunctionState::stack_pool_mutex;
+LocalVector<uint8_t *> GDScriptFunctionState::stack_pool[STACK_POOL_CLASSES];
+
+uint32_t GDScriptFunctionState::_get_stack_pool_class(uint32_t p_size) {
+	// Index of the smallest power of two holding the stack, relative to the smallest class.
+	uint32_t shift = p_size > 1 ? nearest_shift(p_size - 1) : 0;
+	return shift > STACK_POOL_MIN_SHIFT ? shift - STACK_POOL_MIN_SHIFT : 0;
+}
+
+uint8_t *GDScriptFunctionState::_alloc_stack(uint32_t p_size) {
+	uint32_t pool_class = _get_stack_pool_class(p_size);
+	if (pool_class >= STACK_POOL_CLASSES) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	{
+		MutexLock lock(stack_pool_mutex);
+		LocalVector<uint8_t *> &pool = stack_pool[pool_class];
+		if (!pool.is_empty()) {
+			uint8_t *stack = pool[pool.size() - 1];
+			pool.resize(pool.size() - 1);
+			return stack;
+		}
+	}
+	return (uint8_t *)memalloc(1 << (pool_class + STACK_POOL_MIN_SHIFT));
+}
+
+void GDScriptFunctionState::_free_stack(uint8_t *p_stack, uint32_t p_size) {
+	if (!p_stack) {
+		return;
+	}
+
+	uint32_t pool_class = _get_stack_pool_class(p_size);
+	if (pool_class < STACK_POOL_CLASSES) {
+		MutexLock lock(stack_pool_mutex);
+		LocalVector<uint8_t *> &pool = stack_pool[pool_class];
+		if (pool.size() < STACK_POOL_MAX_PER_CLASS) {
+			pool.push_back(p_stack);
+			return;
+		}
+	}
+	memfree(p_stack);
+}
+
+void GDScriptFunctionState::clear_stack_pool() {
+	MutexLock lock(stack_pool_mutex);
+	for (LocalVector<uint8_t *> &pool : stack_pool) {
+		for (uint8_t *stack : pool) {
+			memfree(stack);
+		}
+		pool.reset();
+	}
+}
+
 void GDScriptFunctionState::_clear_connections() {
 	List<Object::Connection> conns;
 	get_signals_connected_to_this(&conns);
@@ -288,4 +363,5 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+	_free_stack(state.stack, state.alloca_size);
 }
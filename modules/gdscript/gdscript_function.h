@@ -35,12 +35,15 @@
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/mutex.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 
+class GDScriptInlineCache;
 class GDScriptInstance;
 class GDScript;
 
@@ -218,6 +221,45 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_ADD_INT,
+		OPCODE_SUBTRACT_INT,
+		OPCODE_MULTIPLY_INT,
+		OPCODE_ADD_FLOAT,
+		OPCODE_SUBTRACT_FLOAT,
+		OPCODE_MULTIPLY_FLOAT,
+		OPCODE_DIVIDE_FLOAT,
+		OPCODE_ADD_VECTOR2,
+		OPCODE_SUBTRACT_VECTOR2,
+		OPCODE_MULTIPLY_VECTOR2,
+		OPCODE_MULTIPLY_VECTOR2_FLOAT,
+		OPCODE_ADD_VECTOR3,
+		OPCODE_SUBTRACT_VECTOR3,
+		OPCODE_MULTIPLY_VECTOR3,
+		OPCODE_MULTIPLY_VECTOR3_FLOAT,
+		OPCODE_EQUAL_INT,
+		OPCODE_NOT_EQUAL_INT,
+		OPCODE_LESS_INT,
+		OPCODE_LESS_EQUAL_INT,
+		OPCODE_GREATER_INT,
+		OPCODE_GREATER_EQUAL_INT,
+		OPCODE_EQUAL_FLOAT,
+		OPCODE_NOT_EQUAL_FLOAT,
+		OPCODE_LESS_FLOAT,
+		OPCODE_LESS_EQUAL_FLOAT,
+		OPCODE_GREATER_FLOAT,
+		OPCODE_GREATER_EQUAL_FLOAT,
+		OPCODE_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_NOT_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_LESS_INT_JUMP_IF_NOT,
+		OPCODE_LESS_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_GREATER_INT_JUMP_IF_NOT,
+		OPCODE_GREATER_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_NOT_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_LESS_FLOAT_JUMP_IF_NOT,
+		OPCODE_LESS_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_GREATER_FLOAT_JUMP_IF_NOT,
+		OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_NATIVE,
@@ -401,6 +443,9 @@ private:
 	friend class GDScript;
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptByteCodeOptimizer;
+	friend class GDScriptBytecodeBuffer;
+	friend class GDScriptJIT;
 	friend class GDScriptLanguage;
 
 	StringName name;
@@ -457,6 +502,7 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _inline_cache_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -475,6 +521,23 @@ private:
 	const GDScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	GDScriptInlineCache *_inline_caches_ptr = nullptr;
+
+#ifdef TOOLS_ENABLED
+	// Code offsets holding an index of the `GDScriptLanguage` global array, relocated when precompiled bytecode is loaded.
+	Vector<int> global_index_offsets;
+#endif
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	typedef void (*NativeCode)(Variant *p_stack, Variant *p_members, const Variant *p_constants, Variant *r_return);
+
+	// Tier-up state, see `GDScriptJIT`. Calls and loop back-edges count towards the threshold.
+	SafeNumeric<uint32_t> _jit_counter;
+	SafeFlag _jit_attempted;
+	SafeFlag _jit_ready;
+	NativeCode _jit_code = nullptr;
+	uint32_t _jit_code_size = 0;
+#endif
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -509,6 +572,8 @@ private:
 	} profile;
 #endif
 
+	void _allocate_inline_caches(int p_count);
+
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
 
@@ -522,7 +587,7 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr; // Owned, see GDScriptFunctionState::_alloc_stack().
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -543,6 +608,10 @@ public:
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	bool is_native_compiled() const { return _jit_ready.is_set(); }
+#endif
+
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
 
@@ -566,6 +635,20 @@ class GDScriptFunctionState : public RefCounted {
 	SelfList<GDScriptFunctionState> scripts_list;
 	SelfList<GDScriptFunctionState> instances_list;
 
+	// Stacks of awaiting functions are recycled, as code awaiting every frame would otherwise allocate
+	// one per await. Buffers are pooled in power of two size classes.
+	enum {
+		STACK_POOL_MIN_SHIFT = 8, // 256 bytes.
+		STACK_POOL_CLASSES = 10, // Up to 128 KiB, bigger stacks aren't pooled.
+		STACK_POOL_MAX_PER_CLASS = 256,
+	};
+	static BinaryMutex stack_pool_mutex;
+	static LocalVector<uint8_t *> stack_pool[STACK_POOL_CLASSES];
+
+	static uint32_t _get_stack_pool_class(uint32_t p_size);
+	static uint8_t *_alloc_stack(uint32_t p_size);
+	static void _free_stack(uint8_t *p_stack, uint32_t p_size);
+
 protected:
 	static void _bind_methods();
 
@@ -576,6 +659,8 @@ public:
 	void _clear_stack();
 	void _clear_connections();
 
+	static void clear_stack_pool();
+
 	GDScriptFunctionState();
 	~GDScriptFunctionState();
 };
@@ -0,0 +1,211 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_inline_cache.h"
+
+#include "core/core_string_names.h"
+#include "core/object/class_db.h"
+
+#include "scene/scene_string_names.h"
+
+SafeNumeric<uint32_t> GDScriptInlineCache::epoch;
+
+bool GDScriptInlineCache::_script_shadows(const GDScript *p_script, const StringName &p_name, Access p_access) {
+	// Mirrors the lookup order of `GDScriptInstance::get()`, `set()` and `callp()`, which run before the native class is tried.
+	if (p_access != ACCESS_CALL && p_script->member_indices.has(p_name)) {
+		return true;
+	}
+	const StringName &fallback = p_access == ACCESS_SET ? GDScriptLanguage::get_singleton()->strings._set : GDScriptLanguage::get_singleton()->strings._get;
+	for (const GDScript *sptr = p_script; sptr; sptr = sptr->_base) {
+		if (!sptr->valid || sptr->member_functions.has(p_name)) {
+			return true;
+		}
+		if (p_access == ACCESS_CALL) {
+			continue;
+		}
+		if (sptr->static_variables_indices.has(p_name) || sptr->member_functions.has(fallback)) {
+			return true;
+		}
+		if (p_access == ACCESS_GET && (sptr->constants.has(p_name) || sptr->_signals.has(p_name) || sptr->subclasses.has(p_name))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void GDScriptInlineCache::_resolve_native(const Shape &p_shape, const StringName &p_name, Access p_access, Target &r_target) {
+	const StringName &class_name = p_shape.object->get_class_name();
+	ClassDB::APIType api = ClassDB::get_api_type(class_name);
+	if (api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+		// Extension instances may handle names in their own callbacks first.
+		return;
+	}
+
+	if (p_access == ACCESS_CALL) {
+		if (p_name == CoreStringName(free_)) {
+			return;
+		}
+		r_target.method = ClassDB::get_method(class_name, p_name);
+		if (r_target.method) {
+			r_target.kind = KIND_METHOD_BIND;
+		}
+		return;
+	}
+
+	// Only plain properties, constants, methods and signals of the same name are left to `ClassDB::get_property()`.
+	if (!ClassDB::has_property(class_name, p_name) || ClassDB::get_property_index(class_name, p_name) != -1) {
+		return;
+	}
+	if (ClassDB::has_integer_constant(class_name, p_name) || ClassDB::has_method(class_name, p_name) || ClassDB::has_signal(class_name, p_name)) {
+		return;
+	}
+	StringName accessor = p_access == ACCESS_SET ? ClassDB::get_property_setter(class_name, p_name) : ClassDB::get_property_getter(class_name, p_name);
+	if (accessor == StringName()) {
+		return;
+	}
+	r_target.method = ClassDB::get_method(class_name, accessor);
+	if (r_target.method) {
+		r_target.kind = KIND_METHOD_BIND;
+	}
+}
+
+bool GDScriptInlineCache::_resolve_target(const Shape &p_shape, const StringName &p_name, Access p_access, Target &r_target) {
+	r_target.type = p_shape.type;
+	r_target.native = p_shape.native;
+	r_target.script = p_shape.script;
+
+	if (p_shape.type != Variant::OBJECT) {
+		if (p_access == ACCESS_GET) {
+			r_target.getter = Variant::get_member_validated_getter(p_shape.type, p_name);
+			if (r_target.getter) {
+				r_target.kind = KIND_BUILTIN_GETTER;
+			}
+		} else if (p_access == ACCESS_SET) {
+			r_target.setter = Variant::get_member_validated_setter(p_shape.type, p_name);
+			if (r_target.setter) {
+				r_target.kind = KIND_BUILTIN_SETTER;
+				r_target.value_type = Variant::get_member_type(p_shape.type, p_name);
+			}
+		}
+		return true;
+	}
+
+	if (!p_shape.script) {
+		_resolve_native(p_shape, p_name, p_access, r_target);
+		return true;
+	}
+
+	for (const GDScript *sptr = p_shape.script; sptr; sptr = sptr->_base) {
+		if (!sptr->valid) {
+			// Nothing is cached until the whole inheritance chain is compiled.
+			return false;
+		}
+	}
+
+	const GDScript *script = p_shape.script;
+	if (p_access == ACCESS_CALL) {
+		if (p_name == SceneStringName(_ready)) {
+			// `GDScriptInstance::callp()` runs the implicit ready functions first.
+			return true;
+		}
+		for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			HashMap<StringName, GDScriptFunction *>::ConstIterator E = sptr->member_functions.find(p_name);
+			if (E) {
+				r_target.kind = KIND_SCRIPT_FUNCTION;
+				r_target.function = E->value;
+				return true;
+			}
+		}
+	} else {
+		HashMap<StringName, GDScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
+		if (E) {
+			if (E->value.getter == StringName() && E->value.setter == StringName()) {
+				r_target.kind = KIND_MEMBER;
+				r_target.member_index = E->value.index;
+				r_target.member_type = E->value.data_type.has_type ? &E->value.data_type : nullptr;
+			}
+			return true;
+		}
+	}
+
+	if (!_script_shadows(script, p_name, p_access)) {
+		_resolve_native(p_shape, p_name, p_access, r_target);
+	}
+	return true;
+}
+
+const GDScriptInlineCache::Target *GDScriptInlineCache::_resolve(const Shape &p_shape, const StringName &p_name, Access p_access) {
+	const Entry *current = entry.load(std::memory_order_acquire);
+	uint32_t current_epoch = epoch.get();
+
+	Target target;
+	if (!_resolve_target(p_shape, p_name, p_access, target)) {
+		return nullptr;
+	}
+
+	Entry *next = memnew(Entry);
+	next->previous = current;
+	next->epoch = current_epoch;
+	if (current) {
+		next->generation = current->generation + 1;
+		for (int i = 0; i < current->target_count; i++) {
+			// Keep what does not depend on scripts, or was resolved since the last invalidation.
+			if (!current->targets[i].script || current->epoch == current_epoch) {
+				next->targets[next->target_count++] = current->targets[i];
+			}
+		}
+	}
+
+	if (next->generation >= MAX_GENERATIONS || next->target_count == MAX_TARGETS) {
+		next->megamorphic = true;
+		next->target_count = 0;
+	} else {
+		next->targets[next->target_count++] = target;
+		for (GDScript *sptr = target.script; sptr; sptr = sptr->_base) {
+			sptr->inline_cached.set();
+		}
+	}
+
+	if (!entry.compare_exchange_strong(current, next, std::memory_order_acq_rel)) {
+		// Another thread updated the site first, keep its entry and use the regular lookup this time.
+		memdelete(next);
+		return nullptr;
+	}
+	return next->megamorphic ? nullptr : &next->targets[next->target_count - 1];
+}
+
+GDScriptInlineCache::~GDScriptInlineCache() {
+	const Entry *current = entry.load(std::memory_order_acquire);
+	while (current) {
+		const Entry *previous = current->previous;
+		memdelete(const_cast<Entry *>(current));
+		current = previous;
+	}
+}
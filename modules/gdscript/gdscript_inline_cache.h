@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_INLINE_CACHE_H
+#define GDSCRIPT_INLINE_CACHE_H
+
+#include "gdscript.h"
+
+#include "core/config/engine.h"
+#include "core/object/method_bind.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
+
+// Cache of a single untyped `OPCODE_GET_NAMED`, `OPCODE_SET_NAMED` or `OPCODE_CALL*` site.
+// It remembers how the name resolved for the last receiver shapes (a builtin type, or a native class
+// with an optional GDScript), so the next executions skip the lookups of `Variant::get_named()`,
+// `Object::get()` and `Object::callp()`. Published entries are immutable and only freed with the function.
+class GDScriptInlineCache {
+public:
+	enum Access {
+		ACCESS_GET,
+		ACCESS_SET,
+		ACCESS_CALL,
+	};
+
+	enum Kind {
+		KIND_GENERIC, // Resolved through the regular lookup.
+		KIND_BUILTIN_GETTER,
+		KIND_BUILTIN_SETTER,
+		KIND_MEMBER,
+		KIND_METHOD_BIND,
+		KIND_SCRIPT_FUNCTION,
+	};
+
+	static constexpr int MAX_TARGETS = 4;
+	// An entry is replaced at most this many times, after which the site stays megamorphic.
+	static constexpr uint32_t MAX_GENERATIONS = 64;
+
+	struct Shape {
+		Variant::Type type = Variant::NIL;
+		const void *native = nullptr;
+		GDScript *script = nullptr;
+		Object *object = nullptr;
+		GDScriptInstance *instance = nullptr;
+	};
+
+	struct Target {
+		Variant::Type type = Variant::NIL;
+		const void *native = nullptr;
+		GDScript *script = nullptr;
+
+		Kind kind = KIND_GENERIC;
+		Variant::Type value_type = Variant::NIL;
+		int member_index = -1;
+		const GDScriptDataType *member_type = nullptr;
+		Variant::ValidatedGetter getter = nullptr;
+		Variant::ValidatedSetter setter = nullptr;
+		MethodBind *method = nullptr;
+		GDScriptFunction *function = nullptr;
+	};
+
+	struct Entry {
+		const Entry *previous = nullptr;
+		uint32_t epoch = 0;
+		uint32_t generation = 0;
+		bool megamorphic = false;
+		int target_count = 0;
+		Target targets[MAX_TARGETS];
+	};
+
+private:
+	static SafeNumeric<uint32_t> epoch;
+
+	std::atomic<const Entry *> entry;
+
+	static bool _script_shadows(const GDScript *p_script, const StringName &p_name, Access p_access);
+	static void _resolve_native(const Shape &p_shape, const StringName &p_name, Access p_access, Target &r_target);
+	static bool _resolve_target(const Shape &p_shape, const StringName &p_name, Access p_access, Target &r_target);
+	const Target *_resolve(const Shape &p_shape, const StringName &p_name, Access p_access);
+
+	_FORCE_INLINE_ static bool _get_shape(const Variant *p_base, Shape &r_shape) {
+		r_shape.type = p_base->get_type();
+		if (r_shape.type != Variant::OBJECT) {
+			return true;
+		}
+
+		Object *obj = p_base->get_validated_object();
+		if (unlikely(!obj)) {
+			return false;
+		}
+		ScriptInstance *script_instance = obj->get_script_instance();
+		if (script_instance) {
+			if (script_instance->get_language() != GDScriptLanguage::get_singleton() || script_instance->is_placeholder()) {
+				return false;
+			}
+			r_shape.instance = static_cast<GDScriptInstance *>(script_instance);
+			r_shape.script = r_shape.instance->script.ptr();
+		}
+		r_shape.object = obj;
+		r_shape.native = obj->get_class_name().data_unique_pointer();
+		return true;
+	}
+
+	_FORCE_INLINE_ const Target *_lookup(const Variant *p_base, const StringName &p_name, Access p_access, Shape &r_shape) {
+		const Entry *current = entry.load(std::memory_order_acquire);
+		if (current && current->megamorphic) {
+			return nullptr;
+		}
+		if (!_get_shape(p_base, r_shape)) {
+			return nullptr;
+		}
+		if (current) {
+			// Targets depending on a script are dropped when scripts are torn down, see `invalidate()`.
+			bool script_targets_valid = current->epoch == epoch.get();
+			for (int i = 0; i < current->target_count; i++) {
+				const Target &target = current->targets[i];
+				if (target.type == r_shape.type && target.native == r_shape.native && target.script == r_shape.script && (!target.script || script_targets_valid)) {
+					return &target;
+				}
+			}
+		}
+		return _resolve(r_shape, p_name, p_access);
+	}
+
+public:
+	// Must be called before the member tables or functions of a script are cleared or freed.
+	static void invalidate(GDScript *p_script) {
+		if (p_script->inline_cached.is_set()) {
+			p_script->inline_cached.clear();
+			epoch.increment();
+		}
+	}
+
+	// The following return `false` when the site can't handle the receiver, and the caller has to use the regular lookup.
+
+	_FORCE_INLINE_ bool get_named(const Variant *p_base, const StringName &p_name, Variant *r_ret) {
+		Shape shape;
+		const Target *target = _lookup(p_base, p_name, ACCESS_GET, shape);
+		if (!target) {
+			return false;
+		}
+
+		// Keep the base alive until the value is read when it is overwritten by the result.
+		Variant aliased;
+		Variant *ret = p_base == r_ret ? &aliased : r_ret;
+		switch (target->kind) {
+			case KIND_BUILTIN_GETTER: {
+				target->getter(p_base, ret);
+			} break;
+			case KIND_MEMBER: {
+				const Vector<Variant> &members = shape.instance->members;
+				if (unlikely(target->member_index >= members.size())) {
+					return false;
+				}
+				*ret = members[target->member_index];
+			} break;
+			case KIND_METHOD_BIND: {
+				Callable::CallError ce;
+				*ret = target->method->call(shape.object, nullptr, 0, ce);
+			} break;
+			default: {
+				return false;
+			}
+		}
+		if (ret == &aliased) {
+			*r_ret = aliased;
+		}
+		return true;
+	}
+
+	_FORCE_INLINE_ bool set_named(Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+#ifdef TOOLS_ENABLED
+		// `Object::set()` also flags edited objects, which only matters to the editor.
+		if (Engine::get_singleton()->is_editor_hint()) {
+			return false;
+		}
+#endif
+		Shape shape;
+		const Target *target = _lookup(p_base, p_name, ACCESS_SET, shape);
+		if (!target) {
+			return false;
+		}
+
+		switch (target->kind) {
+			case KIND_BUILTIN_SETTER: {
+				if (p_value->get_type() != target->value_type) {
+					return false;
+				}
+				target->setter(p_base, p_value);
+				r_valid = true;
+			} break;
+			case KIND_MEMBER: {
+				Vector<Variant> &members = shape.instance->members;
+				if (unlikely(target->member_index >= members.size()) || (target->member_type && !target->member_type->is_type(*p_value))) {
+					return false;
+				}
+				members.write[target->member_index] = *p_value;
+				r_valid = true;
+			} break;
+			case KIND_METHOD_BIND: {
+				Callable::CallError ce;
+				const Variant *args[1] = { p_value };
+				target->method->call(shape.object, args, 1, ce);
+				r_valid = ce.error == Callable::CallError::CALL_OK;
+			} break;
+			default: {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Like the validated method bind opcodes, this skips the debug lock of `Object::callp()`.
+	_FORCE_INLINE_ bool call(const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+		Shape shape;
+		const Target *target = _lookup(p_base, p_name, ACCESS_CALL, shape);
+		if (!target) {
+			return false;
+		}
+
+		r_error.error = Callable::CallError::CALL_OK;
+		switch (target->kind) {
+			case KIND_SCRIPT_FUNCTION: {
+				r_ret = target->function->call(shape.instance, p_args, p_argcount, r_error);
+			} break;
+			case KIND_METHOD_BIND: {
+				r_ret = target->method->call(shape.object, p_args, p_argcount, r_error);
+			} break;
+			default: {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	GDScriptInlineCache() :
+			entry(nullptr) {}
+	~GDScriptInlineCache();
+};
+
+#endif // GDSCRIPT_INLINE_CACHE_H
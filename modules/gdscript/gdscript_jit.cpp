@@ -0,0 +1,824 @@
+/**************************************************************************/
+/*  gdscript_jit.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_jit.h"
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+#include "core/config/project_settings.h"
+#include "core/variant/variant_internal.h"
+
+#include <sys/mman.h>
+
+uint32_t GDScriptJIT::hot_threshold = 0;
+BinaryMutex GDScriptJIT::mutex;
+
+// Minimal x86-64 encoder for the instruction templates, System V calling convention.
+// Operands live in memory, addressed as displacements from one of the base registers below.
+class GDScriptNativeAssembler {
+public:
+	enum Register {
+		RAX = 0,
+		RCX = 1,
+		RDX = 2,
+		RBX = 3,
+		RSP = 4,
+		RSI = 6,
+		RDI = 7,
+		R12 = 12,
+		R13 = 13,
+		R14 = 14,
+	};
+
+	enum Condition {
+		COND_B = 0x2,
+		COND_AE = 0x3,
+		COND_E = 0x4,
+		COND_NE = 0x5,
+		COND_A = 0x7,
+		COND_P = 0xA,
+		COND_NP = 0xB,
+		COND_L = 0xC,
+		COND_GE = 0xD,
+		COND_LE = 0xE,
+		COND_G = 0xF,
+	};
+
+	struct Memory {
+		Register base = RSP;
+		int32_t displacement = 0;
+
+		Memory offset(int32_t p_offset) const {
+			Memory memory = *this;
+			memory.displacement += p_offset;
+			return memory;
+		}
+	};
+
+	LocalVector<uint8_t> bytes;
+
+	void emit_byte(uint8_t p_byte) { bytes.push_back(p_byte); }
+	void emit_int32(int32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			emit_byte((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+	void emit_int64(uint64_t p_value) {
+		for (int i = 0; i < 8; i++) {
+			emit_byte((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+	void patch_int32(uint32_t p_position, int32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			bytes[p_position + i] = (p_value >> (i * 8)) & 0xFF;
+		}
+	}
+
+	void emit_rex(bool p_wide, int p_reg, int p_base) {
+		uint8_t rex = 0x40 | (p_wide ? 0x08 : 0) | ((p_reg & 8) ? 0x04 : 0) | ((p_base & 8) ? 0x01 : 0);
+		if (rex != 0x40) {
+			emit_byte(rex);
+		}
+	}
+	// ModRM with a 32-bit displacement, RSP and R12 also need a SIB byte.
+	void emit_memory(int p_reg, const Memory &p_memory) {
+		emit_byte(0x80 | ((p_reg & 7) << 3) | (p_memory.base & 7));
+		if ((p_memory.base & 7) == RSP) {
+			emit_byte(0x24);
+		}
+		emit_int32(p_memory.displacement);
+	}
+
+	// `op reg64, [mem]` and `op [mem], reg64`, depending on the opcode.
+	void op_memory(uint8_t p_opcode, Register p_reg, const Memory &p_memory) {
+		emit_rex(true, p_reg, p_memory.base);
+		emit_byte(p_opcode);
+		emit_memory(p_reg, p_memory);
+	}
+	void load(Register p_reg, const Memory &p_memory) { op_memory(0x8B, p_reg, p_memory); }
+	void store(const Memory &p_memory, Register p_reg) { op_memory(0x89, p_reg, p_memory); }
+	void lea(Register p_reg, const Memory &p_memory) { op_memory(0x8D, p_reg, p_memory); }
+	void add(Register p_reg, const Memory &p_memory) { op_memory(0x03, p_reg, p_memory); }
+	void sub(Register p_reg, const Memory &p_memory) { op_memory(0x2B, p_reg, p_memory); }
+	void cmp(Register p_reg, const Memory &p_memory) { op_memory(0x3B, p_reg, p_memory); }
+	void imul(Register p_reg, const Memory &p_memory) {
+		emit_rex(true, p_reg, p_memory.base);
+		emit_byte(0x0F);
+		emit_byte(0xAF);
+		emit_memory(p_reg, p_memory);
+	}
+	void store_byte(const Memory &p_memory, Register p_reg) {
+		emit_rex(false, p_reg, p_memory.base);
+		emit_byte(0x88);
+		emit_memory(p_reg, p_memory);
+	}
+
+	// Scalar double operations on `xmm0`.
+	void sse(uint8_t p_prefix, uint8_t p_opcode, int p_xmm, const Memory &p_memory) {
+		emit_byte(p_prefix);
+		emit_rex(false, p_xmm, p_memory.base);
+		emit_byte(0x0F);
+		emit_byte(p_opcode);
+		emit_memory(p_xmm, p_memory);
+	}
+	void movsd_load(const Memory &p_memory) { sse(0xF2, 0x10, 0, p_memory); }
+	void movsd_store(const Memory &p_memory) { sse(0xF2, 0x11, 0, p_memory); }
+	void ucomisd(const Memory &p_memory) { sse(0x66, 0x2E, 0, p_memory); }
+
+	void mov(Register p_dst, Register p_src) {
+		emit_rex(true, p_src, p_dst);
+		emit_byte(0x89);
+		emit_byte(0xC0 | ((p_src & 7) << 3) | (p_dst & 7));
+	}
+	void mov_imm32(Register p_reg, int32_t p_value) {
+		emit_rex(false, 0, p_reg);
+		emit_byte(0xB8 + (p_reg & 7));
+		emit_int32(p_value);
+	}
+	void mov_imm64(Register p_reg, uint64_t p_value) {
+		emit_rex(true, 0, p_reg);
+		emit_byte(0xB8 + (p_reg & 7));
+		emit_int64(p_value);
+	}
+	void add_imm8(Register p_reg, int8_t p_value) {
+		emit_rex(true, 0, p_reg);
+		emit_byte(0x83);
+		emit_byte(0xC0 | (p_reg & 7));
+		emit_byte(p_value);
+	}
+	void sub_rsp(int32_t p_value) {
+		emit_byte(0x48);
+		emit_byte(0x81);
+		emit_byte(0xEC);
+		emit_int32(p_value);
+	}
+	void add_rsp(int32_t p_value) {
+		emit_byte(0x48);
+		emit_byte(0x81);
+		emit_byte(0xC4);
+		emit_int32(p_value);
+	}
+	void push(Register p_reg) {
+		emit_rex(false, 0, p_reg);
+		emit_byte(0x50 + (p_reg & 7));
+	}
+	void pop(Register p_reg) {
+		emit_rex(false, 0, p_reg);
+		emit_byte(0x58 + (p_reg & 7));
+	}
+	void setcc(Condition p_condition, Register p_reg) {
+		emit_byte(0x0F);
+		emit_byte(0x90 + p_condition);
+		emit_byte(0xC0 | p_reg);
+	}
+	void test_al() {
+		emit_byte(0x84);
+		emit_byte(0xC0);
+	}
+	void and_al_cl() {
+		emit_byte(0x20);
+		emit_byte(0xC8);
+	}
+	void or_al_cl() {
+		emit_byte(0x08);
+		emit_byte(0xC8);
+	}
+	void call(const void *p_function) {
+		mov_imm64(RAX, (uint64_t)p_function);
+		emit_byte(0xFF);
+		emit_byte(0xD0);
+	}
+	void ret() { emit_byte(0xC3); }
+
+	// Jumps return the position of their displacement, to be patched once the target is known.
+	uint32_t jmp() {
+		emit_byte(0xE9);
+		emit_int32(0);
+		return bytes.size() - 4;
+	}
+	uint32_t jcc(Condition p_condition) {
+		emit_byte(0x0F);
+		emit_byte(0x80 + p_condition);
+		emit_int32(0);
+		return bytes.size() - 4;
+	}
+};
+
+typedef GDScriptNativeAssembler Asm;
+
+static void _native_assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+static void _native_assign_null(Variant *p_dst) {
+	*p_dst = Variant();
+}
+
+static void _native_assign_bool(Variant *p_dst, bool p_value) {
+	*p_dst = p_value;
+}
+
+static bool _native_booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+static bool _native_iterate_begin_int(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	int64_t size = *VariantInternal::get_int(p_container);
+
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = 0;
+
+	if (size > 0) {
+		VariantInternal::initialize(p_iterator, Variant::INT);
+		*VariantInternal::get_int(p_iterator) = 0;
+		return true;
+	}
+	return false;
+}
+
+class GDScriptJIT::NativeCompiler {
+	const GDScriptFunction *function = nullptr;
+	const int *code = nullptr;
+	int code_size = 0;
+	int ip = 0;
+
+	Asm assembler;
+	// Native offset of every bytecode position an instruction starts at, or -1.
+	LocalVector<int> labels;
+	struct Fixup {
+		uint32_t position = 0;
+		int target = 0; // Bytecode position, or -1 for the epilogue.
+	};
+	LocalVector<Fixup> fixups;
+
+	int32_t frame_size = 0;
+	int32_t int_offset = 0;
+	int32_t float_offset = 0;
+	int32_t bool_offset = 0;
+
+	bool _get_memory(int p_operand, Asm::Memory &r_memory) const {
+		int address = code[ip + 1 + p_operand];
+		int index = address & GDScriptFunction::ADDR_MASK;
+		switch ((address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK:
+				ERR_FAIL_INDEX_V(index, function->_stack_size, false);
+				r_memory.base = Asm::RBX;
+				break;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT:
+				ERR_FAIL_INDEX_V(index, function->_constant_count, false);
+				r_memory.base = Asm::R13;
+				break;
+			case GDScriptFunction::ADDR_TYPE_MEMBER:
+				if (function->is_static()) {
+					return false;
+				}
+				r_memory.base = Asm::R12;
+				break;
+			default:
+				return false;
+		}
+		r_memory.displacement = index * (int32_t)sizeof(Variant);
+		return true;
+	}
+
+	void _jump_to(int p_target, uint32_t p_position) {
+		Fixup fixup;
+		fixup.position = p_position;
+		fixup.target = p_target;
+		fixups.push_back(fixup);
+	}
+
+	bool _lea_operand(Asm::Register p_reg, int p_operand) {
+		Asm::Memory memory;
+		if (!_get_memory(p_operand, memory)) {
+			return false;
+		}
+		assembler.lea(p_reg, memory);
+		return true;
+	}
+
+	bool _emit_int_operator(GDScriptFunction::Opcode p_opcode);
+	bool _emit_float_operator(GDScriptFunction::Opcode p_opcode);
+	bool _emit_evaluator(Variant::Operator p_operator, Variant::Type p_left, Variant::Type p_right);
+	bool _emit_int_comparison(Asm::Condition p_condition, bool p_jump);
+	bool _emit_float_comparison(Variant::Operator p_operator, bool p_jump);
+	bool _emit_call(const void *p_function, int p_operand_count);
+	bool _emit_validated_call(bool p_builtin);
+	bool _emit_instruction(int &r_size);
+
+public:
+	bool compile();
+	Asm &get_assembler() { return assembler; }
+
+	NativeCompiler(const GDScriptFunction *p_function) :
+			function(p_function),
+			code(p_function->_code_ptr),
+			code_size(p_function->_code_size) {
+		// Payload offsets inside a `Variant`, the typed templates read and write it directly.
+		Variant probe;
+		int_offset = (const uint8_t *)VariantInternal::get_int(&probe) - (const uint8_t *)&probe;
+		float_offset = (const uint8_t *)VariantInternal::get_float(&probe) - (const uint8_t *)&probe;
+		bool_offset = (const uint8_t *)VariantInternal::get_bool(&probe) - (const uint8_t *)&probe;
+	}
+};
+
+bool GDScriptJIT::NativeCompiler::_emit_int_operator(GDScriptFunction::Opcode p_opcode) {
+	Asm::Memory a, b, dst;
+	if (!_get_memory(0, a) || !_get_memory(1, b) || !_get_memory(2, dst)) {
+		return false;
+	}
+	assembler.load(Asm::RAX, a.offset(int_offset));
+	switch (p_opcode) {
+		case GDScriptFunction::OPCODE_ADD_INT:
+			assembler.add(Asm::RAX, b.offset(int_offset));
+			break;
+		case GDScriptFunction::OPCODE_SUBTRACT_INT:
+			assembler.sub(Asm::RAX, b.offset(int_offset));
+			break;
+		default:
+			assembler.imul(Asm::RAX, b.offset(int_offset));
+			break;
+	}
+	assembler.store(dst.offset(int_offset), Asm::RAX);
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_float_operator(GDScriptFunction::Opcode p_opcode) {
+	Asm::Memory a, b, dst;
+	if (!_get_memory(0, a) || !_get_memory(1, b) || !_get_memory(2, dst)) {
+		return false;
+	}
+	uint8_t operation = 0;
+	switch (p_opcode) {
+		case GDScriptFunction::OPCODE_ADD_FLOAT:
+			operation = 0x58;
+			break;
+		case GDScriptFunction::OPCODE_SUBTRACT_FLOAT:
+			operation = 0x5C;
+			break;
+		case GDScriptFunction::OPCODE_MULTIPLY_FLOAT:
+			operation = 0x59;
+			break;
+		default:
+			operation = 0x5E;
+			break;
+	}
+	assembler.movsd_load(a.offset(float_offset));
+	assembler.sse(0xF2, operation, 0, b.offset(float_offset));
+	assembler.movsd_store(dst.offset(float_offset));
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_evaluator(Variant::Operator p_operator, Variant::Type p_left, Variant::Type p_right) {
+	Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(p_operator, p_left, p_right);
+	ERR_FAIL_NULL_V(evaluator, false);
+	if (!_lea_operand(Asm::RDI, 0) || !_lea_operand(Asm::RSI, 1) || !_lea_operand(Asm::RDX, 2)) {
+		return false;
+	}
+	assembler.call((const void *)evaluator);
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_int_comparison(Asm::Condition p_condition, bool p_jump) {
+	Asm::Memory a, b, dst;
+	if (!_get_memory(0, a) || !_get_memory(1, b) || !_get_memory(2, dst)) {
+		return false;
+	}
+	assembler.load(Asm::RAX, a.offset(int_offset));
+	assembler.cmp(Asm::RAX, b.offset(int_offset));
+	assembler.setcc(p_condition, Asm::RAX);
+	assembler.store_byte(dst.offset(bool_offset), Asm::RAX);
+	if (p_jump) {
+		assembler.test_al();
+		_jump_to(code[ip + 4], assembler.jcc(Asm::COND_E));
+	}
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_float_comparison(Variant::Operator p_operator, bool p_jump) {
+	Asm::Memory a, b, dst;
+	if (!_get_memory(0, a) || !_get_memory(1, b) || !_get_memory(2, dst)) {
+		return false;
+	}
+
+	// `ucomisd` sets CF on unordered results, so swapping the operands for "less" comparisons
+	// lets NaN fail all of them like in C++.
+	switch (p_operator) {
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+			assembler.movsd_load(b.offset(float_offset));
+			assembler.ucomisd(a.offset(float_offset));
+			assembler.setcc(p_operator == Variant::OP_LESS ? Asm::COND_A : Asm::COND_AE, Asm::RAX);
+			break;
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+			assembler.movsd_load(a.offset(float_offset));
+			assembler.ucomisd(b.offset(float_offset));
+			assembler.setcc(p_operator == Variant::OP_GREATER ? Asm::COND_A : Asm::COND_AE, Asm::RAX);
+			break;
+		case Variant::OP_EQUAL:
+			assembler.movsd_load(a.offset(float_offset));
+			assembler.ucomisd(b.offset(float_offset));
+			assembler.setcc(Asm::COND_E, Asm::RAX);
+			assembler.setcc(Asm::COND_NP, Asm::RCX);
+			assembler.and_al_cl();
+			break;
+		default:
+			assembler.movsd_load(a.offset(float_offset));
+			assembler.ucomisd(b.offset(float_offset));
+			assembler.setcc(Asm::COND_NE, Asm::RAX);
+			assembler.setcc(Asm::COND_P, Asm::RCX);
+			assembler.or_al_cl();
+			break;
+	}
+	assembler.store_byte(dst.offset(bool_offset), Asm::RAX);
+	if (p_jump) {
+		assembler.test_al();
+		_jump_to(code[ip + 4], assembler.jcc(Asm::COND_E));
+	}
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_call(const void *p_function, int p_operand_count) {
+	static const Asm::Register arguments[] = { Asm::RDI, Asm::RSI, Asm::RDX };
+	for (int i = 0; i < p_operand_count; i++) {
+		if (!_lea_operand(arguments[i], i)) {
+			return false;
+		}
+	}
+	assembler.call(p_function);
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_validated_call(bool p_builtin) {
+	// Same layout as `LOAD_INSTRUCTION_ARGS`: the argument count, the addresses, then the call data.
+	int instr_arg_count = code[ip + 1];
+	int tail = ip + 1 + instr_arg_count;
+	int argc = code[tail + 1];
+	int index = code[tail + 2];
+	if (argc < 0 || argc + (p_builtin ? 2 : 1) != instr_arg_count) {
+		return false;
+	}
+
+	// Argument pointers go in the reserved area at the bottom of the native frame.
+	for (int i = 0; i < argc; i++) {
+		if (!_lea_operand(Asm::RAX, 1 + i)) {
+			return false;
+		}
+		Asm::Memory slot;
+		slot.displacement = i * 8;
+		assembler.store(slot, Asm::RAX);
+	}
+
+	if (p_builtin) {
+		ERR_FAIL_INDEX_V(index, function->_builtin_methods_count, false);
+		if (!_lea_operand(Asm::RDI, 1 + argc) || !_lea_operand(Asm::RCX, 2 + argc)) {
+			return false;
+		}
+		assembler.mov(Asm::RSI, Asm::RSP);
+		assembler.mov_imm32(Asm::RDX, argc);
+		assembler.call((const void *)function->_builtin_methods_ptr[index]);
+	} else {
+		ERR_FAIL_INDEX_V(index, function->_utilities_count, false);
+		if (!_lea_operand(Asm::RDI, 1 + argc)) {
+			return false;
+		}
+		assembler.mov(Asm::RSI, Asm::RSP);
+		assembler.mov_imm32(Asm::RDX, argc);
+		assembler.call((const void *)function->_utilities_ptr[index]);
+	}
+	return true;
+}
+
+bool GDScriptJIT::NativeCompiler::_emit_instruction(int &r_size) {
+	GDScriptFunction::Opcode opcode = (GDScriptFunction::Opcode)code[ip];
+
+	switch (opcode) {
+		case GDScriptFunction::OPCODE_ADD_INT:
+		case GDScriptFunction::OPCODE_SUBTRACT_INT:
+		case GDScriptFunction::OPCODE_MULTIPLY_INT:
+			r_size = 4;
+			return _emit_int_operator(opcode);
+		case GDScriptFunction::OPCODE_ADD_FLOAT:
+		case GDScriptFunction::OPCODE_SUBTRACT_FLOAT:
+		case GDScriptFunction::OPCODE_MULTIPLY_FLOAT:
+		case GDScriptFunction::OPCODE_DIVIDE_FLOAT:
+			r_size = 4;
+			return _emit_float_operator(opcode);
+		case GDScriptFunction::OPCODE_ADD_VECTOR2:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_ADD, Variant::VECTOR2, Variant::VECTOR2);
+		case GDScriptFunction::OPCODE_SUBTRACT_VECTOR2:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_SUBTRACT, Variant::VECTOR2, Variant::VECTOR2);
+		case GDScriptFunction::OPCODE_MULTIPLY_VECTOR2:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_MULTIPLY, Variant::VECTOR2, Variant::VECTOR2);
+		case GDScriptFunction::OPCODE_MULTIPLY_VECTOR2_FLOAT:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_MULTIPLY, Variant::VECTOR2, Variant::FLOAT);
+		case GDScriptFunction::OPCODE_ADD_VECTOR3:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_ADD, Variant::VECTOR3, Variant::VECTOR3);
+		case GDScriptFunction::OPCODE_SUBTRACT_VECTOR3:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_SUBTRACT, Variant::VECTOR3, Variant::VECTOR3);
+		case GDScriptFunction::OPCODE_MULTIPLY_VECTOR3:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_MULTIPLY, Variant::VECTOR3, Variant::VECTOR3);
+		case GDScriptFunction::OPCODE_MULTIPLY_VECTOR3_FLOAT:
+			r_size = 4;
+			return _emit_evaluator(Variant::OP_MULTIPLY, Variant::VECTOR3, Variant::FLOAT);
+
+#define INT_COMPARISON(m_name, m_condition)                                    \
+	case GDScriptFunction::OPCODE_##m_name##_INT:                                \
+		r_size = 4;                                                              \
+		return _emit_int_comparison(Asm::m_condition, false);                    \
+	case GDScriptFunction::OPCODE_##m_name##_INT_JUMP_IF_NOT:                    \
+		r_size = 5;                                                              \
+		return _emit_int_comparison(Asm::m_condition, true);
+#define FLOAT_COMPARISON(m_name, m_operator)                                   \
+	case GDScriptFunction::OPCODE_##m_name##_FLOAT:                              \
+		r_size = 4;                                                              \
+		return _emit_float_comparison(Variant::m_operator, false);               \
+	case GDScriptFunction::OPCODE_##m_name##_FLOAT_JUMP_IF_NOT:                  \
+		r_size = 5;                                                              \
+		return _emit_float_comparison(Variant::m_operator, true);
+
+			INT_COMPARISON(EQUAL, COND_E)
+			INT_COMPARISON(NOT_EQUAL, COND_NE)
+			INT_COMPARISON(LESS, COND_L)
+			INT_COMPARISON(LESS_EQUAL, COND_LE)
+			INT_COMPARISON(GREATER, COND_G)
+			INT_COMPARISON(GREATER_EQUAL, COND_GE)
+			FLOAT_COMPARISON(EQUAL, OP_EQUAL)
+			FLOAT_COMPARISON(NOT_EQUAL, OP_NOT_EQUAL)
+			FLOAT_COMPARISON(LESS, OP_LESS)
+			FLOAT_COMPARISON(LESS_EQUAL, OP_LESS_EQUAL)
+			FLOAT_COMPARISON(GREATER, OP_GREATER)
+			FLOAT_COMPARISON(GREATER_EQUAL, OP_GREATER_EQUAL)
+
+#undef INT_COMPARISON
+#undef FLOAT_COMPARISON
+
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+			r_size = 5;
+			int index = code[ip + 4];
+			ERR_FAIL_INDEX_V(index, function->_operator_funcs_count, false);
+			return _emit_call((const void *)function->_operator_funcs_ptr[index], 3);
+		}
+		case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED: {
+			r_size = 4;
+			int index = code[ip + 3];
+			ERR_FAIL_INDEX_V(index, function->_setters_count, false);
+			return _emit_call((const void *)function->_setters_ptr[index], 2);
+		}
+		case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+			r_size = 4;
+			int index = code[ip + 3];
+			ERR_FAIL_INDEX_V(index, function->_getters_count, false);
+			return _emit_call((const void *)function->_getters_ptr[index], 2);
+		}
+		case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+			r_size = 1 + code[ip + 1] + 3;
+			if (ip + r_size > code_size) {
+				return false;
+			}
+			return _emit_validated_call(opcode == GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED);
+		case GDScriptFunction::OPCODE_ASSIGN:
+			r_size = 3;
+			return _emit_call((const void *)&_native_assign, 2);
+		case GDScriptFunction::OPCODE_ASSIGN_NULL:
+			r_size = 2;
+			return _emit_call((const void *)&_native_assign_null, 1);
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			r_size = 2;
+			assembler.mov_imm32(Asm::RSI, opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE);
+			return _emit_call((const void *)&_native_assign_bool, 1);
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+			r_size = 2;
+			return _emit_call((const void *)&VariantTypeAdjust<bool>::adjust, 1);
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+			r_size = 2;
+			return _emit_call((const void *)&VariantTypeAdjust<int64_t>::adjust, 1);
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT:
+			r_size = 2;
+			return _emit_call((const void *)&VariantTypeAdjust<double>::adjust, 1);
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR2:
+			r_size = 2;
+			return _emit_call((const void *)&VariantTypeAdjust<Vector2>::adjust, 1);
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR3:
+			r_size = 2;
+			return _emit_call((const void *)&VariantTypeAdjust<Vector3>::adjust, 1);
+		case GDScriptFunction::OPCODE_JUMP:
+			r_size = 2;
+			_jump_to(code[ip + 1], assembler.jmp());
+			return true;
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+			r_size = 3;
+			if (!_emit_call((const void *)&_native_booleanize, 1)) {
+				return false;
+			}
+			assembler.test_al();
+			_jump_to(code[ip + 2], assembler.jcc(opcode == GDScriptFunction::OPCODE_JUMP_IF ? Asm::COND_NE : Asm::COND_E));
+			return true;
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+			r_size = 5;
+			if (!_emit_call((const void *)&_native_iterate_begin_int, 3)) {
+				return false;
+			}
+			assembler.test_al();
+			_jump_to(code[ip + 4], assembler.jcc(Asm::COND_E));
+			return true;
+		case GDScriptFunction::OPCODE_ITERATE_INT: {
+			r_size = 5;
+			Asm::Memory counter, container, iterator;
+			if (!_get_memory(0, counter) || !_get_memory(1, container) || !_get_memory(2, iterator)) {
+				return false;
+			}
+			assembler.load(Asm::RAX, counter.offset(int_offset));
+			assembler.add_imm8(Asm::RAX, 1);
+			assembler.store(counter.offset(int_offset), Asm::RAX);
+			assembler.cmp(Asm::RAX, container.offset(int_offset));
+			_jump_to(code[ip + 4], assembler.jcc(Asm::COND_GE));
+			assembler.store(iterator.offset(int_offset), Asm::RAX);
+			return true;
+		}
+		case GDScriptFunction::OPCODE_RETURN: {
+			r_size = 2;
+			Asm::Memory value;
+			if (!_get_memory(0, value)) {
+				return false;
+			}
+			assembler.mov(Asm::RDI, Asm::R14);
+			assembler.lea(Asm::RSI, value);
+			assembler.call((const void *)&_native_assign);
+			_jump_to(-1, assembler.jmp());
+			return true;
+		}
+		case GDScriptFunction::OPCODE_LINE:
+			// Only the debugger needs them, and native code never runs with it.
+			r_size = 2;
+			return true;
+		case GDScriptFunction::OPCODE_END:
+			r_size = 1;
+			_jump_to(-1, assembler.jmp());
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool GDScriptJIT::NativeCompiler::compile() {
+	if (!code || code_size == 0 || function->_default_arg_count > 0) {
+		return false;
+	}
+
+	// Room for the argument pointers of the widest validated call.
+	int max_arguments = 0;
+	for (int i = 0; i < code_size;) {
+		int opcode = code[i];
+		if (opcode == GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED || opcode == GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+			max_arguments = MAX(max_arguments, code[i + 1]);
+		}
+		int size = 0;
+		ip = i;
+		// Sizes only, the code is thrown away.
+		if (!_emit_instruction(size) || size <= 0) {
+			return false;
+		}
+		i += size;
+	}
+	assembler.bytes.clear();
+	fixups.clear();
+	// Keeps the stack aligned to 16 bytes for calls after the four pushes below.
+	frame_size = ((max_arguments * 8 + 15) & ~15) + 8;
+
+	assembler.push(Asm::RBX);
+	assembler.push(Asm::R12);
+	assembler.push(Asm::R13);
+	assembler.push(Asm::R14);
+	assembler.sub_rsp(frame_size);
+	assembler.mov(Asm::RBX, Asm::RDI);
+	assembler.mov(Asm::R12, Asm::RSI);
+	assembler.mov(Asm::R13, Asm::RDX);
+	assembler.mov(Asm::R14, Asm::RCX);
+
+	labels.resize(code_size);
+	for (int &E : labels) {
+		E = -1;
+	}
+	ip = 0;
+	while (ip < code_size) {
+		labels[ip] = assembler.bytes.size();
+		int size = 0;
+		if (!_emit_instruction(size)) {
+			return false;
+		}
+		ip += size;
+	}
+
+	int epilogue = assembler.bytes.size();
+	assembler.add_rsp(frame_size);
+	assembler.pop(Asm::R14);
+	assembler.pop(Asm::R13);
+	assembler.pop(Asm::R12);
+	assembler.pop(Asm::RBX);
+	assembler.ret();
+
+	for (const Fixup &E : fixups) {
+		int destination = epilogue;
+		if (E.target >= 0) {
+			if (E.target >= code_size || labels[E.target] < 0) {
+				return false;
+			}
+			destination = labels[E.target];
+		}
+		assembler.patch_int32(E.position, destination - (int)(E.position + 4));
+	}
+
+	return true;
+}
+
+void GDScriptJIT::update_settings() {
+	if (GLOBAL_GET("gdscript/jit/enabled")) {
+		hot_threshold = MAX(1, (int)GLOBAL_GET("gdscript/jit/hot_threshold"));
+	} else {
+		hot_threshold = 0;
+	}
+}
+
+bool GDScriptJIT::_compile(GDScriptFunction *p_function) {
+	NativeCompiler compiler(p_function);
+	if (!compiler.compile()) {
+		return false;
+	}
+
+	const LocalVector<uint8_t> &bytes = compiler.get_assembler().bytes;
+	void *memory = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ERR_FAIL_COND_V_MSG(memory == MAP_FAILED, false, "Failed to allocate memory for native GDScript code.");
+	memcpy(memory, bytes.ptr(), bytes.size());
+	if (mprotect(memory, bytes.size(), PROT_READ | PROT_EXEC) != 0) {
+		munmap(memory, bytes.size());
+		ERR_FAIL_V_MSG(false, "Failed to make native GDScript code executable.");
+	}
+
+	p_function->_jit_code = (GDScriptFunction::NativeCode)memory;
+	p_function->_jit_code_size = bytes.size();
+	return true;
+}
+
+bool GDScriptJIT::compile(GDScriptFunction *p_function) {
+	MutexLock lock(mutex);
+	if (p_function->_jit_attempted.is_set()) {
+		return p_function->_jit_ready.is_set();
+	}
+	p_function->_jit_attempted.set();
+
+	if (!_compile(p_function)) {
+		return false;
+	}
+	p_function->_jit_ready.set();
+	return true;
+}
+
+void GDScriptJIT::free_code(GDScriptFunction *p_function) {
+	if (p_function->_jit_code) {
+		munmap((void *)p_function->_jit_code, p_function->_jit_code_size);
+		p_function->_jit_code = nullptr;
+		p_function->_jit_code_size = 0;
+	}
+	p_function->_jit_ready.clear();
+}
+
+#endif // GDSCRIPT_JIT_ENABLED
@@ -0,0 +1,65 @@
+/**************************************************************************/
+/*  gdscript_jit.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_JIT_H
+#define GDSCRIPT_JIT_H
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+#include "gdscript_function.h"
+
+#include "core/os/mutex.h"
+
+// Baseline compiler turning the bytecode of hot functions into x86-64 machine code.
+// Every instruction is translated with a fixed template: typed arithmetic and comparisons are
+// done inline, everything else calls the same validated function pointers the VM uses.
+// A function is only compiled when all of its instructions are supported, otherwise it stays
+// interpreted. Native code is never used while the debugger is active nor to resume a coroutine.
+class GDScriptJIT {
+	class NativeCompiler;
+
+	static uint32_t hot_threshold;
+	static BinaryMutex mutex;
+
+	static bool _compile(GDScriptFunction *p_function);
+
+public:
+	// Zero when disabled.
+	_FORCE_INLINE_ static uint32_t get_hot_threshold() { return hot_threshold; }
+	static void update_settings();
+
+	// Returns whether native code is ready for the function, compiling it on the first call.
+	static bool compile(GDScriptFunction *p_function);
+	static void free_code(GDScriptFunction *p_function);
+};
+
+#endif // GDSCRIPT_JIT_ENABLED
+
+#endif // GDSCRIPT_JIT_H
@@ -0,0 +1,202 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#ifdef DEBUG_ENABLED
+
+#include "gdscript.h"
+
+#include "core/debugger/engine_debugger.h"
+#include "core/os/os.h"
+#include "core/templates/hash_set.h"
+
+void GDScriptSamplingProfiler::_thread_func(void *p_userdata) {
+	GDScriptSamplingProfiler *profiler = static_cast<GDScriptSamplingProfiler *>(p_userdata);
+	while (profiler->running.is_set()) {
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+		profiler->_take_samples();
+	}
+}
+
+void GDScriptSamplingProfiler::_take_samples() {
+	const int max_depth = GDScriptLanguage::get_singleton()->_debug_max_call_stack;
+
+	// The registry lock keeps the call stacks alive while they are read. The threads owning them
+	// keep running, so a sample may be torn; functions are validated when resolving.
+	MutexLock registry_lock(GDScriptLanguage::call_stack_registry_mutex);
+	MutexLock lock(samples_mutex);
+
+	for (const GDScriptLanguage::CallStack *call_stack : GDScriptLanguage::call_stack_registry) {
+		const int depth = MIN(call_stack->stack_pos, max_depth);
+		if (depth <= 0) {
+			continue; // Not running a script right now.
+		}
+		if (frames.size() + depth > MAX_BUFFERED_FRAMES) {
+			dropped_samples++;
+			continue;
+		}
+
+		Sample sample;
+		sample.first_frame = frames.size();
+		sample.frame_count = depth;
+		for (int i = 0; i < depth; i++) {
+			const GDScriptLanguage::CallLevel &level = call_stack->levels[i];
+			Frame frame;
+			frame.function = level.function;
+			frame.line = level.line ? *level.line : 0;
+			frame.native_call = level.native_call;
+			frames.push_back(frame);
+		}
+		samples.push_back(sample);
+	}
+}
+
+void GDScriptSamplingProfiler::_start() {
+	if (running.is_set()) {
+		return;
+	}
+	{
+		MutexLock lock(samples_mutex);
+		frames.clear();
+		samples.clear();
+		dropped_samples = 0;
+	}
+	running.set();
+	thread.start(_thread_func, this);
+}
+
+void GDScriptSamplingProfiler::_stop() {
+	if (!running.is_set()) {
+		return;
+	}
+	running.clear();
+	thread.wait_to_finish();
+}
+
+void GDScriptSamplingProfiler::toggle(bool p_enable, const Array &p_opts) {
+	if (p_enable) {
+		if (p_opts.size() > 0) {
+			interval_usec = MAX((int64_t)p_opts[0], (int64_t)MIN_INTERVAL_USEC);
+		} else {
+			interval_usec = DEFAULT_INTERVAL_USEC;
+		}
+		_start();
+	} else {
+		_stop();
+	}
+}
+
+bool GDScriptSamplingProfiler::_fold_samples(PackedStringArray &r_stacks, uint32_t &r_dropped) {
+	LocalVector<Frame> pending_frames;
+	LocalVector<Sample> pending_samples;
+	uint32_t dropped = 0;
+	{
+		MutexLock lock(samples_mutex);
+		SWAP(pending_frames, frames);
+		SWAP(pending_samples, samples);
+		SWAP(dropped, dropped_samples);
+	}
+	if (pending_samples.is_empty() && dropped == 0) {
+		return false;
+	}
+
+	HashMap<String, uint32_t> folded;
+	{
+		// Functions only unregister themselves with this lock held, so they can't be freed while resolving.
+		GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+		MutexLock lock(language->mutex);
+
+		HashSet<const GDScriptFunction *> functions;
+		for (const SelfList<GDScriptFunction> *elem = language->function_list.first(); elem; elem = elem->next()) {
+			functions.insert(elem->self());
+		}
+
+		for (const Sample &sample : pending_samples) {
+			String stack;
+			bool valid = true;
+			for (uint32_t i = 0; i < sample.frame_count; i++) {
+				const Frame &frame = pending_frames[sample.first_frame + i];
+				if (!functions.has(frame.function)) {
+					valid = false; // Torn sample, or the function was freed since.
+					break;
+				}
+				if (i > 0) {
+					stack += ";";
+				}
+				stack += frame.function->get_script()->get_script_path() + ":" + frame.function->get_name() + ":" + itos(frame.line);
+				if (frame.native_call) {
+					stack += ";" + String(frame.native_call->get_instance_class()) + "." + frame.native_call->get_name();
+				}
+			}
+			if (!valid) {
+				dropped++;
+				continue;
+			}
+
+			HashMap<String, uint32_t>::Iterator E = folded.find(stack);
+			if (E) {
+				E->value++;
+			} else {
+				folded.insert(stack, 1);
+			}
+		}
+	}
+
+	for (const KeyValue<String, uint32_t> &E : folded) {
+		r_stacks.push_back(E.key + " " + itos(E.value));
+	}
+	r_dropped = dropped;
+	return true;
+}
+
+void GDScriptSamplingProfiler::tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+	if (!running.is_set()) {
+		return;
+	}
+
+	PackedStringArray stacks;
+	uint32_t dropped = 0;
+	if (!_fold_samples(stacks, dropped)) {
+		return;
+	}
+
+	Array data;
+	data.push_back(interval_usec);
+	data.push_back(dropped);
+	data.push_back(stacks);
+	EngineDebugger::get_singleton()->send_message("gdscript_sampler:frame", data);
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+	_stop();
+}
+
+#endif // DEBUG_ENABLED
@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "core/debugger/engine_profiler.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+class MethodBind;
+
+// Statistical alternative to the instrumenting script profiler. A background thread periodically
+// copies the GDScript call stack of every thread running scripts, so scripts themselves pay nothing
+// beyond the call stack bookkeeping the debugger already does. Samples are resolved once per frame
+// on the main thread and sent as folded stacks ("frame;frame;frame count" lines), which flame graph
+// tools read directly.
+//
+// Enabled through the "gdscript_sampler" profiler. The optional first option is the sampling
+// interval in microseconds. Each frame sends a "gdscript_sampler:frame" message containing the
+// interval, the number of samples dropped because the buffer was full, and the folded stacks.
+class GDScriptSamplingProfiler : public EngineProfiler {
+	friend class TestGDScriptSamplingProfilerInternalsAccessor;
+
+	enum {
+		DEFAULT_INTERVAL_USEC = 1000,
+		MIN_INTERVAL_USEC = 100,
+		MAX_BUFFERED_FRAMES = 1 << 18,
+	};
+
+	struct Frame {
+		GDScriptFunction *function = nullptr;
+		int line = 0;
+		MethodBind *native_call = nullptr;
+	};
+
+	struct Sample {
+		uint32_t first_frame = 0;
+		uint32_t frame_count = 0;
+	};
+
+	Thread thread;
+	SafeFlag running;
+	uint64_t interval_usec = DEFAULT_INTERVAL_USEC;
+
+	BinaryMutex samples_mutex;
+	LocalVector<Frame> frames;
+	LocalVector<Sample> samples;
+	uint32_t dropped_samples = 0;
+
+	static void _thread_func(void *p_userdata);
+	void _take_samples();
+	// Resolves the buffered samples into folded stacks. Returns false when there was nothing to report.
+	bool _fold_samples(PackedStringArray &r_stacks, uint32_t &r_dropped);
+	void _start();
+	void _stop();
+
+public:
+	void toggle(bool p_enable, const Array &p_opts) override;
+	void add(const Array &p_data) override {}
+	void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) override;
+
+	~GDScriptSamplingProfiler();
+};
+
+#endif // DEBUG_ENABLED
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -30,6 +30,8 @@
 
 #include "gdscript.h"
 #include "gdscript_function.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 #include "gdscript_lambda_callable.h"
 
 #include "core/os/os.h"
@@ -215,6 +217,45 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {            \
 		&&OPCODE_OPERATOR,                               \
 		&&OPCODE_OPERATOR_VALIDATED,                     \
+		&&OPCODE_ADD_INT,                                \
+		&&OPCODE_SUBTRACT_INT,                           \
+		&&OPCODE_MULTIPLY_INT,                           \
+		&&OPCODE_ADD_FLOAT,                              \
+		&&OPCODE_SUBTRACT_FLOAT,                         \
+		&&OPCODE_MULTIPLY_FLOAT,                         \
+		&&OPCODE_DIVIDE_FLOAT,                           \
+		&&OPCODE_ADD_VECTOR2,                            \
+		&&OPCODE_SUBTRACT_VECTOR2,                       \
+		&&OPCODE_MULTIPLY_VECTOR2,                       \
+		&&OPCODE_MULTIPLY_VECTOR2_FLOAT,                 \
+		&&OPCODE_ADD_VECTOR3,                            \
+		&&OPCODE_SUBTRACT_VECTOR3,                       \
+		&&OPCODE_MULTIPLY_VECTOR3,                       \
+		&&OPCODE_MULTIPLY_VECTOR3_FLOAT,                 \
+		&&OPCODE_EQUAL_INT,                              \
+		&&OPCODE_NOT_EQUAL_INT,                          \
+		&&OPCODE_LESS_INT,                               \
+		&&OPCODE_LESS_EQUAL_INT,                         \
+		&&OPCODE_GREATER_INT,                            \
+		&&OPCODE_GREATER_EQUAL_INT,                      \
+		&&OPCODE_EQUAL_FLOAT,                            \
+		&&OPCODE_NOT_EQUAL_FLOAT,                        \
+		&&OPCODE_LESS_FLOAT,                             \
+		&&OPCODE_LESS_EQUAL_FLOAT,                       \
+		&&OPCODE_GREATER_FLOAT,                          \
+		&&OPCODE_GREATER_EQUAL_FLOAT,                    \
+		&&OPCODE_EQUAL_INT_JUMP_IF_NOT,                  \
+		&&OPCODE_NOT_EQUAL_INT_JUMP_IF_NOT,              \
+		&&OPCODE_LESS_INT_JUMP_IF_NOT,                   \
+		&&OPCODE_LESS_EQUAL_INT_JUMP_IF_NOT,             \
+		&&OPCODE_GREATER_INT_JUMP_IF_NOT,                \
+		&&OPCODE_GREATER_EQUAL_INT_JUMP_IF_NOT,          \
+		&&OPCODE_EQUAL_FLOAT_JUMP_IF_NOT,                \
+		&&OPCODE_NOT_EQUAL_FLOAT_JUMP_IF_NOT,            \
+		&&OPCODE_LESS_FLOAT_JUMP_IF_NOT,                 \
+		&&OPCODE_LESS_EQUAL_FLOAT_JUMP_IF_NOT,           \
+		&&OPCODE_GREATER_FLOAT_JUMP_IF_NOT,              \
+		&&OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT,        \
 		&&OPCODE_TYPE_TEST_BUILTIN,                      \
 		&&OPCODE_TYPE_TEST_ARRAY,                        \
 		&&OPCODE_TYPE_TEST_NATIVE,                       \
@@ -493,17 +534,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 	uint32_t alloca_size = 0;
+	bool stack_moved = false; // Into a GDScriptFunctionState, by await.
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -599,8 +641,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #ifdef DEBUG_ENABLED
 
+	// Lets the sampling profiler see which native method this function is in.
+	GDScriptLanguage::CallLevel *call_level = nullptr;
 	if (EngineDebugger::is_active()) {
-		GDScriptLanguage::get_singleton()->enter_function(p_instance, this, stack, &ip, &line);
+		call_level = GDScriptLanguage::get_singleton()->enter_function(p_instance, this, stack, &ip, &line);
 	}
 
 #define GD_ERR_BREAK(m_cond)                                                                                           \
@@ -680,6 +724,21 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	bool run_native = false;
+	if (!p_state && GDScriptJIT::get_hot_threshold() > 0 && !EngineDebugger::is_active()) {
+		if (_jit_ready.is_set()) {
+			run_native = true;
+		} else if (!_jit_attempted.is_set() && _jit_counter.increment() >= GDScriptJIT::get_hot_threshold()) {
+			run_native = GDScriptJIT::compile(this);
+		}
+	}
+
+	if (run_native) {
+		_jit_code(stack, variant_addresses[ADDR_TYPE_MEMBER], _constants_ptr, &retvalue);
+	} else
+#endif
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
@@ -792,6 +851,80 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Operations on the payloads of operands whose types are known at compile time,
+			// see `GDScriptByteCodeGenerator::write_binary_operator()`.
+#define OPCODE_TYPED_OPERATOR(m_opcode, m_result, m_left, m_operator, m_right)                                                   \
+	OPCODE(m_opcode) {                                                                                                           \
+		CHECK_SPACE(4);                                                                                                          \
+		GET_VARIANT_PTR(a, 0);                                                                                                   \
+		GET_VARIANT_PTR(b, 1);                                                                                                   \
+		GET_VARIANT_PTR(dst, 2);                                                                                                 \
+		*VariantInternal::get_##m_result(dst) = *VariantInternal::get_##m_left(a) m_operator *VariantInternal::get_##m_right(b); \
+		ip += 4;                                                                                                                 \
+	}                                                                                                                            \
+	DISPATCH_OPCODE;
+
+#define OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(m_opcode, m_type, m_operator)                             \
+	OPCODE(m_opcode) {                                                                                \
+		CHECK_SPACE(5);                                                                               \
+		GET_VARIANT_PTR(a, 0);                                                                        \
+		GET_VARIANT_PTR(b, 1);                                                                        \
+		GET_VARIANT_PTR(dst, 2);                                                                      \
+		bool result = *VariantInternal::get_##m_type(a) m_operator *VariantInternal::get_##m_type(b); \
+		*VariantInternal::get_bool(dst) = result;                                                     \
+		if (!result) {                                                                                \
+			int to = _code_ptr[ip + 4];                                                               \
+			GD_ERR_BREAK(to < 0 || to > _code_size);                                                  \
+			ip = to;                                                                                  \
+		} else {                                                                                      \
+			ip += 5;                                                                                  \
+		}                                                                                             \
+	}                                                                                                 \
+	DISPATCH_OPCODE;
+
+			OPCODE_TYPED_OPERATOR(OPCODE_ADD_INT, int, int, +, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_SUBTRACT_INT, int, int, -, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_INT, int, int, *, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_ADD_FLOAT, float, float, +, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_SUBTRACT_FLOAT, float, float, -, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_FLOAT, float, float, *, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_DIVIDE_FLOAT, float, float, /, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_ADD_VECTOR2, vector2, vector2, +, vector2)
+			OPCODE_TYPED_OPERATOR(OPCODE_SUBTRACT_VECTOR2, vector2, vector2, -, vector2)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR2, vector2, vector2, *, vector2)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR2_FLOAT, vector2, vector2, *, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_ADD_VECTOR3, vector3, vector3, +, vector3)
+			OPCODE_TYPED_OPERATOR(OPCODE_SUBTRACT_VECTOR3, vector3, vector3, -, vector3)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR3, vector3, vector3, *, vector3)
+			OPCODE_TYPED_OPERATOR(OPCODE_MULTIPLY_VECTOR3_FLOAT, vector3, vector3, *, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_EQUAL_INT, bool, int, ==, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_NOT_EQUAL_INT, bool, int, !=, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_LESS_INT, bool, int, <, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_LESS_EQUAL_INT, bool, int, <=, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_GREATER_INT, bool, int, >, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_GREATER_EQUAL_INT, bool, int, >=, int)
+			OPCODE_TYPED_OPERATOR(OPCODE_EQUAL_FLOAT, bool, float, ==, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_NOT_EQUAL_FLOAT, bool, float, !=, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_LESS_FLOAT, bool, float, <, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_LESS_EQUAL_FLOAT, bool, float, <=, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_GREATER_FLOAT, bool, float, >, float)
+			OPCODE_TYPED_OPERATOR(OPCODE_GREATER_EQUAL_FLOAT, bool, float, >=, float)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_EQUAL_INT_JUMP_IF_NOT, int, ==)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_NOT_EQUAL_INT_JUMP_IF_NOT, int, !=)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_LESS_INT_JUMP_IF_NOT, int, <)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_LESS_EQUAL_INT_JUMP_IF_NOT, int, <=)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_GREATER_INT_JUMP_IF_NOT, int, >)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_GREATER_EQUAL_INT_JUMP_IF_NOT, int, >=)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_EQUAL_FLOAT_JUMP_IF_NOT, float, ==)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_NOT_EQUAL_FLOAT_JUMP_IF_NOT, float, !=)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_LESS_FLOAT_JUMP_IF_NOT, float, <)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_LESS_EQUAL_FLOAT_JUMP_IF_NOT, float, <=)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_GREATER_FLOAT_JUMP_IF_NOT, float, >)
+			OPCODE_TYPED_COMPARISON_JUMP_IF_NOT(OPCODE_GREATER_EQUAL_FLOAT_JUMP_IF_NOT, float, >=)
+
+#undef OPCODE_TYPED_OPERATOR
+#undef OPCODE_TYPED_COMPARISON_JUMP_IF_NOT
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
@@ -1106,7 +1239,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
@@ -1116,8 +1249,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_inline_caches_ptr[cache_index].set_named(dst, *index, value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1138,7 +1276,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1158,7 +1296,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
@@ -1168,22 +1306,27 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
+
+				if (!_inline_caches_ptr[cache_index].get_named(src, *index, dst)) {
+					bool valid;
 #ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+					//allow better error message in cases where src and dst are the same stack position
+					Variant ret = src->get_named(*index, valid);
 
 #else
-				*dst = src->get_named(*index, valid);
+					*dst = src->get_named(*index, valid);
 #endif
 #ifdef DEBUG_ENABLED
-				if (!valid) {
-					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
-					OPCODE_BREAK;
-				}
-				*dst = ret;
+					if (!valid) {
+						err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
+						OPCODE_BREAK;
+					}
+					*dst = ret;
 #endif
-				ip += 4;
+				}
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1719,7 +1862,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1730,6 +1873,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_index = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
+				GDScriptInlineCache *inline_cache = &_inline_caches_ptr[cache_index];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1747,7 +1894,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!inline_cache->call(base, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
 						if (base_type == Variant::OBJECT) {
@@ -1777,7 +1926,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!inline_cache->call(base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1827,7 +1978,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -1866,6 +2017,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				Callable::CallError err;
@@ -1878,6 +2032,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #ifdef DEBUG_ENABLED
 
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -1969,12 +2126,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				Callable::CallError err;
 				*ret = method->call(nullptr, argptrs, argc, err);
 
 #ifdef DEBUG_ENABLED
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -2010,12 +2173,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc);
 				method->validated_call(nullptr, (const Variant **)argptrs, ret);
 
 #ifdef DEBUG_ENABLED
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -2045,6 +2214,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc);
@@ -2052,6 +2224,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				method->validated_call(nullptr, (const Variant **)argptrs, nullptr);
 
 #ifdef DEBUG_ENABLED
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -2098,12 +2273,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
 				method->validated_call(base_obj, (const Variant **)argptrs, ret);
 
 #ifdef DEBUG_ENABLED
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -2147,6 +2328,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					call_time = OS::get_singleton()->get_ticks_usec();
 				}
+				if (call_level) {
+					call_level->native_call = method;
+				}
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
@@ -2154,6 +2338,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				method->validated_call(base_obj, (const Variant **)argptrs, nullptr);
 
 #ifdef DEBUG_ENABLED
+				if (call_level) {
+					call_level->native_call = nullptr;
+				}
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
 					uint64_t t_taken = OS::get_singleton()->get_ticks_usec() - call_time;
 					_profile_native_call(t_taken, method->get_name(), method->get_instance_class());
@@ -2391,12 +2578,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+					// The stack is moved rather than copied: Variants can be relocated bitwise, and the moved
+					// slots aren't destroyed on exit. First 3 stack addresses are special, so they stay.
+					if (p_state) {
+						// Resumed from an earlier await, the stack already lives in a buffer of its own.
+						gdfs->state.stack = p_state->stack;
+						p_state->stack = nullptr;
+						p_state->stack_size = 0;
+						p_state->alloca_size = 0;
+					} else {
+						gdfs->state.stack = GDScriptFunctionState::_alloc_stack(alloca_size);
+						memcpy((void *)&gdfs->state.stack[sizeof(Variant) * FIXED_ADDRESSES_MAX], (const void *)&stack[FIXED_ADDRESSES_MAX], sizeof(Variant) * (_stack_size - FIXED_ADDRESSES_MAX));
 					}
+					stack_moved = true;
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
 					gdfs->state.ip = ip + 2;
@@ -2520,6 +2714,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				int to = _code_ptr[ip + 1];
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
+#ifdef GDSCRIPT_JIT_ENABLED
+				if (to < ip && !_jit_attempted.is_set() && GDScriptJIT::get_hot_threshold() > 0) {
+					// Loop back-edge.
+					_jit_counter.increment();
+				}
+#endif
 				ip = to;
 			}
 			DISPATCH_OPCODE;
@@ -3694,8 +3894,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 		// Free stack, except reserved addresses.
-		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-			stack[i].~Variant();
+		if (!stack_moved) {
+			for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
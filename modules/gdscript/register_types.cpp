@@ -32,6 +32,7 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_buffer.h"
 #include "gdscript_cache.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_tokenizer_buffer.h"
@@ -84,10 +85,29 @@ class EditorExportGDScript : public EditorExportPlugin {
 
 	static constexpr int DEFAULT_SCRIPT_MODE = EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED;
 	int script_mode = DEFAULT_SCRIPT_MODE;
+	bool export_debug = false;
+
+	void _export_bytecode(const String &p_path, const Vector<uint8_t> &p_binary_tokens) {
+		Error err = OK;
+		Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+		if (err != OK || script.is_null() || !script->is_valid()) {
+			return;
+		}
+
+		Vector<uint8_t> bytecode;
+		err = GDScriptBytecodeBuffer::serialize_script(script, p_binary_tokens, bytecode, !export_debug);
+		if (err != OK) {
+			print_verbose(vformat(R"(GDScript "%s" will be compiled at load time, its bytecode can't be precompiled (%s).)", p_path, error_names[err]));
+			return;
+		}
+
+		add_file(GDScriptBytecodeBuffer::get_bytecode_path(p_path), bytecode, false);
+	}
 
 protected:
 	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
 		script_mode = DEFAULT_SCRIPT_MODE;
+		export_debug = p_debug;
 
 		const Ref<EditorExportPreset> &preset = get_export_preset();
 		if (preset.is_valid()) {
@@ -107,13 +127,18 @@ protected:
 
 		String source;
 		source.parse_utf8(reinterpret_cast<const char *>(file.ptr()), file.size());
-		GDScriptTokenizerBuffer::CompressMode compress_mode = script_mode == EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED ? GDScriptTokenizerBuffer::COMPRESS_ZSTD : GDScriptTokenizerBuffer::COMPRESS_NONE;
+		GDScriptTokenizerBuffer::CompressMode compress_mode = script_mode == EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS ? GDScriptTokenizerBuffer::COMPRESS_NONE : GDScriptTokenizerBuffer::COMPRESS_ZSTD;
 		file = GDScriptTokenizerBuffer::parse_code_string(source, compress_mode);
 		if (file.is_empty()) {
 			return;
 		}
 
 		add_file(p_path.get_basename() + ".gdc", file, true);
+
+		// The tokens are still exported so the script can be compiled when the bytecode doesn't match the engine build.
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_PRECOMPILED_BYTECODE) {
+			_export_bytecode(p_path, file);
+		}
 	}
 
 public:
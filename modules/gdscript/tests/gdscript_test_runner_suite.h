@@ -33,7 +33,16 @@
 
 #include "gdscript_test_runner.h"
 
+#include "../gdscript_bytecode_buffer.h"
+#include "../gdscript_cache.h"
+#include "../gdscript_jit.h"
+
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
 #include "tests/test_macros.h"
+#include "tests/test_utils.h"
 
 namespace GDScriptTests {
 
@@ -48,6 +57,20 @@ TEST_SUITE("[Modules][GDScript]") {
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
 	}
+
+	TEST_CASE("Script compilation and runtime with optimized bytecode") {
+		bool print_filenames = OS::get_singleton()->get_cmdline_args().find("--print-filenames") != nullptr;
+		bool use_binary_tokens = OS::get_singleton()->get_cmdline_args().find("--use-binary-tokens") != nullptr;
+		const Variant previous = GLOBAL_GET("gdscript/compiler/optimize_bytecode");
+		int fail_count = 0;
+		{
+			GDScriptTestRunner runner("modules/gdscript/tests/scripts", true, print_filenames, use_binary_tokens, true);
+			fail_count = runner.run_tests();
+		}
+		ProjectSettings::get_singleton()->set_setting("gdscript/compiler/optimize_bytecode", previous);
+		INFO("The optimizer changed the behavior of the scripts whose `*.out` files don't match.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass with optimized bytecode.");
+	}
 }
 
 TEST_CASE("[Modules][GDScript] Load source code dynamically and run it") {
@@ -70,6 +93,275 @@ func _init():
 	ref_counted->set_script(gdscript);
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
+
+TEST_CASE("[Modules][GDScript] Run a script with optimized bytecode") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+var total := 0
+
+func _init():
+	const LIMIT = 10 * 10
+	for i in 1000:
+		if i >= LIMIT:
+			break
+		var doubled := i * 2
+		total += doubled
+	set_meta("result", total)
+)");
+	const Variant previous = GLOBAL_GET("gdscript/compiler/optimize_bytecode");
+	ProjectSettings::get_singleton()->set_setting("gdscript/compiler/optimize_bytecode", true);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	ProjectSettings::get_singleton()->set_setting("gdscript/compiler/optimize_bytecode", previous);
+	CHECK_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 9900, "The optimized script should compute the same result.");
+}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+TEST_CASE("[Modules][GDScript] Run a hot function as native code") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func sum_to(limit: int) -> int:
+	var total := 0
+	for i in limit:
+		if i % 3 != 0:
+			total += i * 2
+	return total
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	const Variant previous_enabled = GLOBAL_GET("gdscript/jit/enabled");
+	const Variant previous_threshold = GLOBAL_GET("gdscript/jit/hot_threshold");
+	ProjectSettings::get_singleton()->set_setting("gdscript/jit/enabled", true);
+	ProjectSettings::get_singleton()->set_setting("gdscript/jit/hot_threshold", 4);
+	GDScriptJIT::update_settings();
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	for (int i = 0; i < 8; i++) {
+		CHECK_MESSAGE(int(ref_counted->call("sum_to", 100)) == 6534, "Interpreted and native code should compute the same result.");
+	}
+	CHECK_MESSAGE(int(ref_counted->call("sum_to", 0)) == 0, "Native code should skip loops without iterations.");
+	CHECK_MESSAGE(gdscript->get_member_functions()["sum_to"]->is_native_compiled(), "The hot function should be compiled to native code.");
+
+	ProjectSettings::get_singleton()->set_setting("gdscript/jit/enabled", previous_enabled);
+	ProjectSettings::get_singleton()->set_setting("gdscript/jit/hot_threshold", previous_threshold);
+	GDScriptJIT::update_settings();
+}
+#endif // GDSCRIPT_JIT_ENABLED
+
+TEST_CASE("[Modules][GDScript] Keep locals across repeated awaits") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+signal step
+
+var result := []
+
+func run(object: RefCounted) -> void:
+	var kept := object
+	var counter := 0
+	var label := "a"
+	for i in 3:
+		await step
+		counter += i
+		label += str(i)
+	result = [counter, label, kept == object]
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	Ref<RefCounted> object = memnew(RefCounted);
+	const int reference_count = object->get_reference_count();
+	ref_counted->call("run", object);
+	CHECK_MESSAGE(object->get_reference_count() > reference_count, "The awaiting function should keep its locals.");
+
+	for (int i = 0; i < 3; i++) {
+		ref_counted->emit_signal(SNAME("step"));
+	}
+	const Array result = ref_counted->get("result");
+	REQUIRE(result.size() == 3);
+	CHECK(int(result[0]) == 3);
+	CHECK(String(result[1]) == "a012");
+	CHECK(bool(result[2]));
+	CHECK_MESSAGE(object->get_reference_count() == reference_count, "Locals should be released once the function returns.");
+}
+
+TEST_CASE("[Modules][GDScript] Parse scripts and their base classes ahead of time") {
+	const String base_path = TestUtils::get_temp_path("parse_ahead_base.gd");
+	const String derived_path = TestUtils::get_temp_path("parse_ahead_derived.gd");
+	{
+		Ref<FileAccess> f = FileAccess::open(base_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string("extends RefCounted\n\nvar value := 1\n");
+		f = FileAccess::open(derived_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string("extends \"parse_ahead_base.gd\"\n\nfunc twice() -> int:\n\treturn value * 2\n");
+	}
+
+	Vector<String> paths;
+	paths.push_back(derived_path);
+	GDScriptCache::parse_ahead(paths);
+	CHECK_MESSAGE(GDScriptCache::has_parser(derived_path), "The requested script should be parsed.");
+	CHECK_MESSAGE(GDScriptCache::has_parser(base_path), "The script it extends should be parsed too.");
+
+	Error err = OK;
+	Ref<GDScriptParserRef> ref = GDScriptCache::get_parser(derived_path, GDScriptParserRef::PARSED, err);
+	CHECK(err == OK);
+	CHECK(ref->get_status() == GDScriptParserRef::PARSED);
+	ref.unref();
+
+	GDScriptCache::release_parsed_ahead();
+	CHECK_FALSE_MESSAGE(GDScriptCache::has_parser(derived_path), "Released parsers no one uses should be freed.");
+	CHECK_FALSE(GDScriptCache::has_parser(base_path));
+
+	DirAccess::remove_absolute(base_path);
+	DirAccess::remove_absolute(derived_path);
+}
+
+TEST_CASE("[Modules][GDScript] Scripts parsed ahead of time are not parsed again when loaded") {
+	const String base_path = TestUtils::get_temp_path("parse_once_base.gd");
+	const String autoload_path = TestUtils::get_temp_path("parse_once_autoload.gd");
+	{
+		Ref<FileAccess> f = FileAccess::open(base_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string("extends Node\n\nvar value := 1\n");
+		f = FileAccess::open(autoload_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string("extends \"parse_once_base.gd\"\n\nfunc twice() -> int:\n\treturn value * 2\n");
+	}
+
+	Vector<String> paths;
+	paths.push_back(autoload_path);
+	GDScriptCache::parse_ahead(paths);
+
+	Error err = OK;
+	Ref<GDScriptParserRef> autoload_ref = GDScriptCache::get_parser(autoload_path, GDScriptParserRef::PARSED, err);
+	REQUIRE(autoload_ref.is_valid());
+	Ref<GDScriptParserRef> base_ref = GDScriptCache::get_parser(base_path, GDScriptParserRef::PARSED, err);
+	REQUIRE(base_ref.is_valid());
+
+	Ref<GDScript> script = GDScriptCache::get_full_script(autoload_path, err);
+	REQUIRE(err == OK);
+	CHECK(script->is_valid());
+
+	// Compiling from their own parser would leave the trees parsed ahead partially analyzed at most.
+	CHECK_MESSAGE(autoload_ref->get_status() == GDScriptParserRef::FULLY_SOLVED, "The script should be compiled from the tree parsed ahead of time.");
+	CHECK_MESSAGE(base_ref->get_status() == GDScriptParserRef::FULLY_SOLVED, "The script it extends should be compiled from the tree parsed ahead of time.");
+	CHECK(GDScriptCache::get_parser(autoload_path, GDScriptParserRef::EMPTY, err) == autoload_ref);
+	CHECK(GDScriptCache::get_parser(base_path, GDScriptParserRef::EMPTY, err) == base_ref);
+
+	script.unref();
+	autoload_ref.unref();
+	base_ref.unref();
+	GDScriptCache::release_parsed_ahead();
+
+	DirAccess::remove_absolute(base_path);
+	DirAccess::remove_absolute(autoload_path);
+}
+
+TEST_CASE("[Modules][GDScript] Load a script from precompiled bytecode") {
+	const String path = "res://test_precompiled_bytecode.gd";
+	const String code = R"(
+extends RefCounted
+
+const OFFSET = 10
+enum Mode { A, B = 5 }
+
+class Inner:
+	var value := 3
+
+	func twice() -> int:
+		return value * 2
+
+var items: Array[int] = [1, 2, 3]
+
+func compute(p_x: int) -> int:
+	var adder := func(p_value: int) -> int: return p_value + OFFSET + Mode.B
+	var total := 0
+	for item in items:
+		total += adder.call(item)
+	total += Inner.new().twice() + str(p_x).length() + int(Vector2(3, 4).length())
+	return total + p_x + (1 if get_reference_count() > 0 else 0)
+)";
+
+	Vector<uint8_t> binary_tokens;
+	Vector<uint8_t> bytecode;
+	{
+		Ref<GDScript> source_script;
+		source_script.instantiate();
+		source_script->set_path(path);
+		source_script->set_source_code(code);
+		ERR_PRINT_OFF;
+		const Error error = source_script->reload();
+		ERR_PRINT_ON;
+		REQUIRE_MESSAGE(error == OK, "The script should compile successfully.");
+
+		binary_tokens = source_script->get_as_binary_tokens();
+		REQUIRE(GDScriptBytecodeBuffer::serialize_script(source_script, binary_tokens, bytecode) == OK);
+		CHECK(!bytecode.is_empty());
+	}
+	GDScriptCache::remove_script(path);
+
+	SUBCASE("Matching build") {
+		Ref<GDScript> script;
+		script.instantiate();
+		script->set_path(path, true);
+		script->set_binary_tokens_source(binary_tokens);
+		script->set_precompiled_bytecode(bytecode);
+		REQUIRE(GDScriptBytecodeBuffer::make_scripts(script.ptr(), bytecode) == OK);
+		CHECK(script->get_subclasses().has("Inner"));
+
+		const Error error = script->reload();
+		CHECK(error == OK);
+		CHECK_MESSAGE(!script->get_precompiled_bytecode().is_empty(), "The script should be loaded from its bytecode.");
+
+		Ref<RefCounted> ref_counted = memnew(RefCounted);
+		ref_counted->set_script(script);
+		CHECK(int(ref_counted->call("compute", 4)) == 68);
+	}
+
+	SUBCASE("Mismatching build falls back to the binary tokens") {
+		// Corrupt the format version.
+		bytecode.write[4] ^= 0xff;
+
+		Ref<GDScript> script;
+		script.instantiate();
+		script->set_path(path, true);
+		script->set_binary_tokens_source(binary_tokens);
+		script->set_precompiled_bytecode(bytecode);
+		CHECK(GDScriptBytecodeBuffer::make_scripts(script.ptr(), bytecode) != OK);
+
+		ERR_PRINT_OFF;
+		const Error error = script->reload();
+		ERR_PRINT_ON;
+		CHECK(error == OK);
+		CHECK_MESSAGE(script->get_precompiled_bytecode().is_empty(), "The script should be compiled from its binary tokens.");
+
+		Ref<RefCounted> ref_counted = memnew(RefCounted);
+		ref_counted->set_script(script);
+		CHECK(int(ref_counted->call("compute", 4)) == 68);
+	}
+
+	GDScriptCache::remove_script(path);
+}
 #endif // TOOLS_ENABLED
 
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
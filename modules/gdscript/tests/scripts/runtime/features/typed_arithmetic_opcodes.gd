@@ -0,0 +1,63 @@
+# Operations on typed operands use specialized opcodes, and comparisons
+# followed by a conditional jump get fused into a single instruction.
+
+func test():
+	var a: int = 7
+	var b: int = 3
+	print(a + b)
+	print(a - b)
+	print(a * b)
+	print(a < b)
+	print(a <= b)
+	print(a > b)
+	print(a >= b)
+	print(a == b)
+	print(a != b)
+
+	var x: float = 1.5
+	var y: float = 0.5
+	print(x + y == 2.0)
+	print(x - y == 1.0)
+	print(x * y == 0.75)
+	print(x / y == 3.0)
+
+	var v2: Vector2 = Vector2(1, 2)
+	var w2: Vector2 = Vector2(3, 4)
+	print(v2 + w2 == Vector2(4, 6))
+	print(w2 - v2 == Vector2(2, 2))
+	print(v2 * w2 == Vector2(3, 8))
+	print(v2 * y == Vector2(0.5, 1))
+
+	var v3: Vector3 = Vector3(1, 2, 3)
+	var w3: Vector3 = Vector3(4, 5, 6)
+	print(v3 + w3 == Vector3(5, 7, 9))
+	print(w3 - v3 == Vector3(3, 3, 3))
+	print(v3 * w3 == Vector3(4, 10, 18))
+	print(v3 * x == Vector3(1.5, 3, 4.5))
+
+	var count := 0
+	var i := 0
+	while i < 10:
+		if i % 2 == 0:
+			count += 1
+		i += 1
+	print(count)
+
+	var total := 0.0
+	var t := 0.0
+	while t <= 2.0:
+		total += t
+		t += 0.5
+	print(total == 5.0)
+
+	# The result of a fused comparison is still stored.
+	var flag := a > b
+	if flag:
+		print("flag")
+	print(flag)
+
+	if a > b and x < y:
+		print("not ok")
+	else:
+		print("ok")
+	print(a if a < b else b)
@@ -0,0 +1,248 @@
+/**************************************************************************/
+/*  test_inline_cache.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_INLINE_CACHE_H
+#define TEST_INLINE_CACHE_H
+
+#include "../gdscript.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static Ref<GDScript> make_inline_cache_script(const String &p_code) {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(p_code);
+	ERR_PRINT_OFF;
+	const Error error = script->reload();
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(error == OK, "The script should compile successfully.");
+	return script;
+}
+
+static Ref<RefCounted> make_inline_cache_instance(const Ref<GDScript> &p_script) {
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(p_script);
+	return ref_counted;
+}
+
+TEST_CASE("[Modules][GDScript] Inline caches of untyped named access and calls") {
+	Ref<GDScript> script = make_inline_cache_script(R"(
+extends RefCounted
+
+class A:
+	var value = 1
+	var typed: float = 0.0
+	var with_setter = 0:
+		set(p_value):
+			with_setter = p_value * 2
+
+	func get_value():
+		return value
+
+class B extends A:
+	func _init():
+		value = 2
+
+	func get_value():
+		return value * 10
+
+class C:
+	var value = 3
+
+	func get_value():
+		return value
+
+class D:
+	var value = 4
+
+	func get_value():
+		return value
+
+class E:
+	var value = 5
+
+	func get_value():
+		return value
+
+func sum_values(p_objects):
+	var total = 0
+	for i in 3:
+		for object in p_objects:
+			total += object.value
+	return total
+
+func sum_calls(p_objects):
+	var total = 0
+	for i in 3:
+		for object in p_objects:
+			total += object.get_value()
+	return total
+
+func monomorphic():
+	var a = A.new()
+	var total = 0
+	for i in 10:
+		a.value = i
+		total += a.value + a.get_value()
+	return total
+
+func polymorphic_values():
+	return sum_values([A.new(), B.new(), C.new(), { "value": 6 }])
+
+func megamorphic_values():
+	return sum_values([A.new(), B.new(), C.new(), D.new(), E.new(), { "value": 6 }])
+
+func megamorphic_calls():
+	return sum_calls([A.new(), B.new(), C.new(), D.new(), E.new()])
+
+func typed_member_converts():
+	var a = A.new()
+	var converted = true
+	for i in 3:
+		a.typed = i
+		converted = converted and typeof(a.typed) == TYPE_FLOAT
+	return converted
+
+func setter_member():
+	var a = A.new()
+	for i in 3:
+		a.with_setter = i
+	return a.with_setter
+
+func builtin():
+	var vector = Vector2(1, 2)
+	var total = 0.0
+	for i in 3:
+		vector.x = i
+		total += vector.x + vector.y
+	return total
+
+func native():
+	var resource = Resource.new()
+	var names = ""
+	for i in 3:
+		resource.resource_name = str(i)
+		names += resource.resource_name + resource.get_path()
+	return names
+)");
+	Ref<RefCounted> instance = make_inline_cache_instance(script);
+
+	CHECK(int(instance->call("monomorphic")) == 90);
+	CHECK(int(instance->call("polymorphic_values")) == 36);
+	CHECK(int(instance->call("megamorphic_values")) == 63);
+	CHECK(int(instance->call("megamorphic_calls")) == 3 * (1 + 20 + 3 + 4 + 5));
+	CHECK_MESSAGE(bool(instance->call("typed_member_converts")), "Typed members should still convert assigned values.");
+	CHECK_MESSAGE(int(instance->call("setter_member")) == 4, "Members with a setter should still call it.");
+	CHECK(double(instance->call("builtin")) == 9.0);
+	CHECK(String(instance->call("native")) == "012");
+}
+
+TEST_CASE("[Modules][GDScript] Inline caches are invalidated when a script is recompiled") {
+	Ref<GDScript> data = make_inline_cache_script(R"(
+extends RefCounted
+var first = 1
+var second = 2
+)");
+	Ref<GDScript> reader = make_inline_cache_script(R"(
+extends RefCounted
+func read(p_object):
+	return p_object.second
+)");
+	Ref<RefCounted> reader_instance = make_inline_cache_instance(reader);
+
+	{
+		Ref<RefCounted> data_instance = make_inline_cache_instance(data);
+		CHECK(int(reader_instance->call("read", data_instance)) == 2);
+		CHECK(int(reader_instance->call("read", data_instance)) == 2);
+	}
+
+	// The member indices of the recompiled script are swapped.
+	data->set_source_code(R"(
+extends RefCounted
+var second = 20
+var first = 10
+)");
+	ERR_PRINT_OFF;
+	const Error error = data->reload();
+	ERR_PRINT_ON;
+	REQUIRE(error == OK);
+
+	Ref<RefCounted> data_instance = make_inline_cache_instance(data);
+	CHECK(int(reader_instance->call("read", data_instance)) == 20);
+}
+
+TEST_CASE("[Modules][GDScript] Untyped named access and calls should match typed code") {
+	Ref<GDScript> script = make_inline_cache_script(R"(
+extends RefCounted
+
+class Data:
+	var value := 1
+
+	func step(p_delta: int) -> int:
+		value += p_delta
+		return value
+
+func untyped(p_count):
+	var data = Data.new()
+	var vector = Vector2(1, 2)
+	var resource = Resource.new()
+	var total = 0
+	for i in p_count:
+		data.value = i
+		total += data.value + data.step(1) + int(vector.x)
+		resource.resource_local_to_scene = data.value > 0
+		total += int(resource.resource_local_to_scene)
+	return total
+
+func typed(p_count: int) -> int:
+	var data := Data.new()
+	var vector := Vector2(1, 2)
+	var resource := Resource.new()
+	var total := 0
+	for i in p_count:
+		data.value = i
+		total += data.value + data.step(1) + int(vector.x)
+		resource.resource_local_to_scene = data.value > 0
+		total += int(resource.resource_local_to_scene)
+	return total
+)");
+	Ref<RefCounted> instance = make_inline_cache_instance(script);
+	const int count = 100;
+
+	const int64_t untyped_total = instance->call("untyped", count);
+	const int64_t typed_total = instance->call("typed", count);
+	CHECK(untyped_total == typed_total);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_INLINE_CACHE_H
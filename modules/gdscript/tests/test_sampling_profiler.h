@@ -0,0 +1,186 @@
+/**************************************************************************/
+/*  test_sampling_profiler.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAMPLING_PROFILER_H
+#define TEST_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "../gdscript.h"
+#include "../gdscript_sampling_profiler.h"
+
+#include "core/os/os.h"
+#include "tests/test_macros.h"
+
+// Registers a call stack running the given functions, like the one of a thread running scripts with the debugger active.
+class TestGDScriptSamplingProfilerInternalsAccessor {
+	GDScriptLanguage::CallStack call_stack;
+	LocalVector<int> lines;
+	int previous_max_call_stack = 0;
+
+public:
+	static void take_samples(GDScriptSamplingProfiler *p_profiler) {
+		p_profiler->_take_samples();
+	}
+
+	static bool has_samples(GDScriptSamplingProfiler *p_profiler) {
+		MutexLock lock(p_profiler->samples_mutex);
+		return !p_profiler->samples.is_empty();
+	}
+
+	static bool fold_samples(GDScriptSamplingProfiler *p_profiler, PackedStringArray &r_stacks, uint32_t &r_dropped) {
+		return p_profiler->_fold_samples(r_stacks, r_dropped);
+	}
+
+	static bool is_sampling(GDScriptSamplingProfiler *p_profiler) {
+		return p_profiler->thread.is_started();
+	}
+
+	TestGDScriptSamplingProfilerInternalsAccessor(const LocalVector<GDScriptFunction *> &p_functions, const LocalVector<int> &p_lines) {
+		GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+		previous_max_call_stack = language->_debug_max_call_stack;
+		language->_debug_max_call_stack = p_functions.size();
+
+		lines = p_lines;
+		call_stack.levels = memnew_arr(GDScriptLanguage::CallLevel, p_functions.size());
+		for (uint32_t i = 0; i < p_functions.size(); i++) {
+			call_stack.levels[i].function = p_functions[i];
+			call_stack.levels[i].line = &lines[i];
+		}
+		call_stack.stack_pos = p_functions.size();
+		GDScriptLanguage::_register_call_stack(&call_stack);
+	}
+
+	~TestGDScriptSamplingProfilerInternalsAccessor() {
+		GDScriptLanguage::_unregister_call_stack(&call_stack);
+		memdelete_arr(call_stack.levels);
+		call_stack.levels = nullptr;
+		GDScriptLanguage::get_singleton()->_debug_max_call_stack = previous_max_call_stack;
+	}
+};
+
+namespace GDScriptTests {
+
+static Ref<GDScript> make_sampled_script() {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(R"(
+extends RefCounted
+
+func outer():
+	return inner()
+
+func inner():
+	return 1
+)");
+	ERR_PRINT_OFF;
+	const Error error = script->reload();
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(error == OK, "The script should compile successfully.");
+	return script;
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler folds the call stacks of running scripts") {
+	Ref<GDScript> script = make_sampled_script();
+	GDScriptFunction *outer = script->get_member_functions()["outer"];
+	GDScriptFunction *inner = script->get_member_functions()["inner"];
+	REQUIRE(outer);
+	REQUIRE(inner);
+
+	LocalVector<GDScriptFunction *> functions;
+	functions.push_back(outer);
+	functions.push_back(inner);
+	LocalVector<int> lines;
+	lines.push_back(5);
+	lines.push_back(8);
+	TestGDScriptSamplingProfilerInternalsAccessor running_script(functions, lines);
+
+	const String folded_stack = script->get_script_path() + ":outer:5;" + script->get_script_path() + ":inner:8";
+	Ref<GDScriptSamplingProfiler> profiler;
+	profiler.instantiate();
+
+	SUBCASE("Identical samples are folded together") {
+		TestGDScriptSamplingProfilerInternalsAccessor::take_samples(profiler.ptr());
+		TestGDScriptSamplingProfilerInternalsAccessor::take_samples(profiler.ptr());
+
+		PackedStringArray stacks;
+		uint32_t dropped = 0;
+		REQUIRE(TestGDScriptSamplingProfilerInternalsAccessor::fold_samples(profiler.ptr(), stacks, dropped));
+		REQUIRE_EQ(stacks.size(), 1);
+		CHECK_EQ(stacks[0], folded_stack + " 2");
+		CHECK_EQ(dropped, 0u);
+
+		CHECK_FALSE_MESSAGE(TestGDScriptSamplingProfilerInternalsAccessor::fold_samples(profiler.ptr(), stacks, dropped), "Folded samples should be cleared.");
+	}
+
+	SUBCASE("The sampling thread samples the script") {
+		Array options;
+		options.push_back(100);
+		profiler->toggle(true, options);
+		for (int i = 0; i < 1000 && !TestGDScriptSamplingProfilerInternalsAccessor::has_samples(profiler.ptr()); i++) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+		profiler->toggle(false, Array());
+
+		PackedStringArray stacks;
+		uint32_t dropped = 0;
+		REQUIRE(TestGDScriptSamplingProfilerInternalsAccessor::fold_samples(profiler.ptr(), stacks, dropped));
+		REQUIRE_EQ(stacks.size(), 1);
+		CHECK(stacks[0].begins_with(folded_stack + " "));
+	}
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler can be started and stopped repeatedly") {
+	Ref<GDScriptSamplingProfiler> profiler;
+	profiler.instantiate();
+
+	for (int i = 0; i < 3; i++) {
+		profiler->toggle(true, Array());
+		CHECK(TestGDScriptSamplingProfilerInternalsAccessor::is_sampling(profiler.ptr()));
+		// Already running, this shouldn't start another thread.
+		profiler->toggle(true, Array());
+		CHECK(TestGDScriptSamplingProfilerInternalsAccessor::is_sampling(profiler.ptr()));
+
+		profiler->toggle(false, Array());
+		CHECK_FALSE_MESSAGE(TestGDScriptSamplingProfilerInternalsAccessor::is_sampling(profiler.ptr()), "Stopping should join the sampling thread.");
+		profiler->toggle(false, Array());
+		CHECK_FALSE(TestGDScriptSamplingProfilerInternalsAccessor::is_sampling(profiler.ptr()));
+	}
+
+	// Destroying a running profiler should stop its thread as well.
+	profiler->toggle(true, Array());
+	profiler.unref();
+}
+
+} // namespace GDScriptTests
+
+#endif // DEBUG_ENABLED
+
+#endif // TEST_SAMPLING_PROFILER_H
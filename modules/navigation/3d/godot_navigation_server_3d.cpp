@@ -30,6 +30,7 @@
 
 #include "godot_navigation_server_3d.h"
 
+#include "core/config/project_settings.h"
 #include "core/os/mutex.h"
 #include "scene/main/node.h"
 
@@ -82,7 +83,10 @@ using namespace NavigationUtilities;
 	}                                                                 \
 	void GodotNavigationServer3D::MERGE(_cmd_, F_NAME)(T_0 D_0, T_1 D_1)
 
-GodotNavigationServer3D::GodotNavigationServer3D() {}
+GodotNavigationServer3D::GodotNavigationServer3D() {
+	path_query_use_multiple_threads = GLOBAL_GET("navigation/pathfinding/thread_model/path_query_use_multiple_threads");
+	path_query_use_high_priority_threads = GLOBAL_GET("navigation/pathfinding/thread_model/path_query_use_high_priority_threads");
+}
 
 GodotNavigationServer3D::~GodotNavigationServer3D() {
 	flush_queries();
@@ -237,6 +241,34 @@ real_t GodotNavigationServer3D::map_get_link_connection_radius(RID p_map) const
 	return map->get_link_connection_radius();
 }
 
+COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_hierarchical_pathfinding(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_hierarchical_pathfinding(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_hierarchical_pathfinding();
+}
+
+COMMAND_2(map_set_hierarchical_cluster_size, RID, p_map, real_t, p_cluster_size) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_hierarchical_cluster_size(p_cluster_size);
+}
+
+real_t GodotNavigationServer3D::map_get_hierarchical_cluster_size(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, 0);
+
+	return map->get_hierarchical_cluster_size();
+}
+
 Vector<Vector3> GodotNavigationServer3D::map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL_V(map, Vector<Vector3>());
@@ -1298,6 +1330,7 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	int _new_pm_edge_merge_count = 0;
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
+	int _new_pm_polygon_rebuild_count = 0;
 
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
@@ -1315,6 +1348,7 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 		_new_pm_edge_merge_count += active_maps[i]->get_pm_edge_merge_count();
 		_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
 		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
+		_new_pm_polygon_rebuild_count += active_maps[i]->get_pm_polygon_rebuild_count();
 
 		// Emit a signal if a map changed.
 		const uint32_t new_map_iteration_id = active_maps[i]->get_iteration_id();
@@ -1332,6 +1366,7 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	pm_edge_merge_count = _new_pm_edge_merge_count;
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
+	pm_polygon_rebuild_count = _new_pm_polygon_rebuild_count;
 }
 
 void GodotNavigationServer3D::init() {
@@ -1357,12 +1392,63 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 	const NavMap *map = map_owner.get_or_null(p_parameters.map);
 	ERR_FAIL_NULL_V(map, r_query_result);
 
+	RWLockRead read_lock(map->get_rwlock());
+	_query_path_on_map(map, p_parameters, r_query_result);
+
+	return r_query_result;
+}
+
+void GodotNavigationServer3D::_query_paths(const PathQueryParameters *p_parameters, PathQueryResult *r_results, uint32_t p_query_count) const {
+	// Group the queries per map, so each map only needs to be locked once for all its queries.
+	LocalVector<PathQueryBatch> batches;
+	for (uint32_t i = 0; i < p_query_count; i++) {
+		const NavMap *map = map_owner.get_or_null(p_parameters[i].map);
+		ERR_CONTINUE(map == nullptr);
+
+		PathQueryBatch *batch = nullptr;
+		for (PathQueryBatch &map_batch : batches) {
+			if (map_batch.map == map) {
+				batch = &map_batch;
+				break;
+			}
+		}
+		if (batch == nullptr) {
+			batches.push_back(PathQueryBatch());
+			batch = &batches[batches.size() - 1];
+			batch->map = map;
+			batch->parameters = p_parameters;
+			batch->results = r_results;
+		}
+		batch->query_indices.push_back(i);
+	}
+
+	for (PathQueryBatch &batch : batches) {
+		// All the queries of the batch run against the same synchronized state of the map.
+		RWLockRead read_lock(batch.map->get_rwlock());
+
+		if (path_query_use_multiple_threads && batch.query_indices.size() > 1) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_query_path_batch_step, &batch, batch.query_indices.size(), -1, path_query_use_high_priority_threads, SNAME("NavigationPathQueries"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < batch.query_indices.size(); i++) {
+				_query_path_batch_step(i, &batch);
+			}
+		}
+	}
+}
+
+void GodotNavigationServer3D::_query_path_batch_step(uint32_t p_index, PathQueryBatch *p_batch) const {
+	const uint32_t query_index = p_batch->query_indices[p_index];
+	_query_path_on_map(p_batch->map, p_batch->parameters[query_index], p_batch->results[query_index]);
+}
+
+void GodotNavigationServer3D::_query_path_on_map(const NavMap *p_map, const PathQueryParameters &p_parameters, PathQueryResult &r_query_result) const {
 	// run the pathfinding
 
 	if (p_parameters.pathfinding_algorithm == PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR) {
 		// while postprocessing is still part of map.get_path() need to check and route it here for the correct "optimize" post-processing
 		if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_CORRIDORFUNNEL) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->_get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					true,
@@ -1371,7 +1457,7 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
 		} else if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_EDGECENTERED) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->_get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					false,
@@ -1381,7 +1467,7 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
 		}
 	} else {
-		return r_query_result;
+		return;
 	}
 
 	// add path postprocessing
@@ -1429,8 +1515,6 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 	}
 
 	// add path stats
-
-	return r_query_result;
 }
 
 RID GodotNavigationServer3D::source_geometry_parser_create() {
@@ -1566,6 +1650,9 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_EDGE_FREE_COUNT: {
 			return pm_edge_free_count;
 		} break;
+		case INFO_POLYGON_REBUILD_COUNT: {
+			return pm_polygon_rebuild_count;
+		} break;
 	}
 
 	return 0;
@@ -82,6 +82,17 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_iteration_id;
 
+	bool path_query_use_multiple_threads = true;
+	bool path_query_use_high_priority_threads = true;
+
+	/// Path queries of a batch made on the same map.
+	struct PathQueryBatch {
+		const NavMap *map = nullptr;
+		const NavigationUtilities::PathQueryParameters *parameters = nullptr;
+		NavigationUtilities::PathQueryResult *results = nullptr;
+		LocalVector<uint32_t> query_indices;
+	};
+
 #ifndef _3D_DISABLED
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
 #endif // _3D_DISABLED
@@ -95,6 +106,7 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	int pm_edge_merge_count = 0;
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
+	int pm_polygon_rebuild_count = 0;
 
 public:
 	GodotNavigationServer3D();
@@ -129,6 +141,12 @@ public:
 	COMMAND_2(map_set_link_connection_radius, RID, p_map, real_t, p_connection_radius);
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 
+	COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+
+	COMMAND_2(map_set_hierarchical_cluster_size, RID, p_map, real_t, p_cluster_size);
+	virtual real_t map_get_hierarchical_cluster_size(RID p_map) const override;
+
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const override;
@@ -273,6 +291,9 @@ private:
 	static void simplify_path_segment(int p_start_inx, int p_end_inx, const Vector<Vector3> &p_points, real_t p_epsilon, LocalVector<bool> &r_valid_points);
 	static LocalVector<uint32_t> get_simplified_path_indices(const Vector<Vector3> &p_path, real_t p_epsilon);
 
+	void _query_path_on_map(const NavMap *p_map, const NavigationUtilities::PathQueryParameters &p_parameters, NavigationUtilities::PathQueryResult &r_query_result) const;
+	void _query_path_batch_step(uint32_t p_index, PathQueryBatch *p_batch) const;
+
 public:
 	COMMAND_1(free, RID, p_object);
 
@@ -285,6 +306,7 @@ public:
 	virtual void finish() override;
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
+	virtual void _query_paths(const NavigationUtilities::PathQueryParameters *p_parameters, NavigationUtilities::PathQueryResult *r_results, uint32_t p_query_count) const override;
 
 	int get_process_info(ProcessInfo p_info) const override;
 
@@ -0,0 +1,362 @@
+/**************************************************************************/
+/*  nav_cluster_graph.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_cluster_graph.h"
+
+#include "nav_base.h"
+
+#include "core/math/vector3i.h"
+
+void NavClusterGraph::clear() {
+	polygons.clear();
+	polygon_centers.clear();
+	polygon_travel_costs.clear();
+	polygon_clusters.clear();
+	polygon_cluster_indices.clear();
+	clusters.clear();
+	portals.clear();
+}
+
+void NavClusterGraph::build(const LocalVector<gd::Polygon *> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, real_t p_cluster_size) {
+	clear();
+
+	const uint32_t region_polygon_count = p_polygons.size();
+	const uint32_t polygon_count = region_polygon_count + p_link_polygons.size();
+	if (region_polygon_count == 0 || p_cluster_size <= 0.0) {
+		return;
+	}
+
+	polygons.resize(polygon_count);
+	polygon_centers.resize(polygon_count);
+	polygon_travel_costs.resize(polygon_count);
+	polygon_clusters.resize(polygon_count);
+	polygon_cluster_indices.resize(polygon_count);
+
+	LocalVector<Vector3i> polygon_cells;
+	polygon_cells.resize(region_polygon_count);
+
+	for (uint32_t id = 0; id < polygon_count; id++) {
+		const gd::Polygon *polygon = id < region_polygon_count ? p_polygons[id] : &p_link_polygons[id - region_polygon_count];
+		polygons[id] = polygon;
+		polygon_clusters[id] = UINT32_MAX;
+		polygon_cluster_indices[id] = UINT32_MAX;
+		polygon_travel_costs[id] = 1.0;
+
+		Vector3 center;
+		for (const gd::Point &point : polygon->points) {
+			center += point.pos;
+		}
+		if (!polygon->points.is_empty()) {
+			center /= polygon->points.size();
+		}
+		polygon_centers[id] = center;
+
+		if (id < region_polygon_count) {
+			polygon_cells[id] = Vector3i((center / p_cluster_size).floor());
+		}
+	}
+
+	// Flood fill the connected polygons of the same region and cell into clusters.
+	LocalVector<uint32_t> stack;
+	for (uint32_t id = 0; id < region_polygon_count; id++) {
+		if (polygon_clusters[id] != UINT32_MAX) {
+			continue;
+		}
+
+		const uint32_t cluster_index = clusters.size();
+		const NavBase *owner = polygons[id]->owner;
+		clusters.push_back(Cluster());
+		clusters[cluster_index].owner = owner;
+
+		polygon_clusters[id] = cluster_index;
+		stack.push_back(id);
+		while (!stack.is_empty()) {
+			const uint32_t current_id = stack[stack.size() - 1];
+			stack.remove_at(stack.size() - 1);
+
+			polygon_cluster_indices[current_id] = clusters[cluster_index].polygons.size();
+			clusters[cluster_index].polygons.push_back(current_id);
+			polygon_travel_costs[current_id] = owner->get_travel_cost();
+
+			for (const gd::Edge &edge : polygons[current_id]->edges) {
+				for (const gd::Edge::Connection &connection : edge.connections) {
+					const uint32_t connected_id = connection.polygon->id;
+					if (connected_id >= region_polygon_count || polygon_clusters[connected_id] != UINT32_MAX) {
+						continue;
+					}
+					if (polygons[connected_id]->owner != owner || polygon_cells[connected_id] != polygon_cells[current_id]) {
+						continue;
+					}
+					polygon_clusters[connected_id] = cluster_index;
+					stack.push_back(connected_id);
+				}
+			}
+		}
+	}
+
+	// Merge the connections between clusters into portals.
+	// Link polygons get their own cluster when first reached, and as they come after
+	// the region polygons their own connections are processed afterwards.
+	HashMap<uint64_t, uint32_t> portal_indices;
+	LocalVector<uint32_t> portal_pathway_counts;
+	for (uint32_t id = 0; id < polygon_count; id++) {
+		const uint32_t from_cluster = polygon_clusters[id];
+		if (from_cluster == UINT32_MAX) {
+			// Unused link polygon.
+			continue;
+		}
+
+		for (const gd::Edge &edge : polygons[id]->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t connected_id = connection.polygon->id;
+				if (polygon_clusters[connected_id] == UINT32_MAX) {
+					const uint32_t cluster_index = clusters.size();
+					clusters.push_back(Cluster());
+					clusters[cluster_index].owner = connection.polygon->owner;
+					clusters[cluster_index].polygons.push_back(connected_id);
+					polygon_clusters[connected_id] = cluster_index;
+					polygon_cluster_indices[connected_id] = 0;
+					polygon_travel_costs[connected_id] = connection.polygon->owner->get_travel_cost();
+				}
+
+				const uint32_t to_cluster = polygon_clusters[connected_id];
+				if (to_cluster == from_cluster) {
+					continue;
+				}
+
+				const uint64_t portal_key = (uint64_t(from_cluster) << 32) | to_cluster;
+				HashMap<uint64_t, uint32_t>::Iterator portal_index = portal_indices.find(portal_key);
+				if (!portal_index) {
+					portal_index = portal_indices.insert(portal_key, portals.size());
+					portals.push_back(Portal());
+					portals[portals.size() - 1].from_cluster = from_cluster;
+					portals[portals.size() - 1].to_cluster = to_cluster;
+					portal_pathway_counts.push_back(0);
+				}
+
+				Portal &portal = portals[portal_index->value];
+				portal.from_polygons.push_back(id);
+				portal.to_polygons.push_back(connected_id);
+				portal.position += (connection.pathway_start + connection.pathway_end) * 0.5;
+				portal_pathway_counts[portal_index->value] += 1;
+			}
+		}
+	}
+
+	for (uint32_t portal_index = 0; portal_index < portals.size(); portal_index++) {
+		Portal &portal = portals[portal_index];
+		portal.position /= portal_pathway_counts[portal_index];
+		clusters[portal.from_cluster].exit_portals.push_back(portal_index);
+	}
+
+	// Precompute the cost to travel through the cluster each portal leads to.
+	LocalVector<DistanceEntry> seeds;
+	LocalVector<real_t> distances;
+	for (Portal &portal : portals) {
+		seeds.clear();
+		for (uint32_t id : portal.to_polygons) {
+			DistanceEntry seed;
+			seed.distance = polygon_centers[id].distance_to(portal.position) * polygon_travel_costs[id];
+			seed.index = polygon_cluster_indices[id];
+			seeds.push_back(seed);
+		}
+		_compute_cluster_distances(portal.to_cluster, seeds, distances);
+
+		for (uint32_t exit_portal_index : clusters[portal.to_cluster].exit_portals) {
+			const real_t cost = _get_exit_cost(portals[exit_portal_index], distances);
+			if (cost < FLT_MAX) {
+				PortalEdge portal_edge;
+				portal_edge.portal = exit_portal_index;
+				portal_edge.cost = cost;
+				portal.edges.push_back(portal_edge);
+			}
+		}
+	}
+}
+
+void NavClusterGraph::_compute_cluster_distances(uint32_t p_cluster, const LocalVector<DistanceEntry> &p_seeds, LocalVector<real_t> &r_distances) const {
+	const Cluster &cluster = clusters[p_cluster];
+	r_distances.resize(cluster.polygons.size());
+	for (real_t &distance : r_distances) {
+		distance = FLT_MAX;
+	}
+
+	// Dijkstra over the polygons of the cluster.
+	gd::Heap<DistanceEntry> open;
+	for (const DistanceEntry &seed : p_seeds) {
+		if (seed.distance < r_distances[seed.index]) {
+			r_distances[seed.index] = seed.distance;
+			open.push(seed);
+		}
+	}
+
+	while (!open.is_empty()) {
+		const DistanceEntry entry = open.pop();
+		if (entry.distance > r_distances[entry.index]) {
+			// Already reached with a lower cost.
+			continue;
+		}
+
+		const uint32_t id = cluster.polygons[entry.index];
+		for (const gd::Edge &edge : polygons[id]->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t connected_id = connection.polygon->id;
+				if (polygon_clusters[connected_id] != p_cluster) {
+					continue;
+				}
+
+				DistanceEntry next;
+				next.distance = entry.distance + polygon_centers[id].distance_to(polygon_centers[connected_id]) * polygon_travel_costs[id];
+				next.index = polygon_cluster_indices[connected_id];
+				if (next.distance < r_distances[next.index]) {
+					r_distances[next.index] = next.distance;
+					open.push(next);
+				}
+			}
+		}
+	}
+}
+
+real_t NavClusterGraph::_get_exit_cost(const Portal &p_portal, const LocalVector<real_t> &p_distances) const {
+	real_t cost = FLT_MAX;
+	for (uint32_t id : p_portal.from_polygons) {
+		const real_t distance = p_distances[polygon_cluster_indices[id]];
+		if (distance < FLT_MAX) {
+			cost = MIN(cost, distance + polygon_centers[id].distance_to(p_portal.position) * polygon_travel_costs[id]);
+		}
+	}
+	return cost;
+}
+
+real_t NavClusterGraph::_get_entry_cost(const Portal &p_portal, const LocalVector<real_t> &p_distances) const {
+	real_t cost = FLT_MAX;
+	for (uint32_t id : p_portal.to_polygons) {
+		const real_t distance = p_distances[polygon_cluster_indices[id]];
+		if (distance < FLT_MAX) {
+			cost = MIN(cost, distance + polygon_centers[id].distance_to(p_portal.position) * polygon_travel_costs[id]);
+		}
+	}
+	return cost;
+}
+
+bool NavClusterGraph::find_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, gd::PathQueryScratch &r_scratch) const {
+	r_scratch.corridor_clusters.clear();
+
+	if (clusters.is_empty() || p_begin_poly->id >= polygon_clusters.size() || p_end_poly->id >= polygon_clusters.size()) {
+		return false;
+	}
+
+	const uint32_t begin_cluster = polygon_clusters[p_begin_poly->id];
+	const uint32_t end_cluster = polygon_clusters[p_end_poly->id];
+	if (begin_cluster == UINT32_MAX || end_cluster == UINT32_MAX || begin_cluster == end_cluster) {
+		return false;
+	}
+
+	// Costs from the begin point through its cluster, and through the end cluster to the end point.
+	LocalVector<DistanceEntry> seeds;
+	LocalVector<real_t> begin_distances;
+	LocalVector<real_t> end_distances;
+
+	DistanceEntry seed;
+	seed.distance = p_begin_point.distance_to(polygon_centers[p_begin_poly->id]) * polygon_travel_costs[p_begin_poly->id];
+	seed.index = polygon_cluster_indices[p_begin_poly->id];
+	seeds.push_back(seed);
+	_compute_cluster_distances(begin_cluster, seeds, begin_distances);
+
+	seeds.clear();
+	seed.distance = p_end_point.distance_to(polygon_centers[p_end_poly->id]) * polygon_travel_costs[p_end_poly->id];
+	seed.index = polygon_cluster_indices[p_end_poly->id];
+	seeds.push_back(seed);
+	_compute_cluster_distances(end_cluster, seeds, end_distances);
+
+	// A* over the portals, with an extra node for the end point.
+	const uint32_t goal = portals.size();
+	r_scratch.begin_corridor_search(portals.size() + 1);
+
+	gd::Heap<DistanceEntry> open;
+	const auto relax = [&](uint32_t p_node, uint32_t p_previous, real_t p_cost) {
+		if (p_cost >= r_scratch.get_corridor_node_cost(p_node)) {
+			return;
+		}
+		r_scratch.set_corridor_node(p_node, p_cost, p_previous);
+
+		DistanceEntry entry;
+		entry.distance = p_cost + (p_node == goal ? 0.0 : portals[p_node].position.distance_to(p_end_point));
+		entry.index = p_node;
+		open.push(entry);
+	};
+
+	for (uint32_t exit_portal_index : clusters[begin_cluster].exit_portals) {
+		// Only go through clusters with compatible layers.
+		if ((clusters[portals[exit_portal_index].to_cluster].owner->get_navigation_layers() & p_navigation_layers) == 0) {
+			continue;
+		}
+		relax(exit_portal_index, UINT32_MAX, _get_exit_cost(portals[exit_portal_index], begin_distances));
+	}
+
+	while (!open.is_empty()) {
+		const uint32_t node = open.pop().index;
+		if (r_scratch.is_corridor_node_closed(node)) {
+			continue;
+		}
+		r_scratch.close_corridor_node(node);
+
+		if (node == goal) {
+			break;
+		}
+
+		const Portal &portal = portals[node];
+		const real_t cost = r_scratch.get_corridor_node_cost(node);
+		if (portal.to_cluster == end_cluster) {
+			const real_t entry_cost = _get_entry_cost(portal, end_distances);
+			if (entry_cost < FLT_MAX) {
+				relax(goal, node, cost + entry_cost);
+			}
+		}
+
+		for (const PortalEdge &portal_edge : portal.edges) {
+			if ((clusters[portals[portal_edge.portal].to_cluster].owner->get_navigation_layers() & p_navigation_layers) == 0) {
+				continue;
+			}
+			relax(portal_edge.portal, node, cost + portal_edge.cost);
+		}
+	}
+
+	if (!r_scratch.is_corridor_node_closed(goal)) {
+		return false;
+	}
+
+	// Collect the clusters along the portals leading to the end point.
+	r_scratch.corridor_clusters.push_back(end_cluster);
+	for (uint32_t node = r_scratch.get_corridor_node_previous(goal); node != UINT32_MAX; node = r_scratch.get_corridor_node_previous(node)) {
+		r_scratch.corridor_clusters.push_back(portals[node].from_cluster);
+	}
+	return true;
+}
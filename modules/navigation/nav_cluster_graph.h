@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  nav_cluster_graph.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_CLUSTER_GRAPH_H
+#define NAV_CLUSTER_GRAPH_H
+
+#include "nav_utils.h"
+
+/// Abstract graph of a navigation map used for hierarchical path queries.
+/// Connected polygons of the same region that fall in the same spatial cell form a cluster,
+/// and all the connections from a cluster to another one are merged into a portal.
+/// The cost to travel through a cluster from each portal entering it to each portal leaving it
+/// is precomputed, so long queries can find a corridor of clusters before searching polygons.
+class NavClusterGraph {
+	struct Cluster {
+		/// Polygon ids of the cluster.
+		LocalVector<uint32_t> polygons;
+		/// Portals leaving the cluster.
+		LocalVector<uint32_t> exit_portals;
+		/// Region or link owning the polygons of the cluster, its navigation layers can change without a map sync.
+		const NavBase *owner = nullptr;
+	};
+
+	struct PortalEdge {
+		uint32_t portal = 0;
+		real_t cost = 0.0;
+	};
+
+	struct Portal {
+		uint32_t from_cluster = 0;
+		uint32_t to_cluster = 0;
+		Vector3 position;
+		/// Polygons on each side of the portal.
+		LocalVector<uint32_t> from_polygons;
+		LocalVector<uint32_t> to_polygons;
+		/// Portals leaving `to_cluster` that can be reached from this one, with the cost to travel through the cluster.
+		LocalVector<PortalEdge> edges;
+	};
+
+	struct DistanceEntry {
+		real_t distance = 0.0;
+		uint32_t index = 0;
+
+		// Closer entries have a higher priority in the heap.
+		bool operator<(const DistanceEntry &p_other) const {
+			return distance > p_other.distance;
+		}
+	};
+
+	LocalVector<const gd::Polygon *> polygons;
+	LocalVector<Vector3> polygon_centers;
+	LocalVector<real_t> polygon_travel_costs;
+	LocalVector<uint32_t> polygon_clusters;
+	/// Index of each polygon in the polygon list of its cluster.
+	LocalVector<uint32_t> polygon_cluster_indices;
+
+	LocalVector<Cluster> clusters;
+	LocalVector<Portal> portals;
+
+	void _compute_cluster_distances(uint32_t p_cluster, const LocalVector<DistanceEntry> &p_seeds, LocalVector<real_t> &r_distances) const;
+	real_t _get_exit_cost(const Portal &p_portal, const LocalVector<real_t> &p_distances) const;
+	real_t _get_entry_cost(const Portal &p_portal, const LocalVector<real_t> &p_distances) const;
+
+public:
+	void clear();
+	void build(const LocalVector<gd::Polygon *> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons, real_t p_cluster_size);
+
+	bool is_empty() const { return clusters.is_empty(); }
+	uint32_t get_cluster_count() const { return clusters.size(); }
+	uint32_t get_portal_count() const { return portals.size(); }
+	uint32_t get_polygon_cluster(uint32_t p_polygon_id) const { return polygon_clusters[p_polygon_id]; }
+
+	/// Searches the abstract graph for the clusters a path from the begin to the end polygon goes through,
+	/// and stores them in the corridor clusters of the scratch. Must be called after `begin_query()` on the scratch.
+	/// Returns false when both are in the same cluster or no path was found, so the whole map needs to be searched.
+	bool find_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, gd::PathQueryScratch &r_scratch) const;
+};
+
+#endif // NAV_CLUSTER_GRAPH_H
@@ -54,6 +54,9 @@
 		r_path_owners->push_back(poly->owner->get_owner_id()); \
 	}
 
+// Path query buffers of the current thread, reused by all the path queries it makes.
+static thread_local gd::PathQueryScratch path_query_scratch;
+
 #ifdef DEBUG_ENABLED
 #define NAVMAP_ITERATION_ZERO_ERROR_MSG() \
 	ERR_PRINT_ONCE("NavigationServer navigation map query failed because it was made before first map synchronization.\n\
@@ -122,6 +125,23 @@ void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
 	regenerate_links = true;
 }
 
+void NavMap::set_use_hierarchical_pathfinding(bool p_enabled) {
+	if (use_hierarchical_pathfinding == p_enabled) {
+		return;
+	}
+	use_hierarchical_pathfinding = p_enabled;
+	regenerate_links = true;
+}
+
+void NavMap::set_hierarchical_cluster_size(real_t p_cluster_size) {
+	ERR_FAIL_COND_MSG(p_cluster_size <= 0.0, "Hierarchical cluster size must be greater than zero.");
+	if (hierarchical_cluster_size == p_cluster_size) {
+		return;
+	}
+	hierarchical_cluster_size = p_cluster_size;
+	regenerate_links = true;
+}
+
 gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	const int x = static_cast<int>(Math::floor(p_pos.x / merge_rasterizer_cell_size));
 	const int y = static_cast<int>(Math::floor(p_pos.y / merge_rasterizer_cell_height));
@@ -137,6 +157,10 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	RWLockRead read_lock(map_rwlock);
+	return _get_path(p_origin, p_destination, p_optimize, p_navigation_layers, r_path_types, r_path_rids, r_path_owners);
+}
+
+Vector<Vector3> NavMap::_get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector<Vector3>();
@@ -154,40 +178,13 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	}
 
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
+	const int64_t begin_poly_index = _get_closest_polygon(p_origin, true, p_navigation_layers, FLT_MAX, begin_point);
+	const int64_t end_poly_index = _get_closest_polygon(p_destination, true, p_navigation_layers, FLT_MAX, end_point);
+	const gd::Polygon *begin_poly = begin_poly_index != -1 ? polygons[begin_poly_index] : nullptr;
+	const gd::Polygon *end_poly = end_poly_index != -1 ? polygons[end_poly_index] : nullptr;
 	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -219,9 +216,21 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	// Reuse the buffers of the previous queries made on this thread.
+	gd::PathQueryScratch &scratch = path_query_scratch;
+	scratch.begin_query(polygons.size() + link_polygons.size());
+
+	// With hierarchical pathfinding, only search the clusters of the corridor found on the abstract graph of the map.
+	bool use_corridor = false;
+	if (use_hierarchical_pathfinding && !cluster_graph.is_empty()) {
+		use_corridor = cluster_graph.find_corridor(begin_poly, begin_point, end_poly, end_point, p_navigation_layers, scratch);
+		if (use_corridor) {
+			scratch.begin_corridor(cluster_graph.get_cluster_count());
+		}
+	}
+
 	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	LocalVector<gd::NavigationPoly> &navigation_polys = scratch.navigation_polys;
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
@@ -230,10 +239,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 	navigation_polys.push_back(begin_navigation_poly);
+	scratch.set_navigation_poly_index(begin_poly->id, 0);
 
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	// Heap of polygon IDs to visit, ordered by travel cost.
+	gd::Heap<uint32_t, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer> &traversable_polys = scratch.traversable_polys;
 
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = 0;
@@ -256,6 +265,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				// Stay in the corridor, if any.
+				if (use_corridor && !scratch.is_in_corridor(cluster_graph.get_polygon_cluster(connection.polygon->id))) {
+					continue;
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -269,9 +283,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
 				const real_t new_distance = (least_cost_poly.entry.distance_to(new_entry) * poly_travel_cost) + poly_enter_cost + least_cost_poly.traveled_distance;
 
-				int64_t already_visited_polygon_index = navigation_polys.find(gd::NavigationPoly(connection.polygon));
+				const uint32_t already_visited_polygon_index = scratch.get_navigation_poly_index(connection.polygon->id);
 
-				if (already_visited_polygon_index != -1) {
+				if (already_visited_polygon_index != UINT32_MAX) {
 					// Polygon already visited, check if we can reduce the travel cost.
 					gd::NavigationPoly &avp = navigation_polys[already_visited_polygon_index];
 					if (new_distance < avp.traveled_distance) {
@@ -281,6 +295,12 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 						avp.back_navigation_edge_pathway_end = connection.pathway_end;
 						avp.traveled_distance = new_distance;
 						avp.entry = new_entry;
+						avp.distance_to_destination = new_entry.distance_to(end_point) * avp.poly->owner->get_travel_cost();
+
+						// Update its position in the polygons to visit, if it is still waiting there.
+						if (avp.traversable_poly_index != UINT32_MAX) {
+							traversable_polys.shift(avp.traversable_poly_index);
+						}
 					}
 				} else {
 					// Add the neighbor polygon to the reachable ones.
@@ -292,19 +312,35 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
+					new_navigation_poly.distance_to_destination = new_entry.distance_to(end_point) * connection.polygon->owner->get_travel_cost();
 					navigation_polys.push_back(new_navigation_poly);
+					scratch.set_navigation_poly_index(connection.polygon->id, new_navigation_poly.self_id);
 
 					// Add the neighbor polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					traversable_polys.push(new_navigation_poly.self_id);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
+		// The corridor did not lead to the end polygon, search the whole map instead.
+		if (traversable_polys.is_empty() && use_corridor) {
+			use_corridor = false;
+
+			gd::NavigationPoly np = navigation_polys[0];
+			scratch.begin_query(polygons.size() + link_polygons.size());
+			navigation_polys.push_back(np);
+			scratch.set_navigation_poly_index(np.poly->id, 0);
+			least_cost_id = 0;
+			prev_least_cost_id = -1;
+
+			reachable_end = nullptr;
+			reachable_d = FLT_MAX;
+
+			continue;
+		}
 
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (traversable_polys.is_empty()) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -368,10 +404,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Reset open and navigation_polys
 			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
+			scratch.begin_query(polygons.size() + link_polygons.size());
 			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			scratch.set_navigation_poly_index(np.poly->id, 0);
 			least_cost_id = 0;
 			prev_least_cost_id = -1;
 
@@ -380,20 +415,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		real_t least_cost = FLT_MAX;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			real_t cost = np->traveled_distance;
-			cost += (np->entry.distance_to(end_point) * np->poly->owner->get_travel_cost());
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
-
-		ERR_BREAK(least_cost_id == -1);
+		// Pop the polygon with the minimum cost from the list of polygons to visit.
+		least_cost_id = traversable_polys.pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -451,7 +474,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	Vector<Vector3> path;
+	// Built in the frame arena, only the returned copy is allocated.
+	FrameLocalVector<Vector3> path;
 	// Optimize the path.
 	if (p_optimize) {
 		// Set the apex poly/point to the end point
@@ -544,7 +568,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			APPEND_METADATA(begin_poly);
 		}
 
-		path.reverse();
+		path.invert();
 		if (r_path_types) {
 			r_path_types->reverse();
 		}
@@ -580,7 +604,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		path.push_back(begin_point);
 		APPEND_METADATA(begin_poly);
 
-		path.reverse();
+		path.invert();
 		if (r_path_types) {
 			r_path_types->reverse();
 		}
@@ -593,9 +617,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	}
 
 	// Ensure post conditions (path arrays MUST match in size).
-	CRASH_COND(r_path_types && path.size() != r_path_types->size());
-	CRASH_COND(r_path_rids && path.size() != r_path_rids->size());
-	CRASH_COND(r_path_owners && path.size() != r_path_owners->size());
+	CRASH_COND(r_path_types && (int)path.size() != r_path_types->size());
+	CRASH_COND(r_path_rids && (int)path.size() != r_path_rids->size());
+	CRASH_COND(r_path_owners && (int)path.size() != r_path_owners->size());
 
 	return path;
 }
@@ -611,7 +635,8 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 	Vector3 closest_point;
 	real_t closest_point_d = FLT_MAX;
 
-	for (const gd::Polygon &p : polygons) {
+	for (const gd::Polygon *polygon : polygons) {
+		const gd::Polygon &p = *polygon;
 		// For each face check the distance to the segment
 		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
 			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
@@ -703,49 +728,106 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 	RWLockRead read_lock(map_rwlock);
 
 	gd::ClosestPointQueryResult result;
-	real_t closest_point_ds = FLT_MAX;
 
-	for (const gd::Polygon &p : polygons) {
-		// For each face check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t ds = inters.distance_squared_to(p_point);
-			if (ds < closest_point_ds) {
-				result.point = inters;
-				result.normal = f.get_plane().normal;
-				result.owner = p.owner->get_self();
-				closest_point_ds = ds;
-			}
-		}
+	Vector3 closest_point;
+	Vector3 closest_normal;
+	const int64_t closest_polygon_index = _get_closest_polygon(p_point, false, 0, FLT_MAX, closest_point, &closest_normal);
+	if (closest_polygon_index != -1) {
+		result.point = closest_point;
+		result.normal = closest_normal;
+		result.owner = polygons[closest_polygon_index]->owner->get_self();
 	}
 
 	return result;
 }
 
+int64_t NavMap::_get_closest_polygon(const Vector3 &p_point, bool p_use_navigation_layers, uint32_t p_navigation_layers, real_t p_max_distance, Vector3 &r_closest_point, Vector3 *r_closest_normal) const {
+	struct RegionDistance {
+		real_t distance_squared = 0.0;
+		uint32_t index = 0;
+
+		bool operator<(const RegionDistance &p_other) const {
+			return distance_squared < p_other.distance_squared;
+		}
+	};
+
+	// Visit the regions nearest first, so their closest polygon can prune the search in the others.
+	LocalVector<RegionDistance> region_distances;
+	region_distances.reserve(region_polygons.size());
+	for (uint32_t i = 0; i < region_polygons.size(); i++) {
+		const NavRegion *region = region_polygons[i].region;
+		// Only consider the polygons of regions with compatible layers.
+		if (p_use_navigation_layers && (p_navigation_layers & region->get_navigation_layers()) == 0) {
+			continue;
+		}
+		const NavPolygonBVH &bvh = region->get_polygons_bvh();
+		if (bvh.is_empty()) {
+			continue;
+		}
+		RegionDistance region_distance;
+		region_distance.distance_squared = NavPolygonBVH::get_aabb_distance_squared(bvh.get_aabb(), p_point);
+		region_distance.index = i;
+		region_distances.push_back(region_distance);
+	}
+	region_distances.sort();
+
+	NavPolygonBVH::ClosestPolygonResult closest;
+	closest.max_distance_squared = p_max_distance == FLT_MAX ? FLT_MAX : p_max_distance * p_max_distance;
+	int64_t closest_polygon_index = -1;
+
+	for (const RegionDistance &region_distance : region_distances) {
+		if (region_distance.distance_squared > closest.max_distance_squared || region_distance.distance_squared >= closest.distance_squared) {
+			break;
+		}
+		const RegionPolygons &range = region_polygons[region_distance.index];
+		// The result only gets a polygon index when this region has a closer polygon.
+		closest.polygon_index = -1;
+		range.region->get_polygons_bvh().find_closest_polygon(range.region->get_polygons().ptr(), p_point, closest);
+		if (closest.polygon_index != -1) {
+			closest_polygon_index = range.offset + closest.polygon_index;
+		}
+	}
+
+	if (closest_polygon_index != -1) {
+		r_closest_point = closest.point;
+		if (r_closest_normal) {
+			*r_closest_normal = closest.normal;
+		}
+	}
+	return closest_polygon_index;
+}
+
 void NavMap::add_region(NavRegion *p_region) {
 	regions.push_back(p_region);
-	regenerate_links = true;
+	connections_dirty = true;
 }
 
 void NavMap::remove_region(NavRegion *p_region) {
 	int64_t region_index = regions.find(p_region);
 	if (region_index >= 0) {
+		// The region polygons will not outlive it, so disconnect them from the map right away.
+		RWLockWrite write_lock(map_rwlock);
+		_clear_link_connections();
+		_detach_region(p_region);
+		polygons.clear();
+		region_polygons.clear();
+		cluster_graph.clear();
+
 		regions.remove_at_unordered(region_index);
-		regenerate_links = true;
+		connections_dirty = true;
 	}
 }
 
 void NavMap::add_link(NavLink *p_link) {
 	links.push_back(p_link);
-	regenerate_links = true;
+	connections_dirty = true;
 }
 
 void NavMap::remove_link(NavLink *p_link) {
 	int64_t link_index = links.find(p_link);
 	if (link_index >= 0) {
 		links.remove_at_unordered(link_index);
-		regenerate_links = true;
+		connections_dirty = true;
 	}
 }
 
@@ -895,6 +977,299 @@ Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly)
 	}
 }
 
+void NavMap::_clear_connections() {
+	edge_connections.clear();
+	free_edges.clear();
+	new_free_edges.clear();
+
+	for (NavRegion *region : regions) {
+		region->get_connections().clear();
+		for (gd::Polygon &polygon : region->get_polygons()) {
+			for (gd::Edge &edge : polygon.edges) {
+				edge.connections.clear();
+			}
+		}
+	}
+}
+
+void NavMap::_clear_link_connections() {
+	for (gd::Polygon *polygon : link_connected_polygons) {
+		Vector<gd::Edge::Connection> &connections = polygon->edges[0].connections;
+		for (int i = connections.size() - 1; i >= 0; i--) {
+			// Only the connections entering links have no edge.
+			if (connections[i].edge == -1) {
+				connections.remove_at(i);
+			}
+		}
+	}
+	link_connected_polygons.clear();
+	link_polygons.clear();
+}
+
+void NavMap::_detach_region(NavRegion *p_region) {
+	// Unmerge the edges shared with the polygons of other regions.
+	for (gd::Polygon &polygon : p_region->get_polygons()) {
+		for (uint32_t p = 0; p < polygon.points.size(); p++) {
+			const gd::EdgeKey ek(polygon.points[p].key, polygon.points[(p + 1) % polygon.points.size()].key);
+			HashMap<gd::EdgeKey, LocalVector<gd::Edge::Connection>, gd::EdgeKey>::Iterator E = edge_connections.find(ek);
+			if (!E) {
+				continue;
+			}
+
+			LocalVector<gd::Edge::Connection> &edge = E->value;
+			bool removed = false;
+			for (int64_t i = int64_t(edge.size()) - 1; i >= 0; i--) {
+				if (edge[i].polygon->owner == p_region) {
+					edge.remove_at(i);
+					removed = true;
+				}
+			}
+
+			if (edge.is_empty()) {
+				edge_connections.remove(E);
+			} else if (removed) {
+				// The edge left in the other region is now free.
+				const gd::Edge::Connection &other_edge = edge[0];
+				Vector<gd::Edge::Connection> &connections = other_edge.polygon->edges[other_edge.edge].connections;
+				for (int i = connections.size() - 1; i >= 0; i--) {
+					if (connections[i].polygon->owner == p_region) {
+						connections.remove_at(i);
+					}
+				}
+				if (use_edge_connections && other_edge.polygon->owner->get_use_edge_connections()) {
+					new_free_edges.push_back(other_edge);
+				}
+			}
+		}
+	}
+
+	// Remove the connections of the free edges of other regions to this one.
+	// They are checked from both sides, so a connection might only exist in one direction.
+	for (const gd::Edge::Connection &free_edge : free_edges) {
+		if (free_edge.polygon->owner == p_region) {
+			continue;
+		}
+		Vector<gd::Edge::Connection> &connections = free_edge.polygon->edges[free_edge.edge].connections;
+		for (int i = connections.size() - 1; i >= 0; i--) {
+			if (connections[i].polygon->owner == p_region) {
+				connections.remove_at(i);
+			}
+		}
+	}
+
+	for (NavRegion *region : regions) {
+		Vector<gd::Edge::Connection> &region_connections = region->get_connections();
+		if (region == p_region) {
+			region_connections.clear();
+			continue;
+		}
+		for (int i = region_connections.size() - 1; i >= 0; i--) {
+			if (region_connections[i].polygon->owner == p_region) {
+				region_connections.remove_at(i);
+			}
+		}
+	}
+
+	for (int64_t i = int64_t(free_edges.size()) - 1; i >= 0; i--) {
+		if (free_edges[i].polygon->owner == p_region) {
+			free_edges.remove_at_unordered(i);
+		}
+	}
+	for (int64_t i = int64_t(new_free_edges.size()) - 1; i >= 0; i--) {
+		if (new_free_edges[i].polygon->owner == p_region) {
+			new_free_edges.remove_at_unordered(i);
+		}
+	}
+
+	for (gd::Polygon &polygon : p_region->get_polygons()) {
+		for (gd::Edge &edge : polygon.edges) {
+			edge.connections.clear();
+		}
+	}
+}
+
+void NavMap::_attach_region(NavRegion *p_region) {
+	LocalVector<gd::Polygon> &region_polygons_source = p_region->get_polygons();
+
+	// Group all edges per key.
+	for (gd::Polygon &polygon : region_polygons_source) {
+		for (uint32_t p = 0; p < polygon.points.size(); p++) {
+			const uint32_t next_point = (p + 1) % polygon.points.size();
+			const gd::EdgeKey ek(polygon.points[p].key, polygon.points[next_point].key);
+
+			LocalVector<gd::Edge::Connection> &edge = edge_connections[ek];
+			if (edge.size() > 1) {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+				continue;
+			}
+
+			// Add the polygon/edge tuple to this key.
+			gd::Edge::Connection new_connection;
+			new_connection.polygon = &polygon;
+			new_connection.edge = p;
+			new_connection.pathway_start = polygon.points[p].pos;
+			new_connection.pathway_end = polygon.points[next_point].pos;
+
+			if (edge.size() == 1) {
+				const gd::Edge::Connection other_edge = edge[0];
+				if (other_edge.polygon->owner != p_region) {
+					// The edge of the other region was free until now.
+					_remove_free_edge(other_edge);
+				}
+
+				// Connect edge that are shared in different polygons.
+				// Note: The pathway_start/end are full for those connection and do not need to be modified.
+				other_edge.polygon->edges[other_edge.edge].connections.push_back(new_connection);
+				polygon.edges[p].connections.push_back(other_edge);
+			}
+			edge.push_back(new_connection);
+		}
+	}
+
+	if (!use_edge_connections || !p_region->get_use_edge_connections()) {
+		return;
+	}
+
+	// The edges left alone can be connected to the near edges of other regions.
+	for (gd::Polygon &polygon : region_polygons_source) {
+		for (uint32_t p = 0; p < polygon.points.size(); p++) {
+			const gd::EdgeKey ek(polygon.points[p].key, polygon.points[(p + 1) % polygon.points.size()].key);
+			const LocalVector<gd::Edge::Connection> &edge = edge_connections[ek];
+			if (edge.size() == 1 && edge[0].polygon == &polygon) {
+				new_free_edges.push_back(edge[0]);
+			}
+		}
+	}
+}
+
+void NavMap::_remove_free_edge(const gd::Edge::Connection &p_free_edge) {
+	gd::Polygon *polygon = p_free_edge.polygon;
+	NavRegion *region = (NavRegion *)polygon->owner;
+	Vector<gd::Edge::Connection> &connections = polygon->edges[p_free_edge.edge].connections;
+
+	// Remove the connections made with the near edges, in both directions.
+	for (const gd::Edge::Connection &connection : connections) {
+		if (connection.edge == -1) {
+			continue;
+		}
+
+		Vector<gd::Edge::Connection> &other_connections = connection.polygon->edges[connection.edge].connections;
+		for (int i = other_connections.size() - 1; i >= 0; i--) {
+			if (other_connections[i].polygon == polygon && other_connections[i].edge == p_free_edge.edge) {
+				other_connections.remove_at(i);
+			}
+		}
+
+		Vector<gd::Edge::Connection> &other_region_connections = ((NavRegion *)connection.polygon->owner)->get_connections();
+		for (int i = other_region_connections.size() - 1; i >= 0; i--) {
+			if (other_region_connections[i].polygon == polygon && other_region_connections[i].edge == p_free_edge.edge) {
+				other_region_connections.remove_at(i);
+			}
+		}
+
+		// The region connections do not store the edge they come from, only remove one of them.
+		Vector<gd::Edge::Connection> &region_connections = region->get_connections();
+		for (int i = 0; i < region_connections.size(); i++) {
+			if (region_connections[i].polygon == connection.polygon && region_connections[i].edge == connection.edge) {
+				region_connections.remove_at(i);
+				break;
+			}
+		}
+	}
+	connections.clear();
+
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		if (free_edges[i].polygon == polygon && free_edges[i].edge == p_free_edge.edge) {
+			free_edges.remove_at_unordered(i);
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < new_free_edges.size(); i++) {
+		if (new_free_edges[i].polygon == polygon && new_free_edges[i].edge == p_free_edge.edge) {
+			new_free_edges.remove_at_unordered(i);
+			break;
+		}
+	}
+}
+
+void NavMap::_connect_new_free_edges() {
+	// Connect the new free edges with the ones already connected, in both directions,
+	// then between themselves.
+	for (const gd::Edge::Connection &new_free_edge : new_free_edges) {
+		for (const gd::Edge::Connection &free_edge : free_edges) {
+			if (new_free_edge.polygon->owner == free_edge.polygon->owner) {
+				continue;
+			}
+			_connect_free_edges(new_free_edge, free_edge);
+			_connect_free_edges(free_edge, new_free_edge);
+		}
+	}
+
+	for (uint32_t i = 0; i < new_free_edges.size(); i++) {
+		for (uint32_t j = 0; j < new_free_edges.size(); j++) {
+			if (i == j || new_free_edges[i].polygon->owner == new_free_edges[j].polygon->owner) {
+				continue;
+			}
+			_connect_free_edges(new_free_edges[i], new_free_edges[j]);
+		}
+	}
+
+	for (const gd::Edge::Connection &new_free_edge : new_free_edges) {
+		free_edges.push_back(new_free_edge);
+	}
+	new_free_edges.clear();
+}
+
+bool NavMap::_connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge) {
+	const Vector3 edge_p1 = p_free_edge.polygon->points[p_free_edge.edge].pos;
+	const Vector3 edge_p2 = p_free_edge.polygon->points[(p_free_edge.edge + 1) % p_free_edge.polygon->points.size()].pos;
+
+	const Vector3 other_edge_p1 = p_other_edge.polygon->points[p_other_edge.edge].pos;
+	const Vector3 other_edge_p2 = p_other_edge.polygon->points[(p_other_edge.edge + 1) % p_other_edge.polygon->points.size()].pos;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > edge_connection_margin) {
+		return false;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > edge_connection_margin) {
+		return false;
+	}
+
+	// The edges can now be connected.
+	gd::Edge::Connection new_connection = p_other_edge;
+	new_connection.pathway_start = (self1 + other1) / 2.0;
+	new_connection.pathway_end = (self2 + other2) / 2.0;
+	p_free_edge.polygon->edges[p_free_edge.edge].connections.push_back(new_connection);
+
+	// Add the connection to the region_connection map.
+	((NavRegion *)p_free_edge.polygon->owner)->get_connections().push_back(new_connection);
+	return true;
+}
+
 void NavMap::sync() {
 	RWLockWrite write_lock(map_rwlock);
 
@@ -907,6 +1282,7 @@ void NavMap::sync() {
 	int _new_pm_edge_merge_count = pm_edge_merge_count;
 	int _new_pm_edge_connection_count = pm_edge_connection_count;
 	int _new_pm_edge_free_count = pm_edge_free_count;
+	int _new_pm_polygon_rebuild_count = 0;
 
 	// Check if we need to update the links.
 	if (regenerate_polygons) {
@@ -916,97 +1292,66 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	// Regions that need to rebuild their polygons.
+	LocalVector<NavRegion *> changed_regions;
 	for (NavRegion *region : regions) {
-		if (region->sync()) {
-			regenerate_links = true;
+		if (region->is_dirty()) {
+			changed_regions.push_back(region);
 		}
 	}
 
+	bool links_dirty = false;
 	for (NavLink *link : links) {
 		if (link->check_dirty()) {
-			regenerate_links = true;
+			links_dirty = true;
 		}
 	}
 
-	if (regenerate_links) {
-		_new_pm_polygon_count = 0;
-		_new_pm_edge_count = 0;
+	if (regenerate_links || connections_dirty || links_dirty || !changed_regions.is_empty()) {
 		_new_pm_edge_merge_count = 0;
 		_new_pm_edge_connection_count = 0;
-		_new_pm_edge_free_count = 0;
 
-		// Remove regions connections.
-		for (NavRegion *region : regions) {
-			region->get_connections().clear();
-		}
+		// The link polygons are always rebuilt, as any region change can move the polygons they connect to.
+		_clear_link_connections();
 
-		// Resize the polygon count.
-		int count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
+		if (regenerate_links) {
+			_clear_connections();
+		} else {
+			// Only disconnect the changed regions, before their polygons are rebuilt.
+			for (NavRegion *region : changed_regions) {
+				_detach_region(region);
 			}
-			count += region->get_polygons().size();
 		}
-		polygons.resize(count);
 
-		// Copy all region polygons in the map.
-		count = 0;
-		for (const NavRegion *region : regions) {
+		for (NavRegion *region : changed_regions) {
+			region->sync();
+			_new_pm_polygon_rebuild_count += region->get_polygons().size();
+		}
+
+		// Give an id to all the polygons of the enabled regions.
+		polygons.clear();
+		region_polygons.clear();
+		for (NavRegion *region : regions) {
 			if (!region->get_enabled()) {
 				continue;
 			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[count + n] = polygons_source[n];
+			RegionPolygons range;
+			range.region = region;
+			range.offset = polygons.size();
+			region_polygons.push_back(range);
+
+			for (gd::Polygon &polygon : region->get_polygons()) {
+				polygon.id = polygons.size();
+				polygons.push_back(&polygon);
 			}
-			count += region->get_polygons().size();
 		}
 
 		_new_pm_polygon_count = polygons.size();
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
-				}
-			}
-		}
-
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
+		// Connect the polygons of the changed regions, or of all of them when the whole map needs to be connected again.
+		for (NavRegion *region : regenerate_links ? regions : changed_regions) {
+			if (region->get_enabled()) {
+				_attach_region(region);
 			}
 		}
 
@@ -1017,67 +1362,24 @@ void NavMap::sync() {
 		// to be connected, create new polygons to remove that small gap is
 		// not really useful and would result in wasteful computation during
 		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
+		_connect_new_free_edges();
 
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
-
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
-
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
-
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
-
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
-
-				// Add the connection to the region_connection map.
-				((NavRegion *)free_edge.polygon->owner)->get_connections().push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
+		_new_pm_edge_count = edge_connections.size();
+		for (const KeyValue<gd::EdgeKey, LocalVector<gd::Edge::Connection>> &E : edge_connections) {
+			if (E.value.size() == 2) {
+				_new_pm_edge_merge_count += 1;
 			}
 		}
+		for (NavRegion *region : regions) {
+			_new_pm_edge_connection_count += region->get_connections().size();
+		}
+		_new_pm_edge_free_count = free_edges.size();
 
 		uint32_t link_poly_idx = 0;
 		link_polygons.resize(links.size());
+		for (uint32_t i = 0; i < link_polygons.size(); i++) {
+			link_polygons[i].id = polygons.size() + i;
+		}
 
 		// Search for polygons within range of a nav link.
 		for (const NavLink *link : links) {
@@ -1087,49 +1389,14 @@ void NavMap::sync() {
 			const Vector3 start = link->get_start_position();
 			const Vector3 end = link->get_end_position();
 
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
+			// Find the closest polygons within the search radius of the start and end points.
 			Vector3 closest_start_point;
+			const int64_t closest_start_index = _get_closest_polygon(start, false, 0, link_connection_radius, closest_start_point);
+			gd::Polygon *closest_start_polygon = closest_start_index != -1 ? polygons[closest_start_index] : nullptr;
 
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
 			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
-			}
-
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
-			}
+			const int64_t closest_end_index = _get_closest_polygon(end, false, 0, link_connection_radius, closest_end_point);
+			gd::Polygon *closest_end_polygon = closest_end_index != -1 ? polygons[closest_end_index] : nullptr;
 
 			// If we have both a start and end point, then create a synthetic polygon to route through.
 			if (closest_start_polygon && closest_end_polygon) {
@@ -1155,6 +1422,7 @@ void NavMap::sync() {
 					entry_connection.pathway_start = new_polygon.points[0].pos;
 					entry_connection.pathway_end = new_polygon.points[1].pos;
 					closest_start_polygon->edges[0].connections.push_back(entry_connection);
+					link_connected_polygons.push_back(closest_start_polygon);
 
 					gd::Edge::Connection exit_connection;
 					exit_connection.polygon = closest_end_polygon;
@@ -1172,6 +1440,7 @@ void NavMap::sync() {
 					entry_connection.pathway_start = new_polygon.points[2].pos;
 					entry_connection.pathway_end = new_polygon.points[3].pos;
 					closest_end_polygon->edges[0].connections.push_back(entry_connection);
+					link_connected_polygons.push_back(closest_end_polygon);
 
 					gd::Edge::Connection exit_connection;
 					exit_connection.polygon = closest_start_polygon;
@@ -1183,6 +1452,12 @@ void NavMap::sync() {
 			}
 		}
 
+		if (use_hierarchical_pathfinding) {
+			cluster_graph.build(polygons, link_polygons, hierarchical_cluster_size);
+		} else {
+			cluster_graph.clear();
+		}
+
 		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
 		iteration_id = iteration_id % UINT32_MAX + 1;
 	}
@@ -1207,6 +1482,7 @@ void NavMap::sync() {
 
 	regenerate_polygons = false;
 	regenerate_links = false;
+	connections_dirty = false;
 	obstacles_dirty = false;
 	agents_dirty = false;
 
@@ -1219,6 +1495,7 @@ void NavMap::sync() {
 	pm_edge_merge_count = _new_pm_edge_merge_count;
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
+	pm_polygon_rebuild_count = _new_pm_polygon_rebuild_count;
 }
 
 void NavMap::_update_rvo_obstacles_tree_2d() {
@@ -1388,7 +1665,7 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, FrameLocalVector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.is_equal_approx(p_to_point)) {
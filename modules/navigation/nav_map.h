@@ -31,9 +31,12 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "nav_cluster_graph.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
+#include "core/templates/frame_arena.h"
+
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
 
@@ -71,8 +74,16 @@ class NavMap : public NavRid {
 	/// This value is used to limit how far links search to find polygons to connect to.
 	real_t link_connection_radius = 1.0;
 
+	/// Long path queries first search a corridor of clusters on an abstract graph of the map.
+	bool use_hierarchical_pathfinding = false;
+	/// Size of the cells grouping the polygons into clusters.
+	real_t hierarchical_cluster_size = 16.0;
+	NavClusterGraph cluster_graph;
+
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Set when regions or links were added or removed, so the next sync updates the connections of the map.
+	bool connections_dirty = false;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
@@ -81,8 +92,26 @@ class NavMap : public NavRid {
 	LocalVector<NavLink *> links;
 	LocalVector<gd::Polygon> link_polygons;
 
-	/// Map polygons
-	LocalVector<gd::Polygon> polygons;
+	/// Map polygons, by id. They are stored in their regions, so the regions
+	/// that did not change keep their polygons and connections on sync.
+	LocalVector<gd::Polygon *> polygons;
+
+	/// Edges of the region polygons grouped by key, to merge the edges shared by two polygons.
+	HashMap<gd::EdgeKey, LocalVector<gd::Edge::Connection>, gd::EdgeKey> edge_connections;
+	/// Edges that were not merged and can be connected to the near edges of other regions.
+	LocalVector<gd::Edge::Connection> free_edges;
+	/// Free edges that still need to be connected to the near edges, on the next sync.
+	LocalVector<gd::Edge::Connection> new_free_edges;
+	/// Region polygons connected to the link polygons.
+	LocalVector<gd::Polygon *> link_connected_polygons;
+
+	/// Offset of the polygons of each enabled region in the map polygons,
+	/// used to search them through the region polygon BVH.
+	struct RegionPolygons {
+		const NavRegion *region = nullptr;
+		uint32_t offset = 0;
+	};
+	LocalVector<RegionPolygons> region_polygons;
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
@@ -123,6 +152,7 @@ class NavMap : public NavRid {
 	int pm_edge_merge_count = 0;
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
+	int pm_polygon_rebuild_count = 0;
 
 public:
 	NavMap();
@@ -163,9 +193,23 @@ public:
 		return link_connection_radius;
 	}
 
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const {
+		return use_hierarchical_pathfinding;
+	}
+
+	void set_hierarchical_cluster_size(real_t p_cluster_size);
+	real_t get_hierarchical_cluster_size() const {
+		return hierarchical_cluster_size;
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	// Same as get_path(), for callers already holding the read lock of the map.
+	Vector<Vector3> _get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	// Batches of path queries hold the read lock for all of them, so they run against a single synchronized state of the map.
+	const RWLock &get_rwlock() const { return map_rwlock; }
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -216,6 +260,7 @@ public:
 	int get_pm_edge_merge_count() const { return pm_edge_merge_count; }
 	int get_pm_edge_connection_count() const { return pm_edge_connection_count; }
 	int get_pm_edge_free_count() const { return pm_edge_free_count; }
+	int get_pm_polygon_rebuild_count() const { return pm_polygon_rebuild_count; }
 
 private:
 	void compute_single_step(uint32_t index, NavAgent **agent);
@@ -223,7 +268,17 @@ private:
 	void compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent);
 	void compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent);
 
-	void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	void _clear_connections();
+	void _clear_link_connections();
+	void _detach_region(NavRegion *p_region);
+	void _attach_region(NavRegion *p_region);
+	void _remove_free_edge(const gd::Edge::Connection &p_free_edge);
+	void _connect_new_free_edges();
+	bool _connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge);
+
+	int64_t _get_closest_polygon(const Vector3 &p_point, bool p_use_navigation_layers, uint32_t p_navigation_layers, real_t p_max_distance, Vector3 &r_closest_point, Vector3 *r_closest_normal = nullptr) const;
+
+	void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, FrameLocalVector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
 	void _update_rvo_agents_tree_2d();
@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_polygon_bvh.h"
+
+#include "core/math/face3.h"
+
+void NavPolygonBVH::clear() {
+	nodes.clear();
+	items.clear();
+}
+
+void NavPolygonBVH::build(const LocalVector<gd::Polygon> &p_polygons) {
+	clear();
+
+	LocalVector<AABB> aabbs;
+	aabbs.resize(p_polygons.size());
+
+	items.reserve(p_polygons.size());
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		const gd::Polygon &polygon = p_polygons[i];
+		// Skip polygons without any face, they can never be the closest.
+		if (polygon.points.size() < 3) {
+			continue;
+		}
+		AABB aabb(polygon.points[0].pos, Vector3());
+		for (uint32_t j = 1; j < polygon.points.size(); j++) {
+			aabb.expand_to(polygon.points[j].pos);
+		}
+		aabbs[i] = aabb;
+		items.push_back(i);
+	}
+
+	if (items.is_empty()) {
+		return;
+	}
+
+	nodes.reserve(2 * (items.size() / MAX_LEAF_POLYGONS) + 1);
+	nodes.push_back(Node());
+	_build_node(0, 0, items.size(), aabbs, 0);
+}
+
+uint32_t NavPolygonBVH::_build_node(uint32_t p_node, uint32_t p_from, uint32_t p_to, const LocalVector<AABB> &p_aabbs, uint32_t p_depth) {
+	AABB aabb = p_aabbs[items[p_from]];
+	AABB center_aabb(aabb.get_center(), Vector3());
+	for (uint32_t i = p_from + 1; i < p_to; i++) {
+		const AABB &item_aabb = p_aabbs[items[i]];
+		aabb.merge_with(item_aabb);
+		center_aabb.expand_to(item_aabb.get_center());
+	}
+	nodes[p_node].aabb = aabb;
+
+	if (p_to - p_from <= MAX_LEAF_POLYGONS || p_depth >= MAX_DEPTH - 1) {
+		nodes[p_node].first = p_from;
+		nodes[p_node].count = p_to - p_from;
+		return p_node;
+	}
+
+	// Split at the middle of the longest axis of the polygon centers.
+	const Vector3::Axis axis = (Vector3::Axis)center_aabb.get_longest_axis_index();
+	const real_t split = center_aabb.position[axis] + center_aabb.size[axis] * 0.5;
+
+	uint32_t mid = p_from;
+	for (uint32_t i = p_from; i < p_to; i++) {
+		if (p_aabbs[items[i]].get_center()[axis] < split) {
+			SWAP(items[i], items[mid]);
+			mid++;
+		}
+	}
+	if (mid == p_from || mid == p_to) {
+		// All centers are on the same spot, split the range in half.
+		mid = p_from + (p_to - p_from) / 2;
+	}
+
+	const uint32_t first_child = nodes.size();
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+	nodes[p_node].first = first_child;
+	nodes[p_node].count = 0;
+
+	_build_node(first_child, p_from, mid, p_aabbs, p_depth + 1);
+	_build_node(first_child + 1, mid, p_to, p_aabbs, p_depth + 1);
+	return p_node;
+}
+
+AABB NavPolygonBVH::get_aabb() const {
+	if (nodes.is_empty()) {
+		return AABB();
+	}
+	return nodes[0].aabb;
+}
+
+void NavPolygonBVH::find_closest_polygon(const gd::Polygon *p_polygons, const Vector3 &p_point, ClosestPolygonResult &r_result) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	uint32_t stack[MAX_DEPTH * 2];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		const real_t node_distance_squared = get_aabb_distance_squared(node.aabb, p_point);
+		if (node_distance_squared > r_result.max_distance_squared || node_distance_squared >= r_result.distance_squared) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			// Visit the nearest child first, so it can prune the other one.
+			const real_t d0 = get_aabb_distance_squared(nodes[node.first].aabb, p_point);
+			const real_t d1 = get_aabb_distance_squared(nodes[node.first + 1].aabb, p_point);
+			if (d0 < d1) {
+				stack[stack_size++] = node.first + 1;
+				stack[stack_size++] = node.first;
+			} else {
+				stack[stack_size++] = node.first;
+				stack[stack_size++] = node.first + 1;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const gd::Polygon &polygon = p_polygons[items[i]];
+			// For each face check the distance to the point.
+			for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				const Vector3 closest_point = face.get_closest_point_to(p_point);
+				const real_t distance_squared = closest_point.distance_squared_to(p_point);
+				if (distance_squared <= r_result.max_distance_squared && distance_squared < r_result.distance_squared) {
+					r_result.polygon_index = items[i];
+					r_result.point = closest_point;
+					r_result.normal = face.get_plane().normal;
+					r_result.distance_squared = distance_squared;
+				}
+			}
+		}
+	}
+}
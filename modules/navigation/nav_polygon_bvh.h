@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_POLYGON_BVH_H
+#define NAV_POLYGON_BVH_H
+
+#include "nav_utils.h"
+
+#include "core/math/aabb.h"
+
+/// Static bounding volume hierarchy over a set of navigation polygons,
+/// used to find the closest polygon to a point without testing all of them.
+class NavPolygonBVH {
+	static const uint32_t MAX_LEAF_POLYGONS = 4;
+	static const uint32_t MAX_DEPTH = 64;
+
+	struct Node {
+		AABB aabb;
+		/// Index of the first child node for branches, or of the first item for leaves.
+		uint32_t first = 0;
+		/// Number of items for leaves, zero for branches.
+		uint32_t count = 0;
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> items;
+
+	uint32_t _build_node(uint32_t p_node, uint32_t p_from, uint32_t p_to, const LocalVector<AABB> &p_aabbs, uint32_t p_depth);
+
+public:
+	struct ClosestPolygonResult {
+		int64_t polygon_index = -1;
+		Vector3 point;
+		Vector3 normal;
+		real_t distance_squared = FLT_MAX;
+		/// Squared search radius. Points at exactly this distance are still accepted.
+		real_t max_distance_squared = FLT_MAX;
+	};
+
+	void clear();
+	void build(const LocalVector<gd::Polygon> &p_polygons);
+
+	bool is_empty() const { return nodes.is_empty(); }
+	AABB get_aabb() const;
+
+	/// Searches `p_polygons` (the same set the hierarchy was built from) for a point closer to `p_point`
+	/// than `r_result.distance_squared` and within `r_result.max_distance_squared`, and updates `r_result` if one is found.
+	void find_closest_polygon(const gd::Polygon *p_polygons, const Vector3 &p_point, ClosestPolygonResult &r_result) const;
+
+	static real_t get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+		return p_point.clamp(p_aabb.position, p_aabb.position + p_aabb.size).distance_squared_to(p_point);
+	}
+};
+
+#endif // NAV_POLYGON_BVH_H
@@ -219,6 +219,7 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	polygons_bvh.clear();
 	surface_area = 0.0;
 	polygons_dirty = false;
 
@@ -295,4 +296,6 @@ void NavRegion::update_polygons() {
 	}
 
 	surface_area = _new_region_surface_area;
+
+	polygons_bvh.build(polygons);
 }
@@ -32,6 +32,7 @@
 #define NAV_REGION_H
 
 #include "nav_base.h"
+#include "nav_polygon_bvh.h"
 #include "nav_utils.h"
 
 #include "core/os/rw_lock.h"
@@ -49,6 +50,7 @@ class NavRegion : public NavBase {
 
 	/// Cache
 	LocalVector<gd::Polygon> polygons;
+	NavPolygonBVH polygons_bvh;
 
 	real_t surface_area = 0.0;
 
@@ -65,6 +67,10 @@ public:
 		polygons_dirty = true;
 	}
 
+	bool is_dirty() const {
+		return polygons_dirty;
+	}
+
 	void set_enabled(bool p_enabled);
 	bool get_enabled() const { return enabled; }
 
@@ -95,6 +101,14 @@ public:
 	LocalVector<gd::Polygon> const &get_polygons() const {
 		return polygons;
 	}
+	/// The map connects the polygons in place, so they keep their connections while the region does not change.
+	LocalVector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
+
+	const NavPolygonBVH &get_polygons_bvh() const {
+		return polygons_bvh;
+	}
 
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
 
@@ -98,6 +98,9 @@ struct Edge {
 };
 
 struct Polygon {
+	/// Id of the polygon in the map.
+	uint32_t id = UINT32_MAX;
+
 	/// Navigation region or link that contains this polygon.
 	const NavBase *owner = nullptr;
 
@@ -123,8 +126,13 @@ struct NavigationPoly {
 
 	/// The entry position of this poly.
 	Vector3 entry;
-	/// The distance to the destination.
+	/// The distance traveled until now (g cost).
 	real_t traveled_distance = 0.0;
+	/// The distance to the destination (h cost).
+	real_t distance_to_destination = 0.0;
+
+	/// Index in the heap of traversable polygons, or UINT32_MAX when not in the heap.
+	uint32_t traversable_poly_index = UINT32_MAX;
 
 	NavigationPoly() { poly = nullptr; }
 
@@ -138,6 +146,35 @@ struct NavigationPoly {
 	bool operator!=(const NavigationPoly &other) const {
 		return !operator==(other);
 	}
+
+	real_t total_travel_cost() const {
+		return traveled_distance + distance_to_destination;
+	}
+};
+
+struct NavPolyTravelCostGreaterThan {
+	const LocalVector<NavigationPoly> *navigation_polys = nullptr;
+
+	// Polys with lower travel cost are to be processed first.
+	bool operator()(uint32_t p_poly_a, uint32_t p_poly_b) const {
+		const NavigationPoly &poly_a = (*navigation_polys)[p_poly_a];
+		const NavigationPoly &poly_b = (*navigation_polys)[p_poly_b];
+		real_t f_cost_a = poly_a.total_travel_cost();
+		real_t f_cost_b = poly_b.total_travel_cost();
+		if (f_cost_a != f_cost_b) {
+			return f_cost_a > f_cost_b;
+		}
+		// Prefer the poly that made more progress towards the destination on equal cost.
+		return poly_a.distance_to_destination > poly_b.distance_to_destination;
+	}
+};
+
+struct NavPolyHeapIndexer {
+	LocalVector<NavigationPoly> *navigation_polys = nullptr;
+
+	void operator()(uint32_t p_poly, uint32_t p_heap_index) const {
+		(*navigation_polys)[p_poly].traversable_poly_index = p_heap_index;
+	}
 };
 
 struct ClosestPointQueryResult {
@@ -146,6 +183,263 @@ struct ClosestPointQueryResult {
 	RID owner;
 };
 
+template <typename T>
+struct NoopIndexer {
+	void operator()(const T &p_value, uint32_t p_index) {}
+};
+
+/**
+ * A max-heap with the element of highest priority according to `LessThan` at the top.
+ * The `Indexer` is notified of the position of every element so they can be shifted
+ * in place when their priority changes (decrease-key), and gets `UINT32_MAX` once
+ * they are popped out of the heap.
+ */
+template <typename T, typename LessThan = Comparator<T>, typename Indexer = NoopIndexer<T>>
+class Heap {
+	LocalVector<T> _buffer;
+
+	LessThan _less_than;
+	Indexer _indexer;
+
+public:
+	void reserve(uint32_t p_size) {
+		_buffer.reserve(p_size);
+	}
+
+	uint32_t size() const {
+		return _buffer.size();
+	}
+
+	bool is_empty() const {
+		return _buffer.is_empty();
+	}
+
+	void push(const T &p_element) {
+		_buffer.push_back(p_element);
+		_indexer(p_element, _buffer.size() - 1);
+		_shift_up(_buffer.size() - 1);
+	}
+
+	T pop() {
+		ERR_FAIL_COND_V_MSG(_buffer.is_empty(), T(), "Can't pop an empty heap.");
+		T value = _buffer[0];
+		_indexer(value, UINT32_MAX);
+		if (_buffer.size() > 1) {
+			_buffer[0] = _buffer[_buffer.size() - 1];
+			_indexer(_buffer[0], 0);
+			_buffer.remove_at(_buffer.size() - 1);
+			_shift_down(0);
+		} else {
+			_buffer.remove_at(_buffer.size() - 1);
+		}
+		return value;
+	}
+
+	/**
+	 * Update the position of the element in the heap if necessary.
+	 */
+	void shift(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_index, _buffer.size(), "Heap element index is out of range.");
+		if (!_shift_up(p_index)) {
+			_shift_down(p_index);
+		}
+	}
+
+	void clear() {
+		for (const T &element : _buffer) {
+			_indexer(element, UINT32_MAX);
+		}
+		_buffer.clear();
+	}
+
+	Heap() {}
+
+	Heap(const LessThan &p_less_than) :
+			_less_than(p_less_than) {}
+
+	Heap(const Indexer &p_indexer) :
+			_indexer(p_indexer) {}
+
+	Heap(const LessThan &p_less_than, const Indexer &p_indexer) :
+			_less_than(p_less_than), _indexer(p_indexer) {}
+
+private:
+	bool _shift_up(uint32_t p_index) {
+		T value = _buffer[p_index];
+		uint32_t current_index = p_index;
+		uint32_t parent_index = (current_index - 1) / 2;
+		while (current_index > 0 && _less_than(_buffer[parent_index], value)) {
+			_buffer[current_index] = _buffer[parent_index];
+			_indexer(_buffer[current_index], current_index);
+			current_index = parent_index;
+			parent_index = (current_index - 1) / 2;
+		}
+		if (current_index != p_index) {
+			_buffer[current_index] = value;
+			_indexer(value, current_index);
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	bool _shift_down(uint32_t p_index) {
+		T value = _buffer[p_index];
+		uint32_t current_index = p_index;
+		uint32_t child_index = 2 * current_index + 1;
+		while (child_index < _buffer.size()) {
+			if (child_index + 1 < _buffer.size() &&
+					_less_than(_buffer[child_index], _buffer[child_index + 1])) {
+				child_index++;
+			}
+			if (_less_than(_buffer[child_index], value)) {
+				break;
+			}
+			_buffer[current_index] = _buffer[child_index];
+			_indexer(_buffer[current_index], current_index);
+			current_index = child_index;
+			child_index = 2 * current_index + 1;
+		}
+		if (current_index != p_index) {
+			_buffer[current_index] = value;
+			_indexer(value, current_index);
+			return true;
+		} else {
+			return false;
+		}
+	}
+};
+
+/// Buffers of a path query, kept per thread so consecutive queries reuse their allocations.
+struct PathQueryScratch {
+	/// All the reachable navigation polys of the current query.
+	LocalVector<NavigationPoly> navigation_polys;
+
+	/// Polygons to visit, ordered by travel cost.
+	Heap<uint32_t, NavPolyTravelCostGreaterThan, NavPolyHeapIndexer> traversable_polys;
+
+	/// Index in `navigation_polys` of the reached polygons, by polygon id. An entry is only valid
+	/// when its query id matches the current one, so these never need to be cleared between queries.
+	LocalVector<uint32_t> navigation_poly_indices;
+	LocalVector<uint32_t> navigation_poly_query_ids;
+	uint32_t query_id = 0;
+
+	/// Query id of the clusters a hierarchical query is restricted to, by cluster index.
+	LocalVector<uint32_t> corridor_cluster_query_ids;
+	LocalVector<uint32_t> corridor_clusters;
+
+	/// Cost and previous node of the portals reached by the corridor search on the cluster graph, by node index.
+	/// Like the polygon indices, entries are only valid when their query id matches the current one.
+	LocalVector<real_t> corridor_node_costs;
+	LocalVector<uint32_t> corridor_node_previous;
+	LocalVector<uint32_t> corridor_node_query_ids;
+	LocalVector<uint32_t> corridor_node_closed_query_ids;
+
+	/// Starts a new query on a map with `p_polygon_count` polygons, dropping the data of the previous one.
+	void begin_query(uint32_t p_polygon_count) {
+		traversable_polys.clear();
+		navigation_polys.clear();
+
+		if (navigation_poly_query_ids.size() < p_polygon_count) {
+			uint32_t old_size = navigation_poly_query_ids.size();
+			navigation_poly_indices.resize(p_polygon_count);
+			navigation_poly_query_ids.resize(p_polygon_count);
+			for (uint32_t i = old_size; i < p_polygon_count; i++) {
+				navigation_poly_query_ids[i] = 0;
+			}
+		}
+
+		query_id++;
+		if (unlikely(query_id == 0)) {
+			// Wrapped around, old ids could now collide with the new ones.
+			for (uint32_t &id : navigation_poly_query_ids) {
+				id = 0;
+			}
+			for (uint32_t &id : corridor_cluster_query_ids) {
+				id = 0;
+			}
+			for (uint32_t &id : corridor_node_query_ids) {
+				id = 0;
+			}
+			for (uint32_t &id : corridor_node_closed_query_ids) {
+				id = 0;
+			}
+			query_id = 1;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t get_navigation_poly_index(uint32_t p_polygon_id) const {
+		return navigation_poly_query_ids[p_polygon_id] == query_id ? navigation_poly_indices[p_polygon_id] : UINT32_MAX;
+	}
+
+	_FORCE_INLINE_ void set_navigation_poly_index(uint32_t p_polygon_id, uint32_t p_navigation_poly_index) {
+		navigation_poly_indices[p_polygon_id] = p_navigation_poly_index;
+		navigation_poly_query_ids[p_polygon_id] = query_id;
+	}
+
+	/// Restricts the current query to the clusters in `corridor_clusters`.
+	void begin_corridor(uint32_t p_cluster_count) {
+		if (corridor_cluster_query_ids.size() < p_cluster_count) {
+			uint32_t old_size = corridor_cluster_query_ids.size();
+			corridor_cluster_query_ids.resize(p_cluster_count);
+			for (uint32_t i = old_size; i < p_cluster_count; i++) {
+				corridor_cluster_query_ids[i] = 0;
+			}
+		}
+		for (uint32_t cluster : corridor_clusters) {
+			corridor_cluster_query_ids[cluster] = query_id;
+		}
+	}
+
+	_FORCE_INLINE_ bool is_in_corridor(uint32_t p_cluster) const {
+		return p_cluster != UINT32_MAX && corridor_cluster_query_ids[p_cluster] == query_id;
+	}
+
+	/// Starts a corridor search over `p_node_count` nodes of the cluster graph, all unreached.
+	void begin_corridor_search(uint32_t p_node_count) {
+		if (corridor_node_query_ids.size() < p_node_count) {
+			uint32_t old_size = corridor_node_query_ids.size();
+			corridor_node_costs.resize(p_node_count);
+			corridor_node_previous.resize(p_node_count);
+			corridor_node_query_ids.resize(p_node_count);
+			corridor_node_closed_query_ids.resize(p_node_count);
+			for (uint32_t i = old_size; i < p_node_count; i++) {
+				corridor_node_query_ids[i] = 0;
+				corridor_node_closed_query_ids[i] = 0;
+			}
+		}
+	}
+
+	_FORCE_INLINE_ real_t get_corridor_node_cost(uint32_t p_node) const {
+		return corridor_node_query_ids[p_node] == query_id ? corridor_node_costs[p_node] : FLT_MAX;
+	}
+
+	_FORCE_INLINE_ uint32_t get_corridor_node_previous(uint32_t p_node) const {
+		return corridor_node_query_ids[p_node] == query_id ? corridor_node_previous[p_node] : UINT32_MAX;
+	}
+
+	_FORCE_INLINE_ void set_corridor_node(uint32_t p_node, real_t p_cost, uint32_t p_previous) {
+		corridor_node_costs[p_node] = p_cost;
+		corridor_node_previous[p_node] = p_previous;
+		corridor_node_query_ids[p_node] = query_id;
+	}
+
+	_FORCE_INLINE_ bool is_corridor_node_closed(uint32_t p_node) const {
+		return corridor_node_closed_query_ids[p_node] == query_id;
+	}
+
+	_FORCE_INLINE_ void close_corridor_node(uint32_t p_node) {
+		corridor_node_closed_query_ids[p_node] = query_id;
+	}
+
+	PathQueryScratch() :
+			traversable_polys(NavPolyTravelCostGreaterThan{ &navigation_polys }, NavPolyHeapIndexer{ &navigation_polys }) {}
+
+	// The heap points to the polys of this scratch, copies would point to the wrong ones.
+	PathQueryScratch(const PathQueryScratch &) = delete;
+	PathQueryScratch &operator=(const PathQueryScratch &) = delete;
+};
+
 } // namespace gd
 
 #endif // NAV_UTILS_H
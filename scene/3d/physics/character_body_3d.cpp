@@ -37,13 +37,22 @@ bool CharacterBody3D::move_and_slide() {
 	// Hack in order to work with calling from _process as well as from _physics_process; calling from thread is risky
 	double delta = Engine::get_singleton()->is_in_physics_frame() ? get_physics_process_delta_time() : get_process_delta_time();
 
+	if (motion_batching && Engine::get_singleton()->is_in_physics_frame() && Thread::is_main_thread() && is_inside_tree()) {
+		_queue_motion_batch(delta);
+		return false;
+	}
+
+	return _move_and_slide(delta);
+}
+
+bool CharacterBody3D::_move_and_slide(double p_delta) {
 	for (int i = 0; i < 3; i++) {
 		if (locked_axis & (1 << i)) {
 			velocity[i] = 0.0;
 		}
 	}
 
-	Transform3D gt = get_global_transform();
+	Transform3D gt = _get_motion_transform();
 	previous_position = gt.origin;
 
 	Vector3 current_platform_velocity = platform_velocity;
@@ -86,7 +95,7 @@ bool CharacterBody3D::move_and_slide() {
 	last_motion = Vector3();
 
 	if (!current_platform_velocity.is_zero_approx()) {
-		PhysicsServer3D::MotionParameters parameters(get_global_transform(), current_platform_velocity * delta, margin);
+		PhysicsServer3D::MotionParameters parameters(_get_motion_transform(), current_platform_velocity * p_delta, margin);
 		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
 
 		parameters.exclude_bodies.insert(platform_rid);
@@ -95,7 +104,7 @@ bool CharacterBody3D::move_and_slide() {
 		}
 
 		PhysicsServer3D::MotionResult floor_result;
-		if (move_and_collide(parameters, floor_result, false, false)) {
+		if (_move_and_collide(parameters, floor_result, false, false)) {
 			motion_results.push_back(floor_result);
 
 			CollisionState result_state;
@@ -104,13 +113,13 @@ bool CharacterBody3D::move_and_slide() {
 	}
 
 	if (motion_mode == MOTION_MODE_GROUNDED) {
-		_move_and_slide_grounded(delta, was_on_floor);
+		_move_and_slide_grounded(p_delta, was_on_floor);
 	} else {
-		_move_and_slide_floating(delta);
+		_move_and_slide_floating(p_delta);
 	}
 
 	// Compute real velocity.
-	real_velocity = get_position_delta() / delta;
+	real_velocity = (_get_motion_transform().origin - previous_position) / p_delta;
 
 	if (platform_on_leave != PLATFORM_ON_LEAVE_DO_NOTHING) {
 		// Add last platform velocity when just left a moving platform.
@@ -151,12 +160,12 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 	Vector3 total_travel;
 
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer3D::MotionParameters parameters(get_global_transform(), motion, margin);
+		PhysicsServer3D::MotionParameters parameters(_get_motion_transform(), motion, margin);
 		parameters.max_collisions = 6; // There can be 4 collisions between 2 walls + 2 more for the floor.
 		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
 
 		PhysicsServer3D::MotionResult result;
-		bool collided = move_and_collide(parameters, result, false, !sliding_enabled);
+		bool collided = _move_and_collide(parameters, result, false, !sliding_enabled);
 
 		last_motion = result.travel;
 
@@ -182,11 +191,11 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 			}
 
 			if (collision_state.floor && floor_stop_on_slope && (velocity.normalized() + up_direction).length() < 0.01) {
-				Transform3D gt = get_global_transform();
+				Transform3D gt = _get_motion_transform();
 				if (result.travel.length() <= margin + CMP_EPSILON) {
 					gt.origin -= result.travel;
 				}
-				set_global_transform(gt);
+				_set_motion_transform(gt);
 				velocity = Vector3();
 				motion = Vector3();
 				last_motion = Vector3();
@@ -218,7 +227,7 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 						apply_default_sliding = false;
 						if (p_was_on_floor && !vel_dir_facing_up) {
 							// Cancel the motion.
-							Transform3D gt = get_global_transform();
+							Transform3D gt = _get_motion_transform();
 							real_t travel_total = result.travel.length();
 							real_t cancel_dist_max = MIN(0.1, margin * 20);
 							if (travel_total <= margin + CMP_EPSILON) {
@@ -234,7 +243,7 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 								result.travel = result.travel.slide(up_direction);
 								motion = result.remainder;
 							}
-							set_global_transform(gt);
+							_set_motion_transform(gt);
 							// Determines if you are on the ground, and limits the possibility of climbing on the walls because of the approximations.
 							_snap_on_floor(true, false);
 						} else {
@@ -357,9 +366,9 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 		else if (floor_constant_speed && first_slide && _on_floor_if_snapped(p_was_on_floor, vel_dir_facing_up)) {
 			can_apply_constant_speed = false;
 			sliding_enabled = true;
-			Transform3D gt = get_global_transform();
+			Transform3D gt = _get_motion_transform();
 			gt.origin = gt.origin - result.travel;
-			set_global_transform(gt);
+			_set_motion_transform(gt);
 
 			// Slide using the intersection between the motion plane and the floor plane,
 			// in order to keep the direction intact.
@@ -398,11 +407,11 @@ void CharacterBody3D::_move_and_slide_floating(double p_delta) {
 
 	bool first_slide = true;
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer3D::MotionParameters parameters(get_global_transform(), motion, margin);
+		PhysicsServer3D::MotionParameters parameters(_get_motion_transform(), motion, margin);
 		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
 
 		PhysicsServer3D::MotionResult result;
-		bool collided = move_and_collide(parameters, result, false, false);
+		bool collided = _move_and_collide(parameters, result, false, false);
 
 		last_motion = result.travel;
 
@@ -420,9 +429,9 @@ void CharacterBody3D::_move_and_slide_floating(double p_delta) {
 			if (wall_min_slide_angle != 0 && Math::acos(wall_normal.dot(-velocity.normalized())) < wall_min_slide_angle + FLOOR_ANGLE_THRESHOLD) {
 				motion = Vector3();
 				if (result.travel.length() < margin + CMP_EPSILON) {
-					Transform3D gt = get_global_transform();
+					Transform3D gt = _get_motion_transform();
 					gt.origin -= result.travel;
-					set_global_transform(gt);
+					_set_motion_transform(gt);
 				}
 			} else if (first_slide) {
 				Vector3 motion_slide_norm = result.remainder.slide(wall_normal).normalized();
@@ -452,13 +461,13 @@ void CharacterBody3D::apply_floor_snap() {
 	// Snap by at least collision margin to keep floor state consistent.
 	real_t length = MAX(floor_snap_length, margin);
 
-	PhysicsServer3D::MotionParameters parameters(get_global_transform(), -up_direction * length, margin);
+	PhysicsServer3D::MotionParameters parameters(_get_motion_transform(), -up_direction * length, margin);
 	parameters.max_collisions = 4;
 	parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
 	parameters.collide_separation_ray = true;
 
 	PhysicsServer3D::MotionResult result;
-	if (move_and_collide(parameters, result, true, false)) {
+	if (_move_and_collide(parameters, result, true, false)) {
 		CollisionState result_state;
 		// Apply direction for floor only.
 		_set_collision_direction(result, result_state, CollisionState(true, false, false));
@@ -475,7 +484,7 @@ void CharacterBody3D::apply_floor_snap() {
 			}
 
 			parameters.from.origin += result.travel;
-			set_global_transform(parameters.from);
+			_set_motion_transform(parameters.from);
 		}
 	}
 }
@@ -496,13 +505,13 @@ bool CharacterBody3D::_on_floor_if_snapped(bool p_was_on_floor, bool p_vel_dir_f
 	// Snap by at least collision margin to keep floor state consistent.
 	real_t length = MAX(floor_snap_length, margin);
 
-	PhysicsServer3D::MotionParameters parameters(get_global_transform(), -up_direction * length, margin);
+	PhysicsServer3D::MotionParameters parameters(_get_motion_transform(), -up_direction * length, margin);
 	parameters.max_collisions = 4;
 	parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
 	parameters.collide_separation_ray = true;
 
 	PhysicsServer3D::MotionResult result;
-	if (move_and_collide(parameters, result, true, false)) {
+	if (_move_and_collide(parameters, result, true, false)) {
 		CollisionState result_state;
 		// Don't apply direction for any type.
 		_set_collision_direction(result, result_state, CollisionState());
@@ -513,6 +522,211 @@ bool CharacterBody3D::_on_floor_if_snapped(bool p_was_on_floor, bool p_vel_dir_f
 	return false;
 }
 
+// A body waiting for the motion batch of the physics frame, see _flush_motion_batch().
+struct CharacterBody3D::MotionBatchState {
+	struct TestResult {
+		PhysicsServer3D::MotionResult result;
+		bool collided = false;
+	};
+
+	double delta = 0.0;
+	Transform3D transform;
+	bool solving = false;
+
+	// Motion tests solved so far, in the order move_and_slide() asks for them.
+	LocalVector<TestResult> results;
+	uint32_t test_index = 0;
+	bool has_request = false;
+	PhysicsServer3D::MotionParameters request;
+
+	// State of the body when it was queued, every solve starts from it.
+	Transform3D start_transform;
+	CollisionState collision_state;
+	int platform_layer = 0;
+	RID platform_rid;
+	ObjectID platform_object_id;
+	Vector3 velocity;
+	Vector3 floor_normal;
+	Vector3 wall_normal;
+	Vector3 ceiling_normal;
+	Vector3 last_motion;
+	Vector3 platform_velocity;
+	Vector3 platform_angular_velocity;
+	Vector3 platform_ceiling_velocity;
+	Vector3 previous_position;
+	Vector3 real_velocity;
+};
+
+LocalVector<ObjectID> CharacterBody3D::motion_batch_queue;
+
+void CharacterBody3D::_queue_motion_batch(double p_delta) {
+	if (motion_batch) {
+		// Moved twice in the same frame, the second motion has to start where the first one ends.
+		_flush_motion_batch();
+	}
+
+	motion_batch = memnew(MotionBatchState);
+	motion_batch->delta = p_delta;
+	motion_batch->start_transform = get_global_transform();
+	motion_batch->collision_state = collision_state;
+	motion_batch->platform_layer = platform_layer;
+	motion_batch->platform_rid = platform_rid;
+	motion_batch->platform_object_id = platform_object_id;
+	motion_batch->velocity = velocity;
+	motion_batch->floor_normal = floor_normal;
+	motion_batch->wall_normal = wall_normal;
+	motion_batch->ceiling_normal = ceiling_normal;
+	motion_batch->last_motion = last_motion;
+	motion_batch->platform_velocity = platform_velocity;
+	motion_batch->platform_angular_velocity = platform_angular_velocity;
+	motion_batch->platform_ceiling_velocity = platform_ceiling_velocity;
+	motion_batch->previous_position = previous_position;
+	motion_batch->real_velocity = real_velocity;
+
+	if (motion_batch_queue.is_empty()) {
+		callable_mp_static(&CharacterBody3D::_flush_motion_batch).call_deferred();
+	}
+	motion_batch_queue.push_back(get_instance_id());
+}
+
+void CharacterBody3D::_solve_motion_batch() {
+	collision_state = motion_batch->collision_state;
+	platform_layer = motion_batch->platform_layer;
+	platform_rid = motion_batch->platform_rid;
+	platform_object_id = motion_batch->platform_object_id;
+	velocity = motion_batch->velocity;
+	floor_normal = motion_batch->floor_normal;
+	wall_normal = motion_batch->wall_normal;
+	ceiling_normal = motion_batch->ceiling_normal;
+	last_motion = motion_batch->last_motion;
+	platform_velocity = motion_batch->platform_velocity;
+	platform_angular_velocity = motion_batch->platform_angular_velocity;
+	platform_ceiling_velocity = motion_batch->platform_ceiling_velocity;
+	previous_position = motion_batch->previous_position;
+	real_velocity = motion_batch->real_velocity;
+
+	motion_batch->transform = motion_batch->start_transform;
+	motion_batch->test_index = 0;
+	motion_batch->has_request = false;
+
+	motion_batch->solving = true;
+	_move_and_slide(motion_batch->delta);
+	motion_batch->solving = false;
+}
+
+void CharacterBody3D::_flush_motion_batch() {
+	LocalVector<CharacterBody3D *> bodies;
+	for (const ObjectID &id : motion_batch_queue) {
+		CharacterBody3D *body = Object::cast_to<CharacterBody3D>(ObjectDB::get_instance(id));
+		if (!body || !body->motion_batch) {
+			continue;
+		}
+		if (!body->is_inside_tree()) {
+			memdelete(body->motion_batch);
+			body->motion_batch = nullptr;
+			continue;
+		}
+		bodies.push_back(body);
+	}
+	motion_batch_queue.clear();
+
+	// Bodies are solved over and over, each time knowing the result of one more motion test,
+	// until none of them asks for another one. The tests of a round are solved in a single batch.
+	LocalVector<CharacterBody3D *> solving = bodies;
+	LocalVector<CharacterBody3D *> waiting;
+	LocalVector<RID> rids;
+	LocalVector<PhysicsServer3D::MotionParameters> parameters;
+	LocalVector<PhysicsServer3D::MotionResult> results;
+	LocalVector<bool> collided;
+
+	while (!solving.is_empty()) {
+		waiting.clear();
+		rids.clear();
+		parameters.clear();
+
+		for (CharacterBody3D *body : solving) {
+			body->_solve_motion_batch();
+			if (body->motion_batch->has_request) {
+				waiting.push_back(body);
+				rids.push_back(body->get_rid());
+				parameters.push_back(body->motion_batch->request);
+			}
+		}
+
+		if (waiting.is_empty()) {
+			break;
+		}
+
+		results.resize(waiting.size());
+		collided.resize(waiting.size());
+		PhysicsServer3D::get_singleton()->body_test_motions(rids.ptr(), parameters.ptr(), waiting.size(), results.ptr(), collided.ptr());
+
+		for (uint32_t i = 0; i < waiting.size(); i++) {
+			MotionBatchState::TestResult test;
+			test.result = results[i];
+			test.collided = collided[i];
+			waiting[i]->motion_batch->results.push_back(test);
+		}
+
+		SWAP(solving, waiting);
+	}
+
+	for (CharacterBody3D *body : bodies) {
+		Transform3D transform = body->motion_batch->transform;
+		memdelete(body->motion_batch);
+		body->motion_batch = nullptr;
+		body->set_global_transform(transform);
+	}
+}
+
+bool CharacterBody3D::_move_and_collide(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_test_only, bool p_cancel_sliding) {
+	if (!motion_batch || !motion_batch->solving) {
+		return move_and_collide(p_parameters, r_result, p_test_only, p_cancel_sliding);
+	}
+
+	bool colliding = false;
+	if (motion_batch->test_index < motion_batch->results.size()) {
+		const MotionBatchState::TestResult &test = motion_batch->results[motion_batch->test_index];
+		r_result = test.result;
+		colliding = test.collided;
+	} else {
+		// Not solved yet, it goes in the next round. The motion is free until then,
+		// what this solve does past this point is thrown away anyway.
+		if (!motion_batch->has_request) {
+			motion_batch->has_request = true;
+			motion_batch->request = p_parameters;
+		}
+		r_result = PhysicsServer3D::MotionResult();
+		r_result.travel = p_parameters.motion;
+	}
+	motion_batch->test_index++;
+
+	_adjust_motion_result(p_parameters, r_result, colliding, p_cancel_sliding);
+
+	if (!p_test_only) {
+		Transform3D gt = p_parameters.from;
+		gt.origin += r_result.travel;
+		motion_batch->transform = gt;
+	}
+
+	return colliding;
+}
+
+Transform3D CharacterBody3D::_get_motion_transform() const {
+	if (motion_batch && motion_batch->solving) {
+		return motion_batch->transform;
+	}
+	return get_global_transform();
+}
+
+void CharacterBody3D::_set_motion_transform(const Transform3D &p_transform) {
+	if (motion_batch && motion_batch->solving) {
+		motion_batch->transform = p_transform;
+		return;
+	}
+	set_global_transform(p_transform);
+}
+
 void CharacterBody3D::_set_collision_direction(const PhysicsServer3D::MotionResult &p_result, CollisionState &r_state, CollisionState p_apply_state) {
 	r_state.state = 0;
 
@@ -617,6 +831,14 @@ real_t CharacterBody3D::get_safe_margin() const {
 	return margin;
 }
 
+void CharacterBody3D::set_motion_batching_enabled(bool p_enabled) {
+	motion_batching = p_enabled;
+}
+
+bool CharacterBody3D::is_motion_batching_enabled() const {
+	return motion_batching;
+}
+
 const Vector3 &CharacterBody3D::get_velocity() const {
 	return velocity;
 }
@@ -848,6 +1070,8 @@ void CharacterBody3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_safe_margin", "margin"), &CharacterBody3D::set_safe_margin);
 	ClassDB::bind_method(D_METHOD("get_safe_margin"), &CharacterBody3D::get_safe_margin);
+	ClassDB::bind_method(D_METHOD("set_motion_batching_enabled", "enabled"), &CharacterBody3D::set_motion_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_motion_batching_enabled"), &CharacterBody3D::is_motion_batching_enabled);
 	ClassDB::bind_method(D_METHOD("is_floor_stop_on_slope_enabled"), &CharacterBody3D::is_floor_stop_on_slope_enabled);
 	ClassDB::bind_method(D_METHOD("set_floor_stop_on_slope_enabled", "enabled"), &CharacterBody3D::set_floor_stop_on_slope_enabled);
 	ClassDB::bind_method(D_METHOD("set_floor_constant_speed_enabled", "enabled"), &CharacterBody3D::set_floor_constant_speed_enabled);
@@ -916,6 +1140,7 @@ void CharacterBody3D::_bind_methods() {
 
 	ADD_GROUP("Collision", "");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "safe_margin", PROPERTY_HINT_RANGE, "0.001,256,0.001,suffix:m"), "set_safe_margin", "get_safe_margin");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "motion_batching"), "set_motion_batching_enabled", "is_motion_batching_enabled");
 
 	BIND_ENUM_CONSTANT(MOTION_MODE_GROUNDED);
 	BIND_ENUM_CONSTANT(MOTION_MODE_FLOATING);
@@ -936,3 +1161,9 @@ void CharacterBody3D::_validate_property(PropertyInfo &p_property) const {
 CharacterBody3D::CharacterBody3D() :
 		PhysicsBody3D(PhysicsServer3D::BODY_MODE_KINEMATIC) {
 }
+
+CharacterBody3D::~CharacterBody3D() {
+	if (motion_batch) {
+		memdelete(motion_batch);
+	}
+}
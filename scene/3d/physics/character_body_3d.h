@@ -36,6 +36,7 @@
 
 class CharacterBody3D : public PhysicsBody3D {
 	GDCLASS(CharacterBody3D, PhysicsBody3D);
+	friend class TestCharacterBody3DInternalsAccessor;
 
 public:
 	enum MotionMode {
@@ -76,6 +77,9 @@ public:
 	void set_safe_margin(real_t p_margin);
 	real_t get_safe_margin() const;
 
+	void set_motion_batching_enabled(bool p_enabled);
+	bool is_motion_batching_enabled() const;
+
 	bool is_floor_stop_on_slope_enabled() const;
 	void set_floor_stop_on_slope_enabled(bool p_enabled);
 
@@ -113,9 +117,11 @@ public:
 	PlatformOnLeave get_platform_on_leave() const;
 
 	CharacterBody3D();
+	~CharacterBody3D();
 
 private:
 	real_t margin = 0.001;
+	bool motion_batching = false;
 	MotionMode motion_mode = MOTION_MODE_GROUNDED;
 	PlatformOnLeave platform_on_leave = PLATFORM_ON_LEAVE_ADD_VELOCITY;
 	union CollisionState {
@@ -165,6 +171,19 @@ private:
 	Vector<PhysicsServer3D::MotionResult> motion_results;
 	Vector<Ref<KinematicCollision3D>> slide_colliders;
 
+	// Set from a batched move_and_slide() until the end of the physics frame.
+	struct MotionBatchState;
+	MotionBatchState *motion_batch = nullptr;
+	static LocalVector<ObjectID> motion_batch_queue;
+
+	void _queue_motion_batch(double p_delta);
+	void _solve_motion_batch();
+	static void _flush_motion_batch();
+	bool _move_and_collide(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_test_only, bool p_cancel_sliding);
+	Transform3D _get_motion_transform() const;
+	void _set_motion_transform(const Transform3D &p_transform);
+
+	bool _move_and_slide(double p_delta);
 	void _move_and_slide_floating(double p_delta);
 	void _move_and_slide_grounded(double p_delta, bool p_was_on_floor);
 
@@ -108,6 +108,18 @@ Ref<KinematicCollision3D> PhysicsBody3D::_move(const Vector3 &p_motion, bool p_t
 bool PhysicsBody3D::move_and_collide(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_test_only, bool p_cancel_sliding) {
 	bool colliding = PhysicsServer3D::get_singleton()->body_test_motion(get_rid(), p_parameters, &r_result);
 
+	_adjust_motion_result(p_parameters, r_result, colliding, p_cancel_sliding);
+
+	if (!p_test_only) {
+		Transform3D gt = p_parameters.from;
+		gt.origin += r_result.travel;
+		set_global_transform(gt);
+	}
+
+	return colliding;
+}
+
+void PhysicsBody3D::_adjust_motion_result(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_colliding, bool p_cancel_sliding) const {
 	// Restore direction of motion to be along original motion,
 	// in order to avoid sliding due to recovery,
 	// but only if collision depth is low enough to avoid tunneling.
@@ -115,7 +127,7 @@ bool PhysicsBody3D::move_and_collide(const PhysicsServer3D::MotionParameters &p_
 		real_t motion_length = p_parameters.motion.length();
 		real_t precision = 0.001;
 
-		if (colliding) {
+		if (p_colliding) {
 			// Can't just use margin as a threshold because collision depth is calculated on unsafe motion,
 			// so even in normal resting cases the depth can be a bit more than the margin.
 			precision += motion_length * (r_result.collision_unsafe_fraction - r_result.collision_safe_fraction);
@@ -151,14 +163,6 @@ bool PhysicsBody3D::move_and_collide(const PhysicsServer3D::MotionParameters &p_
 			r_result.travel[i] = 0;
 		}
 	}
-
-	if (!p_test_only) {
-		Transform3D gt = p_parameters.from;
-		gt.origin += r_result.travel;
-		set_global_transform(gt);
-	}
-
-	return colliding;
 }
 
 bool PhysicsBody3D::test_move(const Transform3D &p_from, const Vector3 &p_motion, const Ref<KinematicCollision3D> &r_collision, real_t p_margin, bool p_recovery_as_collision, int p_max_collisions) {
@@ -49,6 +49,8 @@ protected:
 	uint16_t locked_axis = 0;
 
 	Ref<KinematicCollision3D> _move(const Vector3 &p_motion, bool p_test_only = false, real_t p_margin = 0.001, bool p_recovery_as_collision = false, int p_max_collisions = 1);
+	// Applies sliding cancellation and axis locks to the result of a body_test_motion() call.
+	void _adjust_motion_result(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_colliding, bool p_cancel_sliding) const;
 
 public:
 	bool move_and_collide(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_test_only = false, bool p_cancel_sliding = true);
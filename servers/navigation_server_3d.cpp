@@ -55,6 +55,10 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_set_link_connection_radius", "map", "radius"), &NavigationServer3D::map_set_link_connection_radius);
 	ClassDB::bind_method(D_METHOD("map_get_link_connection_radius", "map"), &NavigationServer3D::map_get_link_connection_radius);
+	ClassDB::bind_method(D_METHOD("map_set_use_hierarchical_pathfinding", "map", "enabled"), &NavigationServer3D::map_set_use_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("map_get_use_hierarchical_pathfinding", "map"), &NavigationServer3D::map_get_use_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("map_set_hierarchical_cluster_size", "map", "cluster_size"), &NavigationServer3D::map_set_hierarchical_cluster_size);
+	ClassDB::bind_method(D_METHOD("map_get_hierarchical_cluster_size", "map"), &NavigationServer3D::map_get_hierarchical_cluster_size);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "navigation_layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
@@ -72,6 +76,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_paths", "parameters", "results"), &NavigationServer3D::query_paths);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer3D::region_set_enabled);
@@ -216,6 +221,7 @@ void NavigationServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(INFO_POLYGON_REBUILD_COUNT);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
@@ -242,6 +248,9 @@ NavigationServer3D::NavigationServer3D() {
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/avoidance/thread_model/avoidance_use_high_priority_threads", true);
 
+	GLOBAL_DEF("navigation/pathfinding/thread_model/path_query_use_multiple_threads", true);
+	GLOBAL_DEF("navigation/pathfinding/thread_model/path_query_use_high_priority_threads", true);
+
 	GLOBAL_DEF("navigation/baking/use_crash_prevention_checks", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_multiple_threads", true);
 	GLOBAL_DEF("navigation/baking/thread_model/baking_use_high_priority_threads", true);
@@ -942,6 +951,38 @@ void NavigationServer3D::query_path(const Ref<NavigationPathQueryParameters3D> &
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+void NavigationServer3D::query_paths(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results) const {
+	ERR_FAIL_COND_MSG(p_query_parameters.size() != p_query_results.size(), "The number of path query parameters and results must match.");
+
+	const uint32_t query_count = p_query_parameters.size();
+	LocalVector<NavigationUtilities::PathQueryParameters> _query_parameters;
+	_query_parameters.resize(query_count);
+	for (uint32_t i = 0; i < query_count; i++) {
+		const Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		ERR_FAIL_COND(!query_parameters.is_valid());
+		ERR_FAIL_COND(!Ref<NavigationPathQueryResult3D>(p_query_results[i]).is_valid());
+		_query_parameters[i] = query_parameters->get_parameters();
+	}
+
+	LocalVector<NavigationUtilities::PathQueryResult> _query_results;
+	_query_results.resize(query_count);
+	_query_paths(_query_parameters.ptr(), _query_results.ptr(), query_count);
+
+	for (uint32_t i = 0; i < query_count; i++) {
+		Ref<NavigationPathQueryResult3D> query_result = p_query_results[i];
+		query_result->set_path(_query_results[i].path);
+		query_result->set_path_types(_query_results[i].path_types);
+		query_result->set_path_rids(_query_results[i].path_rids);
+		query_result->set_path_owner_ids(_query_results[i].path_owner_ids);
+	}
+}
+
+void NavigationServer3D::_query_paths(const NavigationUtilities::PathQueryParameters *p_parameters, NavigationUtilities::PathQueryResult *r_results, uint32_t p_query_count) const {
+	for (uint32_t i = 0; i < p_query_count; i++) {
+		r_results[i] = _query_path(p_parameters[i]);
+	}
+}
+
 ///////////////////////////////////////////////////////
 
 NavigationServer3DCallback NavigationServer3DManager::create_callback = nullptr;
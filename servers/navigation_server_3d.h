@@ -102,6 +102,14 @@ public:
 	/// Returns the link connection radius of this map.
 	virtual real_t map_get_link_connection_radius(RID p_map) const = 0;
 
+	/// Set whether path queries on this map first search a corridor on a graph of polygon clusters.
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const = 0;
+
+	/// Set the size of the cells grouping the polygons of this map into clusters.
+	virtual void map_set_hierarchical_cluster_size(RID p_map, real_t p_cluster_size) = 0;
+	virtual real_t map_get_hierarchical_cluster_size(RID p_map) const = 0;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const = 0;
 
@@ -344,6 +352,11 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
 
+	/// Returns customized navigation paths for a batch of query parameters objects
+	virtual void query_paths(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results) const;
+
+	virtual void _query_paths(const NavigationUtilities::PathQueryParameters *p_parameters, NavigationUtilities::PathQueryResult *r_results, uint32_t p_query_count) const;
+
 #ifndef _3D_DISABLED
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
@@ -369,6 +382,7 @@ public:
 		INFO_EDGE_MERGE_COUNT,
 		INFO_EDGE_CONNECTION_COUNT,
 		INFO_EDGE_FREE_COUNT,
+		INFO_POLYGON_REBUILD_COUNT,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) const = 0;
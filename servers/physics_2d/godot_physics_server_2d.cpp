@@ -36,6 +36,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #define FLUSH_QUERY_CHECK(m_object) \
@@ -1285,6 +1286,11 @@ void GodotPhysicsServer2D::set_active(bool p_active) {
 void GodotPhysicsServer2D::init() {
 	doing_sync = false;
 	stepper = memnew(GodotStep2D);
+	step_spaces_in_parallel = GLOBAL_GET("physics/2d/step_spaces_in_parallel");
+}
+
+void GodotPhysicsServer2D::_step_space(uint32_t p_index, const real_t *p_step) {
+	space_steppers[p_index]->step(spaces_to_step[p_index], *p_step);
 }
 
 void GodotPhysicsServer2D::step(real_t p_step) {
@@ -1297,6 +1303,27 @@ void GodotPhysicsServer2D::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	if (step_spaces_in_parallel && active_spaces.size() > 1) {
+		// Spaces share no state while stepping. Queries are still flushed afterwards, one space at a time.
+		spaces_to_step.clear();
+		for (const GodotSpace2D *E : active_spaces) {
+			spaces_to_step.push_back(const_cast<GodotSpace2D *>(E));
+		}
+		while (space_steppers.size() < spaces_to_step.size()) {
+			space_steppers.push_back(memnew(GodotStep2D));
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsServer2D::_step_space, &p_step, spaces_to_step.size(), -1, true, SNAME("Physics2DStepSpaces"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		for (const GodotSpace2D *space : spaces_to_step) {
+			island_count += space->get_island_count();
+			active_objects += space->get_active_objects();
+			collision_pairs += space->get_collision_pairs();
+		}
+		return;
+	}
+
 	for (const GodotSpace2D *E : active_spaces) {
 		stepper->step(const_cast<GodotSpace2D *>(E), p_step);
 		island_count += E->get_island_count();
@@ -1365,6 +1392,10 @@ void GodotPhysicsServer2D::end_sync() {
 
 void GodotPhysicsServer2D::finish() {
 	memdelete(stepper);
+	for (GodotStep2D *space_stepper : space_steppers) {
+		memdelete(space_stepper);
+	}
+	space_steppers.clear();
 }
 
 void GodotPhysicsServer2D::_update_shapes() {
@@ -58,6 +58,12 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 	GodotStep2D *stepper = nullptr;
 	HashSet<const GodotSpace2D *> active_spaces;
 
+	// When stepping spaces in parallel, each one needs a stepper of its own.
+	bool step_spaces_in_parallel = false;
+	LocalVector<GodotStep2D *> space_steppers;
+	LocalVector<GodotSpace2D *> spaces_to_step;
+	void _step_space(uint32_t p_index, const real_t *p_step);
+
 	mutable RID_PtrOwner<GodotShape2D, true> shape_owner;
 	mutable RID_PtrOwner<GodotSpace2D, true> space_owner;
 	mutable RID_PtrOwner<GodotArea2D, true> area_owner;
@@ -39,6 +39,8 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+SafeNumeric<uint64_t> GodotStep2D::last_step;
+
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -128,6 +130,8 @@ void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) cons
 void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
+	_step = last_step.increment();
+
 	p_space->setup(); //update inertias, etc
 
 	p_space->set_last_step(p_delta);
@@ -293,7 +297,6 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	all_constraints.clear();
 
 	p_space->unlock();
-	_step++;
 }
 
 GodotStep2D::GodotStep2D() {
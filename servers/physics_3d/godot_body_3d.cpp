@@ -677,7 +677,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 
 	ERR_FAIL_NULL(get_space());
 
-	if (fi_callback_data || body_state_callback.is_valid()) {
+	if ((fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 	}
 
@@ -798,6 +798,124 @@ bool GodotBody3D::sleep_test(real_t p_step) {
 	}
 }
 
+// Followed in the snapshot by contact_count reported contacts.
+struct GodotBody3DSnapshot {
+	Transform3D transform;
+	Transform3D inv_transform;
+	Transform3D new_transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+	Vector3 prev_linear_velocity;
+	Vector3 prev_angular_velocity;
+	Vector3 applied_force;
+	Vector3 applied_torque;
+	Vector3 constant_force;
+	Vector3 constant_torque;
+	real_t still_time = 0.0;
+	int32_t contact_count = 0;
+	uint32_t active = 0; // Not bool, to leave no padding.
+};
+
+// Size of a reported contact in the snapshot, see save_snapshot().
+static constexpr uint32_t BODY_CONTACT_SNAPSHOT_SIZE = 6 * sizeof(Vector3) + sizeof(real_t) + 2 * sizeof(int32_t) + sizeof(uint64_t) + sizeof(RID);
+
+void GodotBody3D::save_snapshot(LocalVector<uint8_t> &r_buffer) const {
+	GodotBody3DSnapshot snapshot;
+	snapshot.transform = get_transform();
+	snapshot.inv_transform = get_inv_transform();
+	snapshot.new_transform = new_transform;
+	snapshot.linear_velocity = linear_velocity;
+	snapshot.angular_velocity = angular_velocity;
+	snapshot.prev_linear_velocity = prev_linear_velocity;
+	snapshot.prev_angular_velocity = prev_angular_velocity;
+	snapshot.applied_force = applied_force;
+	snapshot.applied_torque = applied_torque;
+	snapshot.constant_force = constant_force;
+	snapshot.constant_torque = constant_torque;
+	snapshot.still_time = still_time;
+	snapshot.contact_count = contact_count;
+	snapshot.active = active;
+
+	GodotSpace3D::snapshot_write(r_buffer, &snapshot, sizeof(snapshot));
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		GodotSpace3D::snapshot_write_value(r_buffer, c.local_pos);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.local_normal);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.local_velocity_at_pos);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.depth);
+		GodotSpace3D::snapshot_write_value(r_buffer, (int32_t)c.local_shape);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.collider_pos);
+		GodotSpace3D::snapshot_write_value(r_buffer, (int32_t)c.collider_shape);
+		GodotSpace3D::snapshot_write_value(r_buffer, (uint64_t)c.collider_instance_id);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.collider);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.collider_velocity_at_pos);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.impulse);
+	}
+}
+
+bool GodotBody3D::is_snapshot_valid(const uint8_t *p_data, uint32_t p_size) {
+	GodotBody3DSnapshot snapshot;
+	ERR_FAIL_COND_V(p_size < sizeof(snapshot), false);
+	memcpy(&snapshot, p_data, sizeof(snapshot));
+	ERR_FAIL_COND_V(snapshot.contact_count < 0 || p_size != sizeof(snapshot) + (uint64_t)snapshot.contact_count * BODY_CONTACT_SNAPSHOT_SIZE, false);
+	return true;
+}
+
+bool GodotBody3D::restore_snapshot(const uint8_t *p_data, uint32_t p_size) {
+	ERR_FAIL_COND_V(!is_snapshot_valid(p_data, p_size), false);
+	GodotBody3DSnapshot snapshot;
+	memcpy(&snapshot, p_data, sizeof(snapshot));
+
+	if (get_transform() != snapshot.transform) {
+		_set_transform(snapshot.transform);
+		_update_transform_dependent();
+	}
+	_set_inv_transform(snapshot.inv_transform);
+	new_transform = snapshot.new_transform;
+
+	linear_velocity = snapshot.linear_velocity;
+	angular_velocity = snapshot.angular_velocity;
+	prev_linear_velocity = snapshot.prev_linear_velocity;
+	prev_angular_velocity = snapshot.prev_angular_velocity;
+	applied_force = snapshot.applied_force;
+	applied_torque = snapshot.applied_torque;
+	constant_force = snapshot.constant_force;
+	constant_torque = snapshot.constant_torque;
+	still_time = snapshot.still_time;
+
+	// The reported contacts don't fit if max_contacts_reported was lowered since, keep the first ones.
+	contact_count = MIN(snapshot.contact_count, contacts.size());
+	const uint8_t *ptr = p_data + sizeof(snapshot);
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts.write[i];
+		int32_t shape = 0;
+		uint64_t instance_id = 0;
+		GodotSpace3D::snapshot_read_value(ptr, c.local_pos);
+		GodotSpace3D::snapshot_read_value(ptr, c.local_normal);
+		GodotSpace3D::snapshot_read_value(ptr, c.local_velocity_at_pos);
+		GodotSpace3D::snapshot_read_value(ptr, c.depth);
+		GodotSpace3D::snapshot_read_value(ptr, shape);
+		c.local_shape = shape;
+		GodotSpace3D::snapshot_read_value(ptr, c.collider_pos);
+		GodotSpace3D::snapshot_read_value(ptr, shape);
+		c.collider_shape = shape;
+		GodotSpace3D::snapshot_read_value(ptr, instance_id);
+		c.collider_instance_id = ObjectID(instance_id);
+		GodotSpace3D::snapshot_read_value(ptr, c.collider);
+		GodotSpace3D::snapshot_read_value(ptr, c.collider_velocity_at_pos);
+		GodotSpace3D::snapshot_read_value(ptr, c.impulse);
+	}
+
+	set_active(snapshot.active);
+
+	// Sleeping bodies aren't integrated, so the next step wouldn't report the restored state to the node.
+	if (body_state_callback.is_valid() && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+
+	return true;
+}
+
 void GodotBody3D::set_state_sync_callback(const Callable &p_callable) {
 	body_state_callback = p_callable;
 }
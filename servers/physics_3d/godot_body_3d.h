@@ -34,6 +34,7 @@
 #include "godot_area_3d.h"
 #include "godot_collision_object_3d.h"
 
+#include "core/templates/local_vector.h"
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
@@ -343,6 +344,11 @@ public:
 
 	bool sleep_test(real_t p_step);
 
+	// The state that changes while stepping, see GodotSpace3D::get_snapshot().
+	void save_snapshot(LocalVector<uint8_t> &r_buffer) const;
+	static bool is_snapshot_valid(const uint8_t *p_data, uint32_t p_size);
+	bool restore_snapshot(const uint8_t *p_data, uint32_t p_size);
+
 	GodotBody3D();
 	~GodotBody3D();
 };
@@ -595,6 +595,104 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+// Followed in the snapshot by contact_count contacts.
+struct GodotBodyPair3DSnapshot {
+	Vector3 sep_axis;
+	int32_t contact_count = 0;
+	uint32_t collided = 0; // Not bool, to leave no padding.
+};
+
+// Size of a contact in the snapshot, see save_snapshot().
+static constexpr uint32_t PAIR_CONTACT_SNAPSHOT_SIZE = 8 * sizeof(Vector3) + 7 * sizeof(real_t) + 2 * sizeof(int32_t) + 2 * sizeof(uint8_t);
+
+void GodotBodyPair3D::save_snapshot(LocalVector<uint8_t> &r_buffer) const {
+	GodotBodyPair3DSnapshot snapshot;
+	snapshot.sep_axis = sep_axis;
+	snapshot.contact_count = contact_count;
+	snapshot.collided = collided;
+
+	GodotSpace3D::snapshot_write(r_buffer, &snapshot, sizeof(snapshot));
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		GodotSpace3D::snapshot_write_value(r_buffer, c.position);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.normal);
+		GodotSpace3D::snapshot_write_value(r_buffer, (int32_t)c.index_A);
+		GodotSpace3D::snapshot_write_value(r_buffer, (int32_t)c.index_B);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.local_A);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.local_B);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.acc_impulse);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.acc_normal_impulse);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.acc_tangent_impulse);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.acc_bias_impulse);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.acc_bias_impulse_center_of_mass);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.mass_normal);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.bias);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.bounce);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.depth);
+		GodotSpace3D::snapshot_write_value(r_buffer, (uint8_t)c.active);
+		GodotSpace3D::snapshot_write_value(r_buffer, (uint8_t)c.used);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.rA);
+		GodotSpace3D::snapshot_write_value(r_buffer, c.rB);
+	}
+}
+
+bool GodotBodyPair3D::is_snapshot_valid(const uint8_t *p_data, uint32_t p_size) {
+	GodotBodyPair3DSnapshot snapshot;
+	ERR_FAIL_COND_V(p_size < sizeof(snapshot), false);
+	memcpy(&snapshot, p_data, sizeof(snapshot));
+	ERR_FAIL_COND_V(snapshot.contact_count < 0 || snapshot.contact_count > MAX_CONTACTS, false);
+	ERR_FAIL_COND_V(p_size != sizeof(snapshot) + snapshot.contact_count * PAIR_CONTACT_SNAPSHOT_SIZE, false);
+	return true;
+}
+
+bool GodotBodyPair3D::restore_snapshot(const uint8_t *p_data, uint32_t p_size) {
+	ERR_FAIL_COND_V(!is_snapshot_valid(p_data, p_size), false);
+	GodotBodyPair3DSnapshot snapshot;
+	memcpy(&snapshot, p_data, sizeof(snapshot));
+
+	sep_axis = snapshot.sep_axis;
+	contact_count = snapshot.contact_count;
+	collided = snapshot.collided;
+
+	const uint8_t *ptr = p_data + sizeof(snapshot);
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts[i];
+		int32_t index = 0;
+		uint8_t flag = 0;
+		GodotSpace3D::snapshot_read_value(ptr, c.position);
+		GodotSpace3D::snapshot_read_value(ptr, c.normal);
+		GodotSpace3D::snapshot_read_value(ptr, index);
+		c.index_A = index;
+		GodotSpace3D::snapshot_read_value(ptr, index);
+		c.index_B = index;
+		GodotSpace3D::snapshot_read_value(ptr, c.local_A);
+		GodotSpace3D::snapshot_read_value(ptr, c.local_B);
+		GodotSpace3D::snapshot_read_value(ptr, c.acc_impulse);
+		GodotSpace3D::snapshot_read_value(ptr, c.acc_normal_impulse);
+		GodotSpace3D::snapshot_read_value(ptr, c.acc_tangent_impulse);
+		GodotSpace3D::snapshot_read_value(ptr, c.acc_bias_impulse);
+		GodotSpace3D::snapshot_read_value(ptr, c.acc_bias_impulse_center_of_mass);
+		GodotSpace3D::snapshot_read_value(ptr, c.mass_normal);
+		GodotSpace3D::snapshot_read_value(ptr, c.bias);
+		GodotSpace3D::snapshot_read_value(ptr, c.bounce);
+		GodotSpace3D::snapshot_read_value(ptr, c.depth);
+		GodotSpace3D::snapshot_read_value(ptr, flag);
+		c.active = flag;
+		GodotSpace3D::snapshot_read_value(ptr, flag);
+		c.used = flag;
+		GodotSpace3D::snapshot_read_value(ptr, c.rA);
+		GodotSpace3D::snapshot_read_value(ptr, c.rB);
+	}
+
+	return true;
+}
+
+void GodotBodyPair3D::clear_contacts() {
+	sep_axis = Vector3();
+	contact_count = 0;
+	collided = false;
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
 		GodotBodyContact3D(_arr, 2) {
 	A = p_A;
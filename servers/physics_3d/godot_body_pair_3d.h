@@ -109,6 +109,17 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	// The contacts kept between steps for warm starting, see GodotSpace3D::get_snapshot().
+	void save_snapshot(LocalVector<uint8_t> &r_buffer) const;
+	static bool is_snapshot_valid(const uint8_t *p_data, uint32_t p_size);
+	bool restore_snapshot(const uint8_t *p_data, uint32_t p_size);
+	void clear_contacts();
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
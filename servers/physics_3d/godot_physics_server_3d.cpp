@@ -38,7 +38,9 @@
 #include "joints/godot_pin_joint_3d.h"
 #include "joints/godot_slider_joint_3d.h"
 
+#include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #define FLUSH_QUERY_CHECK(m_object) \
@@ -214,6 +216,20 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> GodotPhysicsServer3D::space_get_snapshot(RID p_space) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG(space->is_locked(), Vector<uint8_t>(), "Can't save a snapshot of a space while it is being stepped.");
+	return space->get_snapshot();
+}
+
+Error GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(space->is_locked() || flushing_queries, ERR_BUSY, "Can't restore a snapshot of a space while it is being stepped or flushing queries.");
+	return space->restore_snapshot(p_snapshot);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -920,6 +936,39 @@ bool GodotPhysicsServer3D::body_test_motion(RID p_body, const MotionParameters &
 	return body->get_space()->test_body_motion(body, p_parameters, r_result);
 }
 
+void GodotPhysicsServer3D::body_test_motions(const RID *p_bodies, const MotionParameters *p_parameters, int p_count, MotionResult *r_results, bool *r_collided) {
+	ERR_FAIL_COND(p_count < 0);
+
+	_update_shapes();
+
+	// Bodies are grouped by space, each space then solves its share of the batch.
+	LocalVector<GodotBody3D *> bodies;
+	LocalVector<GodotSpace3D *> spaces;
+	LocalVector<LocalVector<uint32_t>> space_indices;
+	bodies.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = false;
+		bodies[i] = body_owner.get_or_null(p_bodies[i]);
+		ERR_CONTINUE(!bodies[i]);
+		GodotSpace3D *space = bodies[i]->get_space();
+		ERR_CONTINUE(!space);
+		ERR_CONTINUE(space->is_locked());
+
+		int64_t space_index = spaces.find(space);
+		if (space_index == -1) {
+			space_index = spaces.size();
+			spaces.push_back(space);
+			space_indices.resize(spaces.size());
+		}
+		space_indices[space_index].push_back(i);
+	}
+
+	for (uint32_t i = 0; i < spaces.size(); i++) {
+		spaces[i]->test_body_motions(bodies.ptr(), p_parameters, r_results, r_collided, space_indices[i].ptr(), space_indices[i].size());
+	}
+}
+
 PhysicsDirectBodyState3D *GodotPhysicsServer3D::body_get_direct_state(RID p_body) {
 	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync), nullptr, "Body state is inaccessible right now, wait for iteration or physics process notification.");
 
@@ -1626,6 +1675,11 @@ void GodotPhysicsServer3D::set_active(bool p_active) {
 
 void GodotPhysicsServer3D::init() {
 	stepper = memnew(GodotStep3D);
+	step_spaces_in_parallel = GLOBAL_GET("physics/3d/step_spaces_in_parallel");
+}
+
+void GodotPhysicsServer3D::_step_space(uint32_t p_index, const real_t *p_step) {
+	space_steppers[p_index]->step(spaces_to_step[p_index], *p_step);
 }
 
 void GodotPhysicsServer3D::step(real_t p_step) {
@@ -1640,6 +1694,27 @@ void GodotPhysicsServer3D::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	if (step_spaces_in_parallel && active_spaces.size() > 1) {
+		// Spaces share no state while stepping. Queries are still flushed afterwards, one space at a time.
+		spaces_to_step.clear();
+		for (const GodotSpace3D *E : active_spaces) {
+			spaces_to_step.push_back(const_cast<GodotSpace3D *>(E));
+		}
+		while (space_steppers.size() < spaces_to_step.size()) {
+			space_steppers.push_back(memnew(GodotStep3D));
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsServer3D::_step_space, &p_step, spaces_to_step.size(), -1, true, SNAME("Physics3DStepSpaces"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		for (const GodotSpace3D *space : spaces_to_step) {
+			island_count += space->get_island_count();
+			active_objects += space->get_active_objects();
+			collision_pairs += space->get_collision_pairs();
+		}
+		return;
+	}
+
 	for (const GodotSpace3D *E : active_spaces) {
 		stepper->step(const_cast<GodotSpace3D *>(E), p_step);
 		island_count += E->get_island_count();
@@ -1712,6 +1787,10 @@ void GodotPhysicsServer3D::end_sync() {
 
 void GodotPhysicsServer3D::finish() {
 	memdelete(stepper);
+	for (GodotStep3D *space_stepper : space_steppers) {
+		memdelete(space_stepper);
+	}
+	space_steppers.clear();
 }
 
 int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
@@ -56,6 +56,12 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	GodotStep3D *stepper = nullptr;
 	HashSet<const GodotSpace3D *> active_spaces;
 
+	// When stepping spaces in parallel, each one needs a stepper of its own.
+	bool step_spaces_in_parallel = false;
+	LocalVector<GodotStep3D *> space_steppers;
+	LocalVector<GodotSpace3D *> spaces_to_step;
+	void _step_space(uint32_t p_index, const real_t *p_step);
+
 	mutable RID_PtrOwner<GodotShape3D, true> shape_owner;
 	mutable RID_PtrOwner<GodotSpace3D, true> space_owner;
 	mutable RID_PtrOwner<GodotArea3D, true> area_owner;
@@ -117,6 +123,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_get_snapshot(RID p_space) override;
+	virtual Error space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
@@ -251,6 +260,7 @@ public:
 	virtual void body_set_ray_pickable(RID p_body, bool p_enable) override;
 
 	virtual bool body_test_motion(RID p_body, const MotionParameters &p_parameters, MotionResult *r_result = nullptr) override;
+	virtual void body_test_motions(const RID *p_bodies, const MotionParameters *p_parameters, int p_count, MotionResult *r_results, bool *r_collided) override;
 
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectBodyState3D *body_get_direct_state(RID p_body) override;
@@ -34,6 +34,7 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,16 +106,14 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits) {
 	Vector3 begin, end;
 	Vector3 normal;
 	begin = p_parameters.from;
 	end = p_parameters.to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_segment(begin, end, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindices, r_cull_hits);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -126,21 +125,21 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(r_cull_results[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_cull_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,7 +204,7 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
-int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+int GodotPhysicsDirectSpaceState3D::_intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits) {
 	if (p_result_max <= 0) {
 		return 0;
 	}
@@ -215,7 +214,7 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 
 	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindices, r_cull_hits);
 
 	int cc = 0;
 
@@ -226,18 +225,18 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_results[i];
+		int shape_idx = r_cull_subindices[i];
 
 		if (!GodotCollisionSolver3D::solve_static(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
 			continue;
@@ -260,6 +259,103 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+	return _intersect_ray(p_parameters, r_result, space->intersection_query_results, space->intersection_query_subindex_results, nullptr);
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	return _intersect_shape(p_parameters, r_results, p_result_max, space->intersection_query_results, space->intersection_query_subindex_results, nullptr);
+}
+
+// Groups of a batch cull into buffers of the thread running them, so the groups can run concurrently.
+struct GodotSpace3D::CullBuffers {
+	GodotCollisionObject3D *results[GodotSpace3D::INTERSECTION_QUERY_MAX];
+	int subindices[GodotSpace3D::INTERSECTION_QUERY_MAX];
+	GodotBroadPhase3D::CullHits hits;
+};
+
+GodotSpace3D::CullBuffers *GodotSpace3D::_get_thread_cull_buffers() {
+	// Groups only use the buffers while they run, so each worker thread keeps a single set instead of allocating them per group.
+	struct ThreadCullBuffers {
+		CullBuffers *buffers = nullptr;
+
+		~ThreadCullBuffers() {
+			if (buffers) {
+				memdelete(buffers);
+			}
+		}
+	};
+	static thread_local ThreadCullBuffers thread_buffers;
+
+	if (unlikely(thread_buffers.buffers == nullptr)) {
+		thread_buffers.buffers = memnew(CullBuffers);
+	}
+	return thread_buffers.buffers;
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_rays_group(uint32_t p_group, const RayBatch *p_batch) {
+	GodotSpace3D::CullBuffers *buffers = GodotSpace3D::_get_thread_cull_buffers();
+	const int from = p_group * BATCH_GROUP_SIZE;
+	const int to = MIN(from + BATCH_GROUP_SIZE, p_batch->count);
+	for (int i = from; i < to; i++) {
+		p_batch->hits[i] = _intersect_ray(p_batch->parameters[i], p_batch->results[i], buffers->results, buffers->subindices, &buffers->hits);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_shapes_group(uint32_t p_group, const ShapeBatch *p_batch) {
+	GodotSpace3D::CullBuffers *buffers = GodotSpace3D::_get_thread_cull_buffers();
+	const int from = p_group * BATCH_GROUP_SIZE;
+	const int to = MIN(from + BATCH_GROUP_SIZE, p_batch->count);
+	for (int i = from; i < to; i++) {
+		p_batch->result_counts[i] = _intersect_shape(p_batch->parameters[i], &p_batch->results[i * p_batch->result_max], p_batch->result_max, buffers->results, buffers->subindices, &buffers->hits);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_hits) {
+	if (p_count <= BATCH_GROUP_SIZE) {
+		PhysicsDirectSpaceState3D::intersect_rays(p_parameters, p_count, r_results, r_hits);
+		return;
+	}
+
+	for (int i = 0; i < p_count; i++) {
+		r_hits[i] = false;
+	}
+	ERR_FAIL_COND(space->locked);
+
+	RayBatch batch;
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.count = p_count;
+
+	const uint32_t group_count = (p_count + BATCH_GROUP_SIZE - 1) / BATCH_GROUP_SIZE;
+	space->broadphase->begin_concurrent_culls();
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_rays_group, &batch, group_count, -1, true, SNAME("Physics3DIntersectRays"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	space->broadphase->end_concurrent_culls();
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters *p_parameters, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	if (p_count <= BATCH_GROUP_SIZE || p_result_max <= 0) {
+		PhysicsDirectSpaceState3D::intersect_shapes(p_parameters, p_count, r_results, p_result_max, r_result_counts);
+		return;
+	}
+
+	ShapeBatch batch;
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+	batch.count = p_count;
+
+	const uint32_t group_count = (p_count + BATCH_GROUP_SIZE - 1) / BATCH_GROUP_SIZE;
+	space->broadphase->begin_concurrent_culls();
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_shapes_group, &batch, group_count, -1, true, SNAME("Physics3DIntersectShapes"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	space->broadphase->end_concurrent_culls();
+}
+
 bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
 	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_NULL_V(shape, false);
@@ -615,28 +711,28 @@ GodotPhysicsDirectSpaceState3D::GodotPhysicsDirectSpaceState3D() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int GodotSpace3D::_cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb) {
-	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
+int GodotSpace3D::_cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits) {
+	int amount = broadphase->cull_aabb(p_aabb, r_cull_results, INTERSECTION_QUERY_MAX, r_cull_subindices, r_cull_hits);
 
 	for (int i = 0; i < amount; i++) {
 		bool keep = true;
 
-		if (intersection_query_results[i] == p_body) {
+		if (r_cull_results[i] == p_body) {
 			keep = false;
-		} else if (intersection_query_results[i]->get_type() == GodotCollisionObject3D::TYPE_AREA) {
+		} else if (r_cull_results[i]->get_type() == GodotCollisionObject3D::TYPE_AREA) {
 			keep = false;
-		} else if (intersection_query_results[i]->get_type() == GodotCollisionObject3D::TYPE_SOFT_BODY) {
+		} else if (r_cull_results[i]->get_type() == GodotCollisionObject3D::TYPE_SOFT_BODY) {
 			keep = false;
-		} else if (!p_body->collides_with(static_cast<GodotBody3D *>(intersection_query_results[i]))) {
+		} else if (!p_body->collides_with(static_cast<GodotBody3D *>(r_cull_results[i]))) {
 			keep = false;
-		} else if (static_cast<GodotBody3D *>(intersection_query_results[i])->has_exception(p_body->get_self()) || p_body->has_exception(intersection_query_results[i]->get_self())) {
+		} else if (static_cast<GodotBody3D *>(r_cull_results[i])->has_exception(p_body->get_self()) || p_body->has_exception(r_cull_results[i]->get_self())) {
 			keep = false;
 		}
 
 		if (!keep) {
 			if (i < amount - 1) {
-				SWAP(intersection_query_results[i], intersection_query_results[amount - 1]);
-				SWAP(intersection_query_subindex_results[i], intersection_query_subindex_results[amount - 1]);
+				SWAP(r_cull_results[i], r_cull_results[amount - 1]);
+				SWAP(r_cull_subindices[i], r_cull_subindices[amount - 1]);
 			}
 
 			amount--;
@@ -647,7 +743,7 @@ int GodotSpace3D::_cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb) {
 	return amount;
 }
 
-bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result) {
+bool GodotSpace3D::_test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits) {
 	//give me back regular physics engine logic
 	//this is madness
 	//and most people using this function will think
@@ -720,7 +816,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, r_cull_results, r_cull_subindices, r_cull_hits);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_disabled(j)) {
@@ -731,7 +827,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 				GodotShape3D *body_shape = p_body->get_shape(j);
 
 				for (int i = 0; i < amount; i++) {
-					const GodotCollisionObject3D *col_obj = intersection_query_results[i];
+					const GodotCollisionObject3D *col_obj = r_cull_results[i];
 					if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 						continue;
 					}
@@ -739,7 +835,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 						continue;
 					}
 
-					int shape_idx = intersection_query_subindex_results[i];
+					int shape_idx = r_cull_subindices[i];
 
 					if (GodotCollisionSolver3D::solve_static(body_shape, body_shape_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), cbkres, cbkptr, nullptr, margin)) {
 						collided = cbk.amount > 0;
@@ -804,7 +900,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 		motion_aabb.position += p_parameters.motion;
 		motion_aabb = motion_aabb.merge(body_aabb);
 
-		int amount = _cull_aabb_for_body(p_body, motion_aabb);
+		int amount = _cull_aabb_for_body(p_body, motion_aabb, r_cull_results, r_cull_subindices, r_cull_hits);
 
 		for (int j = 0; j < p_body->get_shape_count(); j++) {
 			if (p_body->is_shape_disabled(j)) {
@@ -835,7 +931,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 			real_t best_unsafe = 1;
 
 			for (int i = 0; i < amount; i++) {
-				const GodotCollisionObject3D *col_obj = intersection_query_results[i];
+				const GodotCollisionObject3D *col_obj = r_cull_results[i];
 				if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 					continue;
 				}
@@ -843,7 +939,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 					continue;
 				}
 
-				int shape_idx = intersection_query_subindex_results[i];
+				int shape_idx = r_cull_subindices[i];
 
 				//test initial overlap, does it collide if going all the way?
 				Vector3 point_A, point_B;
@@ -944,7 +1040,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 		rcd.min_allowed_depth = MIN(motion_length, min_contact_depth);
 
 		body_aabb.position += p_parameters.motion * unsafe;
-		int amount = _cull_aabb_for_body(p_body, body_aabb);
+		int amount = _cull_aabb_for_body(p_body, body_aabb, r_cull_results, r_cull_subindices, r_cull_hits);
 
 		int from_shape = best_shape != -1 ? best_shape : 0;
 		int to_shape = best_shape != -1 ? best_shape + 1 : p_body->get_shape_count();
@@ -958,7 +1054,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 			GodotShape3D *body_shape = p_body->get_shape(j);
 
 			for (int i = 0; i < amount; i++) {
-				const GodotCollisionObject3D *col_obj = intersection_query_results[i];
+				const GodotCollisionObject3D *col_obj = r_cull_results[i];
 				if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 					continue;
 				}
@@ -966,7 +1062,7 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 					continue;
 				}
 
-				int shape_idx = intersection_query_subindex_results[i];
+				int shape_idx = r_cull_subindices[i];
 
 				rcd.object = col_obj;
 				rcd.shape = shape_idx;
@@ -1027,6 +1123,46 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 	return collided;
 }
 
+bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result) {
+	return _test_body_motion(p_body, p_parameters, r_result, intersection_query_results, intersection_query_subindex_results, nullptr);
+}
+
+void GodotSpace3D::_test_body_motions_group(uint32_t p_group, const MotionBatch *p_batch) {
+	CullBuffers *buffers = _get_thread_cull_buffers();
+	const uint32_t from = p_group * MOTION_BATCH_GROUP_SIZE;
+	const uint32_t to = MIN(from + MOTION_BATCH_GROUP_SIZE, p_batch->count);
+	for (uint32_t i = from; i < to; i++) {
+		const uint32_t index = p_batch->indices[i];
+		PhysicsServer3D::MotionResult *result = p_batch->results ? &p_batch->results[index] : nullptr;
+		p_batch->collided[index] = _test_body_motion(p_batch->bodies[index], p_batch->parameters[index], result, buffers->results, buffers->subindices, &buffers->hits);
+	}
+}
+
+void GodotSpace3D::test_body_motions(GodotBody3D *const *p_bodies, const PhysicsServer3D::MotionParameters *p_parameters, PhysicsServer3D::MotionResult *r_results, bool *r_collided, const uint32_t *p_indices, uint32_t p_count) {
+	if (p_count <= MOTION_BATCH_GROUP_SIZE) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			const uint32_t index = p_indices[i];
+			r_collided[index] = test_body_motion(p_bodies[index], p_parameters[index], r_results ? &r_results[index] : nullptr);
+		}
+		return;
+	}
+
+	// Nothing in the space is modified while solving, so every motion sees the space as it was before the batch.
+	MotionBatch batch;
+	batch.bodies = p_bodies;
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.collided = r_collided;
+	batch.indices = p_indices;
+	batch.count = p_count;
+
+	const uint32_t group_count = (p_count + MOTION_BATCH_GROUP_SIZE - 1) / MOTION_BATCH_GROUP_SIZE;
+	broadphase->begin_concurrent_culls();
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotSpace3D::_test_body_motions_group, &batch, group_count, -1, true, SNAME("Physics3DTestBodyMotions"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	broadphase->end_concurrent_culls();
+}
+
 // Assumes a valid collision pair, this should have been checked beforehand in the BVH or octree.
 void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self) {
 	GodotCollisionObject3D::Type type_A = A->get_type();
@@ -1253,6 +1389,196 @@ GodotPhysicsDirectSpaceState3D *GodotSpace3D::get_direct_state() {
 	return direct_access;
 }
 
+#define SNAPSHOT_MAGIC 0x33535347 // "GSS3"
+
+struct GodotSpace3DSnapshotHeader {
+	uint32_t magic = SNAPSHOT_MAGIC;
+	uint32_t real_size = sizeof(real_t);
+	uint32_t body_count = 0;
+	uint32_t pair_count = 0;
+};
+
+struct GodotSpace3DSnapshotPairKey {
+	RID body_A;
+	RID body_B;
+	int32_t shape_A = 0;
+	int32_t shape_B = 0;
+};
+
+// Each record is its size followed by what it belongs to and its data,
+// so the records of bodies and pairs that are gone when restoring can be skipped.
+static uint32_t _snapshot_begin_record(LocalVector<uint8_t> &r_buffer) {
+	uint32_t ofs = r_buffer.size();
+	uint32_t size = 0;
+	GodotSpace3D::snapshot_write(r_buffer, &size, sizeof(size));
+	return ofs;
+}
+
+static void _snapshot_end_record(LocalVector<uint8_t> &r_buffer, uint32_t p_ofs) {
+	uint32_t size = r_buffer.size() - p_ofs - sizeof(uint32_t);
+	memcpy(r_buffer.ptr() + p_ofs, &size, sizeof(size));
+}
+
+static bool _snapshot_read_record(const uint8_t *&r_ptr, const uint8_t *p_end, const uint8_t *&r_record, uint32_t &r_size) {
+	if (p_end - r_ptr < (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	memcpy(&r_size, r_ptr, sizeof(uint32_t));
+	r_ptr += sizeof(uint32_t);
+	if ((uint64_t)(p_end - r_ptr) < r_size) {
+		return false;
+	}
+	r_record = r_ptr;
+	r_ptr += r_size;
+	return true;
+}
+
+// Body pairs are in the constraint maps of both bodies, only the one of body A is used.
+_FORCE_INLINE_ static GodotBodyPair3D *_get_body_pair(const KeyValue<GodotConstraint3D *, int> &p_constraint) {
+	return p_constraint.value == 0 ? dynamic_cast<GodotBodyPair3D *>(p_constraint.key) : nullptr;
+}
+
+Vector<uint8_t> GodotSpace3D::get_snapshot() {
+	GodotSpace3DSnapshotHeader header;
+	snapshot_buffer.clear();
+	snapshot_write(snapshot_buffer, &header, sizeof(header));
+
+	for (const GodotCollisionObject3D *object : objects) {
+		if (object->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody3D *body = static_cast<const GodotBody3D *>(object);
+
+		uint32_t record = _snapshot_begin_record(snapshot_buffer);
+		const RID rid = body->get_self();
+		snapshot_write(snapshot_buffer, &rid, sizeof(rid));
+		body->save_snapshot(snapshot_buffer);
+		_snapshot_end_record(snapshot_buffer, record);
+		header.body_count++;
+	}
+
+	for (const GodotCollisionObject3D *object : objects) {
+		if (object->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+
+		for (const KeyValue<GodotConstraint3D *, int> &E : static_cast<const GodotBody3D *>(object)->get_constraint_map()) {
+			const GodotBodyPair3D *pair = _get_body_pair(E);
+			if (!pair) {
+				continue;
+			}
+
+			uint32_t record = _snapshot_begin_record(snapshot_buffer);
+			GodotSpace3DSnapshotPairKey key;
+			key.body_A = pair->get_body_A()->get_self();
+			key.body_B = pair->get_body_B()->get_self();
+			key.shape_A = pair->get_shape_A();
+			key.shape_B = pair->get_shape_B();
+			snapshot_write(snapshot_buffer, &key, sizeof(key));
+			pair->save_snapshot(snapshot_buffer);
+			_snapshot_end_record(snapshot_buffer, record);
+			header.pair_count++;
+		}
+	}
+
+	memcpy(snapshot_buffer.ptr(), &header, sizeof(header));
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(snapshot_buffer.size());
+	memcpy(snapshot.ptrw(), snapshot_buffer.ptr(), snapshot_buffer.size());
+	return snapshot;
+}
+
+Error GodotSpace3D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	GodotSpace3DSnapshotHeader header;
+	ERR_FAIL_COND_V_MSG(p_snapshot.size() < (int64_t)sizeof(header), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+	memcpy(&header, p_snapshot.ptr(), sizeof(header));
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.real_size != sizeof(real_t), ERR_INVALID_DATA, "Invalid physics space snapshot, or it was saved by a different build of the engine.");
+
+	HashMap<RID, GodotBody3D *> bodies;
+	bodies.reserve(objects.size());
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			GodotBody3D *body = static_cast<GodotBody3D *>(object);
+			bodies.insert(body->get_self(), body);
+		}
+	}
+
+	// Parse and validate the whole snapshot first, so a bad one leaves the space untouched.
+	struct BodyRecord {
+		GodotBody3D *body = nullptr;
+		const uint8_t *data = nullptr;
+		uint32_t size = 0;
+	};
+	struct PairRecord {
+		GodotBodyPair3D *pair = nullptr;
+		const uint8_t *data = nullptr;
+		uint32_t size = 0;
+	};
+	LocalVector<BodyRecord> body_records;
+	LocalVector<PairRecord> pair_records;
+	body_records.reserve(header.body_count);
+	pair_records.reserve(header.pair_count);
+
+	const uint8_t *ptr = p_snapshot.ptr() + sizeof(header);
+	const uint8_t *end = p_snapshot.ptr() + p_snapshot.size();
+	const uint8_t *record = nullptr;
+	uint32_t record_size = 0;
+
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		ERR_FAIL_COND_V_MSG(!_snapshot_read_record(ptr, end, record, record_size) || record_size < sizeof(RID), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		ERR_FAIL_COND_V_MSG(!GodotBody3D::is_snapshot_valid(record + sizeof(RID), record_size - sizeof(RID)), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		RID rid;
+		memcpy(&rid, record, sizeof(rid));
+
+		GodotBody3D **body = bodies.getptr(rid);
+		if (body) {
+			body_records.push_back({ *body, record + sizeof(rid), record_size - (uint32_t)sizeof(rid) });
+		}
+	}
+
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		GodotSpace3DSnapshotPairKey key;
+		ERR_FAIL_COND_V_MSG(!_snapshot_read_record(ptr, end, record, record_size) || record_size < sizeof(key), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		ERR_FAIL_COND_V_MSG(!GodotBodyPair3D::is_snapshot_valid(record + sizeof(key), record_size - sizeof(key)), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		memcpy(&key, record, sizeof(key));
+
+		GodotBody3D **body_A = bodies.getptr(key.body_A);
+		if (!body_A) {
+			continue;
+		}
+
+		for (const KeyValue<GodotConstraint3D *, int> &E : (*body_A)->get_constraint_map()) {
+			GodotBodyPair3D *pair = _get_body_pair(E);
+			if (pair && pair->get_body_B()->get_self() == key.body_B && pair->get_shape_A() == key.shape_A && pair->get_shape_B() == key.shape_B) {
+				pair_records.push_back({ pair, record + sizeof(key), record_size - (uint32_t)sizeof(key) });
+				break;
+			}
+		}
+	}
+
+	ERR_FAIL_COND_V_MSG(ptr != end, ERR_INVALID_DATA, "Invalid physics space snapshot.");
+
+	// Pairs which didn't exist yet when the snapshot was saved start over without contacts, like new pairs.
+	for (KeyValue<RID, GodotBody3D *> &E : bodies) {
+		for (const KeyValue<GodotConstraint3D *, int> &F : E.value->get_constraint_map()) {
+			GodotBodyPair3D *pair = _get_body_pair(F);
+			if (pair) {
+				pair->clear_contacts();
+			}
+		}
+	}
+
+	for (const BodyRecord &body_record : body_records) {
+		body_record.body->restore_snapshot(body_record.data, body_record.size);
+	}
+	for (const PairRecord &pair_record : pair_records) {
+		pair_record.pair->restore_snapshot(pair_record.data, pair_record.size);
+	}
+
+	return OK;
+}
+
 GodotSpace3D::GodotSpace3D() {
 	body_linear_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_linear");
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_angular");
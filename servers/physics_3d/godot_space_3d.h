@@ -46,6 +46,31 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Batches are split in groups of this many queries, smaller batches run on the calling thread.
+	enum {
+		BATCH_GROUP_SIZE = 64
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		int count = 0;
+	};
+
+	struct ShapeBatch {
+		const ShapeParameters *parameters = nullptr;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+		int count = 0;
+	};
+
+	bool _intersect_ray(const RayParameters &p_parameters, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits);
+	int _intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits);
+	void _intersect_rays_group(uint32_t p_group, const RayBatch *p_batch);
+	void _intersect_shapes_group(uint32_t p_group, const ShapeBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
@@ -57,6 +82,9 @@ public:
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual void intersect_rays(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual void intersect_shapes(const ShapeParameters *p_parameters, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
+
 	GodotPhysicsDirectSpaceState3D();
 };
 
@@ -124,9 +152,30 @@ private:
 	Vector<Vector3> contact_debug;
 	int contact_debug_count = 0;
 
+	LocalVector<uint8_t> snapshot_buffer;
+
+	// Motion batches are split in groups of this many bodies, smaller batches run on the calling thread.
+	enum {
+		MOTION_BATCH_GROUP_SIZE = 8
+	};
+
+	struct CullBuffers;
+	static CullBuffers *_get_thread_cull_buffers();
+
+	struct MotionBatch {
+		GodotBody3D *const *bodies = nullptr;
+		const PhysicsServer3D::MotionParameters *parameters = nullptr;
+		PhysicsServer3D::MotionResult *results = nullptr;
+		bool *collided = nullptr;
+		const uint32_t *indices = nullptr;
+		uint32_t count = 0;
+	};
+
 	friend class GodotPhysicsDirectSpaceState3D;
 
-	int _cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb);
+	int _cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits);
+	bool _test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, GodotBroadPhase3D::CullHits *r_cull_hits);
+	void _test_body_motions_group(uint32_t p_group, const MotionBatch *p_batch);
 
 public:
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
@@ -193,6 +242,29 @@ public:
 
 	GodotPhysicsDirectSpaceState3D *get_direct_state();
 
+	// Saves the bodies' motion and sleep state and the body pairs' contacts, for rolling back the simulation.
+	// The snapshot is raw memory, so it can only be restored by the same build of the engine.
+	Vector<uint8_t> get_snapshot();
+	Error restore_snapshot(const Vector<uint8_t> &p_snapshot);
+
+	_FORCE_INLINE_ static void snapshot_write(LocalVector<uint8_t> &r_buffer, const void *p_data, uint32_t p_size) {
+		if (p_size) {
+			uint32_t ofs = r_buffer.size();
+			r_buffer.resize(ofs + p_size);
+			memcpy(r_buffer.ptr() + ofs, p_data, p_size);
+		}
+	}
+	// For structs with padding, which are written field by field so identical states give identical bytes.
+	template <typename T>
+	_FORCE_INLINE_ static void snapshot_write_value(LocalVector<uint8_t> &r_buffer, const T &p_value) {
+		snapshot_write(r_buffer, &p_value, sizeof(T));
+	}
+	template <typename T>
+	_FORCE_INLINE_ static void snapshot_read_value(const uint8_t *&r_ptr, T &r_value) {
+		memcpy(&r_value, r_ptr, sizeof(T));
+		r_ptr += sizeof(T);
+	}
+
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
 	_FORCE_INLINE_ bool is_debugging_contacts() const { return !contact_debug.is_empty(); }
 	_FORCE_INLINE_ void add_debug_contact(const Vector3 &p_contact) {
@@ -210,6 +282,8 @@ public:
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
 
 	bool test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result);
+	// Solves the motions at p_indices in the given arrays, all of those bodies must be in this space.
+	void test_body_motions(GodotBody3D *const *p_bodies, const PhysicsServer3D::MotionParameters *p_parameters, PhysicsServer3D::MotionResult *r_results, bool *r_collided, const uint32_t *p_indices, uint32_t p_count);
 
 	GodotSpace3D();
 	~GodotSpace3D();
@@ -34,9 +34,13 @@
 #include "godot_space_3d.h"
 
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 
 class GodotStep3D {
-	uint64_t _step = 1;
+	// Bodies and constraints are marked with the step that visited them last. Steps are numbered across all
+	// steppers, as spaces may be stepped by a different one each time when stepping them in parallel.
+	static SafeNumeric<uint64_t> last_step;
+	uint64_t _step = 0;
 
 	int iterations = 0;
 	real_t delta = 0.0;
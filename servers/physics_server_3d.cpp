@@ -34,6 +34,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/frame_arena.h"
 #include "core/variant/typed_array.h"
 
 void PhysicsServer3DRenderingServerHandler::set_vertex(int p_vertex_id, const Vector3 &p_vertex) {
@@ -379,11 +380,12 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Ref<PhysicsRayQueryPa
 
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), TypedArray<Dictionary>());
+	ERR_FAIL_COND_V(p_max_results < 0, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> ret;
+	FrameLocalVector<ShapeResult> ret;
 	ret.resize(p_max_results);
 
-	int rc = intersect_point(p_point_query->get_parameters(), ret.ptrw(), ret.size());
+	int rc = intersect_point(p_point_query->get_parameters(), ret.ptr(), ret.size());
 
 	if (rc == 0) {
 		return TypedArray<Dictionary>();
@@ -404,10 +406,11 @@ TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<Phy
 
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Dictionary>());
+	ERR_FAIL_COND_V(p_max_results < 0, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> sr;
+	FrameLocalVector<ShapeResult> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptrw(), sr.size());
+	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptr(), sr.size());
 	TypedArray<Dictionary> ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -439,11 +442,12 @@ Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQue
 
 TypedArray<Vector3> PhysicsDirectSpaceState3D::_collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Vector3>());
+	ERR_FAIL_COND_V(p_max_results < 0, TypedArray<Vector3>());
 
-	Vector<Vector3> ret;
+	FrameLocalVector<Vector3> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptrw(), p_max_results, rc);
+	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptr(), p_max_results, rc);
 	if (!res) {
 		return TypedArray<Vector3>();
 	}
@@ -476,6 +480,123 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(const TypedArray<PhysicsRayQueryParameters3D> &p_ray_queries) {
+	const int count = p_ray_queries.size();
+	FrameLocalVector<RayParameters> parameters;
+	parameters.resize(count);
+	for (int i = 0; i < count; i++) {
+		Ref<PhysicsRayQueryParameters3D> ray_query = p_ray_queries[i];
+		ERR_FAIL_COND_V(ray_query.is_null(), Dictionary());
+		parameters[i] = ray_query->get_parameters();
+	}
+
+	FrameLocalVector<RayResult> results;
+	results.resize(count);
+	FrameLocalVector<bool> hits;
+	hits.resize(count);
+	intersect_rays(parameters.ptr(), count, results.ptr(), hits.ptr());
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	TypedArray<RID> rids;
+	PackedInt32Array shapes;
+	PackedInt32Array face_indices;
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	rids.resize(count);
+	shapes.resize(count);
+	face_indices.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		const RayResult &result = results[i];
+		if (!hits[i]) {
+			collider_ids.write[i] = 0;
+			shapes.write[i] = -1;
+			face_indices.write[i] = -1;
+			continue;
+		}
+		positions.write[i] = result.position;
+		normals.write[i] = result.normal;
+		collider_ids.write[i] = (int64_t)result.collider_id;
+		rids[i] = result.rid;
+		shapes.write[i] = result.shape;
+		face_indices.write[i] = result.face_index;
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["rid"] = rids;
+	d["shape"] = shapes;
+	d["face_index"] = face_indices;
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_shapes(const TypedArray<PhysicsShapeQueryParameters3D> &p_shape_queries, int p_max_results) {
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	const int count = p_shape_queries.size();
+	FrameLocalVector<ShapeParameters> parameters;
+	parameters.resize(count);
+	for (int i = 0; i < count; i++) {
+		Ref<PhysicsShapeQueryParameters3D> shape_query = p_shape_queries[i];
+		ERR_FAIL_COND_V(shape_query.is_null(), Dictionary());
+		parameters[i] = shape_query->get_parameters();
+	}
+
+	FrameLocalVector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	PackedInt32Array counts;
+	counts.resize(count);
+	intersect_shapes(parameters.ptr(), count, results.ptr(), p_max_results, counts.ptrw());
+
+	int total = 0;
+	for (int i = 0; i < count; i++) {
+		total += counts[i];
+	}
+
+	PackedInt64Array collider_ids;
+	TypedArray<RID> rids;
+	PackedInt32Array shapes;
+	collider_ids.resize(total);
+	rids.resize(total);
+	shapes.resize(total);
+
+	// Results are packed one query after the other, each taking as many entries as its count.
+	int packed = 0;
+	for (int i = 0; i < count; i++) {
+		const ShapeResult *query_results = &results[i * p_max_results];
+		for (int j = 0; j < counts[i]; j++) {
+			collider_ids.write[packed] = (int64_t)query_results[j].collider_id;
+			rids[packed] = query_results[j].rid;
+			shapes.write[packed] = query_results[j].shape;
+			packed++;
+		}
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_ids;
+	d["rid"] = rids;
+	d["shape"] = shapes;
+	return d;
+}
+
+void PhysicsDirectSpaceState3D::intersect_rays(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_hits) {
+	for (int i = 0; i < p_count; i++) {
+		r_hits[i] = intersect_ray(p_parameters[i], r_results[i]);
+	}
+}
+
+void PhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters *p_parameters, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = intersect_shape(p_parameters[i], &r_results[i * p_result_max], p_result_max);
+	}
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -486,6 +607,8 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters"), &PhysicsDirectSpaceState3D::_intersect_rays);
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(32));
 }
 
 ///////////////////////////////
@@ -662,6 +785,50 @@ bool PhysicsServer3D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionP
 	return body_test_motion(p_body, p_parameters->get_parameters(), result_ptr);
 }
 
+TypedArray<bool> PhysicsServer3D::_body_test_motions(const TypedArray<RID> &p_bodies, const TypedArray<PhysicsTestMotionParameters3D> &p_parameters, const TypedArray<PhysicsTestMotionResult3D> &p_results) {
+	const int count = p_bodies.size();
+	ERR_FAIL_COND_V(p_parameters.size() != count, TypedArray<bool>());
+	ERR_FAIL_COND_V(!p_results.is_empty() && p_results.size() != count, TypedArray<bool>());
+
+	FrameLocalVector<RID> bodies;
+	FrameLocalVector<MotionParameters> parameters;
+	bodies.resize(count);
+	parameters.resize(count);
+	for (int i = 0; i < count; i++) {
+		Ref<PhysicsTestMotionParameters3D> motion_parameters = p_parameters[i];
+		ERR_FAIL_COND_V(motion_parameters.is_null(), TypedArray<bool>());
+		bodies[i] = p_bodies[i];
+		parameters[i] = motion_parameters->get_parameters();
+	}
+
+	FrameLocalVector<MotionResult> results;
+	if (!p_results.is_empty()) {
+		results.resize(count);
+	}
+	FrameLocalVector<bool> collided;
+	collided.resize(count);
+	body_test_motions(bodies.ptr(), parameters.ptr(), count, results.is_empty() ? nullptr : results.ptr(), collided.ptr());
+
+	TypedArray<bool> ret;
+	ret.resize(count);
+	for (int i = 0; i < count; i++) {
+		ret[i] = collided[i];
+		if (!results.is_empty()) {
+			Ref<PhysicsTestMotionResult3D> result = p_results[i];
+			if (result.is_valid()) {
+				*result->get_result_ptr() = results[i];
+			}
+		}
+	}
+	return ret;
+}
+
+void PhysicsServer3D::body_test_motions(const RID *p_bodies, const MotionParameters *p_parameters, int p_count, MotionResult *r_results, bool *r_collided) {
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = body_test_motion(p_bodies[i], p_parameters[i], r_results ? &r_results[i] : nullptr);
+	}
+}
+
 RID PhysicsServer3D::shape_create(ShapeType p_shape) {
 	switch (p_shape) {
 		case SHAPE_WORLD_BOUNDARY:
@@ -689,6 +856,14 @@ RID PhysicsServer3D::shape_create(ShapeType p_shape) {
 	}
 }
 
+Vector<uint8_t> PhysicsServer3D::space_get_snapshot(RID p_space) {
+	ERR_FAIL_V_MSG(Vector<uint8_t>(), "This physics server doesn't support space snapshots.");
+}
+
+Error PhysicsServer3D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "This physics server doesn't support space snapshots.");
+}
+
 void PhysicsServer3D::_bind_methods() {
 #ifndef _3D_DISABLED
 
@@ -716,6 +891,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_snapshot", "space"), &PhysicsServer3D::space_get_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer3D::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -836,6 +1013,7 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_set_ray_pickable", "body", "enable"), &PhysicsServer3D::body_set_ray_pickable);
 
 	ClassDB::bind_method(D_METHOD("body_test_motion", "body", "parameters", "result"), &PhysicsServer3D::_body_test_motion, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("body_test_motions", "bodies", "parameters", "results"), &PhysicsServer3D::_body_test_motions, DEFVAL(TypedArray<PhysicsTestMotionResult3D>()));
 
 	ClassDB::bind_method(D_METHOD("body_get_direct_state", "body"), &PhysicsServer3D::body_get_direct_state);
 
@@ -1139,6 +1317,7 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
+	GLOBAL_DEF("physics/3d/step_spaces_in_parallel", false);
 }
 
 PhysicsServer3D::~PhysicsServer3D() {
@@ -129,6 +129,8 @@ private:
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
 	TypedArray<Vector3> _collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
+	Dictionary _intersect_rays(const TypedArray<PhysicsRayQueryParameters3D> &p_ray_queries);
+	Dictionary _intersect_shapes(const TypedArray<PhysicsShapeQueryParameters3D> &p_shape_queries, int p_max_results = 32);
 
 protected:
 	static void _bind_methods();
@@ -207,6 +209,12 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	// Batched versions of the queries above, which servers can run in parallel. The default implementations
+	// run them one by one.
+	// Results of shape query `i` are written from `r_results[i * p_result_max]`.
+	virtual void intersect_rays(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_hits);
+	virtual void intersect_shapes(const ShapeParameters *p_parameters, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts);
+
 	PhysicsDirectSpaceState3D();
 };
 
@@ -236,6 +244,7 @@ class PhysicsServer3D : public Object {
 	static PhysicsServer3D *singleton;
 
 	virtual bool _body_test_motion(RID p_body, const Ref<PhysicsTestMotionParameters3D> &p_parameters, const Ref<PhysicsTestMotionResult3D> &p_result = Ref<PhysicsTestMotionResult3D>());
+	TypedArray<bool> _body_test_motions(const TypedArray<RID> &p_bodies, const TypedArray<PhysicsTestMotionParameters3D> &p_parameters, const TypedArray<PhysicsTestMotionResult3D> &p_results);
 
 protected:
 	static void _bind_methods();
@@ -308,6 +317,10 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// For rollback, servers that don't support snapshots fail.
+	virtual Vector<uint8_t> space_get_snapshot(RID p_space);
+	virtual Error space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot);
+
 	//missing space parameters
 
 	/* AREA API */
@@ -568,6 +581,8 @@ public:
 	};
 
 	virtual bool body_test_motion(RID p_body, const MotionParameters &p_parameters, MotionResult *r_result = nullptr) = 0;
+	// Tests p_count independent motions, r_results (if not null) and r_collided hold one entry per body.
+	virtual void body_test_motions(const RID *p_bodies, const MotionParameters *p_parameters, int p_count, MotionResult *r_results, bool *r_collided);
 
 	/* SOFT BODY */
 
@@ -128,6 +128,9 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	FUNC1R(Vector<uint8_t>, space_get_snapshot, RID);
+	FUNC2R(Error, space_restore_snapshot, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -264,6 +267,11 @@ public:
 		return physics_server_3d->body_test_motion(p_body, p_parameters, r_result);
 	}
 
+	void body_test_motions(const RID *p_bodies, const MotionParameters *p_parameters, int p_count, MotionResult *r_results, bool *r_collided) override {
+		ERR_FAIL_COND(!Thread::is_main_thread());
+		physics_server_3d->body_test_motions(p_bodies, p_parameters, p_count, r_results, r_collided);
+	}
+
 	// this function only works on physics process, errors and returns null otherwise
 	PhysicsDirectBodyState3D *body_get_direct_state(RID p_body) override {
 		ERR_FAIL_COND_V(!Thread::is_main_thread(), nullptr);
@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct Item {
+	int id = 0;
+};
+
+class PairTestFunction {
+public:
+	static bool user_pair_check(const Item *p_a, const Item *p_b) {
+		return true;
+	}
+};
+
+class CullTestFunction {
+public:
+	static bool user_cull_check(const Item *p_a, const Item *p_b) {
+		return true;
+	}
+};
+
+typedef BVH_Manager<Item, 1, true, 32, PairTestFunction, CullTestFunction> PairingBVH;
+
+static void *pair_callback(void *p_self, uint32_t p_a, Item *p_item_a, int p_subindex_a, uint32_t p_b, Item *p_item_b, int p_subindex_b) {
+	static_cast<Vector<String> *>(p_self)->push_back(vformat("pair %d %d", p_item_a->id, p_item_b->id));
+	return nullptr;
+}
+
+static void unpair_callback(void *p_self, uint32_t p_a, Item *p_item_a, int p_subindex_a, uint32_t p_b, Item *p_item_b, int p_subindex_b, void *p_pair_data) {
+	static_cast<Vector<String> *>(p_self)->push_back(vformat("unpair %d %d", p_item_a->id, p_item_b->id));
+}
+
+static AABB random_box(RandomPCG &p_rng) {
+	Vector3 position(p_rng.random(0.0f, 40.0f), p_rng.random(0.0f, 40.0f), p_rng.random(0.0f, 40.0f));
+	return AABB(position, Vector3(1, 1, 1));
+}
+
+TEST_CASE("[BVH] Parallel update sends the same pairing callbacks") {
+	const int item_count = 500;
+	Item items[item_count];
+	for (int i = 0; i < item_count; i++) {
+		items[i].id = i;
+	}
+
+	PairingBVH serial;
+	PairingBVH parallel;
+	parallel.params_set_parallel_threshold(1);
+
+	Vector<String> serial_log;
+	Vector<String> parallel_log;
+	serial.set_pair_callback(pair_callback, &serial_log);
+	serial.set_unpair_callback(unpair_callback, &serial_log);
+	parallel.set_pair_callback(pair_callback, &parallel_log);
+	parallel.set_unpair_callback(unpair_callback, &parallel_log);
+
+	RandomPCG rng(42);
+	BVHHandle serial_handles[item_count];
+	BVHHandle parallel_handles[item_count];
+	for (int i = 0; i < item_count; i++) {
+		AABB box = random_box(rng);
+		serial_handles[i] = serial.create(&items[i], true, 0, 1, box);
+		parallel_handles[i] = parallel.create(&items[i], true, 0, 1, box);
+	}
+
+	for (int step = 0; step < 10; step++) {
+		// Move most of the items each step, so plenty of pairs come and go.
+		for (int i = 0; i < item_count; i++) {
+			if (rng.rand(4) == 0) {
+				continue;
+			}
+			AABB box = random_box(rng);
+			serial.move(serial_handles[i], box);
+			parallel.move(parallel_handles[i], box);
+		}
+		serial.update();
+		parallel.update();
+
+		CHECK_MESSAGE(parallel_log == serial_log, vformat("Callbacks should match at step %d.", step));
+	}
+
+	CHECK_MESSAGE(serial_log.size() > 0, "The test should exercise some pairing.");
+
+	for (int i = 0; i < item_count; i++) {
+		AABB serial_aabb;
+		AABB parallel_aabb;
+		serial.item_get_AABB(serial_handles[i], serial_aabb);
+		parallel.item_get_AABB(parallel_handles[i], parallel_aabb);
+		CHECK(serial_aabb == parallel_aabb);
+	}
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
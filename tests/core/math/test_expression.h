@@ -32,6 +32,7 @@
 #define TEST_EXPRESSION_H
 
 #include "core/math/expression.h"
+#include "core/object/worker_thread_pool.h"
 
 #include "tests/test_macros.h"
 
@@ -321,6 +322,144 @@ TEST_CASE("[Expression] Expressions with variables") {
 	ERR_PRINT_ON;
 }
 
+TEST_CASE("[Expression] Repeated execution") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("foo");
+	parameter_names.push_back("bar");
+	CHECK_MESSAGE(
+			expression.parse("foo * 2 + bar.length()", parameter_names) == OK,
+			"The expression should parse successfully.");
+
+	auto inputs = [](const Variant &p_foo, const Variant &p_bar) {
+		Array values;
+		values.push_back(p_foo);
+		values.push_back(p_bar);
+		return values;
+	};
+
+	// Results must stay correct when the input types change between calls.
+	CHECK_MESSAGE(
+			int(expression.execute(inputs(10, "abc"))) == 23,
+			"The expression should return the expected value.");
+	CHECK_MESSAGE(
+			double(expression.execute(inputs(1.5, "abcd"))) == doctest::Approx(7.0),
+			"The expression should return the expected value.");
+	CHECK_MESSAGE(
+			int(expression.execute(inputs(10, "abc"))) == 23,
+			"The expression should return the expected value.");
+	CHECK_MESSAGE(
+			int(expression.execute(inputs(10, Vector2(3, 4)))) == 25,
+			"The expression should return the expected value.");
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			int(expression.execute(inputs(10, 5))) == 0,
+			"Calling a missing method should fail.");
+	CHECK(expression.has_execute_failed());
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(
+			int(expression.execute(inputs(10, "abc"))) == 23,
+			"The expression should return the expected value.");
+	CHECK_FALSE(expression.has_execute_failed());
+}
+
+struct ConcurrentExecution {
+	Ref<Expression> expression;
+	SafeNumeric<uint32_t> mismatches;
+
+	void execute(uint32_t p_index, int p_iterations) {
+		for (int i = 0; i < p_iterations; i++) {
+			// Alternate the input types, so the instruction caches keep being replaced while other threads use them.
+			const int64_t value = p_index * p_iterations + i;
+			Array inputs;
+			inputs.push_back(value % 2 ? Variant(value) : Variant(double(value)));
+			inputs.push_back(value % 3 ? Variant("abc") : Variant(Vector2(3, 4)));
+			const double expected = value * 2.0 + (value % 3 ? 3.0 : 5.0);
+			if (double(expression->execute(inputs)) != expected) {
+				mismatches.increment();
+			}
+		}
+	}
+};
+
+TEST_CASE("[Expression] Concurrent execution") {
+	ConcurrentExecution execution;
+	execution.expression.instantiate();
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("foo");
+	parameter_names.push_back("bar");
+	REQUIRE(execution.expression->parse("foo * 2 + bar.length()", parameter_names) == OK);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&execution, &ConcurrentExecution::execute, 200, 64, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_MESSAGE(
+			execution.mismatches.get() == 0,
+			"Threads executing the same expression should not affect each other's results.");
+}
+
+TEST_CASE("[Expression] Bound inputs") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("foo");
+	parameter_names.push_back("bar");
+	CHECK_MESSAGE(
+			expression.parse("max(foo, bar) - min(foo, bar)", parameter_names) == OK,
+			"The expression should parse successfully.");
+
+	expression.set_input_value(0, 5);
+	expression.set_input_value(1, 12);
+	CHECK_MESSAGE(
+			int(expression.execute_bound()) == 7,
+			"The expression should return the expected value.");
+
+	expression.set_input_value(0, 20);
+	CHECK_MESSAGE(
+			int(expression.execute_bound()) == 8,
+			"The expression should return the expected value.");
+
+	ERR_PRINT_OFF;
+	expression.set_input_value(2, 1);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			int(expression.execute_bound()) == 8,
+			"Setting an out of range input should be ignored.");
+}
+
+TEST_CASE("[Expression] Calls on a base instance") {
+	Ref<Expression> inner;
+	inner.instantiate();
+	CHECK(inner->parse("3 * 4") == OK);
+
+	Expression expression;
+	CHECK_MESSAGE(
+			expression.parse("self.execute() + 1") == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			int(expression.execute(Array(), inner.ptr())) == 13,
+			"The expression should call the method on the base instance.");
+
+	// The base instance executes an expression of its own from within the call.
+	CHECK(inner->parse("self.has_execute_failed()") == OK);
+	CHECK_MESSAGE(
+			expression.parse("self.execute() == false") == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			bool(expression.execute(Array(), inner.ptr())),
+			"The expression should return the expected value.");
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			expression.execute(Array(), inner.ptr(), true, true).get_type() == Variant::NIL,
+			"Non-const methods should not be callable in const mode.");
+	ERR_PRINT_ON;
+	CHECK(expression.has_execute_failed());
+}
+
 TEST_CASE("[Expression] Invalid expressions") {
 	Expression expression;
 
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*  test_small_object_allocator.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SMALL_OBJECT_ALLOCATOR_H
+#define TEST_SMALL_OBJECT_ALLOCATOR_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/os/small_object_allocator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallObjectAllocator {
+
+TEST_CASE("[SmallObjectAllocator] Size classes") {
+	for (size_t bytes = 1; bytes <= SmallObjectAllocator::MAX_BLOCK_SIZE; bytes++) {
+		uint32_t size_class = SmallObjectAllocator::get_size_class(bytes);
+		REQUIRE(size_class < SmallObjectAllocator::SIZE_CLASS_COUNT);
+		CHECK(SmallObjectAllocator::get_block_size(size_class) >= bytes);
+		if (size_class > 0) {
+			// The smallest class that fits.
+			CHECK(SmallObjectAllocator::get_block_size(size_class - 1) < bytes);
+		}
+		CHECK(SmallObjectAllocator::get_block_size(size_class) % alignof(max_align_t) == 0);
+	}
+	CHECK(SmallObjectAllocator::get_size_class(SmallObjectAllocator::MAX_BLOCK_SIZE + 1) == SmallObjectAllocator::SIZE_CLASS_COUNT);
+}
+
+TEST_CASE("[SmallObjectAllocator] Blocks are distinct and reused") {
+	const uint32_t size_class = SmallObjectAllocator::get_size_class(48);
+	LocalVector<uint8_t *> blocks;
+	for (int i = 0; i < 1000; i++) {
+		uint8_t *block = (uint8_t *)SmallObjectAllocator::alloc(size_class);
+		REQUIRE(block != nullptr);
+		memset(block, i & 0xFF, 48);
+		blocks.push_back(block);
+	}
+
+	bool all_intact = true;
+	for (int i = 0; i < 1000; i++) {
+		for (int j = 0; j < 48; j++) {
+			all_intact &= blocks[i][j] == (i & 0xFF);
+		}
+	}
+	CHECK_MESSAGE(all_intact, "Blocks must not overlap.");
+
+	uint8_t *last = blocks[999];
+	SmallObjectAllocator::free(last, size_class);
+	CHECK_MESSAGE(SmallObjectAllocator::alloc(size_class) == last, "The last freed block should be the first reused.");
+
+	for (uint8_t *block : blocks) {
+		SmallObjectAllocator::free(block, size_class);
+	}
+}
+
+TEST_CASE("[Memory] Reallocation keeps the contents across size classes") {
+	uint8_t *mem = (uint8_t *)memalloc(8);
+	for (int i = 0; i < 8; i++) {
+		mem[i] = i;
+	}
+	// Grow within the small size classes, out of them and back.
+	const size_t sizes[] = { 24, 200, 900, 5000, 64, 8 };
+	bool contents_kept = true;
+	for (size_t size : sizes) {
+		mem = (uint8_t *)memrealloc(mem, size);
+		REQUIRE(mem != nullptr);
+		for (int i = 0; i < 8; i++) {
+			contents_kept &= mem[i] == i;
+		}
+	}
+	CHECK(contents_kept);
+	memfree(mem);
+}
+
+static void free_from_other_thread(void *p_blocks, uint32_t p_index) {
+	memfree(((void **)p_blocks)[p_index]);
+}
+
+TEST_CASE("[Memory] Freeing from other threads") {
+	const int count = 4096;
+	void **blocks = (void **)memalloc(sizeof(void *) * count);
+	for (int i = 0; i < count; i++) {
+		blocks[i] = memalloc(1 + (i % 512));
+	}
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(free_from_other_thread, blocks, count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	memfree(blocks);
+
+#if defined(SMALL_OBJECT_ALLOCATOR_ENABLED) && defined(DEBUG_ENABLED)
+	Array size_classes = OS::get_singleton()->get_static_memory_usage_by_size_class();
+	CHECK(size_classes.size() == SmallObjectAllocator::SIZE_CLASS_COUNT);
+#endif
+}
+
+} // namespace TestSmallObjectAllocator
+
+#endif // TEST_SMALL_OBJECT_ALLOCATOR_H
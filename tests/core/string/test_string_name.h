@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Names should be interned") {
+	const StringName from_cstring = StringName("string_name_test");
+	const StringName from_string = StringName(String("string_name_test"));
+	const StringName from_static = _scs_create("string_name_test");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK_EQ(from_cstring.data_unique_pointer(), from_string.data_unique_pointer());
+	CHECK_EQ(String(from_cstring), "string_name_test");
+
+	CHECK(StringName::search("string_name_test") == from_cstring);
+	CHECK(StringName::search(U"string_name_test") == from_cstring);
+	CHECK(StringName::search(String("string_name_test")) == from_cstring);
+	CHECK(StringName::search("string_name_never_created") == StringName());
+}
+
+TEST_CASE("[StringName] Names should still be found after the table grows") {
+	const int name_count = 100000;
+	LocalVector<StringName> names;
+	names.resize(name_count);
+	for (int i = 0; i < name_count; i++) {
+		names[i] = StringName("string_name_grow_" + itos(i));
+	}
+
+	bool all_found = true;
+	for (int i = 0; i < name_count; i++) {
+		// Reduce number of check messages.
+		all_found &= StringName::search("string_name_grow_" + itos(i)) == names[i];
+	}
+	CHECK(all_found);
+
+	names.clear();
+	CHECK(StringName::search("string_name_grow_0") == StringName());
+}
+
+struct ConcurrentLookups {
+	LocalVector<String> strings;
+	LocalVector<StringName> names;
+	SafeNumeric<uint32_t> mismatches;
+
+	void lookup(uint32_t p_index, int p_iterations) {
+		for (int i = 0; i < p_iterations; i++) {
+			const uint32_t name_index = (p_index * 7919 + i) % strings.size();
+			if (StringName(strings[name_index]) != names[name_index]) {
+				mismatches.increment();
+			}
+		}
+	}
+
+	void create_and_release(uint32_t p_index, int p_iterations) {
+		// Names unique to this task, so they are added and removed from the table over and over.
+		for (int i = 0; i < p_iterations; i++) {
+			const String string = "string_name_unique_" + itos(p_index) + "_" + itos(i % 64);
+			const StringName name = StringName(string);
+			if (String(name) != string) {
+				mismatches.increment();
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent lookups and creations should return the right names") {
+	ConcurrentLookups lookups;
+	const int name_count = 4096;
+	for (int i = 0; i < name_count; i++) {
+		lookups.strings.push_back("string_name_concurrent_" + itos(i));
+		lookups.names.push_back(StringName(lookups.strings[i]));
+	}
+	const int iterations = 20000;
+
+	const int task_count = MAX(WorkerThreadPool::get_singleton()->get_thread_count(), 2);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&lookups, &ConcurrentLookups::lookup, iterations, task_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_EQ(lookups.mismatches.get(), 0u);
+
+	group = WorkerThreadPool::get_singleton()->add_template_group_task(&lookups, &ConcurrentLookups::create_and_release, iterations, task_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_EQ(lookups.mismatches.get(), 0u);
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
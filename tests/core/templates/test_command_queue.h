@@ -446,6 +446,111 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class MultiProducerState {
+public:
+	static const int MAX_PRODUCERS = 8;
+
+	CommandQueueMT command_queue;
+	Thread producer_threads[MAX_PRODUCERS];
+	Thread consumer_thread;
+	SafeFlag exit_consumer;
+	int producer_count = 0;
+	int commands_per_producer = 0;
+
+	// Only accessed by the consumer.
+	int last_sequence[MAX_PRODUCERS];
+	int executed = 0;
+	int order_errors = 0;
+
+	void execute(int p_producer, int p_sequence) {
+		if (p_sequence != last_sequence[p_producer] + 1) {
+			order_errors++;
+		}
+		last_sequence[p_producer] = p_sequence;
+		executed++;
+	}
+
+	int get_last_sequence(int p_producer) {
+		return last_sequence[p_producer];
+	}
+
+	struct ProducerData {
+		MultiProducerState *state = nullptr;
+		int index = 0;
+		int sync_errors = 0;
+	};
+	ProducerData producers[MAX_PRODUCERS];
+
+	static void producer_loop(void *p_data) {
+		ProducerData *data = static_cast<ProducerData *>(p_data);
+		MultiProducerState *state = data->state;
+		for (int i = 0; i < state->commands_per_producer; i++) {
+			if (i % 1000 == 999) {
+				// Everything this producer pushed before must have run.
+				int last = -1;
+				state->command_queue.push_and_ret(state, &MultiProducerState::get_last_sequence, data->index, &last);
+				if (last != i - 1) {
+					data->sync_errors++;
+				}
+			}
+			state->command_queue.push(state, &MultiProducerState::execute, data->index, i);
+		}
+	}
+
+	static void consumer_loop(void *p_data) {
+		MultiProducerState *state = static_cast<MultiProducerState *>(p_data);
+		while (!state->exit_consumer.is_set()) {
+			state->command_queue.flush_if_pending();
+		}
+		state->command_queue.flush_all();
+	}
+
+	void run(int p_producer_count, int p_commands_per_producer) {
+		producer_count = p_producer_count;
+		commands_per_producer = p_commands_per_producer;
+		for (int i = 0; i < MAX_PRODUCERS; i++) {
+			last_sequence[i] = -1;
+		}
+		executed = 0;
+		order_errors = 0;
+		exit_consumer.clear();
+
+		consumer_thread.start(&MultiProducerState::consumer_loop, this);
+		for (int i = 0; i < producer_count; i++) {
+			producers[i].state = this;
+			producers[i].index = i;
+			producers[i].sync_errors = 0;
+			producer_threads[i].start(&MultiProducerState::producer_loop, &producers[i]);
+		}
+		for (int i = 0; i < producer_count; i++) {
+			producer_threads[i].wait_to_finish();
+		}
+		exit_consumer.set();
+		consumer_thread.wait_to_finish();
+	}
+
+	int get_sync_errors() const {
+		int errors = 0;
+		for (int i = 0; i < producer_count; i++) {
+			errors += producers[i].sync_errors;
+		}
+		return errors;
+	}
+};
+
+TEST_CASE("[Stress][CommandQueue] Multiple producers keep their submission order") {
+	MultiProducerState state;
+	state.run(MultiProducerState::MAX_PRODUCERS, 20000);
+
+	CHECK_EQ(state.executed, MultiProducerState::MAX_PRODUCERS * 20000);
+	CHECK_MESSAGE(state.order_errors == 0, "Commands of each producer should run in the order they were pushed.");
+	CHECK_MESSAGE(state.get_sync_errors() == 0, "Synchronous commands should run after everything the producer pushed before.");
+	for (int i = 0; i < MultiProducerState::MAX_PRODUCERS; i++) {
+		CHECK_EQ(state.last_sequence[i], 19999);
+	}
+}
+
 } // namespace TestCommandQueue
 
 #endif // TEST_COMMAND_QUEUE_H
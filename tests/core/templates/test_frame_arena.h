@@ -0,0 +1,182 @@
+/**************************************************************************/
+/*  test_frame_arena.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/templates/frame_arena.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Allocations are aligned and grow in place") {
+	FrameArena::end_frame();
+
+	uint8_t *a = (uint8_t *)FrameArena::alloc(3);
+	uint8_t *b = (uint8_t *)FrameArena::alloc(17);
+	CHECK((uintptr_t)a % alignof(max_align_t) == 0);
+	CHECK((uintptr_t)b % alignof(max_align_t) == 0);
+	CHECK(b >= a + 3);
+
+	// Only the most recent allocation can grow without moving.
+	CHECK(FrameArena::realloc(b, 17, 256) == b);
+	uint8_t *a2 = (uint8_t *)FrameArena::realloc(a, 3, 64);
+	CHECK(a2 != a);
+
+	// Larger than a chunk.
+	uint8_t *big = (uint8_t *)FrameArena::alloc(1024 * 1024);
+	CHECK(big != nullptr);
+	big[1024 * 1024 - 1] = 42;
+	CHECK(big[1024 * 1024 - 1] == 42);
+}
+
+TEST_CASE("[FrameArena] FrameLocalVector") {
+	FrameArena::end_frame();
+
+	FrameLocalVector<int> vector;
+	for (int i = 0; i < 1000; i++) {
+		vector.push_back(999 - i);
+	}
+	vector.sort();
+	CHECK(vector.size() == 1000);
+	CHECK(vector[0] == 0);
+	CHECK(vector[999] == 999);
+
+	Vector<int> converted = vector;
+	CHECK(converted.size() == 1000);
+	CHECK(converted[500] == 500);
+
+	FrameLocalVector<String> strings;
+	strings.push_back("a");
+	strings.push_back("b");
+	strings.remove_at(0);
+	CHECK(strings.size() == 1);
+	CHECK(strings[0] == "b");
+}
+
+TEST_CASE("[FrameArena] Data survives until the end of the next frame") {
+	FrameArena::end_frame();
+
+	FrameLocalVector<uint32_t> previous;
+	for (uint32_t i = 0; i < 4096; i++) {
+		previous.push_back(i);
+	}
+
+	FrameArena::end_frame();
+
+	FrameLocalVector<uint32_t> current;
+	for (uint32_t i = 0; i < 4096; i++) {
+		current.push_back(~i);
+	}
+
+	bool intact = true;
+	for (uint32_t i = 0; i < 4096; i++) {
+		intact = intact && previous[i] == i && current[i] == ~i;
+	}
+	CHECK(intact);
+}
+
+TEST_CASE("[FrameArena] No allocations in steady state") {
+	auto simulate_frame = []() {
+		FrameLocalVector<uint64_t> values;
+		for (uint64_t i = 0; i < 10000; i++) {
+			values.push_back(i);
+		}
+		FrameLocalVector<Vector3> points;
+		points.resize(500);
+		FrameArena::end_frame();
+	};
+
+	// Warm up both arenas.
+	simulate_frame();
+	simulate_frame();
+
+	uint64_t reserved = FrameArena::get_thread_reserved_bytes();
+	uint64_t alloc_calls = Memory::get_alloc_call_count();
+	for (int i = 0; i < 10; i++) {
+		simulate_frame();
+	}
+	CHECK(FrameArena::get_thread_reserved_bytes() == reserved);
+	CHECK(Memory::get_alloc_call_count() == alloc_calls);
+	CHECK(FrameArena::get_last_frame_alloc_calls() == 0);
+}
+
+TEST_CASE("[FrameArena] Scopes") {
+	FrameArena::end_frame();
+
+	FrameArena::Scope scope;
+	FrameLocalVector<uint32_t> values;
+	for (uint32_t i = 0; i < 4096; i++) {
+		values.push_back(i);
+	}
+
+	void *inner_alloc = nullptr;
+	{
+		FrameArena::Scope inner;
+		inner_alloc = FrameArena::alloc(1024);
+	}
+	// Memory of the inner scope is handed out again once it's gone.
+	CHECK(FrameArena::alloc(1024) == inner_alloc);
+
+	// Frames don't rewind scoped memory.
+	FrameArena::end_frame();
+	FrameArena::end_frame();
+	FrameArena::end_frame();
+	values.push_back(4096);
+
+	bool intact = values.size() == 4097;
+	for (uint32_t i = 0; i < values.size(); i++) {
+		intact = intact && values[i] == i;
+	}
+	CHECK(intact);
+}
+
+TEST_CASE("[FrameArena] Heap fallback without frames") {
+	FrameArena::end_frame();
+	FrameArena::stop_frames();
+	CHECK_FALSE(FrameArena::is_frame_running());
+
+	uint64_t reserved = FrameArena::get_thread_reserved_bytes();
+	FrameLocalVector<uint64_t> values;
+	for (uint64_t i = 0; i < 100000; i++) {
+		values.push_back(i);
+	}
+	CHECK(values[99999] == 99999);
+	CHECK(FrameArena::get_thread_reserved_bytes() == reserved);
+	values.reset();
+
+	FrameArena::end_frame();
+	CHECK(FrameArena::is_frame_running());
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
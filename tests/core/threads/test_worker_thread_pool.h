@@ -107,6 +107,111 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+static void static_inner_group_test(void *p_arg, uint32_t p_index) {
+	counter[(uintptr_t)p_arg * 16 + p_index].increment();
+}
+static void static_outer_group_test(void *p_arg, uint32_t p_index) {
+	// Posted from a pool thread, so this goes to its own work queue, where other threads can steal it.
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_inner_group_test, (void *)(uintptr_t)p_index, 16, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	counter[(uintptr_t)p_arg].increment();
+}
+TEST_CASE("[WorkerThreadPool] Process group tasks posted and awaited from pool threads") {
+	for (int iterations = 0; iterations < 100; iterations++) {
+		const int outer_count = Math::pow(2.0f, Math::random(0.0f, 6.0f));
+
+		counter.clear();
+		counter.resize(outer_count * 16 + 1);
+		// The last counter tracks the outer elements.
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_outer_group_test, (void *)(uintptr_t)(outer_count * 16), outer_count, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+		bool all_run_once = true;
+		for (int i = 0; i < outer_count * 16; i++) {
+			//Reduce number of check messages
+			all_run_once &= counter[i].get() == 1;
+		}
+		CHECK(all_run_once);
+		CHECK(counter[outer_count * 16].get() == outer_count);
+	}
+}
+
+static void static_first_stage_test(void *p_arg, uint32_t p_index) {
+	counter[p_index].increment();
+}
+static void static_second_stage_test(void *p_arg, uint32_t p_index) {
+	// Only counts if the whole first stage is done.
+	for (uint32_t i = 0; i < counter.size(); i++) {
+		if (counter[i].get() == 0) {
+			return;
+		}
+	}
+	counter[p_index].increment();
+}
+static void static_last_stage_test(void *p_arg) {
+	bool all_stages_done = true;
+	for (uint32_t i = 0; i < counter.size(); i++) {
+		all_stages_done &= counter[i].get() == 2;
+	}
+	*((bool *)p_arg) = all_stages_done;
+}
+TEST_CASE("[WorkerThreadPool] Run tasks and groups after their dependencies") {
+	for (int iterations = 0; iterations < 200; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 5.0f));
+		const bool low_priority = Math::rand() % 2;
+		bool all_stages_done = false;
+
+		counter.clear();
+		counter.resize(count);
+		WorkerThreadPool::GroupID first = WorkerThreadPool::get_singleton()->add_native_group_task(static_first_stage_test, nullptr, count, -1, !low_priority);
+		Vector<WorkerThreadPool::TaskID> dependencies = { first };
+		WorkerThreadPool::GroupID second = WorkerThreadPool::get_singleton()->add_native_dependent_group_task(static_second_stage_test, nullptr, count, dependencies, -1, low_priority);
+		dependencies = { first, second };
+		WorkerThreadPool::TaskID last = WorkerThreadPool::get_singleton()->add_native_dependent_task(static_last_stage_test, &all_stages_done, dependencies, !low_priority);
+
+		// Waiting in reverse order, so the pool has to follow the dependencies by itself.
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(last);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(second);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(first);
+
+		CHECK(all_stages_done);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Capture the task timeline") {
+	counter.clear();
+	counter.resize(16);
+	bool all_stages_done = false;
+
+	WorkerThreadPool::get_singleton()->set_task_timeline_capture_enabled(true);
+	WorkerThreadPool::GroupID first = WorkerThreadPool::get_singleton()->add_native_group_task(static_first_stage_test, nullptr, 16, -1, true, "First");
+	Vector<WorkerThreadPool::TaskID> dependencies = { first };
+	WorkerThreadPool::GroupID second = WorkerThreadPool::get_singleton()->add_native_dependent_group_task(static_second_stage_test, nullptr, 16, dependencies, -1, true, "Second");
+	dependencies = { second };
+	WorkerThreadPool::TaskID last = WorkerThreadPool::get_singleton()->add_native_dependent_task(static_last_stage_test, &all_stages_done, dependencies, true, "Last");
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(last);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(second);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(first);
+	WorkerThreadPool::get_singleton()->set_task_timeline_capture_enabled(false);
+
+	CHECK(all_stages_done);
+
+	Array timeline = WorkerThreadPool::get_singleton()->get_task_timeline();
+	bool last_found = false;
+	for (int i = 0; i < timeline.size(); i++) {
+		Dictionary entry = timeline[i];
+		CHECK(uint64_t(entry["begin_usec"]) <= uint64_t(entry["end_usec"]));
+		if (WorkerThreadPool::TaskID(entry["id"]) == last) {
+			last_found = true;
+			CHECK(String(entry["description"]) == "Last");
+			PackedInt64Array entry_dependencies = entry["dependencies"];
+			CHECK(entry_dependencies.size() == 1);
+			CHECK(entry_dependencies[0] == second);
+		}
+	}
+	CHECK_MESSAGE(last_found, "The dependent task should be in the timeline.");
+}
+
 static void static_test_daemon(void *p_arg) {
 	while (!exit.is_set()) {
 		counter[0].add(1);
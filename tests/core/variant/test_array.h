@@ -634,6 +634,58 @@ TEST_CASE("[Array] Typed copying") {
 	a6.clear();
 }
 
+TEST_CASE("[Array] Typed sorting and searching") {
+	TypedArray<int> ints;
+	ints.push_back(5);
+	ints.push_back(-3);
+	ints.push_back(12);
+	ints.push_back(0);
+	ints.push_back(5);
+
+	CHECK_EQ(ints.min(), Variant(-3));
+	CHECK_EQ(ints.max(), Variant(12));
+
+	ints.sort();
+	CHECK_EQ(ints[0], Variant(-3));
+	CHECK_EQ(ints[1], Variant(0));
+	CHECK_EQ(ints[2], Variant(5));
+	CHECK_EQ(ints[3], Variant(5));
+	CHECK_EQ(ints[4], Variant(12));
+
+	CHECK_EQ(ints.bsearch(5, true), 2);
+	CHECK_EQ(ints.bsearch(5, false), 4);
+	CHECK_EQ(ints.bsearch(-10), 0);
+	CHECK_EQ(ints.bsearch(20), 5);
+
+	TypedArray<String> strings;
+	strings.push_back("pear");
+	strings.push_back("apple");
+	strings.push_back("fig");
+
+	CHECK_EQ(strings.min(), Variant("apple"));
+	CHECK_EQ(strings.max(), Variant("pear"));
+
+	strings.sort();
+	CHECK_EQ(strings[0], Variant("apple"));
+	CHECK_EQ(strings[1], Variant("fig"));
+	CHECK_EQ(strings[2], Variant("pear"));
+
+	// Sorting must give the same result as for an untyped array.
+	TypedArray<double> floats;
+	Array untyped;
+	for (int i = 0; i < 50; i++) {
+		const double value = Math::fmod(i * 37.5, 11.0) - 5.0;
+		floats.push_back(value);
+		untyped.push_back(value);
+	}
+	floats.sort();
+	untyped.sort();
+	CHECK_EQ(Array(floats), untyped);
+
+	CHECK(TypedArray<int>().min().get_type() == Variant::NIL);
+	CHECK(TypedArray<int>().max().get_type() == Variant::NIL);
+}
+
 } // namespace TestArray
 
 #endif // TEST_ARRAY_H
@@ -0,0 +1,174 @@
+/**************************************************************************/
+/*  test_character_body_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_CHARACTER_BODY_3D_H
+#define TEST_CHARACTER_BODY_3D_H
+
+#include "core/object/message_queue.h"
+#include "scene/3d/physics/character_body_3d.h"
+#include "scene/3d/physics/collision_shape_3d.h"
+#include "scene/3d/physics/static_body_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/box_shape_3d.h"
+#include "scene/resources/3d/capsule_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+class TestCharacterBody3DInternalsAccessor {
+public:
+	// Both need a physics frame when going through move_and_slide().
+	static bool move_and_slide(CharacterBody3D *p_body, double p_delta) {
+		return p_body->_move_and_slide(p_delta);
+	}
+	static void queue_motion_batch(CharacterBody3D *p_body, double p_delta) {
+		p_body->_queue_motion_batch(p_delta);
+	}
+};
+
+namespace TestCharacterBody3D {
+
+static void add_box(Node *p_parent, const Vector3 &p_size, const Transform3D &p_transform) {
+	Ref<BoxShape3D> box;
+	box.instantiate();
+	box->set_size(p_size);
+	CollisionShape3D *shape = memnew(CollisionShape3D);
+	shape->set_shape(box);
+
+	StaticBody3D *body = memnew(StaticBody3D);
+	body->set_transform(p_transform);
+	body->add_child(shape);
+	p_parent->add_child(body);
+}
+
+static CharacterBody3D *add_character(Node *p_parent, const Vector3 &p_position, bool p_motion_batching) {
+	Ref<CapsuleShape3D> capsule;
+	capsule.instantiate();
+	capsule->set_radius(0.4);
+	capsule->set_height(1.8);
+	CollisionShape3D *shape = memnew(CollisionShape3D);
+	shape->set_shape(capsule);
+
+	// Characters only collide with the level, so each pair can move through the same space.
+	CharacterBody3D *body = memnew(CharacterBody3D);
+	body->set_collision_layer(2);
+	body->set_collision_mask(1);
+	body->set_floor_snap_length(0.5);
+	body->set_motion_batching_enabled(p_motion_batching);
+	body->set_position(p_position);
+	body->add_child(shape);
+	p_parent->add_child(body);
+	return body;
+}
+
+static void check_same_motion(CharacterBody3D *p_batched, CharacterBody3D *p_single) {
+	CHECK(p_batched->get_global_transform().is_equal_approx(p_single->get_global_transform()));
+	CHECK(p_batched->get_velocity().is_equal_approx(p_single->get_velocity()));
+	CHECK_EQ(p_batched->is_on_floor(), p_single->is_on_floor());
+	CHECK_EQ(p_batched->is_on_wall(), p_single->is_on_wall());
+	REQUIRE_EQ(p_batched->get_slide_collision_count(), p_single->get_slide_collision_count());
+	for (int i = 0; i < p_single->get_slide_collision_count(); i++) {
+		const PhysicsServer3D::MotionResult batched = p_batched->get_slide_collision(i);
+		const PhysicsServer3D::MotionResult single = p_single->get_slide_collision(i);
+		CHECK(batched.travel.is_equal_approx(single.travel));
+		REQUIRE_EQ(batched.collision_count, single.collision_count);
+		for (int j = 0; j < single.collision_count; j++) {
+			CHECK_EQ(batched.collisions[j].collider_id, single.collisions[j].collider_id);
+			CHECK(batched.collisions[j].normal.is_equal_approx(single.collisions[j].normal));
+			CHECK(batched.collisions[j].position.is_equal_approx(single.collisions[j].position));
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][CharacterBody3D] Batched move_and_slide() matches move_and_slide()") {
+	const double delta = 1.0 / 60.0;
+	const real_t gravity = 9.8;
+
+	Node3D *level = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(level);
+
+	// Floor with its top at 0, a 20 degrees ramp going up along +X from about X = 3 and a wall facing +Z.
+	add_box(level, Vector3(100, 1, 100), Transform3D(Basis(), Vector3(0, -0.5, 0)));
+	add_box(level, Vector3(8, 1, 4), Transform3D(Basis(Vector3(0, 0, 1), Math::deg_to_rad(20.0)), Vector3(7, 0.9, 0)));
+	add_box(level, Vector3(20, 4, 1), Transform3D(Basis(), Vector3(0, 2, -13)));
+
+	struct Scenario {
+		const char *name;
+		Vector3 start;
+		Vector3 walk_velocity;
+		CharacterBody3D *batched = nullptr;
+		CharacterBody3D *single = nullptr;
+	};
+	Scenario scenarios[] = {
+		{ "Walking up the slope", Vector3(0, 0.9, 0), Vector3(3, 0, 0) },
+		{ "Sliding along the wall", Vector3(0, 0.9, -10), Vector3(2, 0, -3) },
+		{ "Snapped to the floor walking down the slope", Vector3(9, 3.2, 1), Vector3(-3, 0, 0) },
+	};
+	for (Scenario &scenario : scenarios) {
+		scenario.batched = add_character(level, scenario.start, true);
+		scenario.single = add_character(level, scenario.start, false);
+	}
+	PhysicsServer3D::get_singleton()->step(delta);
+
+	for (int frame = 0; frame < 120; frame++) {
+		for (Scenario &scenario : scenarios) {
+			for (CharacterBody3D *body : { scenario.batched, scenario.single }) {
+				Vector3 velocity = body->get_velocity();
+				velocity.x = scenario.walk_velocity.x;
+				velocity.z = scenario.walk_velocity.z;
+				if (!body->is_on_floor()) {
+					velocity.y -= gravity * delta;
+				}
+				body->set_velocity(velocity);
+			}
+			TestCharacterBody3DInternalsAccessor::queue_motion_batch(scenario.batched, delta);
+			TestCharacterBody3DInternalsAccessor::move_and_slide(scenario.single, delta);
+		}
+		// The batch is solved at the end of the physics frame.
+		MessageQueue::get_singleton()->flush();
+
+		for (const Scenario &scenario : scenarios) {
+			INFO(scenario.name, ", frame ", frame);
+			check_same_motion(scenario.batched, scenario.single);
+		}
+	}
+
+	// Make sure each scenario tested what it's named after.
+	CHECK_MESSAGE(scenarios[0].single->get_global_position().y > 1.5, "The character should have climbed the slope.");
+	CHECK(scenarios[0].single->is_on_floor());
+	CHECK_MESSAGE(scenarios[1].single->is_on_wall(), "The character should be against the wall.");
+	CHECK(scenarios[1].single->get_global_position().x > 3.0);
+	CHECK_MESSAGE(scenarios[2].single->is_on_floor(), "The character should have stayed on the floor down the slope.");
+
+	memdelete(level);
+}
+
+} // namespace TestCharacterBody3D
+
+#endif // TEST_CHARACTER_BODY_3D_H
@@ -31,6 +31,7 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/os/os.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "servers/navigation_server_3d.h"
@@ -61,6 +62,38 @@ static inline Array build_array(Variant item, Targs... Fargs) {
 	return a;
 }
 
+// Builds a flat navigation mesh of `p_size` x `p_size` unit quads starting at the origin.
+static inline Ref<NavigationMesh> build_grid_navigation_mesh(int p_size) {
+	Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+	Vector<Vector3> vertices;
+	vertices.resize((p_size + 1) * (p_size + 1));
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.write[z * (p_size + 1) + x] = Vector3(x, 0, z);
+		}
+	}
+	navigation_mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			navigation_mesh->add_polygon(polygon);
+		}
+	}
+	return navigation_mesh;
+}
+
+static inline real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
 TEST_SUITE("[Navigation]") {
 	TEST_CASE("[NavigationServer3D] Server should be empty when initialized") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
@@ -768,6 +801,207 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Path queries on a large map should find the closest polygons and a valid path") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int grid_size = 128;
+		Ref<NavigationMesh> navigation_mesh = build_grid_navigation_mesh(grid_size);
+		CHECK_EQ(navigation_mesh->get_polygon_count(), grid_size * grid_size);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), grid_size * grid_size);
+
+		SUBCASE("Closest point queries should use the polygon below the query point") {
+			CHECK(navigation_server->map_get_closest_point(map, Vector3(10.5, 3.0, 20.5)).is_equal_approx(Vector3(10.5, 0.0, 20.5)));
+			CHECK(navigation_server->map_get_closest_point(map, Vector3(-5.0, 0.0, -5.0)).is_equal_approx(Vector3(0.0, 0.0, 0.0)));
+			CHECK_EQ(navigation_server->map_get_closest_point_owner(map, Vector3(64.5, 0.0, 64.5)), region);
+		}
+
+		SUBCASE("Optimized path across an open grid should be a straight line") {
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0.0, 0.25), Vector3(grid_size - 0.5, 0.0, 40.75), true);
+			REQUIRE_EQ(path.size(), 2);
+			CHECK(path[0].is_equal_approx(Vector3(0.5, 0.0, 0.25)));
+			CHECK(path[1].is_equal_approx(Vector3(grid_size - 0.5, 0.0, 40.75)));
+		}
+
+		SUBCASE("Repeated path queries should all find a path between their end points") {
+			const int query_count = 64;
+			int valid_paths = 0;
+			for (int i = 0; i < query_count; i++) {
+				const Vector3 origin = Vector3((i * 7) % grid_size + 0.5, 0.0, (i * 13) % grid_size + 0.5);
+				const Vector3 destination = Vector3(grid_size - 1 - (i * 11) % grid_size + 0.5, 0.0, grid_size - 1 - (i * 5) % grid_size + 0.5);
+				const Vector<Vector3> path = navigation_server->map_get_path(map, origin, destination, true);
+				if (path.size() >= 2 && path[0].is_equal_approx(origin) && path[path.size() - 1].is_equal_approx(destination)) {
+					valid_paths++;
+				}
+			}
+			CHECK_EQ(valid_paths, query_count);
+		}
+
+		SUBCASE("Batched path queries should match single path queries") {
+			const int query_count = 256;
+			TypedArray<NavigationPathQueryParameters3D> batch_parameters;
+			TypedArray<NavigationPathQueryResult3D> batch_results;
+			for (int i = 0; i < query_count; i++) {
+				Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+				query_parameters->set_map(map);
+				query_parameters->set_start_position(Vector3((i * 7) % grid_size + 0.5, 0.0, (i * 13) % grid_size + 0.5));
+				query_parameters->set_target_position(Vector3(grid_size - 1 - (i * 11) % grid_size + 0.5, 0.0, grid_size - 1 - (i * 5) % grid_size + 0.5));
+				batch_parameters.push_back(query_parameters);
+				batch_results.push_back(memnew(NavigationPathQueryResult3D));
+			}
+
+			Vector<PackedVector3Array> single_paths;
+			for (int i = 0; i < query_count; i++) {
+				Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+				navigation_server->query_path(batch_parameters[i], query_result);
+				single_paths.push_back(query_result->get_path());
+			}
+
+			navigation_server->query_paths(batch_parameters, batch_results);
+
+			int matching_paths = 0;
+			for (int i = 0; i < query_count; i++) {
+				Ref<NavigationPathQueryResult3D> query_result = batch_results[i];
+				if (query_result->get_path().size() > 0 && query_result->get_path() == single_paths[i]) {
+					matching_paths++;
+				}
+			}
+			CHECK_EQ(matching_paths, query_count);
+		}
+
+		SUBCASE("Hierarchical path queries should reach the same destinations") {
+			CHECK_FALSE(navigation_server->map_get_use_hierarchical_pathfinding(map));
+			navigation_server->map_set_hierarchical_cluster_size(map, 8.0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->map_get_hierarchical_cluster_size(map), doctest::Approx(8.0));
+
+			const int query_count = 64;
+			LocalVector<Vector3> origins;
+			LocalVector<Vector3> destinations;
+			for (int i = 0; i < query_count; i++) {
+				origins.push_back(Vector3((i * 7) % grid_size + 0.5, 0.0, (i * 13) % grid_size + 0.5));
+				destinations.push_back(Vector3(grid_size - 1 - (i * 11) % grid_size + 0.5, 0.0, grid_size - 1 - (i * 5) % grid_size + 0.5));
+			}
+
+			LocalVector<real_t> flat_path_lengths;
+			for (int i = 0; i < query_count; i++) {
+				flat_path_lengths.push_back(get_path_length(navigation_server->map_get_path(map, origins[i], destinations[i], true)));
+			}
+
+			navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK(navigation_server->map_get_use_hierarchical_pathfinding(map));
+
+			int valid_paths = 0;
+			int close_paths = 0;
+			for (int i = 0; i < query_count; i++) {
+				const Vector<Vector3> path = navigation_server->map_get_path(map, origins[i], destinations[i], true);
+				if (path.size() >= 2 && path[0].is_equal_approx(origins[i]) && path[path.size() - 1].is_equal_approx(destinations[i])) {
+					valid_paths++;
+				}
+				// The corridor can miss the optimal path, but should stay close to it.
+				if (get_path_length(path) <= flat_path_lengths[i] * 1.1 + CMP_EPSILON) {
+					close_paths++;
+				}
+			}
+			CHECK_EQ(valid_paths, query_count);
+			CHECK_EQ(close_paths, query_count);
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Map synchronization should only rebuild the regions that changed") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int grid_size = 8;
+		const int grid_polygon_count = grid_size * grid_size;
+		const int grid_edge_count = 2 * grid_size * (grid_size + 1);
+		const int grid_edge_merge_count = 2 * grid_size * (grid_size - 1);
+		Ref<NavigationMesh> navigation_mesh = build_grid_navigation_mesh(grid_size);
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+
+		// Regions side by side along the X axis, sharing their border edges.
+		RID regions[3];
+		for (int i = 0; i < 2; i++) {
+			regions[i] = navigation_server->region_create();
+			navigation_server->region_set_map(regions[i], map);
+			navigation_server->region_set_transform(regions[i], Transform3D(Basis(), Vector3(i * grid_size, 0.0, 0.0)));
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), 2 * grid_polygon_count);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 2 * grid_edge_merge_count + grid_size);
+
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), 0);
+
+		SUBCASE("Adding a region should only rebuild its polygons and merge its border edges") {
+			regions[2] = navigation_server->region_create();
+			navigation_server->region_set_map(regions[2], map);
+			navigation_server->region_set_transform(regions[2], Transform3D(Basis(), Vector3(2 * grid_size, 0.0, 0.0)));
+			navigation_server->region_set_navigation_mesh(regions[2], navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), grid_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 3 * grid_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_COUNT), 3 * grid_edge_count - 2 * grid_size);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 3 * grid_edge_merge_count + 2 * grid_size);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0.0, 0.5), Vector3(3 * grid_size - 0.5, 0.0, grid_size - 0.5), true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(3 * grid_size - 0.5, 0.0, grid_size - 0.5)));
+		}
+
+		SUBCASE("Removing a region should disconnect it from its neighbors") {
+			navigation_server->free(regions[1]);
+			regions[1] = RID();
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), 0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), grid_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_COUNT), grid_edge_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), grid_edge_merge_count);
+
+			// The path can not leave the first region anymore.
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0.0, 4.5), Vector3(grid_size + 4.5, 0.0, 4.5), true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(grid_size, 0.0, 4.5)));
+		}
+
+		SUBCASE("Moving a region should only rebuild its polygons and connect it again") {
+			navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(grid_size + 1.0, 0.0, 0.0)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), grid_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 2 * grid_edge_merge_count);
+
+			navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(grid_size, 0.0, 0.0)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_REBUILD_COUNT), grid_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 2 * grid_edge_merge_count + grid_size);
+		}
+
+		for (const RID &region : regions) {
+			if (region.is_valid()) {
+				navigation_server->free(region);
+			}
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
@@ -0,0 +1,356 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+struct BoxGrid {
+	RID space;
+	RID box_shape;
+	RID sphere_shape;
+	LocalVector<RID> bodies;
+
+	BoxGrid(int p_size) {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		box_shape = ps->box_shape_create();
+		ps->shape_set_data(box_shape, Vector3(0.4, 0.4, 0.4));
+		sphere_shape = ps->sphere_shape_create();
+		ps->shape_set_data(sphere_shape, 0.6);
+
+		for (int x = 0; x < p_size; x++) {
+			for (int z = 0; z < p_size; z++) {
+				RID body = ps->body_create();
+				ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+				ps->body_set_space(body, space);
+				ps->body_add_shape(body, box_shape);
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x, 0, z)));
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	~BoxGrid() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (const RID &body : bodies) {
+			ps->free(body);
+		}
+		ps->free(box_shape);
+		ps->free(sphere_shape);
+		ps->free(space);
+	}
+};
+
+// Deterministic spread of query positions over the grid, including some that miss it.
+static Vector3 query_position(int p_index, int p_size) {
+	const uint32_t hash = hash_murmur3_one_32(p_index);
+	return Vector3((hash & 0xFFFF) / 65535.0 * (p_size + 2) - 1.5, 0, (hash >> 16) / 65535.0 * (p_size + 2) - 1.5);
+}
+
+static Vector<PhysicsDirectSpaceState3D::RayParameters> make_rays(int p_count, int p_size) {
+	Vector<PhysicsDirectSpaceState3D::RayParameters> rays;
+	rays.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		const Vector3 position = query_position(i, p_size);
+		rays.write[i].from = position + Vector3(0, 5, 0);
+		rays.write[i].to = position - Vector3(0, 5, 0);
+	}
+	return rays;
+}
+
+TEST_CASE("[SceneTree][PhysicsDirectSpaceState3D] Batched queries match single queries") {
+	const int size = 16;
+	BoxGrid grid(size);
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(grid.space);
+	REQUIRE(state);
+
+	SUBCASE("Rays") {
+		const int count = 1000;
+		Vector<PhysicsDirectSpaceState3D::RayParameters> rays = make_rays(count, size);
+		Vector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(count);
+		Vector<bool> hits;
+		hits.resize(count);
+		state->intersect_rays(rays.ptr(), count, results.ptrw(), hits.ptrw());
+
+		int hit_count = 0;
+		for (int i = 0; i < count; i++) {
+			PhysicsDirectSpaceState3D::RayResult result;
+			const bool hit = state->intersect_ray(rays[i], result);
+			CHECK_EQ(hits[i], hit);
+			if (hit && hits[i]) {
+				CHECK_EQ(results[i].rid, result.rid);
+				CHECK(results[i].position.is_equal_approx(result.position));
+				CHECK(results[i].normal.is_equal_approx(result.normal));
+				hit_count++;
+			}
+		}
+		CHECK_MESSAGE(hit_count > 0, "Some rays should hit the grid.");
+		CHECK_MESSAGE(hit_count < count, "Some rays should miss the grid.");
+	}
+
+	SUBCASE("Shapes") {
+		const int count = 500;
+		const int max_results = 8;
+		Vector<PhysicsDirectSpaceState3D::ShapeParameters> shapes;
+		shapes.resize(count);
+		for (int i = 0; i < count; i++) {
+			shapes.write[i].shape_rid = grid.sphere_shape;
+			shapes.write[i].transform.origin = query_position(i, size);
+		}
+
+		Vector<PhysicsDirectSpaceState3D::ShapeResult> results;
+		results.resize(count * max_results);
+		Vector<int> result_counts;
+		result_counts.resize(count);
+		state->intersect_shapes(shapes.ptr(), count, results.ptrw(), max_results, result_counts.ptrw());
+
+		PhysicsDirectSpaceState3D::ShapeResult single_results[max_results];
+		for (int i = 0; i < count; i++) {
+			const int single_count = state->intersect_shape(shapes[i], single_results, max_results);
+			REQUIRE_EQ(result_counts[i], single_count);
+			for (int j = 0; j < single_count; j++) {
+				CHECK_EQ(results[i * max_results + j].rid, single_results[j].rid);
+			}
+		}
+	}
+}
+
+// Boxes sliding on a floor, far enough apart that they only ever pair with the floor.
+struct SlidingBoxes {
+	RID space;
+	RID floor_shape;
+	RID box_shape;
+	RID floor;
+	LocalVector<RID> boxes;
+
+	SlidingBoxes(int p_size) {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+		floor_shape = ps->box_shape_create();
+		ps->shape_set_data(floor_shape, Vector3(p_size * 2, 0.5, p_size * 2));
+		box_shape = ps->box_shape_create();
+		ps->shape_set_data(box_shape, Vector3(0.4, 0.4, 0.4));
+
+		floor = ps->body_create();
+		ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_set_space(floor, space);
+		ps->body_add_shape(floor, floor_shape);
+		ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+
+		for (int x = 0; x < p_size; x++) {
+			for (int z = 0; z < p_size; z++) {
+				RID body = ps->body_create();
+				ps->body_set_space(body, space);
+				ps->body_add_shape(body, box_shape);
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x * 3, 0.45, z * 3)));
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(2, 0, 1));
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0, 1, 0));
+				boxes.push_back(body);
+			}
+		}
+	}
+
+	~SlidingBoxes() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (const RID &body : boxes) {
+			ps->free(body);
+		}
+		ps->free(floor);
+		ps->free(box_shape);
+		ps->free(floor_shape);
+		ps->free(space);
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			PhysicsServer3D::get_singleton()->step(1.0 / 60.0);
+		}
+	}
+
+	LocalVector<Transform3D> get_transforms() const {
+		LocalVector<Transform3D> transforms;
+		for (const RID &body : boxes) {
+			transforms.push_back(PhysicsServer3D::get_singleton()->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM));
+		}
+		return transforms;
+	}
+};
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Space snapshots") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	SlidingBoxes scene(5);
+
+	// Let the boxes land, so the floor contacts are cached when saving.
+	scene.step(10);
+	const PackedByteArray snapshot = ps->space_get_snapshot(scene.space);
+	REQUIRE_FALSE(snapshot.is_empty());
+
+	scene.step(20);
+	const LocalVector<Transform3D> expected = scene.get_transforms();
+
+	SUBCASE("Restoring and stepping again gives the same result") {
+		REQUIRE_EQ(ps->space_restore_snapshot(scene.space, snapshot), OK);
+		scene.step(20);
+		const LocalVector<Transform3D> transforms = scene.get_transforms();
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			CHECK_EQ(transforms[i], expected[i]);
+		}
+	}
+
+	SUBCASE("Restoring puts the bodies back") {
+		const Transform3D current = ps->body_get_state(scene.boxes[0], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		REQUIRE_EQ(ps->space_restore_snapshot(scene.space, snapshot), OK);
+		const Transform3D restored = ps->body_get_state(scene.boxes[0], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK_NE(restored, current);
+		CHECK_EQ(ps->space_get_snapshot(scene.space), snapshot);
+	}
+
+	SUBCASE("Invalid snapshots are rejected") {
+		const PackedByteArray current_snapshot = ps->space_get_snapshot(scene.space);
+		PackedByteArray truncated = snapshot;
+		truncated.resize(snapshot.size() - 1);
+		ERR_PRINT_OFF;
+		CHECK_EQ(ps->space_restore_snapshot(scene.space, PackedByteArray()), ERR_INVALID_DATA);
+		CHECK_EQ(ps->space_restore_snapshot(scene.space, truncated), ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+
+		// Nothing is restored from a snapshot that fails to parse.
+		const LocalVector<Transform3D> transforms = scene.get_transforms();
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			CHECK_EQ(transforms[i], expected[i]);
+		}
+		CHECK_EQ(ps->space_get_snapshot(scene.space), current_snapshot);
+	}
+}
+
+static Transform3D synced_transform;
+static int sync_count = 0;
+
+static void sync_body_state(PhysicsDirectBodyState3D *p_state) {
+	synced_transform = p_state->get_transform();
+	sync_count++;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Space snapshots of sleeping bodies") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	SlidingBoxes scene(1);
+	const RID box = scene.boxes[0];
+	ps->body_set_state_sync_callback(box, callable_mp_static(&sync_body_state));
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_CAN_SLEEP, true);
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_SLEEPING, true);
+	scene.step(1);
+	ps->flush_queries();
+
+	const Transform3D asleep = ps->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	const PackedByteArray snapshot = ps->space_get_snapshot(scene.space);
+	REQUIRE_FALSE(snapshot.is_empty());
+
+	// Wake the body somewhere else, so its node follows it there.
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(5, 0.45, 5)));
+	scene.step(1);
+	ps->flush_queries();
+	REQUIRE_NE(synced_transform, asleep);
+
+	REQUIRE_EQ(ps->space_restore_snapshot(scene.space, snapshot), OK);
+	CHECK(bool(ps->body_get_state(box, PhysicsServer3D::BODY_STATE_SLEEPING)));
+
+	sync_count = 0;
+	scene.step(1);
+	ps->flush_queries();
+	CHECK_MESSAGE(sync_count == 1, "The restored sleeping body should report its state once.");
+	CHECK_EQ(synced_transform, asleep);
+
+	ps->body_set_state_sync_callback(box, Callable());
+}
+
+static Vector<PhysicsServer3D::MotionParameters> make_motions(const SlidingBoxes &p_scene) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	Vector<PhysicsServer3D::MotionParameters> motions;
+	motions.resize(p_scene.boxes.size());
+	for (uint32_t i = 0; i < p_scene.boxes.size(); i++) {
+		PhysicsServer3D::MotionParameters &motion = motions.write[i];
+		motion.from = ps->body_get_state(p_scene.boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		// Into the next box, down into the floor, or up into nothing.
+		const Vector3 directions[3] = { Vector3(2.5, 0, 0), Vector3(0.5, -0.3, 0.5), Vector3(0, 1, 0) };
+		motion.motion = directions[i % 3];
+		motion.max_collisions = 4;
+		motion.recovery_as_collision = true;
+	}
+	return motions;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched motion tests match single motion tests") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	SlidingBoxes scene(12);
+	scene.step(1);
+
+	const Vector<PhysicsServer3D::MotionParameters> motions = make_motions(scene);
+	const int count = motions.size();
+	Vector<PhysicsServer3D::MotionResult> results;
+	results.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+	ps->body_test_motions(scene.boxes.ptr(), motions.ptr(), count, results.ptrw(), collided.ptrw());
+
+	int collided_count = 0;
+	for (int i = 0; i < count; i++) {
+		PhysicsServer3D::MotionResult result;
+		const bool single_collided = ps->body_test_motion(scene.boxes[i], motions[i], &result);
+		CHECK_EQ(collided[i], single_collided);
+		CHECK(results[i].travel.is_equal_approx(result.travel));
+		CHECK(results[i].remainder.is_equal_approx(result.remainder));
+		REQUIRE_EQ(results[i].collision_count, result.collision_count);
+		for (int j = 0; j < result.collision_count; j++) {
+			CHECK_EQ(results[i].collisions[j].collider, result.collisions[j].collider);
+			CHECK(results[i].collisions[j].normal.is_equal_approx(result.collisions[j].normal));
+		}
+		if (single_collided) {
+			collided_count++;
+		}
+	}
+	CHECK_MESSAGE(collided_count > 0, "Some motions should collide.");
+	CHECK_MESSAGE(collided_count < count, "Some motions should be free.");
+
+	const Transform3D moved = ps->body_get_state(scene.boxes[0], PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK_MESSAGE(moved == motions[0].from, "Testing motions shouldn't move the bodies.");
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H